@@ -1,5 +1,6 @@
 // C++ includes
 #include <vector>
+#include <memory>
 
 // MAST includes
 #include "examples/fluid/meshing/panel_mesh_2D.h"
@@ -28,6 +29,7 @@
 #include "elasticity/structural_modal_eigenproblem_assembly.h"
 #include "elasticity/structural_near_null_vector_space.h"
 #include "elasticity/fsi_generalized_aero_force_assembly.h"
+#include "elasticity/gaf_database_assembly.h"
 #include "elasticity/fluid_structure_assembly_elem_operations.h"
 #include "boundary_condition/dirichlet_boundary_condition.h"
 #include "property_cards/solid_1d_section_element_property_card.h"
@@ -87,7 +89,11 @@ int main(int argc, char* argv[]) {
     tol                 = input(  "g_tol", "tolerace for convergence of damping of flutter root", 1e-4),
     length              = input("panel_l",                                     "length of panel",  0.3),
     ff_to_panel_l       = input("farfield_to_l_ratio", "Ratio of distance of farfield boundary to panel length",  5.0),
-    ff_to_panel_e_size  = input("farfield_to_panel_elem_size_ratio", "Ratio of element size at far-field to element size at panel",  20.0);
+    ff_to_panel_e_size  = input("farfield_to_panel_elem_size_ratio", "Ratio of element size at far-field to element size at panel",  20.0),
+    gaf_refine_tol      = input("gaf_refine_tol", "tolerance on estimated error of interpolated GAF matrices above which the fluid is solved", 1.e-3);
+    
+    const bool
+    if_gaf_database     = input("if_gaf_database", "interpolate the GAF matrices from a database of reduced frequency samples", false);
     
     
     //////////////////////////////////////////////////////////////////////
@@ -447,7 +453,24 @@ int main(int argc, char* argv[]) {
     // solver for complex solution
     MAST::ComplexSolverBase solver;
     
-    MAST::FSIGeneralizedAeroForceAssembly      fsi_assembly;
+    // the GAF matrices are either computed from the fluid solution at
+    // each reduced frequency, or interpolated from a database of samples
+    std::unique_ptr<MAST::FSIGeneralizedAeroForceAssembly>
+    fsi_assembly_ptr;
+    
+    if (if_gaf_database) {
+        
+        MAST::GAFDatabaseAssembly
+        *gaf_assembly = new MAST::GAFDatabaseAssembly;
+        
+        gaf_assembly->set_reduced_frequency_parameter(omega);
+        gaf_assembly->set_refinement_tolerance(gaf_refine_tol);
+        fsi_assembly_ptr.reset(gaf_assembly);
+    }
+    else
+        fsi_assembly_ptr.reset(new MAST::FSIGeneralizedAeroForceAssembly);
+    
+    MAST::FSIGeneralizedAeroForceAssembly&     fsi_assembly = *fsi_assembly_ptr;
     MAST::FluidStructureAssemblyElemOperations fsi_elem_ops;
     fsi_assembly.set_discipline_and_system(structural_discipline, structural_sys_init);
     fsi_elem_ops.set_discipline_and_system(structural_discipline, structural_sys_init);
@@ -485,6 +508,12 @@ int main(int argc, char* argv[]) {
     
     flutter_solver.print_sorted_roots();
     
+    if (if_gaf_database)
+        libMesh::out
+        << "Number of reduced frequency samples in GAF database: "
+        << dynamic_cast<MAST::GAFDatabaseAssembly&>(fsi_assembly).n_samples()
+        << std::endl;
+    
     // make sure solution was found
     libmesh_assert(sol.first);
     
@@ -44,6 +44,7 @@
 #include "base/nonlinear_system.h"
 #include "base/transient_assembly.h"
 #include "base/boundary_condition_base.h"
+#include "base/parameter_support_index.h"
 #include "boundary_condition/dirichlet_boundary_condition.h"
 #include "solver/first_order_newmark_transient_solver.h"
 #include "property_cards/material_property_card_base.h"
@@ -242,7 +243,8 @@ _indicator_discipline                (nullptr),
 _level_set_discipline                (nullptr),
 _level_set_function                  (nullptr),
 _level_set_vel                       (nullptr),
-_output                              (nullptr) {
+_output                              (nullptr),
+_dv_support                          (nullptr) {
     
 }
 
@@ -262,6 +264,7 @@ MAST::Examples::TopologyOptimizationLevelSet2D::~TopologyOptimizationLevelSet2D(
     delete _level_set_mesh;
     delete _output;
     delete _level_set_sys_init_on_str_mesh;
+    delete _dv_support;
     
     for (unsigned int i=0; i<_dv_params.size(); i++)
         delete _dv_params[i].second;
@@ -317,6 +320,15 @@ MAST::Examples::TopologyOptimizationLevelSet2D::init(MAST::Examples::GetPotWrapp
     // function value
     this->_init_phi_dvs();
 
+    // identify the structural elements influenced by each level set dv, so
+    // that the sensitivity assembly can skip all other elements
+    std::vector<std::pair<libMesh::dof_id_type, const MAST::FunctionBase*> >
+    dv_dofs(_dv_params.size());
+    for (unsigned int i=0; i<_dv_params.size(); i++)
+        dv_dofs[i] = std::make_pair(_dv_params[i].first, _dv_params[i].second);
+    _dv_support            = new MAST::ParameterSupportIndex(*_mesh);
+    _dv_support->add_level_set_dof_support(*_level_set_sys, dv_dofs);
+
     unsigned int
     max_inner_iters        = (*_input)(_prefix+"max_inner_iters", "maximum inner iterations in GCMMA", 15);
     
@@ -477,6 +489,7 @@ MAST::Examples::TopologyOptimizationLevelSet2D::evaluate(const std::vector<Real>
     nonlinear_assembly.set_discipline_and_system(*_discipline, *_sys_init);
     nonlinear_assembly.set_level_set_function(*_level_set_function);
     nonlinear_assembly.set_level_set_velocity_function(*_level_set_vel);
+    nonlinear_assembly.set_parameter_support_index(*_dv_support);
     //nonlinear_assembly.set_indicator_function(indicator);
     eigen_assembly.set_discipline_and_system(*_discipline, *_sys_init);
     eigen_assembly.set_level_set_function(*_level_set_function);
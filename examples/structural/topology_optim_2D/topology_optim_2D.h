@@ -42,6 +42,7 @@ namespace MAST  {
     class AssemblyElemOperations;
     class StructuralModalEigenproblemAssemblyElemOperations;
     class HeatConductionSystemInitialization;
+    class ParameterSupportIndex;
     template <typename ValType> class FieldFunction;
     
     
@@ -189,6 +190,7 @@ namespace MAST  {
             MAST::LevelSetBoundaryVelocity*           _level_set_vel;
             libMesh::ExodusII_IO*                     _output;
             std::vector<std::pair<unsigned int, MAST::Parameter*>>  _dv_params;
+            MAST::ParameterSupportIndex*              _dv_support;
         };
     }
 }
@@ -25,6 +25,7 @@
 MAST::FlutterRootBase::FlutterRootBase():
 has_sensitivity_data  (false),
 if_nonphysical_root   (false),
+if_computed           (true),
 kr                    (0.),
 g                     (0.),
 kr_sens               (0.),
@@ -40,6 +41,7 @@ root_sens             (0.)
 MAST::FlutterRootBase::FlutterRootBase(const FlutterRootBase& f):
 has_sensitivity_data   (f.has_sensitivity_data),
 if_nonphysical_root    (f.if_nonphysical_root),
+if_computed            (f.if_computed),
 kr                     (f.kr),
 g                      (f.g),
 kr_sens                (f.kr_sens),
@@ -60,6 +62,7 @@ MAST::FlutterRootBase::copy_root(const MAST::FlutterRootBase& f) {
     
     has_sensitivity_data   = f.has_sensitivity_data;
     if_nonphysical_root    = f.if_nonphysical_root;
+    if_computed            = f.if_computed;
     kr                     = f.kr;
     g                      = f.g;
     kr_sens                = f.kr_sens;
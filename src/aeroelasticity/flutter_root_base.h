@@ -46,6 +46,14 @@ namespace MAST {
         
         bool has_sensitivity_data, if_nonphysical_root;
         
+        /*!
+         *   false for the roots of a tracked-root solution other than the
+         *   tracked root. These are not computed, and only hold the values
+         *   of the reference solution, so they are excluded from the output
+         *   and from the search for flutter crossover points.
+         */
+        bool if_computed;
+        
         Real kr, g, kr_sens, V, omega, V_sens;
         
         Complex root, root_sens;
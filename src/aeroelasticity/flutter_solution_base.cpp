@@ -45,3 +45,67 @@ MAST::FlutterSolutionBase::swap_root(MAST::FlutterSolutionBase& sol,
 }
 
 
+
+
+
+
+void
+MAST::FlutterSolutionBase::eigenvector_matrix(bool if_left,
+                                              ComplexMatrixX& vecs) const {
+    
+    libmesh_assert(_roots.size());
+    
+    const unsigned int
+    n    = (unsigned int)_roots[0]->eig_vec_right.size();
+    
+    vecs.setZero(n, _roots.size());
+    
+    for (unsigned int i=0; i<_roots.size(); i++)
+        vecs.col(i) = if_left?_roots[i]->eig_vec_left:_roots[i]->eig_vec_right;
+}
+
+
+
+
+void
+MAST::FlutterSolutionBase::
+_sort_with_correlation(const MAST::FlutterSolutionBase& sol,
+                       const ComplexMatrixX& corr) {
+    
+    const unsigned int nvals = this->n_roots();
+    libmesh_assert_equal_to(nvals, sol.n_roots());
+    libmesh_assert_equal_to(corr.rows(), nvals);
+    libmesh_assert_equal_to(corr.cols(), nvals);
+    
+    // the columns of corr refer to the original order of the roots, which
+    // is tracked as the roots are swapped
+    std::vector<unsigned int> perm(nvals);
+    for (unsigned int i=0; i<nvals; i++)
+        perm[i] = i;
+    
+    for (unsigned int i=0; i+1<nvals; i++)
+    {
+        const MAST::FlutterRootBase& r = sol.get_root(i);
+        Real max_val = 0., val = 0.;
+        unsigned int max_val_root = nvals-1;
+        for (unsigned int j=i; j<nvals; j++) {
+            
+            // scale by the eigenvalue separation with the assumption that
+            // the roots will be closer to each other than any other
+            // root at two consecutive eigenvalues. In other words,
+            // we are penalizing the dot product with the eigenvalue
+            // distance
+            val = std::abs(corr(i, perm[j]))/std::abs(r.root-_roots[j]->root);
+            if (val > max_val) {
+                max_val = val;
+                max_val_root = j;
+            }
+        }
+        
+        // now we should have the one with highest dot product
+        if (i != max_val_root) {
+            std::swap(_roots[i], _roots[max_val_root]);
+            std::swap(perm[i],   perm[max_val_root]);
+        }
+    }
+}
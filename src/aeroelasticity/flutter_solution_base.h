@@ -102,6 +102,14 @@ namespace MAST {
                        unsigned int root_num);
                 
         
+        /*!
+         *    initializes \p vecs with the right eigenvectors of the roots as
+         *    its columns, or the left eigenvectors if \p if_left is true.
+         */
+        void eigenvector_matrix(bool if_left,
+                                ComplexMatrixX& vecs) const;
+        
+        
         /*!
          *    prints the data and modes from this solution
          */
@@ -110,6 +118,18 @@ namespace MAST {
         
     protected:
         
+        /*!
+         *    sorts the roots of this solution with respect to those of \p sol.
+         *    \p corr(i,j) is the correlation of the i-th root of \p sol with
+         *    the j-th root of this solution, computed by the derived class as
+         *    a single block product of the eigenvector matrices. Starting
+         *    from the first root of \p sol, the root of this solution with
+         *    the highest correlation scaled by the inverse of the eigenvalue
+         *    separation is moved to the same position.
+         */
+        void _sort_with_correlation(const MAST::FlutterSolutionBase& sol,
+                                    const ComplexMatrixX& corr);
+        
         /*!
          *    Reference value of the sweeping parameter for which this solution
          *    was obtained. For UG solver, this is k_red, and for time domain
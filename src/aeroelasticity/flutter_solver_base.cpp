@@ -28,13 +28,22 @@
 #include "base/boundary_condition_base.h"
 #include "numerics/lapack_dggev_interface.h"
 #include "base/parameter.h"
+#include "base/element_matrix_cache.h"
 
 
 MAST::FlutterSolverBase::FlutterSolverBase():
 _assembly(nullptr),
 _basis_vectors(nullptr),
 _output(nullptr),
-_steady_solver(nullptr) {
+_steady_solver(nullptr),
+_structural_base_sol(nullptr),
+_structural_base_sol_norm(0.),
+_structural_base_sol_sum(0.),
+_if_track_roots(false),
+_scan_comm(nullptr),
+_scan_group_comm(nullptr),
+_scan_group_id(0),
+_n_scan_groups(1) {
     
 }
 
@@ -59,6 +68,8 @@ attach_assembly(MAST::StructuralFluidInteractionAssembly&   assembly) {
     libmesh_assert(!_assembly);
     
     _assembly = &assembly;
+    
+    this->clear_reduced_order_structural_quantities();
 }
 
 
@@ -73,6 +84,8 @@ MAST::FlutterSolverBase::clear() {
         delete _output;
         _output = nullptr;
     }
+    
+    this->clear_reduced_order_structural_quantities();
 }
 
 
@@ -90,6 +103,8 @@ MAST::FlutterSolverBase::clear_assembly_object() {
     
     _assembly      = nullptr;
     _steady_solver = nullptr;
+    
+    this->clear_reduced_order_structural_quantities();
 }
 
 
@@ -101,6 +116,357 @@ initialize(std::vector<libMesh::NumericVector<Real> *>& basis) {
     
     
     _basis_vectors  = &basis;
+    
+    this->clear_reduced_order_structural_quantities();
+}
+
+
+
+void
+MAST::FlutterSolverBase::add_structural_parameter(const MAST::Parameter& p) {
+    
+    _structural_params.push_back(&p);
+    
+    this->clear_reduced_order_structural_quantities();
+}
+
+
+
+void
+MAST::FlutterSolverBase::clear_reduced_order_structural_quantities() {
+    
+    _structural_qty.clear();
+    _structural_base_sol      = nullptr;
+    _structural_base_sol_norm = 0.;
+    _structural_base_sol_sum  = 0.;
+    _structural_param_vals.clear();
+}
+
+
+
+void
+MAST::FlutterSolverBase::
+set_scan_groups(const libMesh::Parallel::Communicator& comm,
+                const libMesh::Parallel::Communicator& group_comm) {
+    
+    // the first processor of each group identifies the group
+    const unsigned int
+    if_leader = group_comm.rank() == 0 ? 1 : 0;
+    
+    std::vector<unsigned int>
+    leaders;
+    comm.allgather(if_leader, leaders);
+    
+    unsigned int
+    n_groups = 0,
+    group_id = 0;
+    
+    for (unsigned int i=0; i<leaders.size(); i++) {
+        
+        if (i == comm.rank())
+            group_id = n_groups;
+        n_groups += leaders[i];
+    }
+    
+    // processors other than the group leader receive the group id
+    group_comm.broadcast(group_id);
+    
+    _scan_comm       = &comm;
+    _scan_group_comm = &group_comm;
+    _scan_group_id   = group_id;
+    _n_scan_groups   = n_groups;
+}
+
+
+
+void
+MAST::FlutterSolverBase::
+split_scan_communicator(const libMesh::Parallel::Communicator& comm,
+                        unsigned int n_groups,
+                        libMesh::Parallel::Communicator& group_comm) {
+    
+    libmesh_assert_greater(n_groups, 0);
+    libmesh_assert_less_equal(n_groups, comm.size());
+    
+    const unsigned int
+    group_id = (comm.rank() * n_groups) / comm.size();
+    
+    comm.split(group_id, comm.rank(), group_comm);
+}
+
+
+
+bool
+MAST::FlutterSolverBase::_track_root(const ComplexMatrixX& A,
+                                     const ComplexMatrixX& B,
+                                     Complex& lambda,
+                                     ComplexVectorX& x,
+                                     ComplexVectorX& y,
+                                     const Real tol,
+                                     const unsigned int max_iters) {
+    
+    libmesh_assert_equal_to(x.size(), A.rows());
+    libmesh_assert_equal_to(y.size(), A.rows());
+    
+    ComplexMatrixX
+    m;
+    
+    ComplexVectorX
+    Ax,
+    Bx;
+    
+    Eigen::PartialPivLU<ComplexMatrixX>
+    lu;
+    
+    x /= x.norm();
+    y /= y.norm();
+    
+    const ComplexVectorX
+    x0 = x;
+    
+    Real
+    res = 0.;
+    
+    bool
+    if_converged = false;
+    
+    // the first shift is the initial eigenvalue, which is then updated by
+    // the two-sided Rayleigh quotient of the iterates
+    for (unsigned int i=0; i<max_iters; i++) {
+        
+        // inverse iteration with the shifted operator for the right and
+        // left eigenvectors
+        m = A - lambda * B;
+        lu.compute(m);
+        
+        x = lu.solve(B * x);
+        y = lu.adjoint().solve(B.adjoint() * y);
+        
+        if (!x.allFinite() || !y.allFinite())
+            return false;
+        
+        x /= x.norm();
+        y /= y.norm();
+        
+        Ax     = A * x;
+        Bx     = B * x;
+        lambda = y.dot(Ax)/y.dot(Bx);
+        
+        res    = (Ax - lambda * Bx).norm()/(Ax.norm() + std::abs(lambda) * Bx.norm());
+        
+        if (res <= tol) {
+            
+            if_converged = true;
+            break;
+        }
+    }
+    
+    // make sure that the iterations did not converge to another root
+    if (!if_converged || std::norm(x0.dot(x)) < 0.5)
+        return false;
+    
+    // same scaling as the left eigenvectors of the full eigensolution
+    const Complex
+    val = y.dot(B * x);
+    
+    if (std::abs(val) > 0.)
+        y *= (1./val);
+    
+    return true;
+}
+
+
+
+void
+MAST::FlutterSolverBase::_exchange_scan_data(std::vector<Real>& data) const {
+    
+    if (!_scan_comm)
+        return;
+    
+    // all processors of a group have the same data, so only the group
+    // leader contributes to the sum
+    if (_scan_group_comm->rank() != 0)
+        std::fill(data.begin(), data.end(), 0.);
+    
+    _scan_comm->sum(data);
+}
+
+
+
+void
+MAST::FlutterSolverBase::_pack_scan_data(const RealMatrixX& m,
+                                         std::vector<Real>& data,
+                                         unsigned int& idx) {
+    
+    libmesh_assert_less_equal(idx + m.size(), data.size());
+    
+    for (unsigned int i=0; i<m.rows(); i++)
+        for (unsigned int j=0; j<m.cols(); j++)
+            data[idx++] = m(i,j);
+}
+
+
+
+void
+MAST::FlutterSolverBase::_pack_scan_data(const ComplexMatrixX& m,
+                                         std::vector<Real>& data,
+                                         unsigned int& idx) {
+    
+    libmesh_assert_less_equal(idx + 2*m.size(), data.size());
+    
+    for (unsigned int i=0; i<m.rows(); i++)
+        for (unsigned int j=0; j<m.cols(); j++) {
+            data[idx++] = m(i,j).real();
+            data[idx++] = m(i,j).imag();
+        }
+}
+
+
+
+void
+MAST::FlutterSolverBase::_unpack_scan_data(const std::vector<Real>& data,
+                                           unsigned int& idx,
+                                           RealMatrixX& m) {
+    
+    libmesh_assert_less_equal(idx + m.size(), data.size());
+    
+    for (unsigned int i=0; i<m.rows(); i++)
+        for (unsigned int j=0; j<m.cols(); j++)
+            m(i,j) = data[idx++];
+}
+
+
+
+void
+MAST::FlutterSolverBase::_unpack_scan_data(const std::vector<Real>& data,
+                                           unsigned int& idx,
+                                           ComplexMatrixX& m) {
+    
+    libmesh_assert_less_equal(idx + 2*m.size(), data.size());
+    
+    for (unsigned int i=0; i<m.rows(); i++)
+        for (unsigned int j=0; j<m.cols(); j++) {
+            m(i,j) = Complex(data[idx], data[idx+1]);
+            idx += 2;
+        }
+}
+
+
+
+void
+MAST::FlutterSolverBase::
+_register_element_matrix_cache_parameter(const MAST::Parameter& p) {
+    
+    libmesh_assert(_assembly);
+    
+    // the parameter is only added the first time, so this is cheap to
+    // call before each assembly
+    if (_assembly->element_matrix_cache())
+        _assembly->element_matrix_cache()->add_parameter(p);
+}
+
+
+
+void
+MAST::FlutterSolverBase::_validate_reduced_order_structural_quantities() {
+    
+    libmesh_assert(_assembly);
+    
+    if (_structural_qty.empty())
+        return;
+    
+    // the parameter values are compared with those used for the
+    // stored quantities
+    bool
+    if_valid = _structural_param_vals.size() == _structural_params.size();
+    
+    for (unsigned int i=0; if_valid && i<_structural_params.size(); i++)
+        if_valid = (*_structural_params[i])() == _structural_param_vals[i];
+    
+    if (!if_valid) {
+        
+        this->clear_reduced_order_structural_quantities();
+        return;
+    }
+    
+    // changes to the base solution are identified from the vector and its
+    // norm and sum. Only the mass matrix is retained if it has changed.
+    const libMesh::NumericVector<Real>*
+    base_sol = nullptr;
+    
+    Real
+    norm     = 0.,
+    sum      = 0.;
+    
+    if (_assembly->if_linearized_about_nonzero_solution()) {
+        
+        base_sol = &_assembly->base_sol();
+        norm     = base_sol->l2_norm();
+        sum      = base_sol->sum();
+    }
+    
+    if (base_sol != _structural_base_sol  ||
+        norm     != _structural_base_sol_norm ||
+        sum      != _structural_base_sol_sum) {
+        
+        std::map<MAST::StructuralQuantityType, RealMatrixX>::iterator
+        it  = _structural_qty.begin();
+        
+        while (it != _structural_qty.end()) {
+            
+            if (it->first == MAST::MASS)
+                it++;
+            else
+                _structural_qty.erase(it++);
+        }
+    }
+}
+
+
+
+void
+MAST::FlutterSolverBase::_assemble_reduced_order_structural_quantities
+(std::map<MAST::StructuralQuantityType, RealMatrixX*>& qty_map) {
+    
+    libmesh_assert(_assembly);
+    libmesh_assert(_basis_vectors);
+    
+    this->_validate_reduced_order_structural_quantities();
+    
+    // quantities that are not available are assembled together
+    std::map<MAST::StructuralQuantityType, RealMatrixX*> assemble_map;
+    
+    std::map<MAST::StructuralQuantityType, RealMatrixX*>::iterator
+    it  = qty_map.begin(),
+    end = qty_map.end();
+    
+    for ( ; it != end; it++)
+        if (!_structural_qty.count(it->first))
+            assemble_map[it->first] = &_structural_qty[it->first];
+    
+    if (assemble_map.size()) {
+        
+        _assembly->assemble_reduced_order_quantity(*_basis_vectors, assemble_map);
+        
+        // record the data used for the stored quantities
+        _structural_param_vals.resize(_structural_params.size());
+        for (unsigned int i=0; i<_structural_params.size(); i++)
+            _structural_param_vals[i] = (*_structural_params[i])();
+        
+        _structural_base_sol      = nullptr;
+        _structural_base_sol_norm = 0.;
+        _structural_base_sol_sum  = 0.;
+        
+        if (_assembly->if_linearized_about_nonzero_solution()) {
+            
+            _structural_base_sol      = &_assembly->base_sol();
+            _structural_base_sol_norm = _structural_base_sol->l2_norm();
+            _structural_base_sol_sum  = _structural_base_sol->sum();
+        }
+    }
+    
+    for (it = qty_map.begin(); it != end; it++)
+        *it->second = _structural_qty[it->first];
 }
 
 
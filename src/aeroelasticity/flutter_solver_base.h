@@ -24,14 +24,18 @@
 #include <string>
 #include <fstream>
 #include <iomanip>
+#include <map>
+#include <vector>
 
 
 // MAST includes
 #include "base/mast_data_types.h"
+#include "elasticity/structural_fluid_interaction_assembly.h"
 
 
 // libMesh includes
 #include "libmesh/numeric_vector.h"
+#include "libmesh/parallel.h"
 
 
 
@@ -39,6 +43,7 @@ namespace MAST {
     
     // Forward declerations
     class FunctionBase;
+    class Parameter;
     class FlutterModel;
     class FlutterRootBase;
     class FlutterSolutionBase;
@@ -119,6 +124,75 @@ namespace MAST {
         void initialize(std::vector<libMesh::NumericVector<Real>*>& basis);
 
         
+        /*!
+         *   The reduced order structural quantities do not depend on the
+         *   reduced frequency or velocity. They are assembled once and reused
+         *   by the subsequent eigensolutions. The stored quantities are
+         *   reassembled when the basis or assembly is changed, when the base
+         *   solution of the assembly changes (except for the mass matrix,
+         *   which is independent of the solution), or when the value of a
+         *   parameter registered with this method changes. Changes to the
+         *   structural model that are not described by a registered
+         *   parameter require a call to
+         *   clear_reduced_order_structural_quantities().
+         */
+        void add_structural_parameter(const MAST::Parameter& p);
+        
+        
+        /*!
+         *   removes the stored reduced order structural quantities
+         */
+        virtual void clear_reduced_order_structural_quantities();
+        
+        
+        /*!
+         *   enables the concurrent evaluation of the scan points in
+         *   scan_for_roots() by groups of processors. \p comm includes the
+         *   processors of all groups, and \p group_comm is the communicator
+         *   of the group that this processor belongs to, which can be
+         *   created by split_scan_communicator(). Each group must hold its
+         *   own copy of the structural and fluid systems on \p group_comm,
+         *   and the assembly and basis of the group are attached to this
+         *   solver. The scan points are distributed cyclically over the
+         *   groups, and the reduced order matrices computed by each group
+         *   are exchanged over \p comm. All processors then compute the
+         *   eigensolutions and sort the roots in the order of the serial
+         *   scan, so that the scan results are identical on all groups.
+         *   This must be called on all processors of \p comm.
+         */
+        void set_scan_groups(const libMesh::Parallel::Communicator& comm,
+                             const libMesh::Parallel::Communicator& group_comm);
+        
+        
+        /*!
+         *   splits \p comm into \p n_groups groups of consecutive processors
+         *   and initializes \p group_comm as the communicator of the group
+         *   that this processor belongs to.
+         */
+        static void
+        split_scan_communicator(const libMesh::Parallel::Communicator& comm,
+                                unsigned int n_groups,
+                                libMesh::Parallel::Communicator& group_comm);
+        
+        
+        
+        /*!
+         *   if \p f is true, the eigensolutions in the search for the
+         *   critical roots after the scan track only the root being
+         *   searched. The eigenpair of the previous solution is used as the
+         *   starting point for a two-sided Rayleigh quotient iteration with
+         *   the matrices at the new reference value. The other roots in the
+         *   new solution are copied from the previous solution. The full
+         *   eigensolution is used if the iterations do not converge, or if
+         *   the converged eigenvector does not correlate with the initial
+         *   vector. Scans always use the full eigensolution. The tracking
+         *   is disabled by default.
+         */
+        void set_root_tracking(bool f) {
+            _if_track_roots = f;
+        }
+        
+        
         
         void set_output_file(const std::string& nm) {
             
@@ -146,6 +220,95 @@ namespace MAST {
     protected:
         
         
+        /*!
+         *   assembles the reduced order structural quantities in \p qty_map,
+         *   reusing the values stored by a previous call if these are still
+         *   valid. This must be called on all processors.
+         */
+        void _assemble_reduced_order_structural_quantities
+        (std::map<MAST::StructuralQuantityType, RealMatrixX*>& qty_map);
+        
+        
+        /*!
+         *   removes the stored quantities that were computed from a base
+         *   solution or parameter values that have since changed.
+         */
+        void _validate_reduced_order_structural_quantities();
+        
+        
+        /*!
+         *   registers \p p with the element matrix cache of the assembly,
+         *   if one is in use, so that element matrices cached for one
+         *   value of the reduced frequency or velocity are not reused
+         *   after the solver changes it.
+         */
+        void _register_element_matrix_cache_parameter(const MAST::Parameter& p);
+        
+        
+        /*!
+         *   iterates on the eigenpair of \f$ A x = \lambda B x \f$ starting
+         *   from \p lambda, the right eigenvector \p x and the left
+         *   eigenvector \p y, which are replaced by the converged values.
+         *   The first inverse iteration is shifted by the initial
+         *   \p lambda, so approximate initial vectors are sufficient.
+         *   The eigenvectors are scaled in the same way as
+         *   LAPACK_ZGGEV_Base::scale_eigenvectors_to_identity_innerproduct().
+         *   @returns false if the iterations did not converge, or if the
+         *   converged right eigenvector has a modal assurance criterion
+         *   less than 0.5 with the initial vector.
+         */
+        static bool _track_root(const ComplexMatrixX& A,
+                                const ComplexMatrixX& B,
+                                Complex& lambda,
+                                ComplexVectorX& x,
+                                ComplexVectorX& y,
+                                const Real tol = 1.e-10,
+                                const unsigned int max_iters = 20);
+        
+        
+        /*!
+         *   @returns true if the scan point with index \p i is evaluated by
+         *   the group of this processor.
+         */
+        bool _if_local_scan_point(unsigned int i) const {
+            return (i % _n_scan_groups) == _scan_group_id;
+        }
+        
+        
+        /*!
+         *   exchanges the data of the scan points between the groups. On
+         *   input \p data has the values of the points evaluated by this
+         *   group and zero elsewhere. On output it has the values of all
+         *   points on all processors.
+         */
+        void _exchange_scan_data(std::vector<Real>& data) const;
+        
+        
+        /*!
+         *   copies \p m to \p data starting at \p idx, and increments
+         *   \p idx past the copied values.
+         */
+        static void _pack_scan_data(const RealMatrixX& m,
+                                    std::vector<Real>& data,
+                                    unsigned int& idx);
+        static void _pack_scan_data(const ComplexMatrixX& m,
+                                    std::vector<Real>& data,
+                                    unsigned int& idx);
+        
+        
+        /*!
+         *   copies the values in \p data starting at \p idx to \p m, and
+         *   increments \p idx past the copied values. \p m must be sized
+         *   before the call.
+         */
+        static void _unpack_scan_data(const std::vector<Real>& data,
+                                      unsigned int& idx,
+                                      RealMatrixX& m);
+        static void _unpack_scan_data(const std::vector<Real>& data,
+                                      unsigned int& idx,
+                                      ComplexMatrixX& m);
+        
+        
         /*!
          *   structural assembly that provides the assembly of the system
          *   matrices.
@@ -170,6 +333,45 @@ namespace MAST {
          */
         MAST::FlutterSolverBase::SteadySolver* _steady_solver;
         
+        
+        /*!
+         *    reduced order structural quantities stored for reuse
+         */
+        std::map<MAST::StructuralQuantityType, RealMatrixX> _structural_qty;
+        
+        
+        /*!
+         *    parameters that the structural quantities depend on, and their
+         *    values when the quantities were assembled
+         */
+        std::vector<const MAST::Parameter*>             _structural_params;
+        std::vector<Real>                               _structural_param_vals;
+        
+        
+        /*!
+         *    base solution used for the stored quantities, along with its
+         *    norm and sum used to identify changes to its values
+         */
+        const libMesh::NumericVector<Real>*             _structural_base_sol;
+        Real                                            _structural_base_sol_norm;
+        Real                                            _structural_base_sol_sum;
+        
+        
+        /*!
+         *    flag to track the searched root during the root search
+         */
+        bool                                            _if_track_roots;
+        
+        
+        /*!
+         *    communicators of all groups and of the group of this processor
+         *    for the concurrent scan, along with the group id and the
+         *    number of groups. The scan is serial if these are not set.
+         */
+        const libMesh::Parallel::Communicator*          _scan_comm;
+        const libMesh::Parallel::Communicator*          _scan_group_comm;
+        unsigned int                                    _scan_group_id;
+        unsigned int                                    _n_scan_groups;
     };
 }
 
@@ -0,0 +1,217 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2018  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <algorithm>
+
+
+// MAST includes
+#include "aeroelasticity/modal_basis_manager.h"
+#include "base/nonlinear_system.h"
+#include "base/eigenproblem_assembly.h"
+#include "base/assembly_elem_operation.h"
+#include "elasticity/structural_fluid_interaction_assembly.h"
+#include "base/performance_counters.h"
+
+
+// libMesh includes
+#include "libmesh/dof_map.h"
+
+
+
+MAST::ModalBasisManager::ModalBasisManager(MAST::NonlinearSystem& sys):
+_system          (sys),
+_if_warm_start   (true),
+_tol             (0.),
+_basis_change    (1.) {
+    
+}
+
+
+
+MAST::ModalBasisManager::~ModalBasisManager() {
+    
+    this->clear();
+}
+
+
+
+void
+MAST::ModalBasisManager::clear() {
+    
+    for (unsigned int i=0; i<_basis.size(); i++) {
+        
+        delete _basis[i];
+        delete _localized_basis[i];
+    }
+    
+    _basis.clear();
+    _localized_basis.clear();
+    _eig_vals.clear();
+    _basis_change = 1.;
+}
+
+
+
+void
+MAST::ModalBasisManager::set_basis_tolerance(Real tol) {
+    
+    libmesh_assert_greater_equal(tol, 0.);
+    
+    _tol = tol;
+}
+
+
+
+bool
+MAST::ModalBasisManager::update(MAST::AssemblyElemOperations& elem_ops,
+                                MAST::EigenproblemAssembly&   assembly) {
+    
+    MAST::PerformanceScope perf("ModalBasisManager::update");
+    
+    // the basis is not valid for a system with a different number of dofs
+    if (_basis.size() && _basis[0]->size() != _system.solution->size())
+        this->clear();
+    
+    if (_if_warm_start && _basis.size())
+        _system.set_eigenproblem_initial_space(_basis);
+    
+    _system.eigenproblem_solve(elem_ops, assembly);
+    _system.clear_eigenproblem_initial_space();
+    
+    const unsigned int
+    nconv = std::min(_system.get_n_converged_eigenvalues(),
+                     _system.get_n_requested_eigenvalues());
+    
+    libmesh_assert_greater(nconv, 0);
+    
+    std::vector<libMesh::NumericVector<Real>*>
+    vecs(nconv, nullptr);
+    
+    _eig_vals.resize(nconv);
+    
+    for (unsigned int i=0; i<nconv; i++) {
+        
+        Real
+        re = 0.,
+        im = 0.;
+        
+        vecs[i] = _system.solution->zero_clone().release();
+        _system.get_eigenpair(i, re, im, *vecs[i]);
+        _eig_vals[i] = re;
+    }
+    
+    // compare the eigenvectors with the current basis using the modal
+    // assurance criterion, MAC = (u^T v)^2 / (u^T u v^T v). The sign of
+    // the eigenvectors is chosen to be consistent with the current basis.
+    _basis_change = 1.;
+    
+    if (_basis.size() == nconv) {
+        
+        _basis_change = 0.;
+        
+        for (unsigned int i=0; i<nconv; i++) {
+            
+            Real
+            uv  = _basis[i]->dot(*vecs[i]),
+            uu  = _basis[i]->dot(*_basis[i]),
+            vv  = vecs[i]->dot(*vecs[i]);
+            
+            if (uv < 0.)
+                vecs[i]->scale(-1.);
+            
+            _basis_change = std::max(_basis_change, 1. - uv*uv/(uu*vv));
+        }
+    }
+    
+    const bool
+    if_replace = _basis.size() != nconv || _basis_change > _tol;
+    
+    if (if_replace) {
+        
+        // the vectors are copied into the existing basis vectors, if
+        // available, so that pointers provided to other objects remain
+        // valid
+        if (_basis.size() == nconv) {
+            
+            for (unsigned int i=0; i<nconv; i++) {
+                
+                *_basis[i] = *vecs[i];
+                delete vecs[i];
+            }
+        }
+        else {
+            
+            for (unsigned int i=0; i<_basis.size(); i++) {
+                
+                delete _basis[i];
+                delete _localized_basis[i];
+            }
+            
+            _basis = vecs;
+            _localized_basis.assign(nconv, nullptr);
+        }
+        
+        this->_localize_basis();
+    }
+    else
+        for (unsigned int i=0; i<nconv; i++)
+            delete vecs[i];
+    
+    libMesh::out
+    << "Modal basis update: n_basis = " << nconv
+    << " , max(1 - MAC) = " << _basis_change
+    << (if_replace?" , basis replaced":" , basis retained") << std::endl;
+    
+    return if_replace;
+}
+
+
+
+void
+MAST::ModalBasisManager::
+attach_localized_basis(MAST::StructuralFluidInteractionAssembly& assembly) const {
+    
+    assembly.attach_localized_basis(_basis, _localized_basis);
+}
+
+
+
+void
+MAST::ModalBasisManager::_localize_basis() {
+    
+    const std::vector<libMesh::dof_id_type>& send_list =
+    _system.get_dof_map().get_send_list();
+    
+    for (unsigned int i=0; i<_basis.size(); i++) {
+        
+        if (!_localized_basis[i]) {
+            
+            _localized_basis[i] =
+            libMesh::NumericVector<Real>::build(_system.comm()).release();
+            _localized_basis[i]->init(_system.n_dofs(),
+                                      _system.n_local_dofs(),
+                                      send_list,
+                                      false,
+                                      libMesh::GHOSTED);
+        }
+        
+        _basis[i]->localize(*_localized_basis[i], send_list);
+    }
+}
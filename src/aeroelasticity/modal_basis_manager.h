@@ -0,0 +1,198 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2018  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__modal_basis_manager_h__
+#define __mast__modal_basis_manager_h__
+
+// C++ includes
+#include <vector>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class NonlinearSystem;
+    class AssemblyElemOperations;
+    class EigenproblemAssembly;
+    class StructuralFluidInteractionAssembly;
+    
+    
+    /*!
+     *   Maintains the structural modal basis used by the reduced order
+     *   flutter analyses over a sequence of design iterations. The
+     *   eigensolution in each update is started from the basis of the
+     *   previous update, which reduces the eigensolver iterations for the
+     *   small design changes of an optimization step. Ghosted copies of
+     *   the basis vectors are kept with the basis and can be attached to
+     *   a MAST::StructuralFluidInteractionAssembly so that the reduced
+     *   order assembly does not localize the basis in each call.
+     *
+     *   The change in the basis is measured by the modal assurance
+     *   criterion (MAC) between the previous and new eigenvectors. If the
+     *   largest value of 1 - MAC is below the specified tolerance, then
+     *   the previous basis is retained. Quantities computed for the basis,
+     *   for example the samples of MAST::GAFDatabaseAssembly, then remain
+     *   valid. update() returns \p true when the basis was replaced.
+     */
+    class ModalBasisManager {
+        
+    public:
+        
+        /*!
+         *   constructor associates the manager with the system used for
+         *   the eigensolution.
+         */
+        ModalBasisManager(MAST::NonlinearSystem& sys);
+        
+        
+        virtual ~ModalBasisManager();
+        
+        
+        /*!
+         *   deletes the basis vectors
+         */
+        void clear();
+        
+        
+        /*!
+         *   if \p f is \p true, which is the default, the eigensolution is
+         *   started from the current basis.
+         */
+        void set_warm_start(bool f) { _if_warm_start = f; }
+        
+        
+        /*!
+         *   sets the tolerance on 1 - MAC below which the current basis is
+         *   retained. The default value of zero replaces the basis in each
+         *   update.
+         */
+        void set_basis_tolerance(Real tol);
+        
+        
+        /*!
+         *   solves the eigenproblem defined by \p elem_ops and \p assembly
+         *   and updates the basis. The number of basis vectors is the number
+         *   of converged eigenpairs, limited to the number of requested
+         *   eigenpairs. This must be called on all processors.
+         *   @returns \p true if the basis was replaced.
+         */
+        bool update(MAST::AssemblyElemOperations& elem_ops,
+                    MAST::EigenproblemAssembly&   assembly);
+        
+        
+        /*!
+         *   @returns the number of basis vectors
+         */
+        unsigned int n_basis() const { return (unsigned int)_basis.size(); }
+        
+        
+        /*!
+         *   @returns the basis vectors
+         */
+        std::vector<libMesh::NumericVector<Real>*>& basis() { return _basis; }
+        
+        
+        /*!
+         *   @returns the ghosted copies of the basis vectors
+         */
+        const std::vector<libMesh::NumericVector<Real>*>&
+        localized_basis() const { return _localized_basis; }
+        
+        
+        /*!
+         *   @returns the eigenvalues from the latest update. These are
+         *   the eigenvalues of the latest eigenproblem even if the previous
+         *   basis was retained.
+         */
+        const std::vector<Real>& eigenvalues() const { return _eig_vals; }
+        
+        
+        /*!
+         *   @returns the largest value of 1 - MAC between the basis vectors
+         *   and the eigenvectors from the latest update. A value of one is
+         *   returned if the number of basis vectors has changed.
+         */
+        Real basis_change() const { return _basis_change; }
+        
+        
+        /*!
+         *   provides the ghosted copies of the basis vectors to
+         *   \p assembly. The vectors are updated in place with the basis.
+         */
+        void
+        attach_localized_basis(MAST::StructuralFluidInteractionAssembly& assembly) const;
+        
+        
+    protected:
+        
+        
+        /*!
+         *   updates the ghosted copies of the basis vectors
+         */
+        void _localize_basis();
+        
+        
+        /*!
+         *   system used for the eigensolution
+         */
+        MAST::NonlinearSystem&                          _system;
+        
+        
+        /*!
+         *   flag to start the eigensolution from the current basis
+         */
+        bool                                            _if_warm_start;
+        
+        
+        /*!
+         *   tolerance on 1 - MAC below which the basis is retained
+         */
+        Real                                            _tol;
+        
+        
+        /*!
+         *   largest value of 1 - MAC from the latest update
+         */
+        Real                                            _basis_change;
+        
+        
+        /*!
+         *   eigenvalues from the latest update
+         */
+        std::vector<Real>                               _eig_vals;
+        
+        
+        /*!
+         *   basis vectors and their ghosted copies
+         */
+        std::vector<libMesh::NumericVector<Real>*>      _basis;
+        std::vector<libMesh::NumericVector<Real>*>      _localized_basis;
+    };
+}
+
+
+#endif // __mast__modal_basis_manager_h__
@@ -78,43 +78,83 @@ MAST::PKFlutterSolution::init (const MAST::PKFlutterSolver& solver,
 
 
 void
-MAST::PKFlutterSolution::sort(const MAST::FlutterSolutionBase& sol)
-{
-    const unsigned int nvals = this->n_roots();
-    libmesh_assert_equal_to(nvals, sol.n_roots());
+MAST::PKFlutterSolution::init_tracked_root(const MAST::PKFlutterSolver& solver,
+                                            const Real k_red,
+                                            const Real v_ref,
+                                            const Real bref,
+                                            const RealMatrixX& kmat,
+                                            const ComplexMatrixX& L,
+                                            const ComplexMatrixX& R,
+                                            const MAST::FlutterSolutionBase& sol,
+                                            const unsigned int root_num,
+                                            const Complex lambda,
+                                            const ComplexVectorX& evec_right,
+                                            const ComplexVectorX& evec_left) {
     
-    // two roots with highest modal_participation dot product are sorted
-    // in the same serial order
-    for (unsigned int i=0; i<nvals-1; i++)
-    {
-        const MAST::FlutterRootBase& r = sol.get_root(i);
-        Real max_val = 0.;
-        Complex val = 0.;
-        unsigned int max_val_root = nvals-1;
-        for (unsigned int j=i; j<nvals; j++) {
+    // make sure that it hasn't already been initialized
+    libmesh_assert(!_roots.size());
+    libmesh_assert_less(root_num, sol.n_roots());
+    
+    _ref_val     = v_ref;
+    _k_red       = k_red;
+    _stiff_mat   = kmat;
+    _Amat        = L;
+    _Bmat        = R;
+    
+    unsigned int
+    nvals        = sol.n_roots();
+    
+    _roots.resize(nvals);
+    
+    for (unsigned int i=0; i<nvals; i++) {
+        
+        MAST::PKFlutterRoot* root = new MAST::PKFlutterRoot;
+        
+        if (i == root_num)
+            root->init(k_red,
+                       v_ref,
+                       bref,
+                       lambda,
+                       1.,
+                       kmat,
+                       evec_right,
+                       evec_left);
+        else {
             
-            val = r.eig_vec_left.dot(_Bmat*_roots[j]->eig_vec_right);
-            //_roots[j]->modal_participation.dot(r.modal_participation);
-            // scale by the eigenvalue separation with the assumption that
-            // the roots will be closer to each other than any other
-            // root at two consecutive eigenvalues. In other words,
-            // we are penalizing the dot product with the eigenvalue
-            // distance
-            val /= abs(r.root-_roots[j]->root);
-            if (abs(val) > max_val) {
-                max_val = abs(val);
-                max_val_root = j;
-            }
+            root->copy_root(sol.get_root(i));
+            root->if_computed = false;
         }
         
-        // now we should have the one with highest dot product
-        std::swap(_roots[i], _roots[max_val_root]);
+        _roots[i] = root;
     }
 }
 
 
 
 
+void
+MAST::PKFlutterSolution::sort(const MAST::FlutterSolutionBase& sol)
+{
+    // two roots with highest dot product of the left eigenvector of the
+    // previous root and the right eigenvector of the current root are sorted
+    // in the same serial order. The products for all pairs of roots are
+    // computed as a single matrix product.
+    ComplexMatrixX
+    vl,
+    vr;
+    sol.eigenvector_matrix(true, vl);
+    this->eigenvector_matrix(false, vr);
+    
+    // the roots store only the displacement components of the eigenvectors
+    const unsigned int
+    n = (unsigned int)vr.rows();
+    
+    this->_sort_with_correlation(sol, vl.adjoint() * (_Bmat.topLeftCorner(n, n) * vr));
+}
+
+
+
+
 
 
 
@@ -164,6 +204,10 @@ MAST::PKFlutterSolution::print(std::ostream &output)
     {
         const MAST::FlutterRootBase& root = this->get_root(i);
         
+        // roots not computed for a tracked-root solution are skipped
+        if (!root.if_computed)
+            continue;
+        
         if (root.if_nonphysical_root)
         {
             std::stringstream oss;
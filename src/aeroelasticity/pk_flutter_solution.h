@@ -56,6 +56,25 @@ namespace MAST {
                            const Real bref,
                            const RealMatrixX& kmat,
                            const MAST::LAPACK_ZGGEV& eig_sol);
+        
+        /*!
+         *   initializes the solution with the root \p root_num computed from
+         *   the eigenvalue \p lambda and eigenvectors \p evec_right and
+         *   \p evec_left of the matrices \p L and \p R. The other roots are
+         *   copied from \p sol.
+         */
+        void init_tracked_root(const MAST::PKFlutterSolver& solver,
+                               const Real k_red,
+                               const Real v_ref,
+                               const Real bref,
+                               const RealMatrixX& kmat,
+                               const ComplexMatrixX& L,
+                               const ComplexMatrixX& R,
+                               const MAST::FlutterSolutionBase& sol,
+                               const unsigned int root_num,
+                               const Complex lambda,
+                               const ComplexVectorX& evec_right,
+                               const ComplexVectorX& evec_left);
 
         /*!
          *    sort this root with respect to the given solution from a previous
@@ -26,6 +26,7 @@
 #include "elasticity/fsi_generalized_aero_force_assembly.h"
 #include "numerics/lapack_zggev_interface.h"
 #include "base/parameter.h"
+#include "base/performance_counters.h"
 
 
 MAST::PKFlutterSolver::PKFlutterSolver():
@@ -141,6 +142,8 @@ MAST::PKFlutterSolver::n_roots_found() const {
 void
 MAST::PKFlutterSolver::scan_for_roots() {
     
+    MAST::PerformanceScope perf("PKFlutterSolver::scan_for_roots");
+    
     // if the initial scanning has not been done, then do it now
     if (!_flutter_solutions.size()) {
         
@@ -156,6 +159,65 @@ MAST::PKFlutterSolver::scan_for_roots() {
         }
         k_red_vals[_n_k_red_divs] = _kr_range.first; // to get around finite-precision arithmetic
         
+        // march from the upper limit to the lower to find the roots
+        Real current_v_ref = _V_range.first,
+        delta_v_ref = (_V_range.second-_V_range.first)/_n_V_divs;
+        
+        std::vector<Real> v_ref_vals(_n_V_divs+1);
+        for (unsigned int i=0; i<_n_V_divs+1; i++) {
+            v_ref_vals[i] = current_v_ref;
+            current_v_ref += delta_v_ref;
+        }
+        v_ref_vals[_n_V_divs] = _V_range.second; // to get around finite-precision arithmetic
+        
+        // with groups of processors, the matrices at the scan points are
+        // computed concurrently by the groups and exchanged between them.
+        // The eigensolutions and sorting of roots then follow in the order
+        // of the serial scan.
+        const unsigned int
+        n  = (unsigned int)_basis_vectors->size();
+        
+        std::vector<Real>
+        data;
+        
+        ComplexMatrixX
+        L,
+        R;
+        
+        RealMatrixX
+        stiff;
+        
+        unsigned int
+        idx = 0;
+        
+        if (_n_scan_groups > 1) {
+            
+            // L and R are the complex 2n x 2n state-space matrices, and
+            // stiff is the real n x n stiffness matrix
+            const unsigned int
+            stride = 2*2*(2*n)*(2*n) + n*n;
+            
+            data.resize((_n_k_red_divs+1)*(_n_V_divs+1)*stride, 0.);
+            
+            for (unsigned int j=0; j<_n_k_red_divs+1; j++)
+                for (unsigned int i=0; i<_n_V_divs+1; i++)
+                    if (this->_if_local_scan_point(j*(_n_V_divs+1)+i)) {
+                        
+                        _initialize_matrices(k_red_vals[j], v_ref_vals[i], L, R, stiff);
+                        idx = (j*(_n_V_divs+1)+i)*stride;
+                        _pack_scan_data(L,     data, idx);
+                        _pack_scan_data(R,     data, idx);
+                        _pack_scan_data(stiff, data, idx);
+                    }
+            
+            this->_exchange_scan_data(data);
+            
+            L.setZero(2*n, 2*n);
+            R.setZero(2*n, 2*n);
+            stiff.setZero(n, n);
+            idx = 0;
+        }
+        
         //
         //  outer loop is on reduced frequency
         //
@@ -163,17 +225,6 @@ MAST::PKFlutterSolver::scan_for_roots() {
             
             current_k_red = k_red_vals[j];
             
-            // march from the upper limit to the lower to find the roots
-            Real current_v_ref = _V_range.first,
-            delta_v_ref = (_V_range.second-_V_range.first)/_n_V_divs;
-            
-            std::vector<Real> v_ref_vals(_n_V_divs+1);
-            for (unsigned int i=0; i<_n_V_divs+1; i++) {
-                v_ref_vals[i] = current_v_ref;
-                current_v_ref += delta_v_ref;
-            }
-            v_ref_vals[_n_V_divs] = _V_range.second; // to get around finite-precision arithmetic
-            
             MAST::FlutterSolutionBase* prev_sol = nullptr;
             
             //
@@ -181,10 +232,22 @@ MAST::PKFlutterSolver::scan_for_roots() {
             //
             for (unsigned int i=0; i<_n_V_divs+1; i++) {
                 current_v_ref = v_ref_vals[i];
-                std::unique_ptr<MAST::FlutterSolutionBase> sol =
-                _analyze(current_k_red,
-                         current_v_ref,
-                         prev_sol);
+                std::unique_ptr<MAST::FlutterSolutionBase> sol;
+                
+                if (_n_scan_groups > 1) {
+                    
+                    _unpack_scan_data(data, idx, L);
+                    _unpack_scan_data(data, idx, R);
+                    _unpack_scan_data(data, idx, stiff);
+                    sol = _eigensolution(current_k_red,
+                                         current_v_ref,
+                                         L, R, stiff,
+                                         prev_sol);
+                }
+                else
+                    sol = _analyze(current_k_red,
+                                   current_v_ref,
+                                   prev_sol);
                 
                 
                 if (_output)
@@ -245,6 +308,9 @@ MAST::PKFlutterSolver::print_sorted_roots()
             const MAST::FlutterRootBase& root =
             sol_it->second->get_root(i);
             
+            if (!root.if_computed)
+                continue;
+            
             *_output
             << std::setw(15) << root.kr
             << std::setw(15) << root.g
@@ -314,6 +380,8 @@ MAST::PKFlutterSolver::_bisection_search(const std::pair<MAST::FlutterSolutionBa
                                         const Real g_tol,
                                         const unsigned int max_iters) {
     
+    MAST::PerformanceScope perf("PKFlutterSolver::_bisection_search");
+    
     // assumes that the upper k_val has +ve g val and lower k_val has -ve
     // k_val
     Real
@@ -330,13 +398,22 @@ MAST::PKFlutterSolver::_bisection_search(const std::pair<MAST::FlutterSolutionBa
     std::unique_ptr<MAST::FlutterSolutionBase> new_sol;
     std::pair<bool, MAST::FlutterSolutionBase*> rval(false, nullptr);
     
+    // solution used as the starting point for the tracked root
+    const MAST::FlutterSolutionBase* track_sol = ref_sol_range.first;
+    
     while (n_iters < max_iters) {
         
         new_v = lower_v + (upper_v-lower_v)/(upper_g-lower_g)*(0.-lower_g); // linear interpolation
         
-        new_sol.reset(_analyze(new_k,
-                               new_v,
-                               ref_sol_range.first).release());
+        if (_if_track_roots)
+            new_sol.reset(_analyze_tracked_root(new_k,
+                                                new_v,
+                                                *track_sol,
+                                                root_num).release());
+        else
+            new_sol.reset(_analyze(new_k,
+                                   new_v,
+                                   ref_sol_range.first).release());
         
         if (_output)
             new_sol->print(*_output);
@@ -350,6 +427,7 @@ MAST::PKFlutterSolver::_bisection_search(const std::pair<MAST::FlutterSolutionBa
         
         libmesh_assert(it != _flutter_solutions.end());
         rval.second = it->second;
+        track_sol   = rval.second;
         const MAST::FlutterRootBase& root = rval.second->get_root(root_num);
         
         // use the estimated flutter velocity to get the next
@@ -412,6 +490,9 @@ std::pair<bool, MAST::FlutterRootBase*>
 MAST::PKFlutterSolver::find_next_root(const Real g_tol,
                                       const unsigned int n_bisection_iters)
 {
+    
+    MAST::PerformanceScope perf("PKFlutterSolver::find_next_root");
+    
     // iterate over the cross-over points and calculate the next that has
     // not been evaluated
     std::multimap<Real, MAST::FlutterRootCrossoverBase*>::iterator
@@ -457,6 +538,9 @@ std::pair<bool,  MAST::FlutterRootBase*>
 MAST::PKFlutterSolver::find_critical_root(const Real g_tol,
                                           const unsigned int n_bisection_iters)
 {
+    
+    MAST::PerformanceScope perf("PKFlutterSolver::find_critical_root");
+    
     // iterate over the cross-over points and calculate the next that has
     // not been evaluated
     std::multimap<Real, MAST::FlutterRootCrossoverBase*>::iterator
@@ -694,7 +778,11 @@ MAST::PKFlutterSolver::_insert_new_solution(const Real k_red,
             dk_old    = fabs(fabs(old_root->kr) - k_ref_old);
             dk_new    = fabs(fabs(new_root->kr) - k_red);
             
-            if (dk_new < dk_old)
+            // roots that were not computed do not replace existing roots
+            if (!new_root->if_computed)
+                continue;
+            
+            if (!old_root->if_computed || dk_new < dk_old)
                 old_root->copy_root(*new_root);
         }
         
@@ -736,6 +824,8 @@ void MAST::PKFlutterSolver::_identify_crossover_points()
         sol_end   = _flutter_solutions.end();
         Real max_g_val = 0., val = 0.;
         for ( ; sol_it!=sol_end; sol_it++) {
+            if (!sol_it->second->get_root(i).if_computed)
+                continue;
             val = fabs(sol_it->second->get_root(i).g);
             if (val > max_g_val)
                 max_g_val = val;
@@ -761,7 +851,8 @@ void MAST::PKFlutterSolver::_identify_crossover_points()
             // for crossover points if a finite damping was seen. Hence,
             // do nothing here, and move to the next iterator
             for (unsigned int i=0; i<nvals; i++) {
-                if (!sol_it->second->get_root(i).if_nonphysical_root &&
+                if (sol_it->second->get_root(i).if_computed &&
+                    !sol_it->second->get_root(i).if_nonphysical_root &&
                     fabs(sol_it->second->get_root(i).g) < tol) {
                     MAST::FlutterRootCrossoverBase* cross =
                     new MAST::PKFlutterRootCrossover;
@@ -787,8 +878,22 @@ void MAST::PKFlutterSolver::_identify_crossover_points()
         if (sol_rit == sol_rend)
             return;
         
+        // solutions in which this root was not computed are skipped, so
+        // that the pairs are formed from the computed roots
+        while (sol_rit != sol_rend && !sol_rit->second->get_root(i).if_computed)
+            sol_rit++;
+        if (sol_rit == sol_rend)
+            continue;
+        
+        sol_ritp1 = sol_rit;
         sol_ritp1++; // increment for the next pair of results
         while (sol_ritp1 != sol_rend) {
+            
+            if (!sol_ritp1->second->get_root(i).if_computed) {
+                sol_ritp1++;
+                continue;
+            }
+            
             // do not use k_red = 0, or if the root is invalid
             if (sol_rit->second->get_root(i).if_nonphysical_root ||
                 sol_ritp1->second->get_root(i).if_nonphysical_root ||
@@ -827,7 +932,7 @@ void MAST::PKFlutterSolver::_identify_crossover_points()
             }
             
             // increment the pointers for next pair of roots
-            sol_rit++;
+            sol_rit = sol_ritp1;
             sol_ritp1++;
         }
     }
@@ -839,6 +944,9 @@ std::unique_ptr<MAST::FlutterSolutionBase>
 MAST::PKFlutterSolver::_analyze(const Real k_red,
                                 const Real v_ref,
                                 const MAST::FlutterSolutionBase* prev_sol) {
+    
+    MAST::PerformanceScope perf("PKFlutterSolver::_analyze");
+    
     // solve the eigenproblem  L x = lambda R x
     ComplexMatrixX R, L;
     RealMatrixX stiff;
@@ -850,23 +958,97 @@ MAST::PKFlutterSolver::_analyze(const Real k_red,
     << "   V_ref = " << std::setw(10) << v_ref << std::endl;
     
     _initialize_matrices(k_red, v_ref, L, R, stiff);
-    LAPACK_ZGGEV ges;
-    ges.compute(L, R);
-    ges.scale_eigenvectors_to_identity_innerproduct();
+    
+    std::unique_ptr<MAST::FlutterSolutionBase>
+    sol = _eigensolution(k_red, v_ref, L, R, stiff, prev_sol);
+    
+    libMesh::out
+    << "Finished PK Solution" << std::endl
+    << " ====================================================" << std::endl;
+    
+    
+    return sol;
+}
+
+
+
+std::unique_ptr<MAST::FlutterSolutionBase>
+MAST::PKFlutterSolver::_analyze_tracked_root(const Real k_red,
+                                             const Real v_ref,
+                                             const MAST::FlutterSolutionBase& ref_sol,
+                                             const unsigned int root_num) {
+    
+    MAST::PerformanceScope perf("PKFlutterSolver::_analyze_tracked_root");
+    
+    ComplexMatrixX R, L;
+    RealMatrixX stiff;
+    
+    _initialize_matrices(k_red, v_ref, L, R, stiff);
+    
+    const MAST::FlutterRootBase&
+    ref_root = ref_sol.get_root(root_num);
+    
+    Complex
+    lambda = ref_root.root;
+    
+    // the roots store only the displacement components of the state-space
+    // eigenvectors. The right eigenvector is completed as {q, lambda q}, and
+    // the left eigenvector with zeros, which is corrected by the first
+    // inverse iteration.
+    const unsigned int
+    n      = (unsigned int)ref_root.eig_vec_right.size();
+    
+    ComplexVectorX
+    x      = ComplexVectorX::Zero(2*n),
+    y      = ComplexVectorX::Zero(2*n);
+    
+    x.topRows(n)    = ref_root.eig_vec_right;
+    x.bottomRows(n) = lambda * ref_root.eig_vec_right;
+    y.topRows(n)    = ref_root.eig_vec_left;
+    
+    if (!_track_root(L, R, lambda, x, y)) {
+        
+        libMesh::out
+        << "Root tracking failed at k_red = " << k_red
+        << ", V_ref = " << v_ref
+        << ", using full eigensolution" << std::endl;
+        
+        return _eigensolution(k_red, v_ref, L, R, stiff, &ref_sol);
+    }
+    
+    MAST::PKFlutterSolution* sol = new MAST::PKFlutterSolution;
+    sol->init_tracked_root(*this,
+                           k_red, v_ref,
+                           (*_bref_param)(),
+                           stiff, L, R,
+                           ref_sol,
+                           root_num,
+                           lambda, x, y);
+    
+    return std::unique_ptr<MAST::FlutterSolutionBase> (sol);
+}
+
+
+
+std::unique_ptr<MAST::FlutterSolutionBase>
+MAST::PKFlutterSolver::_eigensolution(const Real k_red,
+                                      const Real v_ref,
+                                      const ComplexMatrixX& L,
+                                      const ComplexMatrixX& R,
+                                      const RealMatrixX& stiff,
+                                      const MAST::FlutterSolutionBase* prev_sol) {
+    
+    _ges.compute(L, R);
+    _ges.scale_eigenvectors_to_identity_innerproduct();
     
     MAST::PKFlutterSolution* root = new MAST::PKFlutterSolution;
     root->init(*this,
                k_red, v_ref,
                (*_bref_param)(),
-               stiff, ges);
+               stiff, _ges);
     if (prev_sol)
         root->sort(*prev_sol);
     
-    libMesh::out
-    << "Finished PK Solution" << std::endl
-    << " ====================================================" << std::endl;
-    
-    
     return std::unique_ptr<MAST::FlutterSolutionBase> (root);
 }
 
@@ -877,6 +1059,8 @@ void
 MAST::PKFlutterSolver::calculate_sensitivity(MAST::FlutterRootBase& root,
                                              const MAST::FunctionBase& p) {
 
+    MAST::PerformanceScope perf("PKFlutterSolver::calculate_sensitivity");
+    
     /*
     libMesh::out
     << " ====================================================" << std::endl
@@ -972,6 +1156,8 @@ MAST::PKFlutterSolver::_initialize_matrices(const Real k_red,
                                             ComplexMatrixX& B, // mass
                                             RealMatrixX& stiff)// stiffness
 {
+    MAST::PerformanceScope perf("PKFlutterSolver::_initialize_matrices");
+    
     // the PK method equations are
     //
     //   p [ I  0 ] {  X } =  [ 0      I ] {  X }
@@ -1002,7 +1188,10 @@ MAST::PKFlutterSolver::_initialize_matrices(const Real k_red,
     (*_kred_param)      = k_red;
     (*_velocity_param)  = v_ref;
     
-    _assembly->assemble_reduced_order_quantity(*_basis_vectors, qty_map);
+    _register_element_matrix_cache_parameter(*_kred_param);
+    _register_element_matrix_cache_parameter(*_velocity_param);
+    
+    _assemble_reduced_order_structural_quantities(qty_map);
 
     dynamic_cast<MAST::FSIGeneralizedAeroForceAssembly*>(_assembly)->
     assemble_generalized_aerodynamic_force_matrix(*_basis_vectors, a);
@@ -1015,6 +1204,10 @@ MAST::PKFlutterSolver::_initialize_matrices(const Real k_red,
     // here to maintain consistency.
     a  *= -1.;
 
+    A.setZero(2*n, 2*n);
+    B.setZero(2*n, 2*n);
+    stiff = k;
+    
     A.topRightCorner    (n, n)    =  ComplexMatrixX::Identity(n, n);
     A.bottomLeftCorner  (n, n)    = -k.cast<Complex>() + _rho/2.*v_ref*v_ref*a;
     B.topLeftCorner     (n, n)    = ComplexMatrixX::Identity(n, n);
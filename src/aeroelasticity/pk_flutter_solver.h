@@ -26,6 +26,7 @@
 
 // MAST includes
 #include "aeroelasticity/flutter_solver_base.h"
+#include "numerics/lapack_zggev_interface.h"
 
 
 namespace MAST {
@@ -172,6 +173,34 @@ namespace MAST {
                  const MAST::FlutterSolutionBase* prev_sol=nullptr);
         
         
+        /*!
+         *   performs the eigensolution of the matrices \p L and \p R
+         *   initialized at \p k_red and \p v_ref, and sorts the roots based
+         *   on the provided solution pointer. If the pointer is nullptr, then
+         *   no sorting is performed.
+         */
+        std::unique_ptr<MAST::FlutterSolutionBase>
+        _eigensolution(const Real k_red,
+                       const Real v_ref,
+                       const ComplexMatrixX& L,
+                       const ComplexMatrixX& R,
+                       const RealMatrixX& stiff,
+                       const MAST::FlutterSolutionBase* prev_sol=nullptr);
+        
+        
+        /*!
+         *   initializes the matrices at \p k_red and \p v_ref and tracks the
+         *   root \p root_num of \p ref_sol, with the other roots copied from
+         *   \p ref_sol. The full eigensolution is used if the tracking
+         *   does not succeed.
+         */
+        std::unique_ptr<MAST::FlutterSolutionBase>
+        _analyze_tracked_root(const Real k_red,
+                              const Real v_ref,
+                              const MAST::FlutterSolutionBase& ref_sol,
+                              const unsigned int root_num);
+        
+        
         
         /*!
          *    initializes the matrices for the specified k_red. UG does not account
@@ -254,8 +283,12 @@ namespace MAST {
          *   two bounding roots
          */
         std::multimap<Real, MAST::FlutterRootCrossoverBase*> _flutter_crossovers;
-
         
+        
+        /*!
+         *   eigensolver kept across the eigensolutions to reuse its workspace
+         */
+        MAST::LAPACK_ZGGEV                              _ges;
     };
 }
 
@@ -165,40 +165,25 @@ MAST::TimeDomainFlutterSolution::get_critical_root(Real tol) {
 void
 MAST::TimeDomainFlutterSolution::sort(const MAST::FlutterSolutionBase& sol) {
     
-    const unsigned int nvals = this->n_roots();
-    libmesh_assert_equal_to(nvals, sol.n_roots());
+    // two roots with highest dot product of the eigenvectors are sorted
+    // in the same serial order. A combination of the eigenvectors from
+    // both roots is used, and the products for all pairs of roots are
+    // computed as matrix products.
+    ComplexMatrixX
+    vl_sol,
+    vr_sol,
+    vl,
+    vr;
+    sol.eigenvector_matrix(true,  vl_sol);
+    sol.eigenvector_matrix(false, vr_sol);
+    this->eigenvector_matrix(true,  vl);
+    this->eigenvector_matrix(false, vr);
     
-    // two roots with highest modal_participation dot product are sorted
-    // in the same serial order
-    for (unsigned int i=0; i<nvals-1; i++)
-    {
-        const MAST::FlutterRootBase& r = sol.get_root(i);
-        Real max_val = 0.;
-        Complex val = 0.;
-        unsigned int max_val_root = nvals-1;
-        for (unsigned int j=i; j<nvals; j++) {
-            
-            // use a combination of both the eigenvectors from both
-            // roots
-            val = .5*(r.eig_vec_left.dot(_Bmat*_roots[j]->eig_vec_right) +
-                      _roots[j]->eig_vec_left.dot(_Bmat*r.eig_vec_right));
-            //_roots[j]->modal_participation.dot(r.modal_participation);
-            // scale by the eigenvalue separation with the assumption that
-            // the roots will be closer to each other than any other
-            // root at two consecutive eigenvalues. In other words,
-            // we are penalizing the dot product with the eigenvalue
-            // distance
-            val /= abs(r.root-_roots[j]->root);
-            if (abs(val) > max_val) {
-                max_val = abs(val);
-                max_val_root = j;
-            }
-        }
-        
-        // now we should have the one with highest dot product
-        if (i != max_val_root)
-            std::swap(_roots[i], _roots[max_val_root]);
-    }
+    ComplexMatrixX
+    corr = .5 * (vl_sol.adjoint() * (_Bmat * vr) +
+                 (vl.adjoint() * (_Bmat * vr_sol)).transpose());
+    
+    this->_sort_with_correlation(sol, corr);
 }
 
 
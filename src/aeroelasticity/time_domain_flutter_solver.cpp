@@ -17,6 +17,10 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+// C++ includes
+#include <algorithm>
+
+
 // MAST includes
 #include "aeroelasticity/time_domain_flutter_solver.h"
 #include "aeroelasticity/time_domain_flutter_solution.h"
@@ -29,13 +33,22 @@
 #include "numerics/lapack_dggev_interface.h"
 #include "base/parameter.h"
 #include "base/nonlinear_system.h"
+#include "base/performance_counters.h"
 
 
 MAST::TimeDomainFlutterSolver::TimeDomainFlutterSolver():
 MAST::FlutterSolverBase(),
 _velocity_param(nullptr),
 _V_range(),
-_n_V_divs(0.) {
+_n_V_divs(0.),
+_if_velocity_model(false),
+_if_verify_velocity_model(false),
+_velocity_model_order(2),
+_velocity_model_center(0.),
+_velocity_model_half_width(0.),
+_velocity_model_base_sol(nullptr),
+_velocity_model_base_sol_norm(0.),
+_velocity_model_base_sol_sum(0.) {
     
 }
 
@@ -82,6 +95,44 @@ initialize(MAST::Parameter&                             velocity_param,
 
 
 
+void
+MAST::TimeDomainFlutterSolver::
+set_velocity_polynomial_model(bool if_use,
+                              unsigned int order,
+                              bool if_verify) {
+    
+    libmesh_assert_greater(order, 0);
+    
+    _if_velocity_model        = if_use;
+    _if_verify_velocity_model = if_verify;
+    
+    if (order != _velocity_model_order) {
+        
+        _velocity_model_order = order;
+        _velocity_model_c.clear();
+        _velocity_model_k.clear();
+    }
+}
+
+
+
+
+void
+MAST::TimeDomainFlutterSolver::clear_reduced_order_structural_quantities() {
+    
+    MAST::FlutterSolverBase::clear_reduced_order_structural_quantities();
+    
+    _velocity_model_c.clear();
+    _velocity_model_k.clear();
+    _velocity_model_param_vals.clear();
+    _velocity_model_base_sol      = nullptr;
+    _velocity_model_base_sol_norm = 0.;
+    _velocity_model_base_sol_sum  = 0.;
+}
+
+
+
+
 void
 MAST::TimeDomainFlutterSolver::clear_solutions() {
     
@@ -153,6 +204,9 @@ std::pair<bool, MAST::FlutterRootBase*>
 MAST::TimeDomainFlutterSolver::find_next_root(const Real g_tol,
                                               const unsigned int n_bisection_iters)
 {
+    
+    MAST::PerformanceScope perf("TimeDomainFlutterSolver::find_next_root");
+    
     // iterate over the cross-over points and calculate the next that has
     // not been evaluated
     std::multimap<Real, MAST::FlutterRootCrossoverBase*>::iterator
@@ -199,6 +253,9 @@ std::pair<bool,  MAST::FlutterRootBase*>
 MAST::TimeDomainFlutterSolver::find_critical_root(const Real g_tol,
                                                   const unsigned int n_bisection_iters)
 {
+    
+    MAST::PerformanceScope perf("TimeDomainFlutterSolver::find_critical_root");
+    
     // iterate over the cross-over points and calculate the next that has
     // not been evaluated
     std::multimap<Real, MAST::FlutterRootCrossoverBase*>::iterator
@@ -424,6 +481,8 @@ analyze_and_find_critical_root_without_tracking(const Real g_tol,
 void
 MAST::TimeDomainFlutterSolver::scan_for_roots() {
     
+    MAST::PerformanceScope perf("TimeDomainFlutterSolver::scan_for_roots");
+    
     // if the initial scanning has not been done, then do it now
     if (!_flutter_solutions.size()) {
         // march from the upper limit to the lower to find the roots
@@ -571,6 +630,8 @@ _bisection_search(const std::pair<MAST::FlutterSolutionBase*,
                   const Real g_tol,
                   const unsigned int max_iters) {
     
+    MAST::PerformanceScope perf("TimeDomainFlutterSolver::_bisection_search");
+    
     // assumes that the upper k_val has +ve g val and lower k_val has -ve
     // k_val
     Real
@@ -640,6 +701,8 @@ std::unique_ptr<MAST::TimeDomainFlutterSolution>
 MAST::TimeDomainFlutterSolver::_analyze(const Real v_ref,
                                        const MAST::FlutterSolutionBase* prev_sol) {
     
+    MAST::PerformanceScope perf("TimeDomainFlutterSolver::_analyze");
+    
     libMesh::out
     << " ====================================================" << std::endl
     << "Eigensolution" << std::endl
@@ -652,12 +715,11 @@ MAST::TimeDomainFlutterSolver::_analyze(const Real v_ref,
     // initialize the matrices for the structure.
     _initialize_matrices(v_ref, A, B);
     
-    MAST::LAPACK_DGGEV ges;
-    ges.compute(A, B);
-    ges.scale_eigenvectors_to_identity_innerproduct();
+    _ges.compute(A, B);
+    _ges.scale_eigenvectors_to_identity_innerproduct();
     
     MAST::TimeDomainFlutterSolution* root = new MAST::TimeDomainFlutterSolution;
-    root->init(*this, v_ref, ges);
+    root->init(*this, v_ref, _ges);
     if (prev_sol)
         root->sort(*prev_sol);
     
@@ -677,6 +739,8 @@ MAST::TimeDomainFlutterSolver::_initialize_matrices(Real U_inf,
                                                     RealMatrixX &A,
                                                     RealMatrixX &B) {
     
+    MAST::PerformanceScope perf("TimeDomainFlutterSolver::_initialize_matrices");
+    
     // now create the matrices for first-order model
     // original equations are
     //    M x_ddot + C x_dot + K x = q_dyn (A0 x + A1 x_dot)
@@ -698,6 +762,7 @@ MAST::TimeDomainFlutterSolver::_initialize_matrices(Real U_inf,
     
     // set the velocity value in the parameter that was provided
     (*_velocity_param) = U_inf;
+    _register_element_matrix_cache_parameter(*_velocity_param);
     
 
     // if the steady solver object is provided, then solve for the
@@ -719,15 +784,49 @@ MAST::TimeDomainFlutterSolver::_initialize_matrices(Real U_inf,
 
     
     // now prepare a map of the quantities and ask the assembly object to
-    // calculate the quantities of interest.
+    // calculate the quantities of interest. The damping and stiffness
+    // matrices include the aerodynamic contributions that depend on the
+    // velocity, and are assembled for each velocity. The mass matrix is
+    // reused.
     std::map<MAST::StructuralQuantityType, RealMatrixX*> qty_map;
     qty_map[MAST::MASS]       = &m;
+    
+    _assemble_reduced_order_structural_quantities(qty_map);
+    
+    qty_map.clear();
     qty_map[MAST::DAMPING]    = &c;
     qty_map[MAST::STIFFNESS]  = &k;
     
-    
-    _assembly->assemble_reduced_order_quantity(*_basis_vectors,
-                                               qty_map);
+    // the polynomial model is not applicable if the base solution
+    // changes with velocity
+    if (_if_velocity_model && !_steady_solver) {
+        
+        if (!_if_velocity_polynomial_model_valid())
+            _build_velocity_polynomial_model();
+        
+        _evaluate_velocity_polynomial_model(U_inf, c, k);
+        
+        if (_if_verify_velocity_model) {
+            
+            RealMatrixX
+            c_model = c,
+            k_model = k;
+            
+            (*_velocity_param) = U_inf;
+            _assembly->assemble_reduced_order_quantity(*_basis_vectors,
+                                                       qty_map);
+            
+            libMesh::out
+            << "Velocity model relative error: "
+            << " damping = " << std::setw(12)
+            << (c_model - c).norm()/std::max(c.norm(), 1.e-30)
+            << " stiffness = " << std::setw(12)
+            << (k_model - k).norm()/std::max(k.norm(), 1.e-30) << std::endl;
+        }
+    }
+    else
+        _assembly->assemble_reduced_order_quantity(*_basis_vectors,
+                                                   qty_map);
     
     
     // put the matrices back in the system matrices
@@ -749,13 +848,162 @@ MAST::TimeDomainFlutterSolver::_initialize_matrices(Real U_inf,
 
 
 
+void
+MAST::TimeDomainFlutterSolver::_build_velocity_polynomial_model() {
+    
+    MAST::PerformanceScope perf("TimeDomainFlutterSolver::_build_velocity_polynomial_model");
+    
+    libmesh_assert(_velocity_param);
+    libmesh_assert_less(_V_range.first, _V_range.second);
+    
+    const unsigned int
+    n       = (unsigned int)_basis_vectors->size(),
+    n_pts   = _velocity_model_order + 1;
+    
+    _velocity_model_center     = .5 * (_V_range.second + _V_range.first);
+    _velocity_model_half_width = .5 * (_V_range.second - _V_range.first);
+    
+    // the matrices are sampled at the Chebyshev-Lobatto points of the
+    // velocity range, and the coefficients of the polynomial in the
+    // normalized velocity are obtained from the Vandermonde matrix
+    RealMatrixX
+    vand = RealMatrixX::Zero(n_pts, n_pts),
+    c    = RealMatrixX::Zero(n, n),
+    k    = RealMatrixX::Zero(n, n);
+    
+    std::vector<RealMatrixX>
+    c_pts(n_pts),
+    k_pts(n_pts);
+    
+    std::map<MAST::StructuralQuantityType, RealMatrixX*> qty_map;
+    qty_map[MAST::DAMPING]    = &c;
+    qty_map[MAST::STIFFNESS]  = &k;
+    
+    const Real
+    V0   = (*_velocity_param)();
+    
+    _register_element_matrix_cache_parameter(*_velocity_param);
+    
+    for (unsigned int i=0; i<n_pts; i++) {
+        
+        Real
+        x    = cos(libMesh::pi*i/_velocity_model_order);
+        
+        for (unsigned int j=0; j<n_pts; j++)
+            vand(i,j) = pow(x, j);
+        
+        (*_velocity_param) = _velocity_model_center + _velocity_model_half_width * x;
+        
+        _assembly->assemble_reduced_order_quantity(*_basis_vectors,
+                                                   qty_map);
+        
+        c_pts[i] = c;
+        k_pts[i] = k;
+    }
+    
+    (*_velocity_param) = V0;
+    
+    const RealMatrixX
+    vand_inv = vand.inverse();
+    
+    _velocity_model_c.assign(n_pts, RealMatrixX::Zero(n, n));
+    _velocity_model_k.assign(n_pts, RealMatrixX::Zero(n, n));
+    
+    for (unsigned int i=0; i<n_pts; i++)
+        for (unsigned int j=0; j<n_pts; j++) {
+            
+            _velocity_model_c[i] += vand_inv(i,j) * c_pts[j];
+            _velocity_model_k[i] += vand_inv(i,j) * k_pts[j];
+        }
+    
+    // record the data used for the model
+    _velocity_model_param_vals.resize(_structural_params.size());
+    for (unsigned int i=0; i<_structural_params.size(); i++)
+        _velocity_model_param_vals[i] = (*_structural_params[i])();
+    
+    _velocity_model_base_sol      = nullptr;
+    _velocity_model_base_sol_norm = 0.;
+    _velocity_model_base_sol_sum  = 0.;
+    
+    if (_assembly->if_linearized_about_nonzero_solution()) {
+        
+        _velocity_model_base_sol      = &_assembly->base_sol();
+        _velocity_model_base_sol_norm = _velocity_model_base_sol->l2_norm();
+        _velocity_model_base_sol_sum  = _velocity_model_base_sol->sum();
+    }
+}
+
+
+
+
+bool
+MAST::TimeDomainFlutterSolver::_if_velocity_polynomial_model_valid() const {
+    
+    if (_velocity_model_c.empty())
+        return false;
+    
+    if (_velocity_model_param_vals.size() != _structural_params.size())
+        return false;
+    
+    for (unsigned int i=0; i<_structural_params.size(); i++)
+        if ((*_structural_params[i])() != _velocity_model_param_vals[i])
+            return false;
+    
+    const libMesh::NumericVector<Real>*
+    base_sol = nullptr;
+    
+    Real
+    norm     = 0.,
+    sum      = 0.;
+    
+    if (_assembly->if_linearized_about_nonzero_solution()) {
+        
+        base_sol = &_assembly->base_sol();
+        norm     = base_sol->l2_norm();
+        sum      = base_sol->sum();
+    }
+    
+    return (base_sol == _velocity_model_base_sol      &&
+            norm     == _velocity_model_base_sol_norm &&
+            sum      == _velocity_model_base_sol_sum);
+}
+
+
+
+
 void
 MAST::TimeDomainFlutterSolver::
-_initialize_matrix_sensitivity_for_param(const MAST::FunctionBase& f,
-                                         const libMesh::NumericVector<Real>& dXdp,
-                                         Real U_inf,
-                                         RealMatrixX& A,
-                                         RealMatrixX& B) {
+_evaluate_velocity_polynomial_model(Real U_inf,
+                                    RealMatrixX& c,
+                                    RealMatrixX& k) const {
+    
+    libmesh_assert(!_velocity_model_c.empty());
+    
+    const Real
+    x = (U_inf - _velocity_model_center)/_velocity_model_half_width;
+    
+    // Horner evaluation of the polynomials
+    c = _velocity_model_c.back();
+    k = _velocity_model_k.back();
+    
+    for (int i=(int)_velocity_model_c.size()-2; i>=0; i--) {
+        
+        c = x * c + _velocity_model_c[i];
+        k = x * k + _velocity_model_k[i];
+    }
+}
+
+
+
+
+void
+MAST::TimeDomainFlutterSolver::
+_initialize_matrix_sensitivity_for_params
+(const std::vector<const MAST::FunctionBase*>& f,
+ const std::vector<const libMesh::NumericVector<Real>*>& dXdp,
+ Real U_inf,
+ std::vector<RealMatrixX>& A,
+ std::vector<RealMatrixX>& B) {
     
     // now create the matrices for first-order model
     // original equations are
@@ -775,17 +1023,22 @@ _initialize_matrix_sensitivity_for_param(const MAST::FunctionBase& f,
     //        [  0  M ].
     //
     
-    const unsigned int n = (unsigned int)_basis_vectors->size();
+    libmesh_assert_equal_to(f.size(), dXdp.size());
     
-    RealMatrixX
-    m      =  RealMatrixX::Zero(n, n),
-    c      =  RealMatrixX::Zero(n, n),
-    k      =  RealMatrixX::Zero(n, n);
+    const unsigned int
+    n        = (unsigned int)_basis_vectors->size(),
+    n_params = (unsigned int)f.size();
+    
+    std::vector<RealMatrixX>
+    m,
+    c,
+    k;
     
     
     // now prepare a map of the quantities and ask the assembly object to
-    // calculate the quantities of interest.
-    std::map<MAST::StructuralQuantityType, RealMatrixX*> qty_map;
+    // calculate the quantities of interest for all parameters in a single
+    // pass over the elements.
+    std::map<MAST::StructuralQuantityType, std::vector<RealMatrixX>*> qty_map;
     qty_map[MAST::MASS]       = &m;
     qty_map[MAST::DAMPING]    = &c;
     qty_map[MAST::STIFFNESS]  = &k;
@@ -794,24 +1047,28 @@ _initialize_matrix_sensitivity_for_param(const MAST::FunctionBase& f,
     // set the velocity value in the parameter that was provided
     (*_velocity_param) = U_inf;
     
-    _assembly->set_base_solution(dXdp, true);
     _assembly->assemble_reduced_order_quantity_sensitivity
-    (f, *_basis_vectors, qty_map);
-    _assembly->clear_base_solution(true);
+    (f, dXdp, *_basis_vectors, qty_map);
     
     
     // put the matrices back in the system matrices
-    A.setZero(2*n, 2*n);
-    B.setZero(2*n, 2*n);
-    
+    A.resize(n_params);
+    B.resize(n_params);
     
-    B.topLeftCorner(n, n)      = RealMatrixX::Identity(n,n );
-    B.bottomRightCorner(n, n)  = m;
-    
-    
-    A.topRightCorner(n, n)     = RealMatrixX::Identity(n, n);
-    A.bottomLeftCorner(n, n)   = -k;
-    A.bottomRightCorner(n, n)  = -c;
+    for (unsigned int i=0; i<n_params; i++) {
+        
+        A[i].setZero(2*n, 2*n);
+        B[i].setZero(2*n, 2*n);
+        
+        
+        B[i].topLeftCorner(n, n)      = RealMatrixX::Identity(n,n );
+        B[i].bottomRightCorner(n, n)  = m[i];
+        
+        
+        A[i].topRightCorner(n, n)     = RealMatrixX::Identity(n, n);
+        A[i].bottomLeftCorner(n, n)   = -k[i];
+        A[i].bottomRightCorner(n, n)  = -c[i];
+    }
 }
 
 
@@ -994,12 +1251,42 @@ calculate_sensitivity(MAST::FlutterRootBase& root,
                       libMesh::NumericVector<Real>* dXdp,
                       libMesh::NumericVector<Real>* dXdV) {
     
+    std::vector<const MAST::FunctionBase*>
+    f_vec(1, &f);
+    
+    std::vector<libMesh::NumericVector<Real>*>
+    dXdp_vec(1, dXdp);
+    
+    RealVectorX
+    V_sens;
+    
+    this->calculate_sensitivity(root, f_vec, V_sens, dXdp_vec, dXdV);
+}
+
+
+
+
+void
+MAST::TimeDomainFlutterSolver::
+calculate_sensitivity(MAST::FlutterRootBase& root,
+                      const std::vector<const MAST::FunctionBase*>& f,
+                      RealVectorX& V_sens,
+                      const std::vector<libMesh::NumericVector<Real>*>& dXdp,
+                      libMesh::NumericVector<Real>* dXdV) {
+    
+    MAST::PerformanceScope perf("TimeDomainFlutterSolver::calculate_sensitivity");
     
+    libmesh_assert(f.size());
+    libmesh_assert(dXdp.empty() || dXdp.size() == f.size());
+    
+    const unsigned int
+    n_params = (unsigned int)f.size();
     
     libMesh::out
     << " ====================================================" << std::endl
     << "Flutter Sensitivity Solution" << std::endl
-    << "   V_ref = " << std::setw(10) << root.V << std::endl;
+    << "   V_ref = " << std::setw(10) << root.V << std::endl
+    << "   n_params = " << std::setw(10) << n_params << std::endl;
     
     Complex
     eig              = root.root,
@@ -1010,32 +1297,48 @@ calculate_sensitivity(MAST::FlutterRootBase& root,
     // get the sensitivity of the matrices
     RealMatrixX
     mat_A,
-    mat_B,
+    mat_B;
+    
+    std::vector<RealMatrixX>
     mat_A_sens,
     mat_B_sens;
     
-    ComplexVectorX v;
-    
     // initialize the baseline matrices
     _initialize_matrices(root.V, mat_A, mat_B);
     
-    // if the sensitivity of the solution was provided, then use that.
-    // otherwise pass a zero vector
-    libMesh::NumericVector<Real>* sol_sens = dXdp;
+    // the sensitivity wrt velocity is assembled along with the parameters,
+    // as the last entry in the list of functions. If the sensitivity of
+    // the solution was provided, then use that. Otherwise pass a zero
+    // vector, which is shared by all entries without a solution
+    // sensitivity.
+    std::vector<const MAST::FunctionBase*>
+    f_all(f);
+    f_all.push_back(_velocity_param);
+    
+    std::vector<const libMesh::NumericVector<Real>*>
+    sol_sens(n_params+1, nullptr);
     std::unique_ptr<libMesh::NumericVector<Real> > zero_sol_sens;
-    if (!dXdp) {
-        zero_sol_sens.reset(_assembly->system().solution->zero_clone().release());
-        sol_sens = zero_sol_sens.get();
+    
+    for (unsigned int i=0; i<=n_params; i++) {
+        
+        if (i < n_params && dXdp.size() && dXdp[i])
+            sol_sens[i] = dXdp[i];
+        else if (i == n_params && dXdV)
+            sol_sens[i] = dXdV;
+        else {
+            
+            if (!zero_sol_sens)
+                zero_sol_sens.reset(_assembly->system().solution->zero_clone().release());
+            sol_sens[i] = zero_sol_sens.get();
+        }
     }
-    else
-        sol_sens = dXdp;
     
     // calculate the eigenproblem sensitivity
-    _initialize_matrix_sensitivity_for_param(f,
-                                             *sol_sens,
-                                             root.V,
-                                             mat_A_sens,
-                                             mat_B_sens);
+    _initialize_matrix_sensitivity_for_params(f_all,
+                                              sol_sens,
+                                              root.V,
+                                              mat_A_sens,
+                                              mat_B_sens);
     
     
     // the eigenproblem is     y^T A x - lambda y^T B x = 0
@@ -1045,44 +1348,34 @@ calculate_sensitivity(MAST::FlutterRootBase& root,
     //   -dlambda/dp y^T B x = - y^T (dA/dp - lambda dB/dp)
     // or
     //   dlambda/dp = [y^T (dA/dp - lambda dB/dp)]/(y^T B x)
-    
-    // now calculate the numerator for sensitivity
-    // numerator =  ( dA/dp - lambda dB/dp)
     den     = root.eig_vec_left.dot(mat_B*root.eig_vec_right);
-    deig_dp = root.eig_vec_left.dot((mat_A_sens.cast<Complex>() -
-                                    eig*mat_B_sens.cast<Complex>())*root.eig_vec_right)/den;
-    
-    // next we need the sensitivity of eigenvalue wrt V
-    // identify the sensitivity of solution to be used based on the
-    // function arguments
-    if (!dXdV) {
-        sol_sens = zero_sol_sens.get();
-    }
-    else
-        sol_sens = dXdV;
-    
-    _initialize_matrix_sensitivity_for_param(*_velocity_param,
-                                             *sol_sens,
-                                             root.V,
-                                             mat_A_sens,
-                                             mat_B_sens);
-
     
     // now calculate the quotient for sensitivity wrt V
     // calculate numerator
-    deig_dV = root.eig_vec_left.dot((mat_A_sens.cast<Complex>() -
-                                     eig*mat_B_sens.cast<Complex>())*root.eig_vec_right)/den;
-    
-    // since the constraint that defines flutter speed is that damping = 0,
-    // Re(lambda) = 0, then the sensitivity of flutter speed is obtained
-    // from the total derivative of this constraint
-    //     d Re(lambda)/dp + d Re(lambda)/dV dV/dp = 0
-    // or, dV/dp = -[d Re(lambda)/dp] / [d Re(lambda)/dV]
-    // finally, the flutter speed sensitivity
-    root.V_sens     = - deig_dp.real() / deig_dV.real();
-    
-    // total sensitivity of the eigenvlaue
-    root.root_sens  = deig_dp + deig_dV * root.V_sens;
+    deig_dV = root.eig_vec_left.dot((mat_A_sens[n_params].cast<Complex>() -
+                                     eig*mat_B_sens[n_params].cast<Complex>())*root.eig_vec_right)/den;
+    
+    V_sens.setZero(n_params);
+    
+    for (unsigned int i=0; i<n_params; i++) {
+        
+        // now calculate the numerator for sensitivity
+        // numerator =  ( dA/dp - lambda dB/dp)
+        deig_dp = root.eig_vec_left.dot((mat_A_sens[i].cast<Complex>() -
+                                         eig*mat_B_sens[i].cast<Complex>())*root.eig_vec_right)/den;
+        
+        // since the constraint that defines flutter speed is that damping = 0,
+        // Re(lambda) = 0, then the sensitivity of flutter speed is obtained
+        // from the total derivative of this constraint
+        //     d Re(lambda)/dp + d Re(lambda)/dV dV/dp = 0
+        // or, dV/dp = -[d Re(lambda)/dp] / [d Re(lambda)/dV]
+        // finally, the flutter speed sensitivity
+        root.V_sens     = - deig_dp.real() / deig_dV.real();
+        V_sens(i)       = root.V_sens;
+        
+        // total sensitivity of the eigenvlaue
+        root.root_sens  = deig_dp + deig_dV * root.V_sens;
+    }
     
     root.has_sensitivity_data = true;
 
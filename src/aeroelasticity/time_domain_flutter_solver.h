@@ -26,6 +26,7 @@
 
 // MAST includes
 #include "aeroelasticity/flutter_solver_base.h"
+#include "numerics/lapack_dggev_interface.h"
 
 
 
@@ -77,6 +78,33 @@ namespace MAST {
                         unsigned int                                n_V_divs,
                         std::vector<libMesh::NumericVector<Real>*>& basis);
 
+        
+        /*!
+         *   For linearized aerodynamics the reduced order damping and
+         *   stiffness matrices are polynomials in the flight velocity. If
+         *   \p if_use is \p true, the coefficient matrices of a polynomial
+         *   of degree \p order are obtained from assemblies at
+         *   \p order + 1 velocities in the velocity range, and the
+         *   subsequent eigensolutions evaluate the polynomial without a
+         *   traversal of the mesh. The coefficients are recomputed when
+         *   the stored structural quantities are invalidated. The model is
+         *   not used if a steady solver is attached, since the base
+         *   solution then changes with velocity. If \p if_verify is
+         *   \p true, the matrices are also assembled at each velocity,
+         *   the relative error of the model is written to
+         *   \p libMesh::out and the assembled matrices are used.
+         */
+        void set_velocity_polynomial_model(bool if_use,
+                                           unsigned int order = 2,
+                                           bool if_verify = false);
+        
+        
+        /*!
+         *   removes the stored reduced order structural quantities and the
+         *   coefficients of the velocity polynomial model
+         */
+        virtual void clear_reduced_order_structural_quantities();
+        
 
         
         /*!
@@ -145,6 +173,25 @@ namespace MAST {
                               libMesh::NumericVector<Real>* dXdV = nullptr);
         
         
+        /*!
+         *   Calculate the sensitivity of the flutter root with respect to
+         *   each parameter in \par f and return the flutter speed
+         *   sensitivities in \par V_sens. The reduced order matrix
+         *   sensitivities for all parameters and for the velocity are
+         *   assembled in a single pass over the elements. If provided,
+         *   \par dXdp must have one entry per parameter, and \par nullptr
+         *   entries are treated as zero. The sensitivity data stored in
+         *   \par root corresponds to the last parameter in \par f.
+         */
+        virtual void
+        calculate_sensitivity(MAST::FlutterRootBase& root,
+                              const std::vector<const MAST::FunctionBase*>& f,
+                              RealVectorX& V_sens,
+                              const std::vector<libMesh::NumericVector<Real>*>& dXdp =
+                              std::vector<libMesh::NumericVector<Real>*>(),
+                              libMesh::NumericVector<Real>* dXdV = nullptr);
+        
+        
         /*!
          *   Prints the sorted roots to the \par output
          */
@@ -201,17 +248,49 @@ namespace MAST {
 
         
         /*!
-         *    Assembles the reduced order system structural and aerodynmaic
-         *    matrices for specified flight velocity \par U_inf.
+         *    Assembles the sensitivity of the reduced order system
+         *    structural and aerodynmaic matrices for specified flight
+         *    velocity \par U_inf with respect to each parameter in \par f.
+         *    \par dXdp provides the base solution sensitivity for each
+         *    parameter. \par A and \par B are resized to the number of
+         *    parameters.
          */
         void
-        _initialize_matrix_sensitivity_for_param(const MAST::FunctionBase& f,
-                                                 const libMesh::NumericVector<Real>& dXdp,
-                                                 Real U_inf,
-                                                 RealMatrixX& A,
-                                                 RealMatrixX& B);
+        _initialize_matrix_sensitivity_for_params
+        (const std::vector<const MAST::FunctionBase*>& f,
+         const std::vector<const libMesh::NumericVector<Real>*>& dXdp,
+         Real U_inf,
+         std::vector<RealMatrixX>& A,
+         std::vector<RealMatrixX>& B);
 
         
+        /*!
+         *    assembles the reduced order damping and stiffness matrices at
+         *    the sample velocities and computes the coefficient matrices
+         *    of the velocity polynomial model. This must be called on all
+         *    processors.
+         */
+        void _build_velocity_polynomial_model();
+        
+        
+        /*!
+         *    @returns \p true if the coefficients of the velocity polynomial
+         *    model were computed for the current values of the structural
+         *    parameters and base solution.
+         */
+        bool _if_velocity_polynomial_model_valid() const;
+        
+        
+        /*!
+         *    evaluates the reduced order damping matrix \p c and stiffness
+         *    matrix \p k at velocity \p U_inf from the velocity polynomial
+         *    model.
+         */
+        void _evaluate_velocity_polynomial_model(Real U_inf,
+                                                 RealMatrixX& c,
+                                                 RealMatrixX& k) const;
+        
+        
         /*!
          *   identifies all cross-over and divergence points from analyzed
          *   roots
@@ -248,7 +327,48 @@ namespace MAST {
          *   two bounding roots
          */
         std::multimap<Real, MAST::FlutterRootCrossoverBase*> _flutter_crossovers;
-
+        
+        
+        /*!
+         *   eigensolver kept across the eigensolutions to reuse its workspace
+         */
+        MAST::LAPACK_DGGEV                              _ges;
+        
+        
+        /*!
+         *   flags to use and to verify the velocity polynomial model, and
+         *   the degree of the polynomial
+         */
+        bool                                            _if_velocity_model;
+        bool                                            _if_verify_velocity_model;
+        unsigned int                                    _velocity_model_order;
+        
+        
+        /*!
+         *   center and half-width of the velocity interval over which the
+         *   polynomial model was sampled. The polynomial is defined in
+         *   terms of the normalized velocity (V - center)/half-width.
+         */
+        Real                                            _velocity_model_center;
+        Real                                            _velocity_model_half_width;
+        
+        
+        /*!
+         *   coefficient matrices of the damping and stiffness polynomials,
+         *   in order of increasing degree
+         */
+        std::vector<RealMatrixX>                        _velocity_model_c;
+        std::vector<RealMatrixX>                        _velocity_model_k;
+        
+        
+        /*!
+         *   values of the structural parameters, and the base solution along
+         *   with its norm and sum, used for the polynomial model
+         */
+        std::vector<Real>                               _velocity_model_param_vals;
+        const libMesh::NumericVector<Real>*             _velocity_model_base_sol;
+        Real                                            _velocity_model_base_sol_norm;
+        Real                                            _velocity_model_base_sol_sum;
     };
 }
 
@@ -57,6 +57,24 @@ namespace MAST {
                    const MAST::LAPACK_ZGGEV_Base& eig_sol);
         
         
+        /*!
+         *   initializes the solution with the root \p root_num computed from
+         *   the eigenvalue \p lambda and eigenvectors \p evec_right and
+         *   \p evec_left of the matrices \p A and \p B. The other roots are
+         *   copied from \p sol.
+         */
+        void init_tracked_root(const MAST::UGFlutterSolver& solver,
+                               const Real kr_ref,
+                               const Real b_ref,
+                               const ComplexMatrixX& A,
+                               const ComplexMatrixX& B,
+                               const MAST::FlutterSolutionBase& sol,
+                               const unsigned int root_num,
+                               const Complex lambda,
+                               const ComplexVectorX& evec_right,
+                               const ComplexVectorX& evec_left);
+        
+        
         /*!
          *    sort this root with respect to the given solution from a previous
          *    eigen solution. This method relies on the modal participation.
@@ -30,6 +30,7 @@
 #include "numerics/lapack_zggev_interface.h"
 #include "base/parameter.h"
 #include "base/nonlinear_system.h"
+#include "base/performance_counters.h"
 
 
 MAST::UGFlutterSolver::UGFlutterSolver():
@@ -163,6 +164,9 @@ std::pair<bool, MAST::FlutterRootBase*>
 MAST::UGFlutterSolver::find_next_root(const Real g_tol,
                                               const unsigned int n_bisection_iters)
 {
+    
+    MAST::PerformanceScope perf("UGFlutterSolver::find_next_root");
+    
     // iterate over the cross-over points and calculate the next that has
     // not been evaluated
     std::multimap<Real, MAST::FlutterRootCrossoverBase*>::iterator
@@ -208,6 +212,9 @@ std::pair<bool,  MAST::FlutterRootBase*>
 MAST::UGFlutterSolver::find_critical_root(const Real g_tol,
                                                   const unsigned int n_bisection_iters)
 {
+    
+    MAST::PerformanceScope perf("UGFlutterSolver::find_critical_root");
+    
     // iterate over the cross-over points and calculate the next that has
     // not been evaluated
     std::multimap<Real, MAST::FlutterRootCrossoverBase*>::iterator
@@ -261,6 +268,8 @@ MAST::UGFlutterSolver::find_critical_root(const Real g_tol,
 void
 MAST::UGFlutterSolver::scan_for_roots() {
     
+    MAST::PerformanceScope perf("UGFlutterSolver::scan_for_roots");
+    
     // if the initial scanning has not been done, then do it now
     if (!_flutter_solutions.size()) {
         // march from the upper limit to the lower to find the roots
@@ -275,12 +284,57 @@ MAST::UGFlutterSolver::scan_for_roots() {
         }
         k_vals[_n_kr_divs] = _kr_range.first; // to get around finite-precision arithmetic
         
+        // with groups of processors, the matrices at the scan points are
+        // computed concurrently by the groups and exchanged between them.
+        // The eigensolutions and sorting of roots then follow in the order
+        // of the serial scan.
+        const unsigned int
+        n  = (unsigned int)_basis_vectors->size();
+        
+        std::vector<Real>
+        data;
+        
+        ComplexMatrixX
+        A,
+        B;
+        
+        unsigned int
+        idx = 0;
+        
+        if (_n_scan_groups > 1) {
+            
+            data.resize((_n_kr_divs+1)*4*n*n, 0.);
+            
+            for (unsigned int i=0; i< _n_kr_divs+1; i++)
+                if (this->_if_local_scan_point(i)) {
+                    
+                    _initialize_matrices(k_vals[i], A, B);
+                    idx = i*4*n*n;
+                    _pack_scan_data(A, data, idx);
+                    _pack_scan_data(B, data, idx);
+                }
+            
+            this->_exchange_scan_data(data);
+            
+            A.setZero(n, n);
+            B.setZero(n, n);
+            idx = 0;
+        }
+        
         MAST::FlutterSolutionBase* prev_sol = nullptr;
         for (unsigned int i=0; i< _n_kr_divs+1; i++) {
             
             current_kr = k_vals[i];
-            std::unique_ptr<MAST::FlutterSolutionBase> sol =
-            _analyze(current_kr, prev_sol);
+            std::unique_ptr<MAST::FlutterSolutionBase> sol;
+            
+            if (_n_scan_groups > 1) {
+                
+                _unpack_scan_data(data, idx, A);
+                _unpack_scan_data(data, idx, B);
+                sol = _eigensolution(current_kr, A, B, prev_sol);
+            }
+            else
+                sol = _analyze(current_kr, prev_sol);
             
             prev_sol = sol.get();
             
@@ -339,6 +393,9 @@ MAST::UGFlutterSolver::print_sorted_roots()
             const MAST::FlutterRootBase& root =
             sol_it->second->get_root(i);
             
+            if (!root.if_computed)
+                continue;
+            
             *_output
             << std::setw(15) << root.kr
             << std::setw(15) << root.g
@@ -410,6 +467,8 @@ _bisection_search(const std::pair<MAST::FlutterSolutionBase*,
                   const Real g_tol,
                   const unsigned int max_iters) {
     
+    MAST::PerformanceScope perf("UGFlutterSolver::_bisection_search");
+    
     // assumes that the upper k_val has +ve g val and lower k_val has -ve
     // k_val
     Real
@@ -423,6 +482,9 @@ _bisection_search(const std::pair<MAST::FlutterSolutionBase*,
     MAST::FlutterSolutionBase* new_sol = nullptr;
     std::pair<bool, MAST::FlutterSolutionBase*> rval(false, nullptr);
     
+    // solution used as the starting point for the tracked root
+    const MAST::FlutterSolutionBase* track_sol = ref_sol_range.first;
+    
     while (n_iters < max_iters) {
         
         libMesh::out
@@ -434,7 +496,13 @@ _bisection_search(const std::pair<MAST::FlutterSolutionBase*,
         new_kr    = lower_kr +
         (upper_kr-lower_kr)/(upper_g-lower_g)*(0.-lower_g); // linear interpolation
         
-        new_sol  = _analyze(new_kr, ref_sol_range.first).release();
+        if (_if_track_roots) {
+            
+            new_sol   = _analyze_tracked_root(new_kr, *track_sol, root_num).release();
+            track_sol = new_sol;
+        }
+        else
+            new_sol  = _analyze(new_kr, ref_sol_range.first).release();
         
         if (_output)
             new_sol->print(*_output);
@@ -486,6 +554,8 @@ std::unique_ptr<MAST::FlutterSolutionBase>
 MAST::UGFlutterSolver::_analyze(const Real kr_ref,
                                 const MAST::FlutterSolutionBase* prev_sol) {
     
+    MAST::PerformanceScope perf("UGFlutterSolver::_analyze");
+    
     libMesh::out
     << " ====================================================" << std::endl
     << "Eigensolution" << std::endl
@@ -498,31 +568,95 @@ MAST::UGFlutterSolver::_analyze(const Real kr_ref,
     // initialize the matrices for the structure.
     _initialize_matrices(kr_ref, A, B);
     
-    MAST::LAPACK_ZGGEV ges;
-    ges.compute(A, B);
-    ges.scale_eigenvectors_to_identity_innerproduct();
-    
-    MAST::UGFlutterSolution* root = new MAST::UGFlutterSolution;
-    root->init(*this, kr_ref, (*_bref_param)(), ges);
-    if (prev_sol)
-        root->sort(*prev_sol);
+    std::unique_ptr<MAST::FlutterSolutionBase>
+    sol = _eigensolution(kr_ref, A, B, prev_sol);
     
     libMesh::out
     << "Finished Eigensolution" << std::endl
     << " ====================================================" << std::endl;
     
     
+    return sol;
+}
+
+
+
+
+std::unique_ptr<MAST::FlutterSolutionBase>
+MAST::UGFlutterSolver::_eigensolution(const Real kr_ref,
+                                      const ComplexMatrixX& A,
+                                      const ComplexMatrixX& B,
+                                      const MAST::FlutterSolutionBase* prev_sol) {
+    
+    _ges.compute(A, B);
+    _ges.scale_eigenvectors_to_identity_innerproduct();
+    
+    MAST::UGFlutterSolution* root = new MAST::UGFlutterSolution;
+    root->init(*this, kr_ref, (*_bref_param)(), _ges);
+    if (prev_sol)
+        root->sort(*prev_sol);
+    
     return std::unique_ptr<MAST::FlutterSolutionBase> (root);
 }
 
 
 
 
+std::unique_ptr<MAST::FlutterSolutionBase>
+MAST::UGFlutterSolver::
+_analyze_tracked_root(const Real kr_ref,
+                      const MAST::FlutterSolutionBase& ref_sol,
+                      const unsigned int root_num) {
+    
+    MAST::PerformanceScope perf("UGFlutterSolver::_analyze_tracked_root");
+    
+    ComplexMatrixX
+    A,
+    B;
+    
+    _initialize_matrices(kr_ref, A, B);
+    
+    const MAST::FlutterRootBase&
+    ref_root = ref_sol.get_root(root_num);
+    
+    Complex
+    lambda = ref_root.root;
+    
+    ComplexVectorX
+    x      = ref_root.eig_vec_right,
+    y      = ref_root.eig_vec_left;
+    
+    if (!_track_root(A, B, lambda, x, y)) {
+        
+        libMesh::out
+        << "Root tracking failed at kr_ref = " << kr_ref
+        << ", using full eigensolution" << std::endl;
+        
+        return _eigensolution(kr_ref, A, B, &ref_sol);
+    }
+    
+    MAST::UGFlutterSolution* sol = new MAST::UGFlutterSolution;
+    sol->init_tracked_root(*this,
+                           kr_ref,
+                           (*_bref_param)(),
+                           A, B,
+                           ref_sol,
+                           root_num,
+                           lambda, x, y);
+    
+    return std::unique_ptr<MAST::FlutterSolutionBase> (sol);
+}
+
+
+
+
 void
 MAST::UGFlutterSolver::_initialize_matrices(Real kr,
                                             ComplexMatrixX &A,
                                             ComplexMatrixX &B) {
     
+    MAST::PerformanceScope perf("UGFlutterSolver::_initialize_matrices");
+    
     // the UG method equations are
     //
     // ((kr/b)^2 M + rho/2 A(kr))q = lambda K q
@@ -548,8 +682,9 @@ MAST::UGFlutterSolver::_initialize_matrices(Real kr,
     
     // set the velocity value in the parameter that was provided
     (*_kr_param) = kr;
+    _register_element_matrix_cache_parameter(*_kr_param);
     
-    _assembly->assemble_reduced_order_quantity(*_basis_vectors, qty_map);
+    _assemble_reduced_order_structural_quantities(qty_map);
     
     dynamic_cast<MAST::FSIGeneralizedAeroForceAssembly*>(_assembly)->
     assemble_generalized_aerodynamic_force_matrix(*_basis_vectors, a);
@@ -575,11 +710,12 @@ MAST::UGFlutterSolver::_initialize_matrices(Real kr,
 
 void
 MAST::UGFlutterSolver::
-_initialize_matrix_sensitivity_for_param(const MAST::FunctionBase& f,
-                                         const libMesh::NumericVector<Real>& dXdp,
-                                         Real kr,
-                                         ComplexMatrixX& A,
-                                         ComplexMatrixX& B) {
+_initialize_matrix_sensitivity_for_params
+(const std::vector<const MAST::FunctionBase*>& f,
+ const std::vector<const libMesh::NumericVector<Real>*>& dXdp,
+ Real kr,
+ std::vector<ComplexMatrixX>& A,
+ std::vector<ComplexMatrixX>& B) {
     
     // the UG method equations are
     //
@@ -588,18 +724,21 @@ _initialize_matrix_sensitivity_for_param(const MAST::FunctionBase& f,
     // matrices, and A(kr) is the generalized aerodynamic force matrix.
     //
     
-    const unsigned int n = (unsigned int)_basis_vectors->size();
+    const unsigned int
+    n        = (unsigned int)_basis_vectors->size(),
+    n_params = (unsigned int)f.size();
+    
+    std::vector<RealMatrixX>
+    m,
+    k;
     
-    RealMatrixX
-    m      =  RealMatrixX::Zero(n, n),
-    k      =  RealMatrixX::Zero(n, n);
-
     ComplexMatrixX
     a      =  ComplexMatrixX::Zero(n, n);
     
     // now prepare a map of the quantities and ask the assembly object to
-    // calculate the quantities of interest.
-    std::map<MAST::StructuralQuantityType, RealMatrixX*> qty_map;
+    // calculate the quantities of interest for all parameters in a single
+    // pass over the elements.
+    std::map<MAST::StructuralQuantityType, std::vector<RealMatrixX>*> qty_map;
     qty_map[MAST::MASS]       = &m;
     qty_map[MAST::STIFFNESS]  = &k;
     
@@ -608,6 +747,7 @@ _initialize_matrix_sensitivity_for_param(const MAST::FunctionBase& f,
     (*_kr_param) = kr;
     
     _assembly->assemble_reduced_order_quantity_sensitivity(f,
+                                                           dXdp,
                                                            *_basis_vectors,
                                                            qty_map);
 
@@ -626,8 +766,14 @@ _initialize_matrix_sensitivity_for_param(const MAST::FunctionBase& f,
     // here to maintain consistency.
     a  *= -1.;
     
-    A    = pow(kr/(*_bref_param)(),2) * m.cast<Complex>() +  (_rho/2.) * a;
-    B    = k.cast<Complex>();
+    A.resize(n_params);
+    B.resize(n_params);
+    
+    for (unsigned int i=0; i<n_params; i++) {
+        
+        A[i] = pow(kr/(*_bref_param)(),2) * m[i].cast<Complex>() +  (_rho/2.) * a;
+        B[i] = k[i].cast<Complex>();
+    }
 }
 
 
@@ -664,9 +810,9 @@ _initialize_matrix_sensitivity_for_kr(Real kr,
     
     // set the velocity value in the parameter that was provided
     (*_kr_param) = kr;
+    _register_element_matrix_cache_parameter(*_kr_param);
     
-    _assembly->assemble_reduced_order_quantity(*_basis_vectors,
-                                               qty_map);
+    _assemble_reduced_order_structural_quantities(qty_map);
     
     dynamic_cast<MAST::FSIGeneralizedAeroForceAssembly*>(_assembly)->
     assemble_generalized_aerodynamic_force_matrix(*_basis_vectors, a, _kr_param);
@@ -717,6 +863,8 @@ MAST::UGFlutterSolver::_identify_crossover_points() {
         sol_end   = _flutter_solutions.end();
         Real max_g_val = 0., val = 0.;
         for ( ; sol_it!=sol_end; sol_it++) {
+            if (!sol_it->second->get_root(i).if_computed)
+                continue;
             val = fabs(sol_it->second->get_root(i).g);
             if (val > max_g_val)
                 max_g_val = val;
@@ -742,7 +890,8 @@ MAST::UGFlutterSolver::_identify_crossover_points() {
             // for crossover points if a finite damping was seen. Hence,
             // do nothing here, and move to the next iterator
             for (unsigned int i=0; i<nvals; i++) {
-                if (!sol_it->second->get_root(i).if_nonphysical_root &&
+                if (sol_it->second->get_root(i).if_computed &&
+                    !sol_it->second->get_root(i).if_nonphysical_root &&
                     fabs(sol_it->second->get_root(i).g) < tol) {
                     MAST::FlutterRootCrossoverBase* cross =
                     new MAST::UGFlutterRootCrossover;
@@ -768,10 +917,24 @@ MAST::UGFlutterSolver::_identify_crossover_points() {
         if (sol_rit == sol_rend)
             return;
         
+        // solutions in which this root was not computed are skipped, so
+        // that the pairs are formed from the computed roots
+        while (sol_rit != sol_rend && !sol_rit->second->get_root(i).if_computed)
+            sol_rit++;
+        if (sol_rit == sol_rend)
+            continue;
+        
+        sol_ritp1 = sol_rit;
         sol_ritp1++; // increment for the next pair of results
         bool if_process = false;
         
         while (sol_ritp1 != sol_rend) {
+            
+            if (!sol_ritp1->second->get_root(i).if_computed) {
+                sol_ritp1++;
+                continue;
+            }
+            
             if_process =
             (// both should be valid roots
              (!sol_rit->second->get_root(i).if_nonphysical_root &&
@@ -816,7 +979,7 @@ MAST::UGFlutterSolver::_identify_crossover_points() {
             }
             
             // increment the pointers for next pair of roots
-            sol_rit++;
+            sol_rit = sol_ritp1;
             sol_ritp1++;
         }
         
@@ -825,9 +988,13 @@ MAST::UGFlutterSolver::_identify_crossover_points() {
         sol_rit    = _flutter_solutions.rbegin();
         sol_ritp1   = _flutter_solutions.rbegin();
         sol_ritp1++;
+        while (sol_ritp1 != sol_rend && !sol_ritp1->second->get_root(i).if_computed)
+            sol_ritp1++;
         
         if_process =
-        (// both should be valid roots
+        (sol_ritp1 != sol_rend &&
+         sol_rit->second->get_root(i).if_computed &&
+         // both should be valid roots
          (!sol_rit->second->get_root(i).if_nonphysical_root &&
           !sol_ritp1->second->get_root(i).if_nonphysical_root) &&
          // atleast one |g| > tol
@@ -873,13 +1040,43 @@ calculate_sensitivity(MAST::FlutterRootBase& root,
                       libMesh::NumericVector<Real>* dXdp,
                       libMesh::NumericVector<Real>* dXdkr) {
     
+    std::vector<const MAST::FunctionBase*>
+    f_vec(1, &f);
+    
+    std::vector<libMesh::NumericVector<Real>*>
+    dXdp_vec(1, dXdp);
     
+    RealVectorX
+    V_sens;
+    
+    this->calculate_sensitivity(root, f_vec, V_sens, dXdp_vec, dXdkr);
+}
+
+
+
+
+void
+MAST::UGFlutterSolver::
+calculate_sensitivity(MAST::FlutterRootBase& root,
+                      const std::vector<const MAST::FunctionBase*>& f,
+                      RealVectorX& V_sens,
+                      const std::vector<libMesh::NumericVector<Real>*>& dXdp,
+                      libMesh::NumericVector<Real>* dXdkr) {
+    
+    MAST::PerformanceScope perf("UGFlutterSolver::calculate_sensitivity");
+    
+    libmesh_assert(f.size());
+    libmesh_assert(dXdp.empty() || dXdp.size() == f.size());
+    
+    const unsigned int
+    n_params = (unsigned int)f.size();
     
     libMesh::out
     << " ====================================================" << std::endl
     << "UG Sensitivity Solution" << std::endl
     << "   k_red = " << std::setw(10) << root.kr << std::endl
-    << "   V_ref = " << std::setw(10) << root.V << std::endl;
+    << "   V_ref = " << std::setw(10) << root.V << std::endl
+    << "   n_params = " << std::setw(10) << n_params << std::endl;
     
     Complex
     eig              = root.root,
@@ -900,28 +1097,38 @@ calculate_sensitivity(MAST::FlutterRootBase& root,
     mat_A_sens,
     mat_B_sens;
     
-    ComplexVectorX v;
+    std::vector<ComplexMatrixX>
+    mat_A_p_sens,
+    mat_B_p_sens;
     
     // initialize the baseline matrices
     _initialize_matrices(root.kr, mat_A, mat_B);
     
     // if the sensitivity of the solution was provided, then use that.
-    // otherwise pass a zero vector
-    libMesh::NumericVector<Real>* sol_sens = dXdp;
+    // otherwise pass a zero vector, which is shared by all parameters
+    // without a solution sensitivity.
+    std::vector<const libMesh::NumericVector<Real>*>
+    sol_sens(n_params, nullptr);
     std::unique_ptr<libMesh::NumericVector<Real> > zero_sol_sens;
-    if (!dXdp) {
-        zero_sol_sens.reset(_assembly->system().solution->zero_clone().release());
-        sol_sens = zero_sol_sens.get();
+    
+    for (unsigned int i=0; i<n_params; i++) {
+        
+        if (dXdp.size() && dXdp[i])
+            sol_sens[i] = dXdp[i];
+        else {
+            
+            if (!zero_sol_sens)
+                zero_sol_sens.reset(_assembly->system().solution->zero_clone().release());
+            sol_sens[i] = zero_sol_sens.get();
+        }
     }
-    else
-        sol_sens = dXdp;
     
-    // calculate the eigenproblem sensitivity
-    _initialize_matrix_sensitivity_for_param(f,
-                                             *sol_sens,
-                                             root.kr,
-                                             mat_A_sens,
-                                             mat_B_sens);
+    // calculate the eigenproblem sensitivity for all parameters
+    _initialize_matrix_sensitivity_for_params(f,
+                                              sol_sens,
+                                              root.kr,
+                                              mat_A_p_sens,
+                                              mat_B_p_sens);
     
     
     // the eigenproblem is     y^T A x - lambda y^T B x = 0
@@ -931,26 +1138,20 @@ calculate_sensitivity(MAST::FlutterRootBase& root,
     //   -dlambda/dp y^T B x = - y^T (dA/dp - lambda dB/dp)
     // or
     //   dlambda/dp = [y^T (dA/dp - lambda dB/dp)]/(y^T B x)
-    
-    // now calculate the numerator for sensitivity
-    // numerator =  ( dA/dp - lambda dB/dp)
+    //
+    // The denominator and the sensitivity wrt kr are independent of the
+    // parameter and are computed once.
     den     = root.eig_vec_left.dot(mat_B*root.eig_vec_right);
-    deig_dp = root.eig_vec_left.dot((mat_A_sens.cast<Complex>() -
-                                     eig*mat_B_sens.cast<Complex>())*root.eig_vec_right)/den;
     
     // next we need the sensitivity of eigenvalue wrt kr
-    // identify the sensitivity of solution to be used based on the
-    // function arguments
-    sol_sens = zero_sol_sens.get();
-    
     _initialize_matrix_sensitivity_for_kr(root.kr,
                                           mat_A_sens,
                                           mat_B_sens);
     
     // now calculate the quotient for sensitivity wrt k_red
     // calculate numerator
-    deig_dkr = root.eig_vec_left.dot((mat_A_sens.cast<Complex>() -
-                                     eig*mat_B_sens.cast<Complex>())*root.eig_vec_right)/den;
+    deig_dkr = root.eig_vec_left.dot((mat_A_sens -
+                                     eig*mat_B_sens)*root.eig_vec_right)/den;
     
     // using this, the following quantities are caluclated
     // since eig = lambda =  (1+ig)/V^2.
@@ -960,25 +1161,36 @@ calculate_sensitivity(MAST::FlutterRootBase& root,
     // Therefore, the sensitivity of g and V are
     // dV/dp =  -1/2 (1/re(eig))^(-3/2) deig_re/dp
     // dg/dp =  deig_im/dp / re(eig) - im(eig)/re(eig)^2 deig_re/dp
-
-    dg_dp  =
-    deig_dp.imag()/eig.real()  - eig.imag()/pow(eig.real(),2) * deig_dp.real();
     dg_dkr =
     deig_dkr.imag()/eig.real() - eig.imag()/pow(eig.real(),2) * deig_dkr.real();
     
-
-    // since the constraint that defines flutter speed is that damping = 0,
-    //      g(p, kr) = 0,
-    // then the total derivative of this constraint is
-    //      dg/dp + dg/dkr dkr/dp = 0
-    // or,  dkr/dp = -dg/dp / dg/dkr
-    dkr_dp       = -dg_dp / dg_dkr;
-    root.kr_sens = dkr_dp;
+    V_sens.setZero(n_params);
+    
+    for (unsigned int i=0; i<n_params; i++) {
+        
+        // now calculate the numerator for sensitivity
+        // numerator =  ( dA/dp - lambda dB/dp)
+        deig_dp = root.eig_vec_left.dot((mat_A_p_sens[i] -
+                                         eig*mat_B_p_sens[i])*root.eig_vec_right)/den;
+        
+        dg_dp  =
+        deig_dp.imag()/eig.real()  - eig.imag()/pow(eig.real(),2) * deig_dp.real();
+        
+        // since the constraint that defines flutter speed is that damping = 0,
+        //      g(p, kr) = 0,
+        // then the total derivative of this constraint is
+        //      dg/dp + dg/dkr dkr/dp = 0
+        // or,  dkr/dp = -dg/dp / dg/dkr
+        dkr_dp       = -dg_dp / dg_dkr;
+        root.kr_sens = dkr_dp;
+        
+        // Using this, the sensitivity of flutter speed if calculated as
+        // dV/dp = dV/dp + dV/dkr dkr/dp
+        root.root_sens            = deig_dp + deig_dkr * dkr_dp;
+        root.V_sens               = -.5*root.root_sens.real()/pow(eig.real(), 1.5);
+        V_sens(i)                 = root.V_sens;
+    }
     
-    // Using this, the sensitivity of flutter speed if calculated as
-    // dV/dp = dV/dp + dV/dkr dkr/dp
-    root.root_sens            = deig_dp + deig_dkr * dkr_dp;
-    root.V_sens               = -.5*root.root_sens.real()/pow(eig.real(), 1.5);
     root.has_sensitivity_data = true;
     
     libMesh::out
@@ -26,6 +26,7 @@
 
 // MAST includes
 #include "aeroelasticity/flutter_solver_base.h"
+#include "numerics/lapack_zggev_interface.h"
 
 
 namespace MAST {
@@ -132,6 +133,26 @@ namespace MAST {
                               libMesh::NumericVector<Real>* dXdkr = nullptr);
         
         
+        /*!
+         *   Calculate the sensitivity of the flutter root with respect to
+         *   each parameter in \par f and return the flutter speed
+         *   sensitivities in \par V_sens. The baseline matrices and their
+         *   sensitivity wrt kr are computed once and the reduced order
+         *   matrix sensitivities for all parameters are assembled in a
+         *   single pass over the elements. If provided, \par dXdp must have
+         *   one entry per parameter, and \par nullptr entries are treated
+         *   as zero. The sensitivity data stored in \par root corresponds
+         *   to the last parameter in \par f.
+         */
+        virtual void
+        calculate_sensitivity(MAST::FlutterRootBase& root,
+                              const std::vector<const MAST::FunctionBase*>& f,
+                              RealVectorX& V_sens,
+                              const std::vector<libMesh::NumericVector<Real>*>& dXdp =
+                              std::vector<libMesh::NumericVector<Real>*>(),
+                              libMesh::NumericVector<Real>* dXdkr = nullptr);
+        
+        
         /*!
          *   Prints the sorted roots to the \par output
          */
@@ -166,6 +187,31 @@ namespace MAST {
                  const MAST::FlutterSolutionBase* prev_sol=nullptr);
         
         
+        /*!
+         *   performs the eigensolution of the matrices \p A and \p B
+         *   initialized at \p kr_ref, and sorts the roots based on the
+         *   provided solution pointer. If the pointer is nullptr, then no
+         *   sorting is performed.
+         */
+        std::unique_ptr<MAST::FlutterSolutionBase>
+        _eigensolution(const Real kr_ref,
+                       const ComplexMatrixX& A,
+                       const ComplexMatrixX& B,
+                       const MAST::FlutterSolutionBase* prev_sol=nullptr);
+        
+        
+        /*!
+         *   initializes the matrices at \p kr_ref and tracks the root
+         *   \p root_num of \p ref_sol, with the other roots copied from
+         *   \p ref_sol. The full eigensolution is used if the tracking
+         *   does not succeed.
+         */
+        std::unique_ptr<MAST::FlutterSolutionBase>
+        _analyze_tracked_root(const Real kr_ref,
+                              const MAST::FlutterSolutionBase& ref_sol,
+                              const unsigned int root_num);
+        
+        
         
         /*!
          *    bisection method search
@@ -188,15 +234,18 @@ namespace MAST {
         
         
         /*!
-         *    Assembles the reduced order system structural and aerodynmaic
-         *    matrices for specified flight velocity \par U_inf.
+         *    Assembles the sensitivity of the reduced order system
+         *    structural and aerodynmaic matrices for specified reduced
+         *    frequency \par kr with respect to each parameter in \par f.
+         *    \par A and \par B are resized to the number of parameters.
          */
         void
-        _initialize_matrix_sensitivity_for_param(const MAST::FunctionBase& f,
-                                                 const libMesh::NumericVector<Real>& dXdp,
-                                                 Real kr,
-                                                 ComplexMatrixX& A,
-                                                 ComplexMatrixX& B);
+        _initialize_matrix_sensitivity_for_params
+        (const std::vector<const MAST::FunctionBase*>& f,
+         const std::vector<const libMesh::NumericVector<Real>*>& dXdp,
+         Real kr,
+         std::vector<ComplexMatrixX>& A,
+         std::vector<ComplexMatrixX>& B);
 
         
         /*!
@@ -264,6 +313,11 @@ namespace MAST {
          */
         std::multimap<Real, MAST::FlutterRootCrossoverBase*> _flutter_crossovers;
         
+        
+        /*!
+         *   eigensolver kept across the eigensolutions to reuse its workspace
+         */
+        MAST::LAPACK_ZGGEV                              _ges;
     };
 }
 
@@ -27,7 +27,13 @@
 #include "base/assembly_elem_operation.h"
 #include "base/output_assembly_elem_operations.h"
 #include "mesh/fe_base.h"
+#include "mesh/fe_object_pool.h"
+#include "mesh/fe_geometry_cache.h"
+#include "base/parameter_support_index.h"
+#include "base/element_matrix_cache.h"
+#include "base/element_scatter.h"
 #include "numerics/utility.h"
+#include "base/performance_counters.h"
 
 
 // libMesh includes
@@ -40,7 +46,13 @@ _elem_ops         (nullptr),
 _discipline       (nullptr),
 _system           (nullptr),
 _sol_function     (nullptr),
-_solver_monitor   (nullptr) {
+_solver_monitor   (nullptr),
+_if_reuse_fe      (true),
+_fe_pool          (new MAST::FEObjectPool),
+_fe_geom_cache    (nullptr),
+_elem_scatter     (new MAST::ElementScatter),
+_elem_mat_cache   (nullptr),
+_param_support    (nullptr) {
     
 }
 
@@ -153,6 +165,11 @@ clear_discipline_and_system() {
     
     _discipline    = nullptr;
     _system        = nullptr;
+    
+    _elem_scatter->clear();
+    
+    if (_elem_mat_cache)
+        _elem_mat_cache->clear();
 }
 
 
@@ -231,16 +248,140 @@ MAST::AssemblyBase::build_fe() {
     std::unique_ptr<MAST::FEBase>
     fe(new MAST::FEBase(*_system));
     
+    if (_if_reuse_fe)
+        fe->set_object_pool(*_fe_pool);
+    
+    if (_fe_geom_cache)
+        fe->set_geometry_cache(*_fe_geom_cache);
+    
     return fe;
 }
 
 
 
+void
+MAST::AssemblyBase::set_reuse_fe_objects(bool f) {
+    
+    _if_reuse_fe = f;
+    
+    // the pool is kept alive since FEBase objects created earlier may still
+    // hold a pointer to it, and return their objects when destroyed. Only
+    // the objects that are not in use are deleted.
+    if (!f)
+        _fe_pool->clear();
+}
+
+
+
+MAST::FEObjectPool*
+MAST::AssemblyBase::fe_object_pool() {
+    
+    return _if_reuse_fe ? _fe_pool.get() : nullptr;
+}
+
+
+
+void
+MAST::AssemblyBase::set_cache_fe_geometry(bool f) {
+    
+    if (f && !_fe_geom_cache)
+        _fe_geom_cache.reset(new MAST::FEGeometryCache);
+    else if (!f)
+        _fe_geom_cache.reset();
+}
+
+
+
+void
+MAST::AssemblyBase::clear_fe_geometry_cache() {
+    
+    if (_fe_geom_cache)
+        _fe_geom_cache->clear();
+}
+
+
+
+
+void
+MAST::AssemblyBase::set_cache_element_matrices(bool f) {
+    
+    if (f && !_elem_mat_cache)
+        _elem_mat_cache.reset(new MAST::ElementMatrixCache);
+    else if (!f)
+        _elem_mat_cache.reset();
+}
+
+
+
+MAST::ElementMatrixCache*
+MAST::AssemblyBase::element_matrix_cache() {
+    
+    return _elem_mat_cache.get();
+}
+
+
+
+void
+MAST::AssemblyBase::
+set_parameter_support_index(const MAST::ParameterSupportIndex& idx) {
+    
+    _param_support = &idx;
+}
+
+
+
+void
+MAST::AssemblyBase::clear_parameter_support_index() {
+    
+    _param_support = nullptr;
+}
+
+
+
+void
+MAST::AssemblyBase::
+_sensitivity_elems(const std::vector<const MAST::FunctionBase*>& p,
+                   std::vector<const libMesh::Elem*>& elems) const {
+    
+    libmesh_assert(_system);
+    
+    if (_param_support) {
+        
+        _param_support->elems_for_parameters(p, elems);
+        return;
+    }
+    
+    elems.clear();
+    
+    const libMesh::MeshBase& mesh = _system->system().get_mesh();
+    
+    libMesh::MeshBase::const_element_iterator
+    el     = mesh.active_local_elements_begin(),
+    end_el = mesh.active_local_elements_end();
+    
+    for ( ; el != end_el; ++el)
+        elems.push_back(*el);
+}
+
+
+
+bool
+MAST::AssemblyBase::
+_if_elem_in_parameter_support(const MAST::FunctionBase& p,
+                              const libMesh::Elem& elem) const {
+    
+    return !_param_support || _param_support->if_elem_in_support(p, elem);
+}
+
+
+
 
 void
 MAST::AssemblyBase::calculate_output(const libMesh::NumericVector<Real>& X,
                                      MAST::OutputAssemblyElemOperations& output) {
     
+    MAST::PerformanceScope perf("AssemblyBase::calculate_output");
+    
     libmesh_assert(_discipline);
     libmesh_assert(_system);
     
@@ -312,6 +453,8 @@ calculate_output_derivative(const libMesh::NumericVector<Real>& X,
                             MAST::OutputAssemblyElemOperations& output,
                             libMesh::NumericVector<Real>& dq_dX) {
     
+    MAST::PerformanceScope perf("AssemblyBase::calculate_output_derivative");
+    
     libmesh_assert(_discipline);
     libmesh_assert(_system);
 
@@ -394,6 +537,8 @@ calculate_output_direct_sensitivity(const libMesh::NumericVector<Real>& X,
                                     const MAST::FunctionBase& p,
                                     MAST::OutputAssemblyElemOperations& output) {
 
+    MAST::PerformanceScope perf("AssemblyBase::calculate_output_direct_sensitivity");
+    
     libmesh_assert(_discipline);
     libmesh_assert(_system);
 
@@ -479,6 +624,8 @@ calculate_output_adjoint_sensitivity(const libMesh::NumericVector<Real>& X,
                                      MAST::OutputAssemblyElemOperations& output,
                                      const bool include_partial_sens) {
 
+    MAST::PerformanceScope perf("AssemblyBase::calculate_output_adjoint_sensitivity");
+    
     libmesh_assert(_discipline);
     libmesh_assert(_system);
     
@@ -508,3 +655,84 @@ calculate_output_adjoint_sensitivity(const libMesh::NumericVector<Real>& X,
     return dq_dp;
 }
 
+
+
+bool
+MAST::AssemblyBase::
+sensitivity_assemble_for_parameters
+(const std::vector<const MAST::FunctionBase*>& f,
+ std::vector<libMesh::NumericVector<Real>*>& sensitivity_rhs) {
+    
+    MAST::PerformanceScope perf("AssemblyBase::sensitivity_assemble_for_parameters");
+    
+    libmesh_assert_equal_to(f.size(), sensitivity_rhs.size());
+    
+    bool rval = true;
+    
+    for (unsigned int i=0; i<f.size(); i++)
+        rval = this->sensitivity_assemble(*f[i], *sensitivity_rhs[i]) && rval;
+    
+    return rval;
+}
+
+
+
+void
+MAST::AssemblyBase::
+calculate_output_direct_sensitivity_for_parameters
+(const libMesh::NumericVector<Real>& X,
+ const std::vector<const libMesh::NumericVector<Real>*>& dXdp,
+ const std::vector<const MAST::FunctionBase*>& p,
+ MAST::OutputAssemblyElemOperations& output,
+ std::vector<Real>& dq_dp) {
+    
+    MAST::PerformanceScope perf("AssemblyBase::calculate_output_direct_sensitivity_for_parameters");
+    
+    libmesh_assert(dXdp.empty() || dXdp.size() == p.size());
+    
+    dq_dp.assign(p.size(), 0.);
+    
+    std::unique_ptr<libMesh::NumericVector<Real>>
+    zero_X;
+    
+    for (unsigned int i=0; i<p.size(); i++) {
+        
+        if (i < dXdp.size() && dXdp[i])
+            this->calculate_output_direct_sensitivity(X, *dXdp[i], *p[i], output);
+        else {
+            
+            if (!zero_X)
+                zero_X.reset(X.zero_clone().release());
+            this->calculate_output_direct_sensitivity(X, *zero_X, *p[i], output);
+        }
+        
+        dq_dp[i] = output.output_sensitivity_total(*p[i]);
+    }
+}
+
+
+
+void
+MAST::AssemblyBase::
+calculate_output_adjoint_sensitivity_for_parameters
+(const libMesh::NumericVector<Real>& X,
+ const libMesh::NumericVector<Real>& dq_dX,
+ const std::vector<const MAST::FunctionBase*>& p,
+ MAST::AssemblyElemOperations&       elem_ops,
+ MAST::OutputAssemblyElemOperations& output,
+ std::vector<Real>& dq_dp,
+ const bool include_partial_sens) {
+    
+    MAST::PerformanceScope perf("AssemblyBase::calculate_output_adjoint_sensitivity_for_parameters");
+    
+    dq_dp.assign(p.size(), 0.);
+    
+    for (unsigned int i=0; i<p.size(); i++)
+        dq_dp[i] = this->calculate_output_adjoint_sensitivity(X,
+                                                              dq_dX,
+                                                              *p[i],
+                                                              elem_ops,
+                                                              output,
+                                                              include_partial_sens);
+}
+
@@ -23,6 +23,7 @@
 // C++ includes
 #include <map>
 #include <memory>
+#include <vector>
 
 
 // MAST includes
@@ -47,6 +48,11 @@ namespace MAST {
     class AssemblyElemOperations;
     class OutputAssemblyElemOperations;
     class FunctionBase;
+    class FEObjectPool;
+    class FEGeometryCache;
+    class ParameterSupportIndex;
+    class ElementMatrixCache;
+    class ElementScatter;
     
     class AssemblyBase:
     public libMesh::NonlinearImplicitSystem::ComputeResidualandJacobian {
@@ -245,6 +251,55 @@ namespace MAST {
                                              const bool include_partial_sens = true);
 
         
+        /*!
+         *   assembles the RHS of the sensitivity equations for each parameter
+         *   in \par f into the corresponding vector in \par sensitivity_rhs.
+         *   The default implementation calls sensitivity_assemble() for each
+         *   parameter. Derived classes can compute all vectors in a single
+         *   pass over the elements.
+         */
+        virtual bool
+        sensitivity_assemble_for_parameters
+        (const std::vector<const MAST::FunctionBase*>& f,
+         std::vector<libMesh::NumericVector<Real>*>& sensitivity_rhs);
+        
+        
+        /*!
+         *   evaluates the sensitivity of \par output with respect to each
+         *   parameter in \par p and returns the values in \par dq_dp.
+         *   \par dXdp is either empty, or provides the solution sensitivity
+         *   for each parameter in \par p. A nullptr entry, or an empty
+         *   \par dXdp, results in the partial derivative of \par output
+         *   wrt the parameter. The default implementation calls
+         *   calculate_output_direct_sensitivity() for each parameter.
+         */
+        virtual void
+        calculate_output_direct_sensitivity_for_parameters
+        (const libMesh::NumericVector<Real>& X,
+         const std::vector<const libMesh::NumericVector<Real>*>& dXdp,
+         const std::vector<const MAST::FunctionBase*>& p,
+         MAST::OutputAssemblyElemOperations& output,
+         std::vector<Real>& dq_dp);
+        
+        
+        /*!
+         *   Evaluates the total sensitivity of \par output wrt each parameter
+         *   in \par p using the adjoint solution provided in \par dq_dX for
+         *   a linearization about solution \par X. The values are returned in
+         *   \par dq_dp. The default implementation calls
+         *   calculate_output_adjoint_sensitivity() for each parameter.
+         */
+        virtual void
+        calculate_output_adjoint_sensitivity_for_parameters
+        (const libMesh::NumericVector<Real>& X,
+         const libMesh::NumericVector<Real>& dq_dX,
+         const std::vector<const MAST::FunctionBase*>& p,
+         MAST::AssemblyElemOperations&       elem_ops,
+         MAST::OutputAssemblyElemOperations& output,
+         std::vector<Real>& dq_dp,
+         const bool include_partial_sens = true);
+
+        
         /*!
          *   localizes the parallel vector so that the local copy
          *   stores all values necessary for calculation of the
@@ -265,9 +320,94 @@ namespace MAST {
         virtual std::unique_ptr<MAST::FEBase>
         build_fe();
         
+        
+        /*!
+         *   enables or disables the reuse of the libMesh finite element and
+         *   quadrature objects by the MAST::FEBase objects created in
+         *   build_fe(). When enabled, which is the default, these objects
+         *   are kept in a pool owned by this assembly and reused for
+         *   subsequent elements instead of being allocated for each element.
+         */
+        void set_reuse_fe_objects(bool f);
+        
+        /*!
+         *   @returns a pointer to the pool of finite element objects used by
+         *   this assembly, or nullptr if reuse has been disabled.
+         */
+        MAST::FEObjectPool* fe_object_pool();
+        
+        
+        /*!
+         *   enables or disables the caching of quadrature point data
+         *   (shape functions, their derivatives, JxW and locations) for
+         *   each element by the MAST::FEBase objects created in build_fe().
+         *   This is disabled by default. When enabled, the finite element
+         *   reinitialization is skipped for elements whose geometry has not
+         *   changed since the data was stored, which is useful for repeated
+         *   assemblies on a fixed mesh.
+         */
+        void set_cache_fe_geometry(bool f);
+        
+        /*!
+         *   clears the data in the geometry cache, if enabled. This should be
+         *   called after the mesh is refined or redistributed. Changes in
+         *   node locations are detected by the cache.
+         */
+        void clear_fe_geometry_cache();
+        
+        
+        /*!
+         *   enables or disables the caching of solution-independent element
+         *   matrices. This is disabled by default. When enabled, assemblies
+         *   of linear operators about a zero base solution, such as the
+         *   eigenproblem and reduced-order structural matrices, store the
+         *   element matrices on the first assembly and reuse them in
+         *   subsequent assemblies.
+         */
+        void set_cache_element_matrices(bool f);
+        
+        /*!
+         *   @returns a pointer to the element matrix cache, or nullptr if
+         *   caching is disabled. The cache is cleared when the property
+         *   cards of the discipline, or the parameters that these and the
+         *   loads depend on, change. Other parameters that the element
+         *   matrices depend on should be registered with the cache.
+         */
+        MAST::ElementMatrixCache* element_matrix_cache();
+        
+        
+        /*!
+         *   attaches an index of the elements influenced by each parameter.
+         *   When attached, the sensitivity assembly routines only visit the
+         *   elements in the support of a parameter. Parameters without a
+         *   registered support continue to use all active local elements.
+         */
+        void set_parameter_support_index(const MAST::ParameterSupportIndex& idx);
+        
+        /*!
+         *   clears the parameter support index
+         */
+        void clear_parameter_support_index();
+        
 
     protected:
         
+        /*!
+         *   populates \p elems with the active local elements that are
+         *   visited for sensitivity with respect to parameters \p p.
+         */
+        void
+        _sensitivity_elems(const std::vector<const MAST::FunctionBase*>& p,
+                           std::vector<const libMesh::Elem*>& elems) const;
+        
+        /*!
+         *   @returns false if \p elem is known to lie outside the support of
+         *   parameter \p p, and true otherwise.
+         */
+        bool
+        _if_elem_in_parameter_support(const MAST::FunctionBase& p,
+                                      const libMesh::Elem& elem) const;
+        
         /*!
          *   provides assembly elem operations for use by this class
          */
@@ -295,6 +435,42 @@ namespace MAST {
          *   nonlinear solvers, if provided
          */
         MAST::AssemblyBase::SolverMonitor *_solver_monitor;
+        
+        /*!
+         *   flag to attach the object pool to MAST::FEBase objects created by
+         *   this assembly
+         */
+        bool _if_reuse_fe;
+        
+        /*!
+         *   pool of libMesh finite element and quadrature objects reused by
+         *   the MAST::FEBase objects created by this assembly. The pool
+         *   exists for the lifetime of the assembly, even if reuse is disabled,
+         *   so that objects created earlier can return their objects to it.
+         */
+        std::unique_ptr<MAST::FEObjectPool> _fe_pool;
+        
+        /*!
+         *   cache of element quadrature point data used by the
+         *   MAST::FEBase objects created by this assembly, if enabled
+         */
+        std::unique_ptr<MAST::FEGeometryCache> _fe_geom_cache;
+        
+        /*!
+         *   dof layout of elements used to add element quantities to
+         *   the global vectors and matrices
+         */
+        std::unique_ptr<MAST::ElementScatter> _elem_scatter;
+        
+        /*!
+         *   cache of solution-independent element matrices, if enabled
+         */
+        std::unique_ptr<MAST::ElementMatrixCache> _elem_mat_cache;
+        
+        /*!
+         *   index of elements influenced by each parameter, if provided
+         */
+        const MAST::ParameterSupportIndex* _param_support;
     };
         
 }
@@ -187,6 +187,16 @@ MAST::AssemblyElemOperations::set_elem_perturbed_acceleration(const RealVectorX
 }
 
 
+
+bool
+MAST::AssemblyElemOperations::
+if_elem_depends_on_parameter(const libMesh::Elem& elem,
+                             const MAST::FunctionBase& p) const {
+    
+    return true;
+}
+
+
 void
 MAST::AssemblyElemOperations::clear_elem() {
     
@@ -155,6 +155,16 @@ namespace MAST {
          */
         virtual void set_elem_perturbed_acceleration(const RealVectorX& accel);
 
+        /*!
+         *   @returns true if the element quantities computed by this object
+         *   for \p elem depend on the parameter \p p. Assembly routines use
+         *   this to skip sensitivity calculations on elements that do not
+         *   depend on a parameter. Returns true by default.
+         */
+        virtual bool
+        if_elem_depends_on_parameter(const libMesh::Elem& elem,
+                                     const MAST::FunctionBase& p) const;
+        
         
     protected:
 
@@ -28,6 +28,8 @@
 #include "base/parameter.h"
 #include "base/nonlinear_system.h"
 #include "base/complex_assembly_elem_operations.h"
+#include "base/element_scatter.h"
+#include "base/performance_counters.h"
 
 
 // libMesh includes
@@ -244,6 +246,8 @@ residual_and_jacobian_field_split (const libMesh::NumericVector<Real>& X_R,
                                    libMesh::SparseMatrix<Real>&  J_R,
                                    libMesh::SparseMatrix<Real>&  J_I) {
 
+    MAST::PerformanceScope perf("ComplexAssemblyBase::residual_and_jacobian_field_split");
+    
     libmesh_assert(_system);
     libmesh_assert(_discipline);
     libmesh_assert(_elem_ops);
@@ -262,8 +266,8 @@ residual_and_jacobian_field_split (const libMesh::NumericVector<Real>& X_R,
     ComplexVectorX delta_sol, vec;
     ComplexMatrixX mat;
     
-    std::vector<libMesh::dof_id_type> dof_indices;
     const libMesh::DofMap& dof_map = _system->system().get_dof_map();
+    _elem_scatter->init(_system->system());
     
     
     std::unique_ptr<libMesh::NumericVector<Real> >
@@ -303,7 +307,11 @@ residual_and_jacobian_field_split (const libMesh::NumericVector<Real>& X_R,
         
         const libMesh::Elem* elem = *el;
         
-        dof_map.dof_indices (elem, dof_indices);
+        const MAST::ElementScatter::Layout&
+        layout = _elem_scatter->layout(dof_map, *elem);
+        
+        const std::vector<libMesh::dof_id_type>&
+        dof_indices = layout.dof_indices;
         
         ops.init(*elem);
         
@@ -353,27 +361,19 @@ residual_and_jacobian_field_split (const libMesh::NumericVector<Real>& X_R,
         //     [ J_R   -J_I] {x_R}  +  {r_R}  = {0}
         //     [ J_I    J_R] {x_I}  +  {r_I}  = {0}
         //
-        DenseRealVector v;
-        DenseRealMatrix m;
 
-        // copy the real part of the residual and Jacobian
-        MAST::copy(v, vec.real());
-        MAST::copy(m, mat.real());
+        // the real part of the residual and Jacobian
+        vec_re = vec.real();
+        mat_re = mat.real();
         
-        dof_map.constrain_element_matrix_and_vector(m, v, dof_indices);
-        R_R.add_vector(v, dof_indices);
-        J_R.add_matrix(m, dof_indices);
+        _elem_scatter->add(dof_map, layout, vec_re, mat_re, &R_R, &J_R);
 
         
-        // copy the imag part of the residual and Jacobian
-        v.zero();
-        m.zero();
-        MAST::copy(v, vec.imag());
-        MAST::copy(m, mat.imag());
+        // the imag part of the residual and Jacobian
+        vec_re = vec.imag();
+        mat_re = mat.imag();
         
-        dof_map.constrain_element_matrix_and_vector(m, v, dof_indices);
-        R_I.add_vector(v, dof_indices);
-        J_I.add_matrix(m, dof_indices);
+        _elem_scatter->add(dof_map, layout, vec_re, mat_re, &R_I, &J_I);
     }
     
     
@@ -399,9 +399,11 @@ void
 MAST::ComplexAssemblyBase::
 residual_and_jacobian_blocked (const libMesh::NumericVector<Real>& X,
                                libMesh::NumericVector<Real>& R,
-                               libMesh::SparseMatrix<Real>&  J,
+                               libMesh::SparseMatrix<Real>*  J,
                                MAST::Parameter* p) {
 
+    MAST::PerformanceScope perf("ComplexAssemblyBase::residual_and_jacobian_blocked");
+    
     libmesh_assert(_system);
     libmesh_assert(_discipline);
     libmesh_assert(_elem_ops);
@@ -411,7 +413,7 @@ residual_and_jacobian_blocked (const libMesh::NumericVector<Real>& X,
     MAST::NonlinearSystem& nonlin_sys = _system->system();
     
     R.zero();
-    J.zero();
+    if (J) J->zero();
     
     // iterate over each element, initialize it and get the relevant
     // analysis quantities
@@ -426,7 +428,7 @@ residual_and_jacobian_blocked (const libMesh::NumericVector<Real>& X,
 
     // get the petsc vector and matrix objects
     Mat
-    jac_bmat = dynamic_cast<libMesh::PetscMatrix<Real>&>(J).mat();
+    jac_bmat = J?dynamic_cast<libMesh::PetscMatrix<Real>*>(J)->mat():nullptr;
     
     PetscInt ierr;
     
@@ -518,7 +520,7 @@ residual_and_jacobian_blocked (const libMesh::NumericVector<Real>& X,
         
         
         // perform the element level calculations
-        ops.elem_calculations(true, vec, mat);
+        ops.elem_calculations(J != nullptr, vec, mat);
         
         // if sensitivity was requested, then ask the element for sensitivity
         // of the residual
@@ -552,9 +554,11 @@ residual_and_jacobian_blocked (const libMesh::NumericVector<Real>& X,
         MAST::copy(m_I2, mat.imag());                // this is the J_I component
         MAST::copy( v_R, vec.real());
         MAST::copy( v_I, vec.imag());
-        dof_map.constrain_element_matrix(m_R,  dof_indices);
-        dof_map.constrain_element_matrix(m_I1, dof_indices);
-        dof_map.constrain_element_matrix(m_I2, dof_indices);
+        if (J) {
+            dof_map.constrain_element_matrix(m_R,  dof_indices);
+            dof_map.constrain_element_matrix(m_I1, dof_indices);
+            dof_map.constrain_element_matrix(m_I2, dof_indices);
+        }
         dof_map.constrain_element_vector(v_R,  dof_indices);
         dof_map.constrain_element_vector(v_I,  dof_indices);
         
@@ -564,7 +568,7 @@ residual_and_jacobian_blocked (const libMesh::NumericVector<Real>& X,
             R.add(2*dof_indices[i],     v_R(i));
             R.add(2*dof_indices[i]+1,   v_I(i));
             
-            for (unsigned int j=0; j<dof_indices.size(); j++) {
+            for (unsigned int j=0; J && j<dof_indices.size(); j++) {
                 vals[0] = m_R (i,j);
                 vals[1] = m_I1(i,j);
                 vals[2] = m_I2(i,j);
@@ -584,7 +588,7 @@ residual_and_jacobian_blocked (const libMesh::NumericVector<Real>& X,
     //    _sol_function->clear();
     
     R.close();
-    J.close();
+    if (J) J->close();
     
     libMesh::out << "R: " << R.l2_norm() << std::endl;
     STOP_LOG("residual_and_jacobian()", "ComplexSolve");
@@ -600,6 +604,8 @@ MAST::ComplexAssemblyBase::
 sensitivity_assemble (const MAST::FunctionBase& f,
                       libMesh::NumericVector<Real>& sensitivity_rhs) {
 
+    MAST::PerformanceScope perf("ComplexAssemblyBase::sensitivity_assemble");
+    
     libmesh_error(); // not implemented. Call the blocked assembly instead.
     
     return false;
@@ -108,12 +108,13 @@ namespace MAST {
          *   is the current complex solution with the real and imaginary parts 
          *   of each element stored as adjacent entries. Likewise, the Jaacobian
          *   matrix has a 2x2 block storage. If \par p is provided, then \par R
-         *   will return the sensitivity of the residual vector.
+         *   will return the sensitivity of the residual vector. If \par J is
+         *   nullptr, then only the residual is assembled.
          */
         void
         residual_and_jacobian_blocked (const libMesh::NumericVector<Real>& X,
                                        libMesh::NumericVector<Real>& R,
-                                       libMesh::SparseMatrix<Real>&  J,
+                                       libMesh::SparseMatrix<Real>*  J,
                                        MAST::Parameter* p = nullptr);
 
         /**
@@ -25,6 +25,9 @@
 #include "base/physics_discipline_base.h"
 #include "numerics/utility.h"
 #include "base/eigenproblem_assembly_elem_operations.h"
+#include "base/element_matrix_cache.h"
+#include "base/element_scatter.h"
+#include "base/performance_counters.h"
 
 // libMesh includes
 #include "libmesh/numeric_vector.h"
@@ -32,6 +35,12 @@
 #include "libmesh/dof_map.h"
 
 
+// quantity types used to identify the matrices in the element matrix cache
+static const unsigned int
+__mast_eigenproblem_A_matrix = 0,
+__mast_eigenproblem_B_matrix = 1;
+
+
 
 MAST::EigenproblemAssembly::EigenproblemAssembly():
 MAST::AssemblyBase(),
@@ -88,6 +97,8 @@ MAST::EigenproblemAssembly::
 eigenproblem_assemble(libMesh::SparseMatrix<Real>* A,
                       libMesh::SparseMatrix<Real>* B) {
     
+    MAST::PerformanceScope perf("EigenproblemAssembly::eigenproblem_assemble");
+    
     libmesh_assert(_system);
     libmesh_assert(_discipline);
     libmesh_assert(_elem_ops);
@@ -107,17 +118,20 @@ eigenproblem_assemble(libMesh::SparseMatrix<Real>* A,
     std::unique_ptr<libMesh::NumericVector<Real> >
     localized_solution;
     
-    if (_base_sol)
+    if (_base_sol) {
+        
         localized_solution.reset(build_localized_vector(eigen_sys,
                                                          *_base_sol).release());
+        perf.add_bytes(localized_solution->size()*sizeof(Real));
+    }
 
     
     // iterate over each element, initialize it and get the relevant
     // analysis quantities
     RealVectorX sol;
     RealMatrixX mat_A, mat_B;
-    std::vector<libMesh::dof_id_type> dof_indices;
     const libMesh::DofMap& dof_map = eigen_sys.get_dof_map();
+    _elem_scatter->init(eigen_sys);
     
     
     libMesh::MeshBase::const_element_iterator       el     =
@@ -128,41 +142,55 @@ eigenproblem_assemble(libMesh::SparseMatrix<Real>* A,
     MAST::EigenproblemAssemblyElemOperations
     &ops = dynamic_cast<MAST::EigenproblemAssemblyElemOperations&>(*_elem_ops);
     
+    // the element matrices are cached only for the eigenproblem about a
+    // zero base solution
+    MAST::ElementMatrixCache
+    *cache = _base_sol?nullptr:_elem_mat_cache.get();
+    
+    if (cache)
+        cache->validate(&ops, *_discipline);
+    
     for ( ; el != end_el; ++el) {
         
         const libMesh::Elem* elem = *el;
         
-        dof_map.dof_indices (elem, dof_indices);
+        const MAST::ElementScatter::Layout&
+        layout = _elem_scatter->layout(dof_map, *elem);
         
-        ops.init(*elem);
+        const std::vector<libMesh::dof_id_type>&
+        dof_indices = layout.dof_indices;
         
-        // get the solution
-        unsigned int ndofs = (unsigned int)dof_indices.size();
-        sol.setZero(ndofs);
-        mat_A.setZero(ndofs, ndofs);
-        mat_B.setZero(ndofs, ndofs);
-        
-        // if the base solution is provided, then tell the element about it
-        if (_base_sol) {
-            for (unsigned int i=0; i<dof_indices.size(); i++)
-                sol(i) = (*localized_solution)(dof_indices[i]);
+        if (!cache ||
+            !cache->get(*elem, __mast_eigenproblem_A_matrix, mat_A) ||
+            !cache->get(*elem, __mast_eigenproblem_B_matrix, mat_B)) {
+            
+            ops.init(*elem);
+            
+            // get the solution
+            unsigned int ndofs = (unsigned int)dof_indices.size();
+            sol.setZero(ndofs);
+            mat_A.setZero(ndofs, ndofs);
+            mat_B.setZero(ndofs, ndofs);
+            
+            // if the base solution is provided, then tell the element about it
+            if (_base_sol) {
+                for (unsigned int i=0; i<dof_indices.size(); i++)
+                    sol(i) = (*localized_solution)(dof_indices[i]);
+            }
+            
+            ops.set_elem_solution(sol);
+            ops.elem_calculations(mat_A, mat_B);
+            ops.clear_elem();
+            
+            if (cache) {
+                cache->store(*elem, __mast_eigenproblem_A_matrix, mat_A);
+                cache->store(*elem, __mast_eigenproblem_B_matrix, mat_B);
+            }
         }
-        
-        ops.set_elem_solution(sol);
-        ops.elem_calculations(mat_A, mat_B);
-        ops.clear_elem();
 
-        // copy to the libMesh matrix for further processing
-        DenseRealMatrix A, B;
-        MAST::copy(A, mat_A);
-        MAST::copy(B, mat_B);
-
-        // constrain the element matrices.
-        dof_map.constrain_element_matrix(A, dof_indices);
-        dof_map.constrain_element_matrix(B, dof_indices);
-        
-        matrix_A.add_matrix (A, dof_indices); // load independent
-        matrix_B.add_matrix (B, dof_indices); // load dependent
+        // constrain the element matrices and add to the global matrices
+        _elem_scatter->add_matrix(dof_map, layout, mat_A, matrix_A); // load independent
+        _elem_scatter->add_matrix(dof_map, layout, mat_B, matrix_B); // load dependent
     }
     
     // finalize the data structures
@@ -180,6 +208,8 @@ eigenproblem_sensitivity_assemble(const MAST::FunctionBase& f,
                                   libMesh::SparseMatrix<Real>* sensitivity_A,
                                   libMesh::SparseMatrix<Real>* sensitivity_B) {
 
+    MAST::PerformanceScope perf("EigenproblemAssembly::eigenproblem_sensitivity_assemble");
+    
     libmesh_assert(_system);
     libmesh_assert(_discipline);
     libmesh_assert(_elem_ops);
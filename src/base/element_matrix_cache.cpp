@@ -0,0 +1,277 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2018  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <algorithm>
+
+// MAST includes
+#include "base/element_matrix_cache.h"
+#include "base/parameter.h"
+#include "base/physics_discipline_base.h"
+
+
+// relative tolerance below which a matrix is stored as symmetric
+static const Real
+__mast_elem_matrix_cache_symmetry_tol = 1.e-12;
+
+
+
+MAST::ElementMatrixCache::ElementMatrixCache():
+_owner            (nullptr),
+_n_unused_values  (0) {
+    
+}
+
+
+
+MAST::ElementMatrixCache::~ElementMatrixCache() {
+    
+}
+
+
+
+void
+MAST::ElementMatrixCache::add_parameter(const MAST::Parameter& p) {
+    
+    if (std::find(_params.begin(), _params.end(), &p) != _params.end())
+        return;
+    
+    // data stored before the dependency was registered may not be
+    // consistent with the current value
+    this->clear();
+    
+    _params.push_back(&p);
+}
+
+
+
+void
+MAST::ElementMatrixCache::validate(const void* owner,
+                                   const MAST::PhysicsDisciplineBase& discipline) {
+    
+    // property cards currently assigned to the discipline
+    std::vector<const void*>
+    cards;
+    
+    const MAST::PropertyCardMapType&
+    card_map = discipline.property_cards();
+    
+    MAST::PropertyCardMapType::const_iterator
+    c_it  = card_map.begin(),
+    c_end = card_map.end();
+    
+    for ( ; c_it != c_end; c_it++)
+        cards.push_back(c_it->second);
+    
+    // the registered parameters, followed by all other parameters that the
+    // property cards and loads of the discipline depend on. The set is
+    // ordered by address, so that the sequence is reproducible.
+    std::vector<const MAST::Parameter*>
+    params = _params;
+    
+    const std::set<const MAST::Parameter*>&
+    all_params = MAST::Parameter::all_parameters();
+    
+    std::set<const MAST::Parameter*>::const_iterator
+    p_it  = all_params.begin(),
+    p_end = all_params.end();
+    
+    for ( ; p_it != p_end; p_it++)
+        if (std::find(_params.begin(), _params.end(), *p_it) == _params.end() &&
+            discipline.depends_on_parameter(**p_it))
+            params.push_back(*p_it);
+    
+    bool
+    valid =
+    (owner == _owner)             &&
+    (cards == _cards)             &&
+    (params == _recorded_params)  &&
+    (_param_vals.size() == _recorded_params.size());
+    
+    for (unsigned int i=0; valid && i<_recorded_params.size(); i++)
+        valid = ((*_recorded_params[i])() == _param_vals[i]);
+    
+    if (!valid) {
+        
+        this->clear();
+        _owner            = owner;
+        _cards.swap(cards);
+        _recorded_params.swap(params);
+        _record_parameter_values();
+    }
+}
+
+
+
+void
+MAST::ElementMatrixCache::clear() {
+    
+    _entries.clear();
+    _data.clear();
+    _n_unused_values = 0;
+    _param_vals.clear();
+    _owner = nullptr;
+}
+
+
+
+bool
+MAST::ElementMatrixCache::contains(const libMesh::Elem& elem,
+                                   unsigned int qty) const {
+    
+    return _entries.count(std::make_pair(elem.id(), qty)) > 0;
+}
+
+
+
+bool
+MAST::ElementMatrixCache::get(const libMesh::Elem& elem,
+                              unsigned int qty,
+                              RealMatrixX& m) const {
+    
+    std::map<std::pair<libMesh::dof_id_type, unsigned int>,
+    MAST::ElementMatrixCache::Entry>::const_iterator
+    it = _entries.find(std::make_pair(elem.id(), qty));
+    
+    if (it == _entries.end())
+        return false;
+    
+    const MAST::ElementMatrixCache::Entry& e = it->second;
+    const Real* v = _data.data() + e.offset;
+    
+    m.setZero(e.n, e.n);
+    
+    if (e.symmetric) {
+        
+        for (unsigned int j=0; j<e.n; j++)
+            for (unsigned int i=0; i<=j; i++) {
+                m(i,j) = *v;
+                m(j,i) = *v;
+                v++;
+            }
+    }
+    else
+        m = Eigen::Map<const RealMatrixX>(v, e.n, e.n);
+    
+    return true;
+}
+
+
+
+void
+MAST::ElementMatrixCache::store(const libMesh::Elem& elem,
+                                unsigned int qty,
+                                const RealMatrixX& m) {
+    
+    libmesh_assert_equal_to(m.rows(), m.cols());
+    
+    if (_param_vals.size() != _recorded_params.size())
+        _record_parameter_values();
+    
+    const unsigned int
+    n = (unsigned int)m.rows();
+    
+    const bool
+    symmetric = (n == 0) ||
+    ((m - m.transpose()).cwiseAbs().maxCoeff() <=
+     __mast_elem_matrix_cache_symmetry_tol * m.cwiseAbs().maxCoeff());
+    
+    const std::size_t
+    n_vals = symmetric ? (n*(n+1))/2 : n*n;
+    
+    std::pair<std::map<std::pair<libMesh::dof_id_type, unsigned int>,
+    MAST::ElementMatrixCache::Entry>::iterator, bool>
+    it = _entries.insert(std::make_pair(std::make_pair(elem.id(), qty),
+                                        MAST::ElementMatrixCache::Entry()));
+    
+    MAST::ElementMatrixCache::Entry& e = it.first->second;
+    
+    // an existing entry of the same size is overwritten, otherwise the
+    // matrix is appended and the old storage is released by _compact().
+    const std::size_t
+    old_n_vals = it.second ? 0 : (e.symmetric ? (e.n*(e.n+1))/2 : e.n*e.n);
+    
+    if (it.second || old_n_vals != n_vals) {
+        
+        _n_unused_values += old_n_vals;
+        e.offset = _data.size();
+        _data.resize(_data.size() + n_vals);
+    }
+    
+    e.n         = n;
+    e.symmetric = symmetric;
+    
+    Real* v = _data.data() + e.offset;
+    
+    if (symmetric) {
+        
+        for (unsigned int j=0; j<n; j++)
+            for (unsigned int i=0; i<=j; i++) {
+                *v = m(i,j);
+                v++;
+            }
+    }
+    else
+        Eigen::Map<RealMatrixX>(v, n, n) = m;
+    
+    if (_n_unused_values > _data.size()/2)
+        _compact();
+}
+
+
+
+void
+MAST::ElementMatrixCache::_record_parameter_values() {
+    
+    _param_vals.resize(_recorded_params.size());
+    
+    for (unsigned int i=0; i<_recorded_params.size(); i++)
+        _param_vals[i] = (*_recorded_params[i])();
+}
+
+
+
+void
+MAST::ElementMatrixCache::_compact() {
+    
+    std::vector<Real>
+    data;
+    data.reserve(_data.size() - _n_unused_values);
+    
+    std::map<std::pair<libMesh::dof_id_type, unsigned int>,
+    MAST::ElementMatrixCache::Entry>::iterator
+    it  = _entries.begin(),
+    end = _entries.end();
+    
+    for ( ; it != end; it++) {
+        
+        MAST::ElementMatrixCache::Entry& e = it->second;
+        
+        const std::size_t
+        n_vals = e.symmetric ? (e.n*(e.n+1))/2 : e.n*e.n;
+        
+        data.insert(data.end(),
+                    _data.begin() + e.offset,
+                    _data.begin() + e.offset + n_vals);
+        e.offset = data.size() - n_vals;
+    }
+    
+    _data.swap(data);
+    _n_unused_values = 0;
+}
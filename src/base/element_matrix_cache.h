@@ -0,0 +1,181 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2018  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast_element_matrix_cache_h__
+#define __mast_element_matrix_cache_h__
+
+// C++ includes
+#include <map>
+#include <vector>
+#include <utility>
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+// libMesh includes
+#include "libmesh/elem.h"
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class Parameter;
+    class PhysicsDisciplineBase;
+    
+    
+    /*!
+     *   Stores element matrices that do not depend on the solution, such as
+     *   the stiffness and mass matrices of a linear analysis, so that
+     *   repeated assemblies can skip the element calculations. Entries are
+     *   identified by the element id and an integer quantity type defined
+     *   by the assembly using the cache.
+     *
+     *   The matrices are stored in a single contiguous array. Symmetric
+     *   matrices are stored as the packed upper triangle.
+     *
+     *   The values of all parameters that the property cards and loads of
+     *   the discipline depend on, along with those registered with
+     *   add_parameter(), are recorded with the stored data, and the cache
+     *   is cleared by validate() if any of these, or the property cards
+     *   assigned to the discipline, have changed. Changes to the mesh
+     *   require an explicit call to clear().
+     */
+    class ElementMatrixCache {
+        
+    public:
+        
+        ElementMatrixCache();
+        
+        virtual ~ElementMatrixCache();
+        
+        /*!
+         *   the cached data is invalidated if the value of \p p changes.
+         *   This is only needed for parameters that are not identified
+         *   through the property cards and loads of the discipline.
+         */
+        void add_parameter(const MAST::Parameter& p);
+        
+        /*!
+         *   clears the cached data if the object \p owner that computes
+         *   the element matrices, the property cards of \p discipline, or
+         *   the values of the parameters that these depend on have changed
+         *   since the data was stored. The assembly calls this before
+         *   using the cache.
+         */
+        void validate(const void* owner,
+                      const MAST::PhysicsDisciplineBase& discipline);
+        
+        /*!
+         *   removes all stored matrices. The registered parameters are
+         *   retained.
+         */
+        void clear();
+        
+        /*!
+         *   @returns true if a matrix is stored for \p elem and \p qty.
+         */
+        bool contains(const libMesh::Elem& elem, unsigned int qty) const;
+        
+        /*!
+         *   copies the matrix stored for \p elem and \p qty into \p m.
+         *   @returns false, without modifying \p m, if no matrix is stored.
+         */
+        bool get(const libMesh::Elem& elem, unsigned int qty, RealMatrixX& m) const;
+        
+        /*!
+         *   stores the square matrix \p m for \p elem and \p qty, replacing
+         *   previously stored data.
+         */
+        void store(const libMesh::Elem& elem, unsigned int qty, const RealMatrixX& m);
+        
+        /*!
+         *   @returns the number of stored matrices.
+         */
+        unsigned int size() const { return (unsigned int)_entries.size(); }
+        
+        /*!
+         *   @returns the number of values in the packed storage.
+         */
+        std::size_t n_stored_values() const { return _data.size(); }
+        
+    protected:
+        
+        /*!
+         *   location of a matrix in the packed storage
+         */
+        struct Entry {
+            std::size_t   offset;
+            unsigned int  n;
+            bool          symmetric;
+        };
+        
+        /*!
+         *   records the current values of the parameters in
+         *   \p _recorded_params
+         */
+        void _record_parameter_values();
+        
+        /*!
+         *   repacks the stored matrices to release the storage of
+         *   matrices that were replaced by store()
+         */
+        void _compact();
+        
+        /*!
+         *   object that computed the stored data
+         */
+        const void*                                                 _owner;
+        
+        /*!
+         *   parameters registered with add_parameter()
+         */
+        std::vector<const MAST::Parameter*>                         _params;
+        
+        /*!
+         *   property cards of the discipline when the data was stored
+         */
+        std::vector<const void*>                                    _cards;
+        
+        /*!
+         *   parameters that the stored data depends on, and their values
+         *   when the data was stored
+         */
+        std::vector<const MAST::Parameter*>                         _recorded_params;
+        std::vector<Real>                                           _param_vals;
+        
+        /*!
+         *   map of (element id, quantity type) to the stored matrix
+         */
+        std::map<std::pair<libMesh::dof_id_type, unsigned int>,
+        MAST::ElementMatrixCache::Entry>                            _entries;
+        
+        /*!
+         *   packed storage for all matrices
+         */
+        std::vector<Real>                                           _data;
+        
+        /*!
+         *   number of values in \p _data that are no longer referenced
+         *   by an entry
+         */
+        std::size_t                                                 _n_unused_values;
+    };
+}
+
+#endif // __mast_element_matrix_cache_h__
@@ -0,0 +1,264 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2018  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// MAST includes
+#include "base/element_scatter.h"
+#include "base/nonlinear_system.h"
+#include "numerics/utility.h"
+#include "base/performance_counters.h"
+
+// libMesh includes
+#include "libmesh/petsc_matrix.h"
+
+
+MAST::ElementScatter::ElementScatter():
+_dof_map              (nullptr),
+_dof_revision         (0),
+_n_dofs               (0),
+_n_constrained_dofs   (0),
+_first_dof            (0),
+_end_dof              (0),
+_revision             (0) {
+    
+}
+
+
+
+MAST::ElementScatter::~ElementScatter() {
+    
+}
+
+
+
+void
+MAST::ElementScatter::clear() {
+    
+    _dof_map            = nullptr;
+    _dof_revision       = 0;
+    _n_dofs             = 0;
+    _n_constrained_dofs = 0;
+    _first_dof          = 0;
+    _end_dof            = 0;
+    _layouts.clear();
+    _revision++;
+}
+
+
+
+void
+MAST::ElementScatter::init(const MAST::NonlinearSystem& sys) {
+    
+    const libMesh::DofMap&
+    dof_map = sys.get_dof_map();
+    
+    const unsigned int
+    dof_revision       = sys.dof_revision();
+    
+    const libMesh::dof_id_type
+    n_dofs             = dof_map.n_dofs(),
+    n_constrained_dofs = dof_map.n_constrained_dofs(),
+    first_dof          = dof_map.first_dof(),
+    end_dof            = dof_map.end_dof();
+    
+    // the dof revision identifies renumbering, mesh refinement and new
+    // constraints through the system reinit. The remaining quantities
+    // are checked in case the DofMap is modified directly.
+    if (_dof_map            != &dof_map           ||
+        _dof_revision       != dof_revision       ||
+        _n_dofs             != n_dofs             ||
+        _n_constrained_dofs != n_constrained_dofs ||
+        _first_dof          != first_dof          ||
+        _end_dof            != end_dof) {
+        
+        this->clear();
+        _dof_map            = &dof_map;
+        _dof_revision       = dof_revision;
+        _n_dofs             = n_dofs;
+        _n_constrained_dofs = n_constrained_dofs;
+        _first_dof          = first_dof;
+        _end_dof            = end_dof;
+    }
+}
+
+
+
+const MAST::ElementScatter::Layout&
+MAST::ElementScatter::layout(const libMesh::DofMap& dof_map,
+                             const libMesh::Elem& elem) {
+    
+    // init() must be called before the layouts are requested
+    libmesh_assert_equal_to(_dof_map, &dof_map);
+    
+    std::map<libMesh::dof_id_type, MAST::ElementScatter::Layout>::iterator
+    it = _layouts.find(elem.id());
+    
+    if (it != _layouts.end())
+        return it->second;
+    
+    MAST::ElementScatter::Layout&
+    l = _layouts[elem.id()];
+    
+    dof_map.dof_indices(&elem, l.dof_indices);
+    
+    l.constrained = false;
+    l.petsc_dof_indices.resize(l.dof_indices.size());
+    
+    for (unsigned int i=0; i<l.dof_indices.size(); i++) {
+        
+        l.petsc_dof_indices[i] = (PetscInt)l.dof_indices[i];
+        l.constrained          = l.constrained || dof_map.is_constrained_dof(l.dof_indices[i]);
+    }
+    
+    return l;
+}
+
+
+
+void
+MAST::ElementScatter::add(const libMesh::DofMap& dof_map,
+                          const MAST::ElementScatter::Layout& layout,
+                          const RealVectorX& v,
+                          const RealMatrixX& m,
+                          libMesh::NumericVector<Real>* R,
+                          libMesh::SparseMatrix<Real>*  J) {
+    
+    if (R && J && layout.constrained) {
+        
+        // the constraint application can modify the dof indices, so a copy
+        // of the stored indices is used.
+        std::vector<libMesh::dof_id_type> dof_indices = layout.dof_indices;
+        
+        DenseRealVector v_d;
+        DenseRealMatrix m_d;
+        MAST::copy(v_d, v);
+        MAST::copy(m_d, m);
+        
+        {
+            MAST::PerformanceScope perf("ElementScatter::constrain");
+            dof_map.constrain_element_matrix_and_vector(m_d, v_d, dof_indices);
+        }
+        
+        R->add_vector(v_d, dof_indices);
+        J->add_matrix(m_d, dof_indices);
+        return;
+    }
+    
+    if (R) this->add_vector(dof_map, layout, v, *R);
+    if (J) this->add_matrix(dof_map, layout, m, *J);
+}
+
+
+
+void
+MAST::ElementScatter::add_matrix(const libMesh::DofMap& dof_map,
+                                 const MAST::ElementScatter::Layout& layout,
+                                 const RealMatrixX& m,
+                                 libMesh::SparseMatrix<Real>& J) {
+    
+    libmesh_assert_equal_to(m.rows(), layout.dof_indices.size());
+    libmesh_assert_equal_to(m.cols(), layout.dof_indices.size());
+    
+    if (!layout.constrained && _add_unconstrained_matrix(layout, m, J))
+        return;
+    
+    std::vector<libMesh::dof_id_type> dof_indices = layout.dof_indices;
+    
+    DenseRealMatrix m_d;
+    MAST::copy(m_d, m);
+    
+    {
+        MAST::PerformanceScope perf("ElementScatter::constrain");
+        dof_map.constrain_element_matrix(m_d, dof_indices);
+    }
+    
+    J.add_matrix(m_d, dof_indices);
+}
+
+
+
+void
+MAST::ElementScatter::add_vector(const libMesh::DofMap& dof_map,
+                                 const MAST::ElementScatter::Layout& layout,
+                                 const RealVectorX& v,
+                                 libMesh::NumericVector<Real>& R) {
+    
+    libmesh_assert_equal_to(v.size(), layout.dof_indices.size());
+    
+    if (!layout.constrained) {
+        
+        R.add_vector(v.data(), layout.dof_indices);
+        return;
+    }
+    
+    std::vector<libMesh::dof_id_type> dof_indices = layout.dof_indices;
+    
+    DenseRealVector v_d;
+    MAST::copy(v_d, v);
+    
+    {
+        MAST::PerformanceScope perf("ElementScatter::constrain");
+        dof_map.constrain_element_vector(v_d, dof_indices);
+    }
+    
+    R.add_vector(v_d, dof_indices);
+}
+
+
+
+bool
+MAST::ElementScatter::
+_add_unconstrained_matrix(const MAST::ElementScatter::Layout& layout,
+                          const RealMatrixX& m,
+                          libMesh::SparseMatrix<Real>& J) {
+    
+    libMesh::PetscMatrix<Real>
+    *J_petsc = dynamic_cast<libMesh::PetscMatrix<Real>*>(&J);
+    
+    if (!J_petsc)
+        return false;
+    
+    if (!layout.petsc_dof_indices.size())
+        return true;
+    
+    Mat
+    mat = J_petsc->mat();
+    
+    const PetscInt
+    n   = (PetscInt)layout.petsc_dof_indices.size();
+    
+    PetscErrorCode
+    ierr = 0;
+    
+    // the Eigen matrix is stored column-major, which is communicated to
+    // PETSc so that the values are added without a transposed copy.
+    ierr = MatSetOption(mat, MAT_ROW_ORIENTED, PETSC_FALSE);
+    CHKERRABORT(J.comm().get(), ierr);
+    
+    ierr = MatSetValues(mat,
+                        n, &layout.petsc_dof_indices[0],
+                        n, &layout.petsc_dof_indices[0],
+                        m.data(),
+                        ADD_VALUES);
+    CHKERRABORT(J.comm().get(), ierr);
+    
+    ierr = MatSetOption(mat, MAT_ROW_ORIENTED, PETSC_TRUE);
+    CHKERRABORT(J.comm().get(), ierr);
+    
+    return true;
+}
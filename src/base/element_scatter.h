@@ -0,0 +1,167 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2018  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast_element_scatter_h__
+#define __mast_element_scatter_h__
+
+// C++ includes
+#include <map>
+#include <vector>
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+// libMesh includes
+#include "libmesh/elem.h"
+#include "libmesh/dof_map.h"
+#include "libmesh/numeric_vector.h"
+#include "libmesh/sparse_matrix.h"
+
+// PETSc includes
+#include <petscmat.h>
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class NonlinearSystem;
+    
+    /*!
+     *   Adds element vectors and matrices stored in Eigen data-structures
+     *   to the global vectors and matrices. The dof indices of each element,
+     *   and whether any of them is constrained, are computed once and
+     *   stored. Element quantities of elements without constrained dofs
+     *   are added directly from the Eigen storage, without the copy to
+     *   libMesh::DenseMatrix and the constraint application. Quantities
+     *   of elements with constrained dofs are constrained by the
+     *   libMesh::DofMap before being added.
+     *
+     *   The stored data is discarded by init() if the dofs of the system
+     *   have been redistributed, which is identified by the dof revision of
+     *   MAST::NonlinearSystem, or if the number of dofs, constraints or the
+     *   local dof range of the DofMap changes.
+     */
+    class ElementScatter {
+        
+    public:
+        
+        /*!
+         *   dof indices of an element
+         */
+        struct Layout {
+            std::vector<libMesh::dof_id_type>   dof_indices;
+            std::vector<PetscInt>               petsc_dof_indices;
+            bool                                constrained;
+        };
+        
+        ElementScatter();
+        
+        virtual ~ElementScatter();
+        
+        /*!
+         *   removes all stored data
+         */
+        void clear();
+        
+        /*!
+         *   prepares the object for the element loop of an assembly of
+         *   \p sys. The stored layouts are discarded if the dofs of \p sys
+         *   have been redistributed since the last call. This must be
+         *   called on all processors.
+         */
+        void init(const MAST::NonlinearSystem& sys);
+        
+        /*!
+         *   @returns the layout of \p elem for the dofs in \p dof_map. The
+         *   returned reference remains valid until clear() is called or
+         *   init() detects a change in the DofMap.
+         */
+        const MAST::ElementScatter::Layout&
+        layout(const libMesh::DofMap& dof_map, const libMesh::Elem& elem);
+        
+        /*!
+         *   @returns a counter that is incremented each time the stored
+         *   layouts are discarded. References returned by layout() before
+         *   a change in this value are no longer valid.
+         */
+        unsigned int revision() const { return _revision; }
+        
+        /*!
+         *   adds \p v to \p R and \p m to \p J for the element with
+         *   \p layout. Either of \p R or \p J can be \p nullptr, in which case
+         *   the corresponding element quantity is not used.
+         */
+        void add(const libMesh::DofMap& dof_map,
+                 const MAST::ElementScatter::Layout& layout,
+                 const RealVectorX& v,
+                 const RealMatrixX& m,
+                 libMesh::NumericVector<Real>* R,
+                 libMesh::SparseMatrix<Real>*  J);
+        
+        /*!
+         *   adds \p m to \p J for the element with \p layout.
+         */
+        void add_matrix(const libMesh::DofMap& dof_map,
+                        const MAST::ElementScatter::Layout& layout,
+                        const RealMatrixX& m,
+                        libMesh::SparseMatrix<Real>& J);
+        
+        /*!
+         *   adds \p v to \p R for the element with \p layout.
+         */
+        void add_vector(const libMesh::DofMap& dof_map,
+                        const MAST::ElementScatter::Layout& layout,
+                        const RealVectorX& v,
+                        libMesh::NumericVector<Real>& R);
+        
+    protected:
+        
+        /*!
+         *   adds \p m to \p J without constraints. @returns false if
+         *   \p J is not a PETSc matrix.
+         */
+        bool _add_unconstrained_matrix(const MAST::ElementScatter::Layout& layout,
+                                       const RealMatrixX& m,
+                                       libMesh::SparseMatrix<Real>& J);
+        
+        /*!
+         *   DofMap for which the layouts are stored, the dof revision of
+         *   its system, and its number of dofs, constraints and local
+         *   dof range
+         */
+        const libMesh::DofMap*                                      _dof_map;
+        unsigned int                                                _dof_revision;
+        libMesh::dof_id_type                                        _n_dofs;
+        libMesh::dof_id_type                                        _n_constrained_dofs;
+        libMesh::dof_id_type                                        _first_dof;
+        libMesh::dof_id_type                                        _end_dof;
+        
+        /*!
+         *   number of times the stored layouts have been discarded
+         */
+        unsigned int                                                _revision;
+        
+        /*!
+         *   map of element id to its layout
+         */
+        std::map<libMesh::dof_id_type, MAST::ElementScatter::Layout> _layouts;
+    };
+}
+
+#endif // __mast_element_scatter_h__
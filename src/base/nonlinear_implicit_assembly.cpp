@@ -17,6 +17,9 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+// C++ includes
+#include <algorithm>
+
 // MAST includes
 #include "base/nonlinear_implicit_assembly.h"
 #include "base/system_initialization.h"
@@ -24,21 +27,74 @@
 #include "base/mesh_field_function.h"
 #include "base/nonlinear_system.h"
 #include "base/nonlinear_implicit_assembly_elem_operations.h"
+#include "base/output_assembly_elem_operations.h"
+#include "base/element_scatter.h"
 #include "numerics/utility.h"
+#include "base/performance_counters.h"
 
 // libMesh includes
+#include "libmesh/libmesh.h"
 #include "libmesh/nonlinear_solver.h"
 #include "libmesh/numeric_vector.h"
 #include "libmesh/sparse_matrix.h"
 #include "libmesh/dof_map.h"
+#include "libmesh/threads.h"
+#include "libmesh/stored_range.h"
+
+
+// number of elements processed by each thread between scatters to the
+// global data-structures. This bounds the storage of element quantities.
+static const unsigned int
+__mast_n_elems_per_thread_batch = 64;
+
+
+//---------------------------------------------------------------
+// range and body for the threaded element loop. Each entry in the range
+// is the index of an element operations object, which processes a
+// contiguous block of elements in the current batch.
+typedef libMesh::StoredRange<std::vector<unsigned int>::const_iterator, unsigned int>
+__mast_thread_ops_range;
+
+
+struct
+__mast_thread_elem_loop_body {
+    
+    unsigned int                                                       n_elems;
+    std::vector<MAST::NonlinearImplicitAssemblyElemOperations*>*       ops;
+    const std::function<void(MAST::NonlinearImplicitAssemblyElemOperations&,
+                             unsigned int)>*                           f;
+    
+    void operator() (const __mast_thread_ops_range& range) const {
+        
+        const unsigned int
+        n_ops    = (unsigned int)ops->size(),
+        n_block  = (n_elems + n_ops - 1)/n_ops;
+        
+        for (__mast_thread_ops_range::const_iterator it = range.begin();
+             it != range.end(); it++) {
+            
+            const unsigned int
+            i_ops  = *it,
+            begin  = std::min(i_ops*n_block, n_elems),
+            end    = std::min(begin+n_block, n_elems);
+            
+            for (unsigned int i=begin; i<end; i++)
+                (*f)(*(*ops)[i_ops], i);
+        }
+    }
+};
+//---------------------------------------------------------------
 
 
 
 MAST::NonlinearImplicitAssembly::
 NonlinearImplicitAssembly():MAST::AssemblyBase(),
+_n_threads               (libMesh::n_threads()),
 _post_assembly           (nullptr),
 _res_l2_norm             (0.),
-_first_iter_res_l2_norm  (-1.) {
+_first_iter_res_l2_norm  (-1.),
+_lin_jac_scatter_revision(0),
+_lin_jac_dof_revision    (0) {
     
 }
 
@@ -59,6 +115,90 @@ set_post_assembly_operation(MAST::NonlinearImplicitAssembly::PostAssemblyOperati
 
 
 
+void
+MAST::NonlinearImplicitAssembly::set_n_threads(unsigned int n) {
+    
+    libmesh_assert_greater(n, 0);
+    
+    // more element operations objects than threads in the libMesh
+    // thread pool do not run concurrently
+    if (n > libMesh::n_threads())
+        libmesh_error_msg("Number of assembly threads: " << n
+                          << " exceeds libMesh::n_threads(): " << libMesh::n_threads()
+                          << ". Use --n_threads to increase the libMesh thread count.");
+    
+    _n_threads = n;
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+_init_thread_elem_ops(std::vector<MAST::NonlinearImplicitAssemblyElemOperations*>& ops,
+                      std::vector<std::unique_ptr<MAST::NonlinearImplicitAssemblyElemOperations>>& clones) {
+    
+    libmesh_assert(_elem_ops);
+    
+    ops.clear();
+    clones.clear();
+    
+    ops.push_back(&dynamic_cast<MAST::NonlinearImplicitAssemblyElemOperations&>(*_elem_ops));
+    
+    for (unsigned int i=1; i<_n_threads; i++) {
+        
+        std::unique_ptr<MAST::NonlinearImplicitAssemblyElemOperations>
+        c = ops[0]->clone();
+        
+        // if the object cannot be cloned then the serial loop is used
+        if (!c.get()) {
+            clones.clear();
+            ops.resize(1);
+            return;
+        }
+        
+        ops.push_back(c.get());
+        clones.push_back(std::move(c));
+    }
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+_thread_elem_loop(unsigned int n_elems,
+                  std::vector<MAST::NonlinearImplicitAssemblyElemOperations*>& ops,
+                  const MAST::NonlinearImplicitAssembly::ElemFunction& f) {
+    
+    libmesh_assert(ops.size());
+    
+    if (ops.size() == 1) {
+        
+        for (unsigned int i=0; i<n_elems; i++)
+            f(*ops[0], i);
+        return;
+    }
+    
+    std::vector<unsigned int>
+    ops_ids(ops.size());
+    for (unsigned int i=0; i<ops.size(); i++)
+        ops_ids[i] = i;
+    
+    __mast_thread_elem_loop_body
+    body;
+    body.n_elems = n_elems;
+    body.ops     = &ops;
+    body.f       = &f;
+    
+    // grainsize of one so that each element operations object is
+    // processed as an independent task
+    libMesh::Threads::parallel_for(__mast_thread_ops_range(ops_ids.begin(),
+                                                           ops_ids.end(),
+                                                           1),
+                                   body);
+}
+
+
+
 void
 MAST::NonlinearImplicitAssembly::
 residual_and_jacobian (const libMesh::NumericVector<Real>& X,
@@ -66,6 +206,8 @@ residual_and_jacobian (const libMesh::NumericVector<Real>& X,
                        libMesh::SparseMatrix<Real>*  J,
                        libMesh::NonlinearImplicitSystem& S) {
     
+    MAST::PerformanceScope perf("NonlinearImplicitAssembly::residual_and_jacobian");
+    
     libmesh_assert(_system);
     libmesh_assert(_discipline);
     libmesh_assert(_elem_ops);
@@ -81,16 +223,18 @@ residual_and_jacobian (const libMesh::NumericVector<Real>& X,
     
     // iterate over each element, initialize it and get the relevant
     // analysis quantities
-    RealVectorX vec, sol;
-    RealMatrixX mat;
-    
-    std::vector<libMesh::dof_id_type> dof_indices;
     const libMesh::DofMap& dof_map = _system->system().get_dof_map();
+    _elem_scatter->init(_system->system());
     
     
     std::unique_ptr<libMesh::NumericVector<Real> > localized_solution;
-    localized_solution.reset(build_localized_vector(nonlin_sys,
-                                                     X).release());
+    {
+        MAST::PerformanceScope
+        perf_loc("NonlinearImplicitAssembly::residual_and_jacobian::localize");
+        localized_solution.reset(build_localized_vector(nonlin_sys,
+                                                         X).release());
+        perf_loc.add_bytes(localized_solution->size()*sizeof(Real));
+    }
     
     
     // if a solution function is attached, initialize it
@@ -103,62 +247,81 @@ residual_and_jacobian (const libMesh::NumericVector<Real>& X,
     const libMesh::MeshBase::const_element_iterator end_el =
     nonlin_sys.get_mesh().active_local_elements_end();
     
-    MAST::NonlinearImplicitAssemblyElemOperations&
-    ops = dynamic_cast<MAST::NonlinearImplicitAssemblyElemOperations&>(*_elem_ops);
+    std::vector<MAST::NonlinearImplicitAssemblyElemOperations*> ops;
+    std::vector<std::unique_ptr<MAST::NonlinearImplicitAssemblyElemOperations>> clones;
+    _init_thread_elem_ops(ops, clones);
 
-    for ( ; el != end_el; ++el) {
-        
-        const libMesh::Elem* elem = *el;
-        
-        dof_map.dof_indices (elem, dof_indices);
-        
-        ops.init(*elem);
+    // element quantities for the current batch of elements
+    const unsigned int
+    n_batch = (unsigned int)ops.size() * __mast_n_elems_per_thread_batch;
+    
+    std::vector<const libMesh::Elem*>                   elems;
+    std::vector<const MAST::ElementScatter::Layout*>    layouts(n_batch, nullptr);
+    std::vector<RealVectorX>                            sols(n_batch), vecs(n_batch);
+    std::vector<RealMatrixX>                            mats(n_batch);
+    
+    const bool if_jac = J!=nullptr?true:false;
+    
+    // perform the element level calculations
+    MAST::NonlinearImplicitAssembly::ElemFunction
+    elem_func = [&] (MAST::NonlinearImplicitAssemblyElemOperations& elem_ops,
+                     unsigned int i) {
         
-        // get the solution
-        unsigned int ndofs = (unsigned int)dof_indices.size();
-        sol.setZero(ndofs);
-        vec.setZero(ndofs);
-        mat.setZero(ndofs, ndofs);
+        const unsigned int ndofs = (unsigned int)layouts[i]->dof_indices.size();
         
-        for (unsigned int i=0; i<dof_indices.size(); i++)
-            sol(i) = (*localized_solution)(dof_indices[i]);
+        elem_ops.init(*elems[i]);
         
-        ops.set_elem_solution(sol);
+        vecs[i].setZero(ndofs);
+        mats[i].setZero(ndofs, ndofs);
         
+        elem_ops.set_elem_solution(sols[i]);
         
 //        if (_sol_function)
 //            physics_elem->attach_active_solution_function(*_sol_function);
         
         //_check_element_numerical_jacobian(*physics_elem, sol);
         
-        // perform the element level calculations
-        ops.elem_calculations(J!=nullptr?true:false,
-                                              vec, mat);
+        elem_ops.elem_calculations(if_jac, vecs[i], mats[i]);
         
 //        physics_elem->detach_active_solution_function();
 
-        ops.clear_elem();
+        elem_ops.clear_elem();
+    };
+    
+    while (el != end_el) {
         
-        // copy to the libMesh matrix for further processing
-        DenseRealVector v;
-        DenseRealMatrix m;
-        if (R)
-            MAST::copy(v, vec);
-        if (J)
-            MAST::copy(m, mat);
-
-        // constrain the quantities to account for hanging dofs,
-        // Dirichlet constraints, etc.
-        if (R && J)
-            dof_map.constrain_element_matrix_and_vector(m, v, dof_indices);
-        else if (R)
-            dof_map.constrain_element_vector(v, dof_indices);
-        else
-            dof_map.constrain_element_matrix(m, dof_indices);
+        elems.clear();
+        for ( ; el != end_el && elems.size() < n_batch; ++el)
+            elems.push_back(*el);
         
-        // add to the global matrices
-        if (R) R->add_vector(v, dof_indices);
-        if (J) J->add_matrix(m, dof_indices);
+        // get the solution for each element in the batch
+        for (unsigned int i=0; i<elems.size(); i++) {
+            
+            layouts[i] = &_elem_scatter->layout(dof_map, *elems[i]);
+            
+            const std::vector<libMesh::dof_id_type>&
+            dof_indices = layouts[i]->dof_indices;
+            
+            unsigned int ndofs = (unsigned int)dof_indices.size();
+            sols[i].setZero(ndofs);
+            
+            for (unsigned int j=0; j<ndofs; j++)
+                sols[i](j) = (*localized_solution)(dof_indices[j]);
+        }
+        
+        {
+            MAST::PerformanceScope
+            perf_elem("NonlinearImplicitAssembly::residual_and_jacobian::elem_calculations");
+            perf_elem.add_elements(elems.size());
+            _thread_elem_loop((unsigned int)elems.size(), ops, elem_func);
+        }
+        
+        // constrain the quantities to account for hanging dofs,
+        // Dirichlet constraints, etc. and add to the global matrices
+        MAST::PerformanceScope
+        perf_scatter("NonlinearImplicitAssembly::residual_and_jacobian::scatter");
+        for (unsigned int i=0; i<elems.size(); i++)
+            _elem_scatter->add(dof_map, *layouts[i], vecs[i], mats[i], R, J);
     }
     
     // call the post assembly object, if provided by user
@@ -170,6 +333,9 @@ residual_and_jacobian (const libMesh::NumericVector<Real>& X,
     if (_sol_function)
         _sol_function->clear();
     
+    MAST::PerformanceScope
+    perf_close("NonlinearImplicitAssembly::residual_and_jacobian::close");
+    
     if (R) {
         
         R->close();
@@ -190,6 +356,8 @@ linearized_jacobian_solution_product (const libMesh::NumericVector<Real>& X,
                                       libMesh::NumericVector<Real>& JdX,
                                       libMesh::NonlinearImplicitSystem& S) {
     
+    MAST::PerformanceScope perf("NonlinearImplicitAssembly::linearized_jacobian_solution_product");
+    
     libmesh_assert(_system);
     libmesh_assert(_discipline);
     libmesh_assert(_elem_ops);
@@ -205,11 +373,8 @@ linearized_jacobian_solution_product (const libMesh::NumericVector<Real>& X,
     
     // iterate over each element, initialize it and get the relevant
     // analysis quantities
-    RealVectorX vec, sol, dsol;
-    RealMatrixX mat;
-    
-    std::vector<libMesh::dof_id_type> dof_indices;
     const libMesh::DofMap& dof_map = _system->system().get_dof_map();
+    _elem_scatter->init(_system->system());
     
     
     std::unique_ptr<libMesh::NumericVector<Real> >
@@ -220,6 +385,7 @@ linearized_jacobian_solution_product (const libMesh::NumericVector<Real>& X,
                                                      X).release());
     localized_perturbed_solution.reset(build_localized_vector(nonlin_sys,
                                                                dX).release());
+    perf.add_bytes(2*localized_solution->size()*sizeof(Real));
     
     
     // if a solution function is attached, initialize it
@@ -232,55 +398,266 @@ linearized_jacobian_solution_product (const libMesh::NumericVector<Real>& X,
     const libMesh::MeshBase::const_element_iterator end_el =
     nonlin_sys.get_mesh().active_local_elements_end();
     
-    MAST::NonlinearImplicitAssemblyElemOperations&
-    ops = dynamic_cast<MAST::NonlinearImplicitAssemblyElemOperations&>(*_elem_ops);
-
-    for ( ; el != end_el; ++el) {
+    std::vector<MAST::NonlinearImplicitAssemblyElemOperations*> ops;
+    std::vector<std::unique_ptr<MAST::NonlinearImplicitAssemblyElemOperations>> clones;
+    _init_thread_elem_ops(ops, clones);
+    
+    // element quantities for the current batch of elements
+    const unsigned int
+    n_batch = (unsigned int)ops.size() * __mast_n_elems_per_thread_batch;
+    
+    std::vector<const libMesh::Elem*>                   elems;
+    std::vector<const MAST::ElementScatter::Layout*>    layouts(n_batch, nullptr);
+    std::vector<RealVectorX>                            sols(n_batch), dsols(n_batch), vecs(n_batch);
+    
+    // perform the element level calculations
+    MAST::NonlinearImplicitAssembly::ElemFunction
+    elem_func = [&] (MAST::NonlinearImplicitAssemblyElemOperations& elem_ops,
+                     unsigned int i) {
         
-        const libMesh::Elem* elem = *el;
+        elem_ops.init(*elems[i]);
         
-        dof_map.dof_indices (elem, dof_indices);
+        vecs[i].setZero(layouts[i]->dof_indices.size());
         
-        ops.init(*elem);
+        elem_ops.set_elem_solution(sols[i]);
+        elem_ops.set_elem_perturbed_solution(dsols[i]);
         
-        // get the solution
-        unsigned int ndofs = (unsigned int)dof_indices.size();
-        sol.setZero(ndofs);
-        dsol.setZero(ndofs);
-        vec.setZero(ndofs);
-        mat.setZero(ndofs, ndofs);
+//        if (_sol_function)
+//            physics_elem->attach_active_solution_function(*_sol_function);
         
-        for (unsigned int i=0; i<dof_indices.size(); i++) {
-            sol (i) = (*localized_solution)          (dof_indices[i]);
-            dsol(i) = (*localized_perturbed_solution)(dof_indices[i]);
+        elem_ops.elem_linearized_jacobian_solution_product(vecs[i]);
+        
+        //physics_elem->detach_active_solution_function();
+        elem_ops.clear_elem();
+    };
+
+    while (el != end_el) {
+        
+        elems.clear();
+        for ( ; el != end_el && elems.size() < n_batch; ++el)
+            elems.push_back(*el);
+        
+        // get the solution for each element in the batch
+        for (unsigned int i=0; i<elems.size(); i++) {
+            
+            layouts[i] = &_elem_scatter->layout(dof_map, *elems[i]);
+            
+            const std::vector<libMesh::dof_id_type>&
+            dof_indices = layouts[i]->dof_indices;
+            
+            unsigned int ndofs = (unsigned int)dof_indices.size();
+            sols [i].setZero(ndofs);
+            dsols[i].setZero(ndofs);
+            
+            for (unsigned int j=0; j<ndofs; j++) {
+                sols [i](j) = (*localized_solution)          (dof_indices[j]);
+                dsols[i](j) = (*localized_perturbed_solution)(dof_indices[j]);
+            }
         }
         
-        ops.set_elem_solution(sol);
-        ops.set_elem_perturbed_solution(dsol);
+        _thread_elem_loop((unsigned int)elems.size(), ops, elem_func);
         
-//        if (_sol_function)
-//            physics_elem->attach_active_solution_function(*_sol_function);
+        // constrain the quantities to account for hanging dofs,
+        // Dirichlet constraints, etc. and add to the global vector
+        for (unsigned int i=0; i<elems.size(); i++)
+            _elem_scatter->add_vector(dof_map, *layouts[i], vecs[i], JdX);
+    }
+    
+    
+    // if a solution function is attached, clear it
+    if (_sol_function)
+        _sol_function->clear();
+    
+    JdX.close();
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+init_linearized_jacobian_cache(const libMesh::NumericVector<Real>& X) {
+    
+    MAST::PerformanceScope perf("NonlinearImplicitAssembly::init_linearized_jacobian_cache");
+    
+    libmesh_assert(_system);
+    
+    this->clear_linearized_jacobian_cache();
+    
+    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    
+    const libMesh::DofMap& dof_map = nonlin_sys.get_dof_map();
+    _elem_scatter->init(nonlin_sys);
+    
+    std::unique_ptr<libMesh::NumericVector<Real> >
+    localized_solution(build_localized_vector(nonlin_sys, X).release());
+    
+    // the copy of the solution is used to initialize the solution function,
+    // if one is attached.
+    _lin_jac_X.reset(X.clone().release());
+    perf.add_bytes((localized_solution->size() + X.local_size())*sizeof(Real));
+    
+    libMesh::MeshBase::const_element_iterator       el     =
+    nonlin_sys.get_mesh().active_local_elements_begin();
+    const libMesh::MeshBase::const_element_iterator end_el =
+    nonlin_sys.get_mesh().active_local_elements_end();
+    
+    for ( ; el != end_el; ++el)
+        _lin_jac_elems.push_back(*el);
+    
+    _lin_jac_layouts.resize(_lin_jac_elems.size());
+    _lin_jac_sols.resize(_lin_jac_elems.size());
+    
+    for (unsigned int i=0; i<_lin_jac_elems.size(); i++) {
         
-        //_check_element_numerical_jacobian(*physics_elem, sol);
+        _lin_jac_layouts[i] = &_elem_scatter->layout(dof_map, *_lin_jac_elems[i]);
         
-        // perform the element level calculations
-        ops.elem_linearized_jacobian_solution_product(vec);
+        const std::vector<libMesh::dof_id_type>&
+        dof_indices = _lin_jac_layouts[i]->dof_indices;
         
-        //physics_elem->detach_active_solution_function();
-        ops.clear_elem();
+        unsigned int ndofs = (unsigned int)dof_indices.size();
+        _lin_jac_sols[i].setZero(ndofs);
+        
+        for (unsigned int j=0; j<ndofs; j++)
+            _lin_jac_sols[i](j) = (*localized_solution)(dof_indices[j]);
+        
+        perf.add_bytes(ndofs*sizeof(Real));
+    }
+    
+    // the thread clones of the element operations object are reused by
+    // all products about this solution
+    _init_thread_elem_ops(_lin_jac_ops, _lin_jac_clones);
+    
+    _lin_jac_scatter_revision = _elem_scatter->revision();
+    _lin_jac_dof_revision     = nonlin_sys.dof_revision();
+}
 
-        // copy to the libMesh matrix for further processing
-        DenseRealVector v;
-        MAST::copy(v, vec);
+
+
+bool
+MAST::NonlinearImplicitAssembly::if_linearized_jacobian_cache_initialized() const {
+    
+    return (_lin_jac_X.get() != nullptr                                  &&
+            _lin_jac_dof_revision     == _system->system().dof_revision() &&
+            _lin_jac_scatter_revision == _elem_scatter->revision());
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::clear_linearized_jacobian_cache() {
+    
+    _lin_jac_X.reset();
+    _lin_jac_elems.clear();
+    _lin_jac_layouts.clear();
+    _lin_jac_sols.clear();
+    _lin_jac_ops.clear();
+    _lin_jac_clones.clear();
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+cached_linearized_jacobian_solution_product (const libMesh::NumericVector<Real>& dX,
+                                             libMesh::NumericVector<Real>& JdX) {
+    
+    MAST::PerformanceScope perf("NonlinearImplicitAssembly::cached_linearized_jacobian_solution_product");
+    
+    libmesh_assert(_system);
+    libmesh_assert(_discipline);
+    libmesh_assert(_elem_ops);
+    libmesh_assert(_lin_jac_X.get());
+    
+    // zero the solution vector
+    JdX.zero();
+    
+    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    
+    const libMesh::DofMap& dof_map = nonlin_sys.get_dof_map();
+    
+    // the linearization point is stored in the dof numbering at the time
+    // the cache was initialized, and cannot be used after the dofs are
+    // redistributed.
+    if (_lin_jac_dof_revision != nonlin_sys.dof_revision())
+        libmesh_error_msg("Dofs redistributed after init_linearized_jacobian_cache()");
+    
+    // the stored layouts are discarded if the scatter was cleared since
+    // the cache was initialized. The cache is then rebuilt about the same
+    // solution.
+    _elem_scatter->init(nonlin_sys);
+    
+    if (_lin_jac_scatter_revision != _elem_scatter->revision()) {
         
-        // constrain the quantities to account for hanging dofs,
-        // Dirichlet constraints, etc.
-        dof_map.constrain_element_vector(v, dof_indices);
+        std::unique_ptr<libMesh::NumericVector<Real>>
+        X(_lin_jac_X.release());
         
-        // add to the global matrices
-        JdX.add_vector(v, dof_indices);
+        this->init_linearized_jacobian_cache(*X);
     }
     
+    std::unique_ptr<libMesh::NumericVector<Real> >
+    localized_perturbed_solution(build_localized_vector(nonlin_sys,
+                                                        dX).release());
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function)
+        _sol_function->init(*_lin_jac_X);
+    
+    // the element operations objects are cloned once for the cache
+    std::vector<MAST::NonlinearImplicitAssemblyElemOperations*>&
+    ops = _lin_jac_ops;
+    libmesh_assert(ops.size());
+    
+    // element quantities for the current batch of elements
+    const unsigned int
+    n_elems = (unsigned int)_lin_jac_elems.size(),
+    n_batch = (unsigned int)ops.size() * __mast_n_elems_per_thread_batch;
+    
+    unsigned int
+    first = 0;
+    
+    std::vector<RealVectorX>                            dsols(n_batch), vecs(n_batch);
+    
+    // perform the element level calculations
+    MAST::NonlinearImplicitAssembly::ElemFunction
+    elem_func = [&] (MAST::NonlinearImplicitAssemblyElemOperations& elem_ops,
+                     unsigned int i) {
+        
+        elem_ops.init(*_lin_jac_elems[first+i]);
+        
+        vecs[i].setZero(_lin_jac_layouts[first+i]->dof_indices.size());
+        
+        elem_ops.set_elem_solution(_lin_jac_sols[first+i]);
+        elem_ops.set_elem_perturbed_solution(dsols[i]);
+        
+        elem_ops.elem_linearized_jacobian_solution_product(vecs[i]);
+        
+        elem_ops.clear_elem();
+    };
+    
+    for ( ; first < n_elems; first += n_batch) {
+        
+        const unsigned int
+        n = std::min(n_batch, n_elems-first);
+        
+        // get the perturbed solution for each element in the batch
+        for (unsigned int i=0; i<n; i++) {
+            
+            const std::vector<libMesh::dof_id_type>&
+            dofs = _lin_jac_layouts[first+i]->dof_indices;
+            
+            dsols[i].setZero(dofs.size());
+            
+            for (unsigned int j=0; j<dofs.size(); j++)
+                dsols[i](j) = (*localized_perturbed_solution)(dofs[j]);
+        }
+        
+        _thread_elem_loop(n, ops, elem_func);
+        
+        // constrain the quantities to account for hanging dofs,
+        // Dirichlet constraints, etc. and add to the global vector
+        for (unsigned int i=0; i<n; i++)
+            _elem_scatter->add_vector(dof_map, *_lin_jac_layouts[first+i], vecs[i], JdX);
+    }
     
     // if a solution function is attached, clear it
     if (_sol_function)
@@ -298,6 +675,8 @@ second_derivative_dot_solution_assembly (const libMesh::NumericVector<Real>& X,
                                          libMesh::SparseMatrix<Real>& d_JdX_dX,
                                          libMesh::NonlinearImplicitSystem& S) {
     
+    MAST::PerformanceScope perf("NonlinearImplicitAssembly::second_derivative_dot_solution_assembly");
+    
     libmesh_assert(_system);
     libmesh_assert(_discipline);
     libmesh_assert(_elem_ops);
@@ -328,6 +707,7 @@ second_derivative_dot_solution_assembly (const libMesh::NumericVector<Real>& X,
                                                      X).release());
     localized_perturbed_solution.reset(build_localized_vector(nonlin_sys,
                                                                dX).release());
+    perf.add_bytes(2*localized_solution->size()*sizeof(Real));
     
     
     // if a solution function is attached, initialize it
@@ -403,6 +783,8 @@ MAST::NonlinearImplicitAssembly::
 sensitivity_assemble (const MAST::FunctionBase& f,
                       libMesh::NumericVector<Real>& sensitivity_rhs) {
     
+    MAST::PerformanceScope perf("NonlinearImplicitAssembly::sensitivity_assemble");
+    
     libmesh_assert(_system);
     libmesh_assert(_discipline);
     libmesh_assert(_elem_ops);
@@ -413,9 +795,6 @@ sensitivity_assemble (const MAST::FunctionBase& f,
     
     // iterate over each element, initialize it and get the relevant
     // analysis quantities
-    RealVectorX vec, sol;
-    
-    std::vector<libMesh::dof_id_type> dof_indices;
     const libMesh::DofMap& dof_map = nonlin_sys.get_dof_map();
     
     
@@ -427,59 +806,409 @@ sensitivity_assemble (const MAST::FunctionBase& f,
     if (_sol_function)
         _sol_function->init( *nonlin_sys.solution);
     
+    // only the elements in the support of the parameter are visited
+    std::vector<const libMesh::Elem*> support_elems;
+    _sensitivity_elems(std::vector<const MAST::FunctionBase*>(1, &f), support_elems);
+    
+    std::vector<const libMesh::Elem*>::const_iterator
+    el     = support_elems.begin(),
+    end_el = support_elems.end();
+    
+    std::vector<MAST::NonlinearImplicitAssemblyElemOperations*> ops;
+    std::vector<std::unique_ptr<MAST::NonlinearImplicitAssemblyElemOperations>> clones;
+    _init_thread_elem_ops(ops, clones);
+    
+    // element quantities for the current batch of elements
+    const unsigned int
+    n_batch = (unsigned int)ops.size() * __mast_n_elems_per_thread_batch;
+    
+    std::vector<const libMesh::Elem*>                   elems;
+    std::vector<std::vector<libMesh::dof_id_type> >     elem_dof_indices(n_batch);
+    std::vector<RealVectorX>                            sols(n_batch), vecs(n_batch);
+    
+    // perform the element level calculations
+    MAST::NonlinearImplicitAssembly::ElemFunction
+    elem_func = [&] (MAST::NonlinearImplicitAssemblyElemOperations& elem_ops,
+                     unsigned int i) {
+        
+        elem_ops.init(*elems[i]);
+        
+        vecs[i].setZero(elem_dof_indices[i].size());
+        
+        elem_ops.set_elem_solution(sols[i]);
+        
+//        if (_sol_function)
+//            physics_elem->attach_active_solution_function(*_sol_function);
+        
+        elem_ops.elem_sensitivity_calculations(f, vecs[i]);
+        
+//        physics_elem->detach_active_solution_function();
+        elem_ops.clear_elem();
+    };
+    
+    while (el != end_el) {
+        
+        elems.clear();
+        for ( ; el != end_el && elems.size() < n_batch; ++el)
+            elems.push_back(*el);
+        
+        // get the solution for each element in the batch
+        for (unsigned int i=0; i<elems.size(); i++) {
+            
+            dof_map.dof_indices (elems[i], elem_dof_indices[i]);
+            
+            unsigned int ndofs = (unsigned int)elem_dof_indices[i].size();
+            sols[i].setZero(ndofs);
+            
+            for (unsigned int j=0; j<ndofs; j++)
+                sols[i](j) = (*localized_solution)(elem_dof_indices[i][j]);
+        }
+        
+        _thread_elem_loop((unsigned int)elems.size(), ops, elem_func);
+        
+        for (unsigned int i=0; i<elems.size(); i++) {
+            
+            // copy to the libMesh matrix for further processing
+            DenseRealVector v;
+            MAST::copy(v, vecs[i]);
+            
+            // constrain the quantities to account for hanging dofs,
+            // Dirichlet constraints, etc.
+            dof_map.constrain_element_vector(v, elem_dof_indices[i]);
+            
+            // add to the global matrices
+            sensitivity_rhs.add_vector(v, elem_dof_indices[i]);
+        }
+    }
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function)
+        _sol_function->clear();
+    
+    sensitivity_rhs.close();
+    
+    return true;
+}
+
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+_sensitivity_elem_loop(const libMesh::NumericVector<Real>& X,
+                       const std::vector<const MAST::FunctionBase*>& f,
+                       const MAST::NonlinearImplicitAssembly::SensitivityScatterFunction& scatter) {
+    
+    libmesh_assert(_system);
+    libmesh_assert(_discipline);
+    libmesh_assert(_elem_ops);
+    
+    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    
+    const libMesh::DofMap& dof_map = nonlin_sys.get_dof_map();
+    
+    const unsigned int
+    n_params = (unsigned int)f.size();
+    
+    std::unique_ptr<libMesh::NumericVector<Real> > localized_solution;
+    localized_solution.reset(build_localized_vector(nonlin_sys, X).release());
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function)
+        _sol_function->init(X);
+    
+    // union of the supports of all parameters
+    std::vector<const libMesh::Elem*> support_elems;
+    _sensitivity_elems(f, support_elems);
+    
+    std::vector<const libMesh::Elem*>::const_iterator
+    el     = support_elems.begin(),
+    end_el = support_elems.end();
+    
+    std::vector<MAST::NonlinearImplicitAssemblyElemOperations*> ops;
+    std::vector<std::unique_ptr<MAST::NonlinearImplicitAssemblyElemOperations>> clones;
+    _init_thread_elem_ops(ops, clones);
+    
+    // element quantities for the current batch of elements. An empty
+    // vector identifies a parameter that the element does not depend on.
+    const unsigned int
+    n_batch = (unsigned int)ops.size() * __mast_n_elems_per_thread_batch;
+    
+    std::vector<const libMesh::Elem*>                   elems;
+    std::vector<std::vector<libMesh::dof_id_type> >     elem_dof_indices(n_batch);
+    std::vector<RealVectorX>                            sols(n_batch);
+    std::vector<std::vector<RealVectorX> >              vecs(n_batch,
+                                                             std::vector<RealVectorX>(n_params));
+    
+    // perform the element level calculations for all parameters after a
+    // single initialization of the element
+    MAST::NonlinearImplicitAssembly::ElemFunction
+    elem_func = [&] (MAST::NonlinearImplicitAssemblyElemOperations& elem_ops,
+                     unsigned int i) {
+        
+        elem_ops.init(*elems[i]);
+        elem_ops.set_elem_solution(sols[i]);
+        
+        for (unsigned int j=0; j<n_params; j++) {
+            
+            if (this->_if_elem_in_parameter_support(*f[j], *elems[i]) &&
+                elem_ops.if_elem_depends_on_parameter(*elems[i], *f[j])) {
+                
+                vecs[i][j].setZero(elem_dof_indices[i].size());
+                elem_ops.elem_sensitivity_calculations(*f[j], vecs[i][j]);
+            }
+            else
+                vecs[i][j].resize(0);
+        }
+        
+        elem_ops.clear_elem();
+    };
+    
+    DenseRealVector v;
+    std::vector<libMesh::dof_id_type> dof_indices;
+    
+    while (el != end_el) {
+        
+        elems.clear();
+        for ( ; el != end_el && elems.size() < n_batch; ++el)
+            elems.push_back(*el);
+        
+        // get the solution for each element in the batch
+        for (unsigned int i=0; i<elems.size(); i++) {
+            
+            dof_map.dof_indices (elems[i], elem_dof_indices[i]);
+            
+            unsigned int ndofs = (unsigned int)elem_dof_indices[i].size();
+            sols[i].setZero(ndofs);
+            
+            for (unsigned int j=0; j<ndofs; j++)
+                sols[i](j) = (*localized_solution)(elem_dof_indices[i][j]);
+        }
+        
+        _thread_elem_loop((unsigned int)elems.size(), ops, elem_func);
+        
+        for (unsigned int i=0; i<elems.size(); i++)
+            for (unsigned int j=0; j<n_params; j++) {
+                
+                if (!vecs[i][j].size())
+                    continue;
+                
+                // the constraint may add dofs to the index vector, so a
+                // copy is used for each parameter
+                dof_indices = elem_dof_indices[i];
+                MAST::copy(v, vecs[i][j]);
+                dof_map.constrain_element_vector(v, dof_indices);
+                
+                scatter(j, v, dof_indices);
+            }
+    }
+    
+    // if a solution function is attached, clear it
+    if (_sol_function)
+        _sol_function->clear();
+}
+
+
+
+
+bool
+MAST::NonlinearImplicitAssembly::
+sensitivity_assemble_for_parameters
+(const std::vector<const MAST::FunctionBase*>& f,
+ std::vector<libMesh::NumericVector<Real>*>& sensitivity_rhs) {
+    
+    MAST::PerformanceScope perf("NonlinearImplicitAssembly::sensitivity_assemble_for_parameters");
+    
+    libmesh_assert(_system);
+    libmesh_assert_equal_to(f.size(), sensitivity_rhs.size());
+    
+    for (unsigned int i=0; i<sensitivity_rhs.size(); i++)
+        sensitivity_rhs[i]->zero();
+    
+    MAST::NonlinearImplicitAssembly::SensitivityScatterFunction
+    scatter = [&] (unsigned int i,
+                   const DenseRealVector& v,
+                   const std::vector<libMesh::dof_id_type>& dof_indices) {
+        
+        sensitivity_rhs[i]->add_vector(v, dof_indices);
+    };
+    
+    _sensitivity_elem_loop(*_system->system().solution, f, scatter);
+    
+    for (unsigned int i=0; i<sensitivity_rhs.size(); i++)
+        sensitivity_rhs[i]->close();
+    
+    return true;
+}
+
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+calculate_output_direct_sensitivity_for_parameters
+(const libMesh::NumericVector<Real>& X,
+ const std::vector<const libMesh::NumericVector<Real>*>& dXdp,
+ const std::vector<const MAST::FunctionBase*>& p,
+ MAST::OutputAssemblyElemOperations& output,
+ std::vector<Real>& dq_dp) {
+    
+    MAST::PerformanceScope perf("NonlinearImplicitAssembly::calculate_output_direct_sensitivity_for_parameters");
+    
+    // outputs that accumulate the sensitivity in a single value must be
+    // evaluated one parameter at a time
+    if (!output.if_stores_sensitivity_per_parameter()) {
+        
+        MAST::AssemblyBase::calculate_output_direct_sensitivity_for_parameters(X,
+                                                                               dXdp,
+                                                                               p,
+                                                                               output,
+                                                                               dq_dp);
+        return;
+    }
+    
+    libmesh_assert(_discipline);
+    libmesh_assert(_system);
+    libmesh_assert(dXdp.empty() || dXdp.size() == p.size());
+    
+    output.zero_for_sensitivity();
+    
+    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    output.set_assembly(*this);
+    
+    RealVectorX
+    sol,
+    dsol;
+    
+    std::vector<libMesh::dof_id_type> dof_indices;
+    const libMesh::DofMap& dof_map = nonlin_sys.get_dof_map();
+    
+    std::unique_ptr<libMesh::NumericVector<Real> >
+    localized_solution;
+    localized_solution.reset(build_localized_vector(nonlin_sys,
+                                                    X).release());
+    
+    // solution sensitivity is localized only for parameters that provide it
+    std::vector<std::unique_ptr<libMesh::NumericVector<Real> > >
+    localized_solution_sens(dXdp.size());
+    for (unsigned int i=0; i<dXdp.size(); i++)
+        if (dXdp[i])
+            localized_solution_sens[i].reset(build_localized_vector(nonlin_sys,
+                                                                    *dXdp[i]).release());
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function)
+        _sol_function->init( X);
+    
     libMesh::MeshBase::const_element_iterator       el     =
     nonlin_sys.get_mesh().active_local_elements_begin();
     const libMesh::MeshBase::const_element_iterator end_el =
     nonlin_sys.get_mesh().active_local_elements_end();
     
-    MAST::NonlinearImplicitAssemblyElemOperations&
-    ops = dynamic_cast<MAST::NonlinearImplicitAssemblyElemOperations&>(*_elem_ops);
-
     for ( ; el != end_el; ++el) {
         
         const libMesh::Elem* elem = *el;
         
         dof_map.dof_indices (elem, dof_indices);
         
-        ops.init(*elem);
-        
         // get the solution
         unsigned int ndofs = (unsigned int)dof_indices.size();
         sol.setZero(ndofs);
-        vec.setZero(ndofs);
         
         for (unsigned int i=0; i<dof_indices.size(); i++)
-            sol(i) = (*localized_solution)(dof_indices[i]);
+            sol(i)  = (*localized_solution)(dof_indices[i]);
         
-        ops.set_elem_solution(sol);
-        
-//        if (_sol_function)
-//            physics_elem->attach_active_solution_function(*_sol_function);
-        
-        ops.elem_sensitivity_calculations(f, vec);
+        output.init(*elem);
+        output.set_elem_solution(sol);
         
-//        physics_elem->detach_active_solution_function();
-        ops.clear_elem();
-
-        // copy to the libMesh matrix for further processing
-        DenseRealVector v;
-        MAST::copy(v, vec);
-
-        // constrain the quantities to account for hanging dofs,
-        // Dirichlet constraints, etc.
-        dof_map.constrain_element_vector(v, dof_indices);
+        for (unsigned int j=0; j<p.size(); j++) {
+            
+            dsol.setZero(ndofs);
+            
+            if (j < localized_solution_sens.size() && localized_solution_sens[j])
+                for (unsigned int i=0; i<dof_indices.size(); i++)
+                    dsol(i) = (*localized_solution_sens[j])(dof_indices[i]);
+            
+            output.set_elem_solution_sensitivity(dsol);
+            output.evaluate_sensitivity(*p[j]);
+        }
         
-        // add to the global matrices
-        sensitivity_rhs.add_vector(v, dof_indices);
+        output.clear_elem();
     }
     
-    // if a solution function is attached, initialize it
+    // if a solution function is attached, clear it
     if (_sol_function)
         _sol_function->clear();
     
-    sensitivity_rhs.close();
+    dq_dp.resize(p.size());
+    for (unsigned int j=0; j<p.size(); j++)
+        dq_dp[j] = output.output_sensitivity_total(*p[j]);
     
-    return true;
+    output.clear_assembly();
 }
 
 
+
+
+void
+MAST::NonlinearImplicitAssembly::
+calculate_output_adjoint_sensitivity_for_parameters
+(const libMesh::NumericVector<Real>& X,
+ const libMesh::NumericVector<Real>& dq_dX,
+ const std::vector<const MAST::FunctionBase*>& p,
+ MAST::AssemblyElemOperations&       elem_ops,
+ MAST::OutputAssemblyElemOperations& output,
+ std::vector<Real>& dq_dp,
+ const bool include_partial_sens) {
+    
+    MAST::PerformanceScope perf("NonlinearImplicitAssembly::calculate_output_adjoint_sensitivity_for_parameters");
+    
+    libmesh_assert(_discipline);
+    libmesh_assert(_system);
+    
+    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    
+    dq_dp.assign(p.size(), 0.);
+    
+    std::unique_ptr<libMesh::NumericVector<Real> >
+    localized_adjoint;
+    localized_adjoint.reset(build_localized_vector(nonlin_sys,
+                                                   dq_dX).release());
+    
+    // the product of the adjoint with the sensitivity of the residual is
+    // accumulated from the element vectors, which is the same as the dot
+    // product with the assembled sensitivity vector.
+    MAST::NonlinearImplicitAssembly::SensitivityScatterFunction
+    scatter = [&] (unsigned int i,
+                   const DenseRealVector& v,
+                   const std::vector<libMesh::dof_id_type>& dof_indices) {
+        
+        for (unsigned int j=0; j<dof_indices.size(); j++)
+            dq_dp[i] += v(j) * (*localized_adjoint)(dof_indices[j]);
+    };
+    
+    this->set_elem_operation_object(elem_ops);
+    _sensitivity_elem_loop(X, p, scatter);
+    this->clear_elem_operation_object();
+    
+    nonlin_sys.comm().sum(dq_dp);
+    
+    if (include_partial_sens) {
+        
+        // partial sensitivity of the output, which is calculated with zero
+        // solution sensitivity
+        std::vector<Real>
+        dq_dp_partial;
+        
+        this->calculate_output_direct_sensitivity_for_parameters
+        (X,
+         std::vector<const libMesh::NumericVector<Real>*>(),
+         p,
+         output,
+         dq_dp_partial);
+        
+        for (unsigned int i=0; i<p.size(); i++)
+            dq_dp[i] += dq_dp_partial[i];
+    }
+}
+
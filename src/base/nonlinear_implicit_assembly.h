@@ -20,8 +20,14 @@
 #ifndef __mast__nonlinear_implicit_assembly__
 #define __mast__nonlinear_implicit_assembly__
 
+// C++ includes
+#include <vector>
+#include <memory>
+#include <functional>
+
 // MAST includes
 #include "base/assembly_base.h"
+#include "base/element_scatter.h"
 
 // libMesh includes
 #include "libmesh/nonlinear_implicit_system.h"
@@ -92,6 +98,29 @@ namespace MAST {
         void
         set_post_assembly_operation(MAST::NonlinearImplicitAssembly::PostAssemblyOperation& post);
         
+        /*!
+         *    sets the number of threads used for element calculations in
+         *    residual_and_jacobian(), linearized_jacobian_solution_product()
+         *    and sensitivity_assemble(). Each thread uses its own clone of the
+         *    element operations object, and if the element operations object
+         *    does not provide a clone the serial loop is used. The element
+         *    quantities are added to the global vector and matrix in the same
+         *    order as the serial loop, so the results are independent of the
+         *    number of threads. All user-provided functions used by the
+         *    property cards and loads must support concurrent evaluation.
+         *
+         *    The element operations objects are processed by the libMesh
+         *    thread pool, so \p n cannot exceed \p libMesh::n_threads(),
+         *    which is set with the \p --n_threads command line option. The
+         *    default is \p libMesh::n_threads().
+         */
+        void set_n_threads(unsigned int n);
+        
+        /*!
+         *   @returns the number of threads requested for element calculations
+         */
+        unsigned int n_threads() const { return _n_threads; }
+        
         /*!
          *    function that assembles the matrices and vectors quantities for
          *    nonlinear solution
@@ -117,6 +146,49 @@ namespace MAST {
                                              libMesh::NumericVector<Real>& JdX,
                                              libMesh::NonlinearImplicitSystem& S);
 
+        
+        /*!
+         *    localizes \p X and stores the element solutions of all local
+         *    elements for use in \p cached_linearized_jacobian_solution_product().
+         *    This is intended to be called once per nonlinear iteration, so
+         *    that the repeated products of a Krylov solve do not localize
+         *    the solution or recompute the element dof indices. Any
+         *    previously cached data is replaced.
+         */
+        void
+        init_linearized_jacobian_cache(const libMesh::NumericVector<Real>& X);
+        
+        
+        /*!
+         *   clears the data cached by \p init_linearized_jacobian_cache()
+         */
+        void clear_linearized_jacobian_cache();
+        
+        
+        /*!
+         *   @returns \p true if \p init_linearized_jacobian_cache() has been
+         *   called since the last call to \p clear_linearized_jacobian_cache(),
+         *   the dofs of the system have not since been redistributed, and
+         *   the element dof layouts stored with the cache have not been
+         *   discarded.
+         */
+        bool if_linearized_jacobian_cache_initialized() const;
+        
+        
+        /*!
+         *    calculates \f$ [J] \{\Delta X\}  \f$ about the solution provided
+         *    to \p init_linearized_jacobian_cache(). Only \p dX is localized
+         *    in this method, and the thread clones of the element operations
+         *    object are those created by \p init_linearized_jacobian_cache().
+         *    The element operations are still initialized for each element
+         *    in each product, since these objects hold the data of a single
+         *    element, so the product evaluates the element physics and shape
+         *    functions as \p linearized_jacobian_solution_product() does.
+         */
+        void
+        cached_linearized_jacobian_solution_product(const libMesh::NumericVector<Real>& dX,
+                                                    libMesh::NumericVector<Real>& JdX);
+        
 
         /*!
          *    calculates \f$ d ([J] \{\Delta X\})/ dX  \f$.
@@ -143,9 +215,103 @@ namespace MAST {
         sensitivity_assemble (const MAST::FunctionBase& f,
                               libMesh::NumericVector<Real>& sensitivity_rhs);
         
+        /*!
+         *   assembles the RHS of the sensitivity equations for all parameters
+         *   in \par f in a single pass over the elements. Each element is
+         *   initialized once, and the sensitivity is computed only for the
+         *   parameters that the element depends on.
+         */
+        virtual bool
+        sensitivity_assemble_for_parameters
+        (const std::vector<const MAST::FunctionBase*>& f,
+         std::vector<libMesh::NumericVector<Real>*>& sensitivity_rhs);
+        
+        /*!
+         *   evaluates the output sensitivity for all parameters in \par p
+         *   in a single pass over the elements if the output stores the
+         *   sensitivity separately for each parameter. Otherwise, the
+         *   calculation is performed for one parameter at a time.
+         */
+        virtual void
+        calculate_output_direct_sensitivity_for_parameters
+        (const libMesh::NumericVector<Real>& X,
+         const std::vector<const libMesh::NumericVector<Real>*>& dXdp,
+         const std::vector<const MAST::FunctionBase*>& p,
+         MAST::OutputAssemblyElemOperations& output,
+         std::vector<Real>& dq_dp);
+        
+        /*!
+         *   evaluates the adjoint sensitivity of \par output for all
+         *   parameters in \par p. The product of the adjoint vector with the
+         *   residual sensitivity is computed element-by-element in a single
+         *   pass, so that global sensitivity vectors are not created for
+         *   each parameter.
+         */
+        virtual void
+        calculate_output_adjoint_sensitivity_for_parameters
+        (const libMesh::NumericVector<Real>& X,
+         const libMesh::NumericVector<Real>& dq_dX,
+         const std::vector<const MAST::FunctionBase*>& p,
+         MAST::AssemblyElemOperations&       elem_ops,
+         MAST::OutputAssemblyElemOperations& output,
+         std::vector<Real>& dq_dp,
+         const bool include_partial_sens = true);
+        
     protected:
         
-
+        /*!
+         *   function object called with the index of the parameter, the
+         *   constrained element residual sensitivity and the corresponding
+         *   dof indices.
+         */
+        typedef std::function<void(unsigned int,
+                                   const DenseRealVector&,
+                                   const std::vector<libMesh::dof_id_type>&)>
+        SensitivityScatterFunction;
+        
+        /*!
+         *   computes the element residual sensitivity for each parameter in
+         *   \p f about solution \p X over all local elements and passes the
+         *   constrained element vectors to \p scatter in element order.
+         *   Parameters that an element does not depend on are skipped.
+         */
+        void
+        _sensitivity_elem_loop(const libMesh::NumericVector<Real>& X,
+                               const std::vector<const MAST::FunctionBase*>& f,
+                               const SensitivityScatterFunction& scatter);
+        
+        /*!
+         *   function object called by the threaded element loop with the
+         *   element operations object of the thread and the index of the
+         *   element in the current batch.
+         */
+        typedef std::function<void(MAST::NonlinearImplicitAssemblyElemOperations&,
+                                   unsigned int)> ElemFunction;
+        
+        /*!
+         *   populates \p ops with one element operations object per thread.
+         *   The first entry is always the object attached to this assembly,
+         *   and the remaining are clones owned by \p clones. Only the
+         *   attached object is returned if it cannot be cloned.
+         */
+        void
+        _init_thread_elem_ops(std::vector<MAST::NonlinearImplicitAssemblyElemOperations*>& ops,
+                              std::vector<std::unique_ptr<MAST::NonlinearImplicitAssemblyElemOperations>>& clones);
+        
+        /*!
+         *   calls \p f for each of the \p n_elems elements in the current
+         *   batch, with contiguous blocks of elements distributed over the
+         *   element operation objects in \p ops.
+         */
+        void
+        _thread_elem_loop(unsigned int n_elems,
+                          std::vector<MAST::NonlinearImplicitAssemblyElemOperations*>& ops,
+                          const ElemFunction& f);
+        
+        /*!
+         *   number of threads used for element calculations
+         */
+        unsigned int _n_threads;
         
         /*!
          *    this object, if non-NULL is user-provided to perform actions
@@ -158,6 +324,40 @@ namespace MAST {
          */
         Real _res_l2_norm, _first_iter_res_l2_norm;
         
+        /*!
+         *   solution about which the cached linearized Jacobian products are
+         *   computed. This is \p nullptr if the cache is not initialized.
+         */
+        std::unique_ptr<libMesh::NumericVector<Real>> _lin_jac_X;
+        
+        /*!
+         *   local elements, their dof layouts and element solutions stored
+         *   by \p init_linearized_jacobian_cache()
+         */
+        std::vector<const libMesh::Elem*>                _lin_jac_elems;
+        std::vector<const MAST::ElementScatter::Layout*> _lin_jac_layouts;
+        std::vector<RealVectorX>                         _lin_jac_sols;
+        
+        /*!
+         *   element operations objects, and the clones owned by the cache,
+         *   used by \p cached_linearized_jacobian_solution_product()
+         */
+        std::vector<MAST::NonlinearImplicitAssemblyElemOperations*>                  _lin_jac_ops;
+        std::vector<std::unique_ptr<MAST::NonlinearImplicitAssemblyElemOperations>> _lin_jac_clones;
+        
+        /*!
+         *   revision of \p _elem_scatter when \p _lin_jac_layouts were
+         *   obtained. The layouts are stale if this has changed.
+         */
+        unsigned int                                     _lin_jac_scatter_revision;
+        
+        /*!
+         *   dof revision of the system when the cache was initialized. The
+         *   linearization point stored in \p _lin_jac_X uses the dof
+         *   numbering of this revision.
+         */
+        unsigned int                                     _lin_jac_dof_revision;
+        
     };
 }
 
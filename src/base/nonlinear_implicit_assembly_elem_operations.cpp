@@ -36,6 +36,14 @@ MAST::NonlinearImplicitAssemblyElemOperations::
 
 
 
+std::unique_ptr<MAST::NonlinearImplicitAssemblyElemOperations>
+MAST::NonlinearImplicitAssemblyElemOperations::clone() const {
+    
+    return std::unique_ptr<MAST::NonlinearImplicitAssemblyElemOperations>();
+}
+
+
+
 namespace MAST {
     
     bool
@@ -24,6 +24,9 @@
 #include "base/assembly_elem_operation.h"
 #include "base/mast_data_types.h"
 
+// C++ includes
+#include <memory>
+
 
 namespace MAST {
     
@@ -41,6 +44,18 @@ namespace MAST {
         virtual ~NonlinearImplicitAssemblyElemOperations();
         
         
+        /*!
+         *   @returns a new object of the same type attached to the same
+         *   discipline, system and assembly as \p this. The clone is used
+         *   by the assembly for concurrent element calculations on threads.
+         *   Objects that carry state that cannot be shared across threads
+         *   should return a null pointer, which is the default, in which
+         *   case the assembly uses a serial element loop.
+         */
+        virtual std::unique_ptr<MAST::NonlinearImplicitAssemblyElemOperations>
+        clone() const;
+        
+        
         /*!
          *   performs the element calculations over \par elem, and returns
          *   the element vector and matrix quantities in \par mat and
@@ -32,6 +32,7 @@
 #include "base/parameter.h"
 #include "base/output_assembly_elem_operations.h"
 #include "solver/slepc_eigen_solver.h"
+#include "base/performance_counters.h"
 
 // libMesh includes
 #include "libmesh/numeric_vector.h"
@@ -40,6 +41,8 @@
 #include "libmesh/dof_map.h"
 #include "libmesh/nonlinear_solver.h"
 #include "libmesh/petsc_linear_solver.h"
+#include "libmesh/petsc_vector.h"
+#include "libmesh/petsc_matrix.h"
 #include "libmesh/xdr_cxx.h"
 #include "libmesh/mesh_tools.h"
 #include "libmesh/utility.h"
@@ -49,6 +52,157 @@
 #include "libmesh/fem_context.h"
 
 
+//---------------------------------------------------------------
+// context for the PETSc callbacks of the Jacobian-free Newton-Krylov solve
+struct
+__mast_nonlinear_system_mf_context {
+    MAST::NonlinearSystem*              sys;
+    MAST::NonlinearImplicitAssembly*    assembly;
+};
+
+
+// copies the PETSc solution to the system and enforces the constraints
+// on the localized solution
+void
+__mast_nonlinear_system_mf_update_solution(MAST::NonlinearSystem& sys, Vec x) {
+    
+    libMesh::PetscVector<Real> X_global(x, sys.comm());
+    
+    X_global.swap(*sys.solution);
+    sys.update();
+    X_global.swap(*sys.solution);
+    
+    sys.get_dof_map().enforce_constraints_exactly(sys, sys.current_local_solution.get());
+}
+
+
+
+PetscErrorCode
+__mast_nonlinear_system_mf_mat_mult(Mat mat, Vec dx, Vec y) {
+    
+    LOG_SCOPE("mat_mult()", "MatrixFreeNonlinearSolver");
+    
+    PetscErrorCode ierr=0;
+    
+    libmesh_assert(mat);
+    libmesh_assert(dx);
+    libmesh_assert(y);
+    
+    void * ctx = PETSC_NULL;
+    
+    ierr = MatShellGetContext(mat, &ctx);
+    CHKERRABORT(PetscObjectComm((PetscObject)mat), ierr);
+    
+    __mast_nonlinear_system_mf_context
+    *mf_ctx = static_cast<__mast_nonlinear_system_mf_context*> (ctx);
+    
+    MAST::NonlinearSystem
+    &sys  = *mf_ctx->sys;
+    
+    const libMesh::DofMap& dof_map = sys.get_dof_map();
+    
+    libMesh::PetscVector<Real>
+    dX  (dx, sys.comm()),
+    JdX (y,  sys.comm());
+    
+    // the perturbation is made consistent with the homogeneous constraints
+    // before computing the product. The Krylov vector is not modified.
+    std::unique_ptr<libMesh::NumericVector<Real> >
+    dX_c(dX.clone().release());
+    dof_map.enforce_constraints_exactly(sys, dX_c.get(), true);
+    
+    mf_ctx->assembly->cached_linearized_jacobian_solution_product(*dX_c, JdX);
+    
+    // the constrained rows of the assembled Jacobian are
+    // dX_i - sum_j c_ij dX_j, which is added here so that the shell
+    // matrix is consistent with the preconditioner matrix.
+    for (libMesh::dof_id_type i=dX.first_local_index(); i<dX.last_local_index(); i++)
+        if (dof_map.is_constrained_dof(i))
+            JdX.add(i, dX(i) - (*dX_c)(i));
+    
+    JdX.close();
+    
+    return ierr;
+}
+
+
+
+PetscErrorCode
+__mast_nonlinear_system_mf_snes_residual(SNES snes, Vec x, Vec r, void * ctx) {
+    
+    LOG_SCOPE("residual()", "MatrixFreeNonlinearSolver");
+    
+    PetscErrorCode ierr=0;
+    
+    libmesh_assert(x);
+    libmesh_assert(r);
+    libmesh_assert(ctx);
+    
+    __mast_nonlinear_system_mf_context
+    *mf_ctx = static_cast<__mast_nonlinear_system_mf_context*> (ctx);
+    
+    MAST::NonlinearSystem
+    &sys  = *mf_ctx->sys;
+    
+    __mast_nonlinear_system_mf_update_solution(sys, x);
+    
+    libMesh::PetscVector<Real> R(r, sys.comm());
+    
+    mf_ctx->assembly->residual_and_jacobian(*sys.current_local_solution,
+                                            &R,
+                                            nullptr,
+                                            sys);
+    
+    return ierr;
+}
+
+
+
+PetscErrorCode
+__mast_nonlinear_system_mf_snes_jacobian(SNES snes, Vec x, Mat jac, Mat pc, void * ctx) {
+    
+    LOG_SCOPE("jacobian()", "MatrixFreeNonlinearSolver");
+    
+    PetscErrorCode ierr=0;
+    
+    libmesh_assert(x);
+    libmesh_assert(jac);
+    libmesh_assert(pc);
+    libmesh_assert(ctx);
+    
+    __mast_nonlinear_system_mf_context
+    *mf_ctx = static_cast<__mast_nonlinear_system_mf_context*> (ctx);
+    
+    MAST::NonlinearSystem
+    &sys  = *mf_ctx->sys;
+    
+    __mast_nonlinear_system_mf_update_solution(sys, x);
+    
+    // the linearization is updated once per nonlinear iteration and reused
+    // for all products in the Krylov solve.
+    mf_ctx->assembly->init_linearized_jacobian_cache(*sys.current_local_solution);
+    
+    // the preconditioner matrix is reassembled only on the iterations where
+    // SNES recomputes the preconditioner.
+    PetscInt
+    it = 0;
+    ierr = SNESGetIterationNumber(snes, &it);        CHKERRABORT(sys.comm().get(), ierr);
+    
+    if (it % sys.matrix_free_pc_lag() == 0)
+        mf_ctx->assembly->residual_and_jacobian(*sys.current_local_solution,
+                                                nullptr,
+                                                sys.matrix,
+                                                sys);
+    
+    ierr = MatAssemblyBegin(jac, MAT_FINAL_ASSEMBLY);  CHKERRABORT(sys.comm().get(), ierr);
+    ierr = MatAssemblyEnd(jac, MAT_FINAL_ASSEMBLY);    CHKERRABORT(sys.comm().get(), ierr);
+    
+    return ierr;
+}
+//---------------------------------------------------------------
+
+
+
 MAST::NonlinearSystem::NonlinearSystem(libMesh::EquationSystems& es,
                                        const std::string& name,
                                        const unsigned int number):
@@ -64,6 +218,14 @@ _n_converged_eigenpairs               (0),
 _n_iterations                         (0),
 _is_generalized_eigenproblem          (false),
 _eigen_problem_type                   (libMesh::NHEP),
+_if_matrix_free_jacobian              (false),
+_matrix_free_pc_lag                   (1),
+_if_lagged_jacobian                   (false),
+_if_lagged_jacobian_valid             (false),
+_jacobian_lag                         (0),
+_n_solves_since_jacobian              (0),
+_jacobian_stagnation_ratio            (0.5),
+_dof_revision                         (0),
 _operation                            (MAST::NonlinearSystem::NONE) {
     
 }
@@ -116,6 +278,9 @@ MAST::NonlinearSystem::init_data () {
     // initialize parent data
     libMesh::NonlinearImplicitSystem::init_data();
     
+    // the dofs and constraints have been distributed
+    _dof_revision++;
+    
     // define the type of eigenproblem
     if (_eigen_problem_type == libMesh::GNHEP ||
         _eigen_problem_type == libMesh::GHEP  ||
@@ -165,6 +330,12 @@ void MAST::NonlinearSystem::reinit () {
     // initialize parent data
     libMesh::NonlinearImplicitSystem::reinit();
     
+    // the dofs and constraints may have been redistributed
+    _dof_revision++;
+    
+    // the matrix is reinitialized, so the lagged Jacobian is not available
+    _if_lagged_jacobian_valid = false;
+    
     // Clear the matrices
     matrix_A->clear();
     
@@ -197,6 +368,8 @@ void
 MAST::NonlinearSystem::solve(MAST::AssemblyElemOperations& elem_ops,
                              MAST::AssemblyBase&  assembly) {
     
+    MAST::PerformanceScope perf("NonlinearSystem::solve");
+    
     libmesh_assert(_operation == MAST::NonlinearSystem::NONE);
     
     _operation = MAST::NonlinearSystem::NONLINEAR_SOLVE;
@@ -209,7 +382,23 @@ MAST::NonlinearSystem::solve(MAST::AssemblyElemOperations& elem_ops,
     //if (assembly.get_solver_monitor())
     //    assembly.get_solver_monitor()->init(assembly);
     
-    libMesh::NonlinearImplicitSystem::solve();
+    if (_if_lagged_jacobian)
+        _lagged_jacobian_solve(assembly);
+    else if (_if_matrix_free_jacobian) {
+        
+        MAST::NonlinearImplicitAssembly
+        *nonlin_assembly = dynamic_cast<MAST::NonlinearImplicitAssembly*>(&assembly);
+        
+        if (!nonlin_assembly)
+            libmesh_error_msg("Matrix-free Jacobian requires MAST::NonlinearImplicitAssembly");
+        
+        _matrix_free_solve(*nonlin_assembly);
+    }
+    else {
+        
+        MAST::PerformanceScope perf_snes("NonlinearSystem::solve::snes");
+        libMesh::NonlinearImplicitSystem::solve();
+    }
     
     this->nonlinear_solver->residual_and_jacobian_object = old_ptr;
     
@@ -219,10 +408,282 @@ MAST::NonlinearSystem::solve(MAST::AssemblyElemOperations& elem_ops,
 
 
 
+void
+MAST::NonlinearSystem::set_matrix_free_jacobian(bool flag, unsigned int pc_lag) {
+    
+    libmesh_assert_greater(pc_lag, 0);
+    
+    if (flag && _if_lagged_jacobian)
+        libmesh_error_msg("Matrix-free Jacobian cannot be used with the lagged Jacobian");
+    
+    _if_matrix_free_jacobian = flag;
+    _matrix_free_pc_lag      = pc_lag;
+}
+
+
+
+void
+MAST::NonlinearSystem::set_lagged_jacobian(bool flag,
+                                           unsigned int lag,
+                                           Real stagnation_ratio) {
+    
+    libmesh_assert_greater(stagnation_ratio, 0.);
+    
+    if (flag && _if_matrix_free_jacobian)
+        libmesh_error_msg("Lagged Jacobian cannot be used with the matrix-free Jacobian");
+    
+    _if_lagged_jacobian         = flag;
+    _if_lagged_jacobian_valid   = false;
+    _jacobian_lag               = lag;
+    _n_solves_since_jacobian    = 0;
+    _jacobian_stagnation_ratio  = stagnation_ratio;
+}
+
+
+
+void
+MAST::NonlinearSystem::_lagged_jacobian_solve(MAST::AssemblyBase& assembly) {
+    
+    MAST::PerformanceScope perf("NonlinearSystem::_lagged_jacobian_solve");
+    
+    START_LOG("lagged_jacobian_solve()", "NonlinearSystem");
+    
+    const Real
+    abs_tol  = this->nonlinear_solver->absolute_residual_tolerance,
+    rel_tol  = this->nonlinear_solver->relative_residual_tolerance;
+    
+    const unsigned int
+    max_its  = this->nonlinear_solver->max_nonlinear_iterations;
+    
+    std::pair<unsigned int, Real>
+    solver_params = this->get_linear_solve_parameters();
+    
+    libMesh::SparseMatrix<Real>
+    *pc = this->request_matrix("Preconditioner");
+    
+    std::unique_ptr<libMesh::NumericVector<Real> >
+    dsol(solution->zero_clone().release());
+    
+    // the Jacobian is reassembled at the start of the solve if it is not
+    // available, or if it has been used for the specified number of solves
+    if (_jacobian_lag && _n_solves_since_jacobian >= _jacobian_lag)
+        _if_lagged_jacobian_valid = false;
+    
+    Real
+    res0     = 0.,
+    res_prev = 0.,
+    res      = 0.;
+    
+    bool
+    if_jac_current = false;
+    
+    unsigned int
+    it = 0;
+    
+    this->get_dof_map().enforce_constraints_exactly(*this);
+    this->update();
+    
+    for ( ; it <= max_its; it++) {
+        
+        // the residual is assembled along with the Jacobian only if the
+        // Jacobian needs to be updated
+        bool
+        if_assemble_jac = !_if_lagged_jacobian_valid;
+        
+        assembly.residual_and_jacobian(*current_local_solution,
+                                       rhs,
+                                       if_assemble_jac?matrix:nullptr,
+                                       *this);
+        
+        res = rhs->l2_norm();
+        if (it == 0)
+            res0 = res;
+        
+        libMesh::out
+        << "Lagged Jacobian Newton iter: " << it
+        << " : ||R|| = " << res
+        << (if_assemble_jac?" (Jacobian updated)":"") << std::endl;
+        
+        if (res <= abs_tol || res <= rel_tol * res0 || it == max_its)
+            break;
+        
+        // if the lagged Jacobian does not reduce the residual sufficiently,
+        // then it is reassembled at the current solution
+        if (!if_assemble_jac && !if_jac_current &&
+            it > 0 && res > _jacobian_stagnation_ratio * res_prev) {
+            
+            assembly.residual_and_jacobian(*current_local_solution,
+                                           nullptr,
+                                           matrix,
+                                           *this);
+            if_assemble_jac = true;
+        }
+        
+        if (if_assemble_jac) {
+            
+            _if_lagged_jacobian_valid = true;
+            _n_solves_since_jacobian  = 0;
+        }
+        if_jac_current = if_assemble_jac;
+        
+        // the preconditioner is rebuilt only with the Jacobian
+        this->linear_solver->reuse_preconditioner(!if_assemble_jac);
+        {
+            MAST::PerformanceScope perf_ksp("NonlinearSystem::_lagged_jacobian_solve::ksp");
+            this->linear_solver->solve (*matrix, pc,
+                                        *dsol,
+                                        *rhs,
+                                        solver_params.second,
+                                        solver_params.first);
+        }
+        
+        // The linear solver may not have fit our constraints exactly
+#ifdef LIBMESH_ENABLE_CONSTRAINTS
+        this->get_dof_map().enforce_constraints_exactly(*this, dsol.get(), /* homogeneous = */ true);
+#endif
+        
+        solution->add(-1., *dsol);
+        solution->close();
+        this->update();
+        
+        res_prev = res;
+    }
+    
+    // other solves with the linear solver rebuild the preconditioner
+    this->linear_solver->reuse_preconditioner(false);
+    
+    _n_nonlinear_iterations = it;
+    _n_solves_since_jacobian++;
+    
+    STOP_LOG("lagged_jacobian_solve()", "NonlinearSystem");
+}
+
+
+
+void
+MAST::NonlinearSystem::_matrix_free_solve(MAST::NonlinearImplicitAssembly& assembly) {
+    
+    MAST::PerformanceScope perf("NonlinearSystem::_matrix_free_solve");
+    
+    START_LOG("matrix_free_solve()", "NonlinearSystem");
+    
+    // copy the solver tolerances from the system parameters
+    this->set_solver_parameters();
+    
+    PetscErrorCode   ierr;
+    SNES             snes;
+    Mat              jac;
+    KSP              ksp;
+    
+    __mast_nonlinear_system_mf_context
+    ctx;
+    ctx.sys      = this;
+    ctx.assembly = &assembly;
+    
+    libMesh::PetscVector<Real>
+    &sol  = dynamic_cast<libMesh::PetscVector<Real>&>(*this->solution),
+    &res  = dynamic_cast<libMesh::PetscVector<Real>&>(*this->rhs);
+    libMesh::PetscMatrix<Real>
+    &pc   = dynamic_cast<libMesh::PetscMatrix<Real>&>(*this->matrix);
+    
+    ierr = SNESCreate(this->comm().get(), &snes);      CHKERRABORT(this->comm().get(), ierr);
+    
+    // shell matrix for the Jacobian
+    ierr = MatCreateShell(this->comm().get(),
+                          this->n_local_dofs(),
+                          this->n_local_dofs(),
+                          this->n_dofs(),
+                          this->n_dofs(),
+                          &ctx,
+                          &jac);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    ierr = MatShellSetOperation(jac,
+                                MATOP_MULT,
+                                (void(*)(void))__mast_nonlinear_system_mf_mat_mult);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    // tell the solver where to store the residual and how to calculate
+    // the Jacobian and preconditioner
+    ierr = SNESSetFunction(snes,
+                           res.vec(),
+                           __mast_nonlinear_system_mf_snes_residual,
+                           &ctx);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = SNESSetJacobian(snes,
+                           jac,
+                           pc.mat(),
+                           __mast_nonlinear_system_mf_snes_jacobian,
+                           &ctx);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = SNESSetLagPreconditioner(snes, (PetscInt)_matrix_free_pc_lag);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    ierr = SNESSetTolerances(snes,
+                             this->nonlinear_solver->absolute_residual_tolerance,
+                             this->nonlinear_solver->relative_residual_tolerance,
+                             this->nonlinear_solver->relative_step_tolerance,
+                             this->nonlinear_solver->max_nonlinear_iterations,
+                             this->nonlinear_solver->max_function_evaluations);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    ierr = SNESGetKSP(snes, &ksp);                     CHKERRABORT(this->comm().get(), ierr);
+    ierr = KSPSetTolerances(ksp,
+                            this->nonlinear_solver->initial_linear_tolerance,
+                            PETSC_DEFAULT,
+                            PETSC_DEFAULT,
+                            this->nonlinear_solver->max_linear_iterations);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    if (libMesh::on_command_line("--solver_system_names")) {
+        
+        std::string nm = this->name() + "_";
+        ierr = SNESSetOptionsPrefix(snes, nm.c_str());  CHKERRABORT(this->comm().get(), ierr);
+    }
+    ierr = SNESSetFromOptions(snes);                   CHKERRABORT(this->comm().get(), ierr);
+    
+    // now solve
+    {
+        MAST::PerformanceScope perf_snes("NonlinearSystem::_matrix_free_solve::snes");
+        ierr = SNESSolve(snes, PETSC_NULL, sol.vec()); CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    PetscInt
+    n_iters = 0;
+    ierr = SNESGetIterationNumber(snes, &n_iters);     CHKERRABORT(this->comm().get(), ierr);
+    _n_nonlinear_iterations = n_iters;
+    
+    // report divergence the same way as the libMesh nonlinear solver
+    SNESConvergedReason
+    reason = SNES_CONVERGED_ITERATING;
+    ierr = SNESGetConvergedReason(snes, &reason);      CHKERRABORT(this->comm().get(), ierr);
+    this->nonlinear_solver->converged = (reason > 0);
+    
+    if (reason < 0)
+        libMesh::out
+        << "Warning: matrix-free nonlinear solve diverged: "
+        << SNESConvergedReasons[reason] << std::endl;
+    
+    assembly.clear_linearized_jacobian_cache();
+    
+    // destroy the Petsc contexts
+    ierr = SNESDestroy(&snes);                         CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatDestroy(&jac);                           CHKERRABORT(this->comm().get(), ierr);
+    
+    // update the localized solution
+    this->update();
+    
+    STOP_LOG("matrix_free_solve()", "NonlinearSystem");
+}
+
+
+
 void
 MAST::NonlinearSystem::eigenproblem_solve(MAST::AssemblyElemOperations& elem_ops,
                                           MAST::EigenproblemAssembly& assembly) {
     
+    MAST::PerformanceScope perf("NonlinearSystem::eigenproblem_solve");
+    
     libmesh_assert(_operation == MAST::NonlinearSystem::NONE);
     
     _operation = MAST::NonlinearSystem::EIGENPROBLEM_SOLVE;
@@ -259,6 +720,10 @@ MAST::NonlinearSystem::eigenproblem_solve(MAST::AssemblyElemOperations& elem_ops
     
     // assemble the matrices
     assembly.eigenproblem_assemble(matrix_A, matrix_B);
+    
+    // warm-start the solver with the initial space, if provided
+    if (_eigenproblem_initial_space.size())
+        this->_set_eigenproblem_initial_space();
 
     // If we haven't initialized any condensed dofs,
     // just use the default eigen_system
@@ -367,6 +832,53 @@ MAST::NonlinearSystem::eigenproblem_solve(MAST::AssemblyElemOperations& elem_ops
 
 
 
+void
+MAST::NonlinearSystem::_set_eigenproblem_initial_space() {
+    
+    if (!_condensed_dofs_initialized) {
+        
+        eigen_solver->set_initial_space(_eigenproblem_initial_space);
+        return;
+    }
+    
+    // If we reach here, then there should be some non-condensed dofs
+    libmesh_assert(!_local_non_condensed_dofs_vector.empty());
+    
+    unsigned int
+    n_local   = (unsigned int)_local_non_condensed_dofs_vector.size(),
+    n         = n_local;
+    this->comm().sum(n);
+    
+    // restrict the vectors to the non-condensed dofs, using the same
+    // mapping as in get_eigenpair()
+    std::vector<libMesh::NumericVector<Real>*>
+    condensed(_eigenproblem_initial_space.size(), nullptr);
+    
+    for (unsigned int i=0; i<condensed.size(); i++) {
+        
+        condensed[i] = libMesh::NumericVector<Real>::build(this->comm()).release();
+        condensed[i]->init (n, n_local, false, libMesh::PARALLEL);
+        
+        const libMesh::NumericVector<Real>&
+        v = *_eigenproblem_initial_space[i];
+        
+        for (unsigned int j=0; j<_local_non_condensed_dofs_vector.size(); j++)
+            condensed[i]->set(condensed[i]->first_local_index()+j,
+                              v(_local_non_condensed_dofs_vector[j]));
+        
+        condensed[i]->close();
+    }
+    
+    // SLEPc keeps a reference to the vectors, so these can be deleted
+    eigen_solver->set_initial_space(condensed);
+    
+    for (unsigned int i=0; i<condensed.size(); i++)
+        delete condensed[i];
+}
+
+
+
+
 void
 MAST::NonlinearSystem::get_eigenvalue(unsigned int i, Real&  re, Real&  im) {
     
@@ -542,6 +1054,8 @@ eigenproblem_sensitivity_solve (MAST::AssemblyElemOperations&    elem_ops,
                                 std::vector<Real>&               sens,
                                 const std::vector<unsigned int>* indices) {
     
+    MAST::PerformanceScope perf("NonlinearSystem::eigenproblem_sensitivity_solve");
+    
     // make sure that eigensolution is already available
     libmesh_assert(_n_converged_eigenpairs);
 
@@ -727,6 +1241,8 @@ MAST::NonlinearSystem::sensitivity_solve(MAST::AssemblyElemOperations& elem_ops,
                                          const MAST::FunctionBase&     p,
                                          bool                          if_assemble_jacobian) {
 
+    MAST::PerformanceScope perf("NonlinearSystem::sensitivity_solve");
+    
     libmesh_assert(_operation == MAST::NonlinearSystem::NONE);
     
     _operation = MAST::NonlinearSystem::FORWARD_SENSITIVITY_SOLVE;
@@ -755,12 +1271,14 @@ MAST::NonlinearSystem::sensitivity_solve(MAST::AssemblyElemOperations& elem_ops,
     // Solve the linear system.
     libMesh::SparseMatrix<Real> * pc = this->request_matrix("Preconditioner");
     
-    std::pair<unsigned int, Real> rval =
-    this->linear_solver->solve (*matrix, pc,
-                                dsol,
-                                rhs,
-                                solver_params.second,
-                                solver_params.first);
+    {
+        MAST::PerformanceScope perf_ksp("NonlinearSystem::sensitivity_solve::ksp");
+        this->linear_solver->solve (*matrix, pc,
+                                    dsol,
+                                    rhs,
+                                    solver_params.second,
+                                    solver_params.first);
+    }
     
     // The linear solver may not have fit our constraints exactly
 #ifdef LIBMESH_ENABLE_CONSTRAINTS
@@ -782,6 +1300,7 @@ MAST::NonlinearSystem::adjoint_solve(MAST::AssemblyElemOperations&       elem_op
                                      MAST::AssemblyBase&                 assembly,
                                      bool if_assemble_jacobian) {
     
+    MAST::PerformanceScope perf("NonlinearSystem::adjoint_solve");
 
     libmesh_assert(_operation == MAST::NonlinearSystem::NONE);
     
@@ -810,12 +1329,14 @@ MAST::NonlinearSystem::adjoint_solve(MAST::AssemblyElemOperations&       elem_op
     std::pair<unsigned int, Real>
     solver_params = this->get_linear_solve_parameters();
     
-    const std::pair<unsigned int, Real> rval =
-    linear_solver->adjoint_solve (*matrix,
-                                  dsol,
-                                  rhs,
-                                  solver_params.second,
-                                  solver_params.first);
+    {
+        MAST::PerformanceScope perf_ksp("NonlinearSystem::adjoint_solve::ksp");
+        linear_solver->adjoint_solve (*matrix,
+                                      dsol,
+                                      rhs,
+                                      solver_params.second,
+                                      solver_params.first);
+    }
     
     // The linear solver may not have fit our constraints exactly
 #ifdef LIBMESH_ENABLE_CONSTRAINTS
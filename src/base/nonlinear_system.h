@@ -39,6 +39,7 @@ namespace MAST {
     class Parameter;
     class SlepcEigenSolver;
     class AssemblyBase;
+    class NonlinearImplicitAssembly;
     class PhysicsDisciplineBase;
     class AssemblyElemOperations;
     class OutputAssemblyElemOperations;
@@ -109,6 +110,77 @@ namespace MAST {
         virtual void reinit () libmesh_override;
 
 
+        /*!
+         *   sets the flag to solve the nonlinear problem using a Jacobian-free
+         *   Newton-Krylov method. The Jacobian is applied through a PETSc
+         *   shell matrix that calls
+         *   \p MAST::NonlinearImplicitAssembly::cached_linearized_jacobian_solution_product(),
+         *   and the system matrix is assembled only as the preconditioner.
+         *   The preconditioner is recomputed every \p pc_lag nonlinear
+         *   iterations, and the lagged matrix is reused in between. This
+         *   requires the assembly object to be a
+         *   \p MAST::NonlinearImplicitAssembly. This is false by default.
+         */
+        void set_matrix_free_jacobian(bool flag, unsigned int pc_lag = 1);
+        
+        /*!
+         *   @returns \p true if the Jacobian-free Newton-Krylov method
+         *   is used for the nonlinear solve.
+         */
+        bool if_matrix_free_jacobian() const { return _if_matrix_free_jacobian; }
+        
+        /*!
+         *   @returns the number of nonlinear iterations between updates
+         *   of the preconditioner for the matrix-free solve.
+         */
+        unsigned int matrix_free_pc_lag() const { return _matrix_free_pc_lag; }
+        
+        
+        /*!
+         *   sets the flag to solve the nonlinear problem with a Newton method
+         *   that reuses the assembled Jacobian and its factorization across
+         *   calls to solve(). Only the residual is assembled in each
+         *   iteration. The Jacobian is reassembled at the start of a solve
+         *   after \p lag solves with the same Jacobian, or never if \p lag
+         *   is zero, which is appropriate for a linear problem with a
+         *   constant operator, for example linear structural dynamics with a
+         *   constant time step. It is also reassembled if the residual norm
+         *   is reduced by less than the factor \p stagnation_ratio in an
+         *   iteration with a lagged Jacobian, or after
+         *   reset_lagged_jacobian(). This is false by default.
+         */
+        void set_lagged_jacobian(bool flag,
+                                 unsigned int lag = 0,
+                                 Real stagnation_ratio = 0.5);
+        
+        /*!
+         *   @returns \p true if the Jacobian is lagged across nonlinear solves.
+         */
+        bool if_lagged_jacobian() const { return _if_lagged_jacobian; }
+        
+        /*!
+         *   requires the Jacobian to be reassembled in the next solve with
+         *   the lagged Jacobian. This should be called if the operator
+         *   changes, for example with a change in the time step, or if the
+         *   system matrix is used for another operator.
+         */
+        void reset_lagged_jacobian() { _if_lagged_jacobian_valid = false; }
+        
+        /*!
+         *   @returns a counter that is incremented each time the dofs are
+         *   distributed, i.e. in init_data() and reinit(). Data computed
+         *   from the dof indices or constraints of this system is no longer
+         *   valid after a change in this value.
+         */
+        unsigned int dof_revision() const { return _dof_revision; }
+        
+        /*!
+         *   increments the dof revision. This should be called if the
+         *   constraints are modified without a call to reinit().
+         */
+        void increment_dof_revision() { _dof_revision++; }
+        
+        
         /*!
          *  solves the nonlinear problem with the specified assembly operation
          *  object
@@ -191,6 +263,27 @@ namespace MAST {
                        libMesh::NumericVector<Real>& vec_re,
                        libMesh::NumericVector<Real>* vec_im = nullptr);
         
+        /*!
+         * sets the vectors used as the initial space of the eigensolver in
+         * subsequent calls to eigenproblem_solve(), for example the
+         * eigenvectors from a previous solution of a nearby problem. The
+         * vectors are not copied and must remain valid until
+         * clear_eigenproblem_initial_space() is called.
+         */
+        void
+        set_eigenproblem_initial_space
+        (const std::vector<libMesh::NumericVector<Real>*>& vecs) {
+            _eigenproblem_initial_space = vecs;
+        }
+        
+        
+        /*!
+         * clears the initial space set for the eigensolver
+         */
+        void clear_eigenproblem_initial_space()
+        { _eigenproblem_initial_space.clear(); }
+        
+        
         /*!
          * sets the flag to exchange the A and B matrices for a generalized 
          * eigenvalue problem. This is needed typically when the B matrix is
@@ -306,6 +399,20 @@ namespace MAST {
         virtual void init_data () libmesh_override;
         
         
+        /*!
+         *   solves the nonlinear problem using a PETSc SNES with a shell
+         *   matrix for the Jacobian and the system matrix for the
+         *   preconditioner.
+         */
+        void _matrix_free_solve(MAST::NonlinearImplicitAssembly& assembly);
+        
+        
+        /*!
+         *   Newton solve with the lagged Jacobian and factorization
+         */
+        void _lagged_jacobian_solve(MAST::AssemblyBase& assembly);
+        
+        
         /**
          * Set the _n_converged_eigenpairs member, useful for
          * subclasses of EigenSystem.
@@ -321,6 +428,13 @@ namespace MAST {
         { _n_iterations = its;}
         
         
+        /*!
+         *   provides the initial space to the eigensolver, after restricting
+         *   the vectors to the non-condensed dofs if these are initialized.
+         */
+        void _set_eigenproblem_initial_space();
+        
+        
         /*!
          *   initialize the B matrix in addition to A, which might be needed
          *   for solution of complex system of equations using PC field split
@@ -365,6 +479,43 @@ namespace MAST {
          */
         libMesh::EigenProblemType          _eigen_problem_type;
         
+        /*!
+         *   flag to use the Jacobian-free Newton-Krylov solve
+         */
+        bool                               _if_matrix_free_jacobian;
+        
+        /*!
+         *   number of nonlinear iterations between preconditioner updates
+         *   in the Jacobian-free Newton-Krylov solve
+         */
+        unsigned int                       _matrix_free_pc_lag;
+        
+        /*!
+         *   flag to reuse the Jacobian across nonlinear solves, and flag
+         *   to indicate that the system matrix holds a Jacobian that can be
+         *   reused
+         */
+        bool                               _if_lagged_jacobian;
+        bool                               _if_lagged_jacobian_valid;
+        
+        /*!
+         *   number of solves after which the lagged Jacobian is reassembled,
+         *   and the number of solves since it was last assembled
+         */
+        unsigned int                       _jacobian_lag;
+        unsigned int                       _n_solves_since_jacobian;
+        
+        /*!
+         *   the Jacobian is reassembled if the residual norm is reduced
+         *   by less than this factor in an iteration
+         */
+        Real                               _jacobian_stagnation_ratio;
+        
+        /*!
+         *   number of times the dofs have been distributed
+         */
+        unsigned int                       _dof_revision;
+        
         /*!
          *   current operation of the system
          */
@@ -377,6 +528,11 @@ namespace MAST {
          */
         std::vector<libMesh::dof_id_type>  _local_non_condensed_dofs_vector;
         
+        /*!
+         *   vectors used as the initial space of the eigensolver
+         */
+        std::vector<libMesh::NumericVector<Real>*> _eigenproblem_initial_space;
+        
     };
 }
 
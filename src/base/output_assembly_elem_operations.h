@@ -145,6 +145,17 @@ namespace MAST {
          */
         virtual void evaluate_sensitivity(const MAST::FunctionBase& f) = 0;
 
+        /*!
+         *    @returns true if the data computed by \p evaluate_sensitivity()
+         *    is stored separately for each parameter, so that sensitivity
+         *    for multiple parameters can be evaluated in a single pass over
+         *    the elements. Outputs that accumulate the sensitivity in a
+         *    single value should return false, which is the default.
+         */
+        virtual bool if_stores_sensitivity_per_parameter() const {
+            return false;
+        }
+
         /*!
          *    this evaluates all relevant shape sensitivity components on
          *    the element.
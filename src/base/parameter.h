@@ -21,6 +21,9 @@
 #define __mast__parameter__
 
 
+// C++ includes
+#include <set>
+
 // MAST includes
 #include "base/function_base.h"
 
@@ -39,21 +42,33 @@ namespace MAST {
                   const Real& val):
         MAST::FunctionBase(nm, false),
         _val(new Real)
-        { *_val = val;}
+        { *_val = val; all_parameters().insert(this); }
 
         
         Parameter(const MAST::Parameter& f):
         MAST::FunctionBase(f),
         _val(f._val)
-        { }
+        { all_parameters().insert(this); }
         
 
         ~Parameter() {
 
+            all_parameters().erase(this);
             delete _val;
         }
         
         
+        /*!
+         *   @returns the set of all parameters that currently exist. This
+         *   is used by the element matrix cache to identify the parameters
+         *   that the property cards and loads of a discipline depend on.
+         */
+        static std::set<const MAST::Parameter*>& all_parameters() {
+            static std::set<const MAST::Parameter*> params;
+            return params;
+        }
+        
+        
         /*!
          *   @returns a writable reference to this parameter value
          */
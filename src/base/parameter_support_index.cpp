@@ -0,0 +1,330 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2018  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <algorithm>
+#include <limits>
+
+// MAST includes
+#include "base/parameter_support_index.h"
+#include "base/function_base.h"
+
+// libMesh includes
+#include "libmesh/elem.h"
+#include "libmesh/dof_map.h"
+#include "libmesh/parallel.h"
+
+
+// orders elements by id for sorting and searching the support
+static bool
+__mast_elem_id_less(const libMesh::Elem* e1, const libMesh::Elem* e2) {
+    
+    return e1->id() < e2->id();
+}
+
+
+
+MAST::ParameterSupportIndex::ParameterSupportIndex(const libMesh::MeshBase& mesh):
+_mesh   (mesh) {
+    
+}
+
+
+
+MAST::ParameterSupportIndex::~ParameterSupportIndex() {
+    
+}
+
+
+
+void
+MAST::ParameterSupportIndex::clear() {
+    
+    _support.clear();
+}
+
+
+
+void
+MAST::ParameterSupportIndex::clear(const MAST::FunctionBase& p) {
+    
+    _support.erase(&p);
+}
+
+
+
+void
+MAST::ParameterSupportIndex::
+add_subdomain_support(const MAST::FunctionBase& p,
+                      const std::set<libMesh::subdomain_id_type>& sids) {
+    
+    std::vector<const libMesh::Elem*>&
+    elems = _support[&p];
+    
+    libMesh::MeshBase::const_element_iterator
+    el     = _mesh.active_local_elements_begin(),
+    end_el = _mesh.active_local_elements_end();
+    
+    for ( ; el != end_el; ++el)
+        if (sids.count((*el)->subdomain_id()))
+            elems.push_back(*el);
+    
+    _finalize(p);
+}
+
+
+
+void
+MAST::ParameterSupportIndex::
+add_nodal_support(const MAST::FunctionBase& p,
+                  const std::set<libMesh::dof_id_type>& node_ids) {
+    
+    std::vector<const libMesh::Elem*>&
+    elems = _support[&p];
+    
+    libMesh::MeshBase::const_element_iterator
+    el     = _mesh.active_local_elements_begin(),
+    end_el = _mesh.active_local_elements_end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        for (unsigned int i=0; i<elem->n_nodes(); i++)
+            if (node_ids.count(elem->node_ref(i).id())) {
+                
+                elems.push_back(elem);
+                break;
+            }
+    }
+    
+    _finalize(p);
+}
+
+
+
+void
+MAST::ParameterSupportIndex::
+add_level_set_dof_support
+(const libMesh::System& level_set_sys,
+ const std::vector<std::pair<libMesh::dof_id_type, const MAST::FunctionBase*> >& dvs) {
+    
+    const unsigned int
+    n_dvs = (unsigned int)dvs.size();
+    
+    const Real
+    big   = std::numeric_limits<Real>::max();
+    
+    // bounding box of the support of each dof, stored as
+    // (x, y, z) for dv i at 3*i.
+    std::vector<Real>
+    box_min(3*n_dvs,  big),
+    box_max(3*n_dvs, -big);
+    
+    // a dof may be associated with more than one parameter
+    std::multimap<libMesh::dof_id_type, unsigned int> dof_to_dv;
+    for (unsigned int i=0; i<n_dvs; i++)
+        dof_to_dv.insert(std::make_pair(dvs[i].first, i));
+    
+    const libMesh::MeshBase& level_set_mesh = level_set_sys.get_mesh();
+    const libMesh::DofMap&   dof_map        = level_set_sys.get_dof_map();
+    std::vector<libMesh::dof_id_type> dof_indices;
+    
+    // all elements available on this processor are used, which includes the
+    // ghosted elements on a distributed mesh.
+    libMesh::MeshBase::const_element_iterator
+    el     = level_set_mesh.active_elements_begin(),
+    end_el = level_set_mesh.active_elements_end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        dof_map.dof_indices(elem, dof_indices);
+        
+        for (unsigned int i=0; i<dof_indices.size(); i++) {
+            
+            std::pair<std::multimap<libMesh::dof_id_type, unsigned int>::const_iterator,
+            std::multimap<libMesh::dof_id_type, unsigned int>::const_iterator>
+            it = dof_to_dv.equal_range(dof_indices[i]);
+            
+            for ( ; it.first != it.second; it.first++) {
+                
+                const unsigned int dv = it.first->second;
+                
+                for (unsigned int j=0; j<elem->n_nodes(); j++)
+                    for (unsigned int k=0; k<3; k++) {
+                        
+                        box_min[3*dv+k] = std::min(box_min[3*dv+k], elem->point(j)(k));
+                        box_max[3*dv+k] = std::max(box_max[3*dv+k], elem->point(j)(k));
+                    }
+            }
+        }
+    }
+    
+    // on a distributed mesh the elements sharing a dof can live on other
+    // processors. The reduction gives the same box on all processors.
+    if (!level_set_mesh.is_serial()) {
+        
+        level_set_sys.comm().min(box_min);
+        level_set_sys.comm().max(box_max);
+    }
+    
+    // tolerance for the overlap check, relative to the size of each box
+    std::vector<Real>
+    tol(n_dvs, 0.);
+    
+    for (unsigned int i=0; i<n_dvs; i++)
+        for (unsigned int k=0; k<3; k++)
+            if (box_max[3*i+k] >= box_min[3*i+k])
+                tol[i] = std::max(tol[i],
+                                  libMesh::TOLERANCE * (box_max[3*i+k] - box_min[3*i+k]));
+    
+    // now identify the elements of the analysis mesh that overlap each box
+    Real
+    e_min[3],
+    e_max[3];
+    bool
+    overlap = false;
+    
+    el     = _mesh.active_local_elements_begin();
+    end_el = _mesh.active_local_elements_end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        for (unsigned int k=0; k<3; k++) {
+            e_min[k] =  big;
+            e_max[k] = -big;
+        }
+        
+        for (unsigned int j=0; j<elem->n_nodes(); j++)
+            for (unsigned int k=0; k<3; k++) {
+                
+                e_min[k] = std::min(e_min[k], elem->point(j)(k));
+                e_max[k] = std::max(e_max[k], elem->point(j)(k));
+            }
+        
+        for (unsigned int i=0; i<n_dvs; i++) {
+            
+            overlap = true;
+            for (unsigned int k=0; k<3 && overlap; k++)
+                overlap = (e_max[k] >= box_min[3*i+k] - tol[i] &&
+                           e_min[k] <= box_max[3*i+k] + tol[i]);
+            
+            if (overlap)
+                _support[dvs[i].second].push_back(elem);
+        }
+    }
+    
+    // parameters without any overlapping local elements still have a
+    // registered, empty support on this processor
+    for (unsigned int i=0; i<n_dvs; i++)
+        _finalize(*dvs[i].second);
+}
+
+
+
+bool
+MAST::ParameterSupportIndex::has_support(const MAST::FunctionBase& p) const {
+    
+    return _support.count(&p);
+}
+
+
+
+const std::vector<const libMesh::Elem*>&
+MAST::ParameterSupportIndex::support(const MAST::FunctionBase& p) const {
+    
+    std::map<const MAST::FunctionBase*, std::vector<const libMesh::Elem*> >::const_iterator
+    it = _support.find(&p);
+    
+    libmesh_assert(it != _support.end());
+    
+    return it->second;
+}
+
+
+
+bool
+MAST::ParameterSupportIndex::if_elem_in_support(const MAST::FunctionBase& p,
+                                                const libMesh::Elem& elem) const {
+    
+    std::map<const MAST::FunctionBase*, std::vector<const libMesh::Elem*> >::const_iterator
+    it = _support.find(&p);
+    
+    if (it == _support.end())
+        return true;
+    
+    return std::binary_search(it->second.begin(),
+                              it->second.end(),
+                              &elem,
+                              __mast_elem_id_less);
+}
+
+
+
+void
+MAST::ParameterSupportIndex::
+elems_for_parameters(const std::vector<const MAST::FunctionBase*>& p,
+                     std::vector<const libMesh::Elem*>& elems) const {
+    
+    elems.clear();
+    
+    bool
+    all_supported = true;
+    
+    for (unsigned int i=0; i<p.size() && all_supported; i++)
+        all_supported = this->has_support(*p[i]);
+    
+    if (all_supported) {
+        
+        for (unsigned int i=0; i<p.size(); i++) {
+            
+            const std::vector<const libMesh::Elem*>& s = this->support(*p[i]);
+            elems.insert(elems.end(), s.begin(), s.end());
+        }
+        
+        std::sort(elems.begin(), elems.end(), __mast_elem_id_less);
+        elems.erase(std::unique(elems.begin(), elems.end()), elems.end());
+    }
+    else {
+        
+        libMesh::MeshBase::const_element_iterator
+        el     = _mesh.active_local_elements_begin(),
+        end_el = _mesh.active_local_elements_end();
+        
+        for ( ; el != end_el; ++el)
+            elems.push_back(*el);
+    }
+}
+
+
+
+void
+MAST::ParameterSupportIndex::_finalize(const MAST::FunctionBase& p) {
+    
+    std::vector<const libMesh::Elem*>&
+    elems = _support[&p];
+    
+    std::sort(elems.begin(), elems.end(), __mast_elem_id_less);
+    elems.erase(std::unique(elems.begin(), elems.end()), elems.end());
+}
+
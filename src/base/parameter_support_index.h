@@ -0,0 +1,157 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2018  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast_parameter_support_index_h__
+#define __mast_parameter_support_index_h__
+
+// C++ includes
+#include <map>
+#include <set>
+#include <vector>
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+// libMesh includes
+#include "libmesh/mesh_base.h"
+#include "libmesh/system.h"
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class FunctionBase;
+    
+    /*!
+     *   Stores, for each parameter, the active local elements of a mesh on
+     *   which the parameter can have a nonzero influence. Sensitivity
+     *   assembly routines use this to visit only the elements in the support
+     *   of a parameter instead of all active local elements. Parameters
+     *   without a registered support are assumed to influence all elements.
+     *
+     *   The support can be identified from a set of subdomains, a set of
+     *   nodes, or from the degrees of freedom of a level set system
+     *   discretized on a separate mesh. The support only depends on the
+     *   mesh, so the index should be cleared and rebuilt if the mesh is
+     *   refined or redistributed.
+     */
+    class ParameterSupportIndex {
+        
+    public:
+        
+        /*!
+         *   \p mesh is the mesh on which the sensitivity assembly is
+         *   performed.
+         */
+        ParameterSupportIndex(const libMesh::MeshBase& mesh);
+        
+        virtual ~ParameterSupportIndex();
+        
+        /*!
+         *   clears the support of all parameters
+         */
+        void clear();
+        
+        /*!
+         *   clears the support of parameter \p p
+         */
+        void clear(const MAST::FunctionBase& p);
+        
+        /*!
+         *   adds the active local elements in subdomains \p sids to the
+         *   support of \p p.
+         */
+        void
+        add_subdomain_support(const MAST::FunctionBase& p,
+                              const std::set<libMesh::subdomain_id_type>& sids);
+        
+        /*!
+         *   adds the active local elements connected to any of the nodes
+         *   with ids in \p node_ids to the support of \p p.
+         */
+        void
+        add_nodal_support(const MAST::FunctionBase& p,
+                          const std::set<libMesh::dof_id_type>& node_ids);
+        
+        /*!
+         *   adds the active local elements that overlap the support of
+         *   a degree of freedom of \p level_set_sys to the support of the
+         *   parameter associated with it in \p dvs. The support of a
+         *   dof is the bounding box of the level set elements that share
+         *   the dof. If the level set mesh is distributed the boxes are
+         *   reduced over all processors, so that the support is consistent
+         *   when it crosses processor boundaries.
+         */
+        void
+        add_level_set_dof_support
+        (const libMesh::System& level_set_sys,
+         const std::vector<std::pair<libMesh::dof_id_type, const MAST::FunctionBase*> >& dvs);
+        
+        /*!
+         *   @returns true if a support has been registered for \p p.
+         */
+        bool has_support(const MAST::FunctionBase& p) const;
+        
+        /*!
+         *   @returns the active local elements in the support of \p p,
+         *   sorted by element id. This should only be called if
+         *   has_support() returns true for \p p.
+         */
+        const std::vector<const libMesh::Elem*>&
+        support(const MAST::FunctionBase& p) const;
+        
+        /*!
+         *   @returns true if \p elem is in the support of \p p, or if no
+         *   support has been registered for \p p.
+         */
+        bool if_elem_in_support(const MAST::FunctionBase& p,
+                                const libMesh::Elem& elem) const;
+        
+        /*!
+         *   populates \p elems with the active local elements that should be
+         *   visited for sensitivity with respect to the parameters in \p p.
+         *   This is the union of the supports, sorted by element id, if all
+         *   parameters have a registered support, and all active local
+         *   elements otherwise.
+         */
+        void
+        elems_for_parameters(const std::vector<const MAST::FunctionBase*>& p,
+                             std::vector<const libMesh::Elem*>& elems) const;
+        
+    protected:
+        
+        /*!
+         *   sorts and removes duplicate entries from the support of \p p.
+         */
+        void _finalize(const MAST::FunctionBase& p);
+        
+        /*!
+         *   mesh for which the support is identified
+         */
+        const libMesh::MeshBase& _mesh;
+        
+        /*!
+         *   active local elements in the support of each parameter
+         */
+        std::map<const MAST::FunctionBase*, std::vector<const libMesh::Elem*> > _support;
+    };
+}
+
+
+#endif // __mast_parameter_support_index_h__
@@ -0,0 +1,283 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2018  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+// MAST includes
+#include "base/performance_counters.h"
+
+// libMesh includes
+#include "libmesh/libmesh.h"
+
+
+MAST::PerformanceCounters&
+MAST::PerformanceCounters::instance() {
+    
+    static MAST::PerformanceCounters counters;
+    return counters;
+}
+
+
+
+MAST::PerformanceCounters::PerformanceCounters():
+_enabled   (false) {
+    
+    if (libMesh::on_command_line("--mast_performance_counters"))
+        _enabled = true;
+}
+
+
+
+void
+MAST::PerformanceCounters::enable(bool f) {
+    
+    _enabled = f;
+}
+
+
+
+void
+MAST::PerformanceCounters::clear() {
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    
+    std::map<std::thread::id, MAST::PerformanceCounters::ThreadData>::iterator
+    it  = _threads.begin(),
+    end = _threads.end();
+    
+    for ( ; it != end; it++) {
+        
+        libmesh_assert_msg(it->second.stack.empty(),
+                           "Error: Performance counters cleared within a phase.");
+        
+        it->second.data.clear();
+        it->second.lookup.clear();
+    }
+}
+
+
+
+MAST::PerformanceCounters::ThreadData&
+MAST::PerformanceCounters::_thread_data() {
+    
+    // the counters are a singleton, so the data of a thread can be
+    // cached in thread local storage
+    static thread_local MAST::PerformanceCounters::ThreadData* td = nullptr;
+    
+    if (!td) {
+        
+        std::lock_guard<std::mutex> lock(_mutex);
+        td = &_threads[std::this_thread::get_id()];
+    }
+    
+    return *td;
+}
+
+
+
+MAST::PerformanceCounters::Data*
+MAST::PerformanceCounters::start(const char* name) {
+    
+    if (!_enabled)
+        return nullptr;
+    
+    MAST::PerformanceCounters::ThreadData& td = _thread_data();
+    
+    MAST::PerformanceCounters::Data*& d = td.lookup[name];
+    if (!d)
+        d = &td.data[name];
+    
+    d->calls++;
+    
+    MAST::PerformanceCounters::Active a;
+    a.data       = d;
+    a.start      = std::chrono::steady_clock::now();
+    a.child_time = 0.;
+    
+    td.stack.push_back(a);
+    
+    return d;
+}
+
+
+
+void
+MAST::PerformanceCounters::stop() {
+    
+    std::vector<MAST::PerformanceCounters::Active>& stack = _thread_data().stack;
+    
+    libmesh_assert(!stack.empty());
+    
+    const MAST::PerformanceCounters::Active a = stack.back();
+    stack.pop_back();
+    
+    const Real
+    t = std::chrono::duration<Real>(std::chrono::steady_clock::now() - a.start).count();
+    
+    a.data->inclusive += t;
+    a.data->exclusive += t - a.child_time;
+    
+    // the time of this phase is excluded from its parent
+    if (!stack.empty())
+        stack.back().child_time += t;
+}
+
+
+
+void
+MAST::PerformanceCounters::write_json(const libMesh::Parallel::Communicator& comm,
+                                      std::ostream& out) const {
+    
+    // merge the data of all threads on this processor
+    std::map<std::string, MAST::PerformanceCounters::Data> data;
+    
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        
+        std::map<std::thread::id, MAST::PerformanceCounters::ThreadData>::const_iterator
+        t_it  = _threads.begin(),
+        t_end = _threads.end();
+        
+        for ( ; t_it != t_end; t_it++) {
+            
+            std::map<std::string, MAST::PerformanceCounters::Data>::const_iterator
+            d_it  = t_it->second.data.begin(),
+            d_end = t_it->second.data.end();
+            
+            for ( ; d_it != d_end; d_it++) {
+                
+                MAST::PerformanceCounters::Data& d = data[d_it->first];
+                d.calls     += d_it->second.calls;
+                d.inclusive += d_it->second.inclusive;
+                d.exclusive += d_it->second.exclusive;
+                d.elements  += d_it->second.elements;
+                d.bytes     += d_it->second.bytes;
+            }
+        }
+    }
+    
+    // union of the phases recorded on all processors
+    std::vector<std::string> names;
+    
+    std::map<std::string, MAST::PerformanceCounters::Data>::const_iterator
+    it  = data.begin(),
+    end = data.end();
+    
+    for ( ; it != end; it++)
+        names.push_back(it->first);
+    
+    comm.allgather(names, false);
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    
+    const unsigned int
+    n = (unsigned int)names.size();
+    
+    std::vector<unsigned long>
+    procs    (n, 0),
+    calls    (n, 0),
+    elements (n, 0),
+    bytes    (n, 0);
+    
+    // phases that are not recorded on this processor do not contribute
+    // to the minimum, maximum and mean of the times
+    std::vector<Real>
+    inc_min  (n, std::numeric_limits<Real>::max()),
+    inc_max  (n, 0.),
+    inc_sum  (n, 0.),
+    exc_min  (n, std::numeric_limits<Real>::max()),
+    exc_max  (n, 0.),
+    exc_sum  (n, 0.);
+    
+    for (unsigned int i=0; i<n; i++) {
+        
+        it = data.find(names[i]);
+        
+        if (it != data.end()) {
+            
+            procs[i]    = 1;
+            calls[i]    = it->second.calls;
+            elements[i] = it->second.elements;
+            bytes[i]    = it->second.bytes;
+            inc_min[i]  = inc_max[i] = inc_sum[i] = it->second.inclusive;
+            exc_min[i]  = exc_max[i] = exc_sum[i] = it->second.exclusive;
+        }
+    }
+    
+    comm.sum(procs);
+    comm.sum(calls);
+    comm.sum(elements);
+    comm.sum(bytes);
+    comm.min(inc_min);
+    comm.max(inc_max);
+    comm.sum(inc_sum);
+    comm.min(exc_min);
+    comm.max(exc_max);
+    comm.sum(exc_sum);
+    
+    if (comm.rank() != 0)
+        return;
+    
+    out
+    << std::setprecision(8)
+    << "{" << std::endl
+    << "  \"n_processors\": " << comm.size() << "," << std::endl
+    << "  \"phases\": {" << std::endl;
+    
+    for (unsigned int i=0; i<n; i++) {
+        
+        out
+        << "    \"" << names[i] << "\": {" << std::endl
+        << "      \"processors\": " << procs[i]    << "," << std::endl
+        << "      \"calls\": "      << calls[i]    << "," << std::endl
+        << "      \"elements\": "   << elements[i] << "," << std::endl
+        << "      \"bytes\": "      << bytes[i]    << "," << std::endl
+        << "      \"inclusive_time\": {"
+        << "\"min\": "  << inc_min[i]           << ", "
+        << "\"max\": "  << inc_max[i]           << ", "
+        << "\"mean\": " << inc_sum[i]/procs[i]  << "}," << std::endl
+        << "      \"exclusive_time\": {"
+        << "\"min\": "  << exc_min[i]           << ", "
+        << "\"max\": "  << exc_max[i]           << ", "
+        << "\"mean\": " << exc_sum[i]/procs[i]  << "}" << std::endl
+        << "    }" << (i < n-1 ? "," : "") << std::endl;
+    }
+    
+    out
+    << "  }" << std::endl
+    << "}" << std::endl;
+}
+
+
+
+void
+MAST::PerformanceCounters::write_json(const libMesh::Parallel::Communicator& comm,
+                                      const std::string& nm) const {
+    
+    std::ofstream out;
+    
+    if (comm.rank() == 0)
+        out.open(nm.c_str(), std::ofstream::out);
+    
+    this->write_json(comm, out);
+}
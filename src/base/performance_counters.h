@@ -0,0 +1,207 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2018  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast_performance_counters_h__
+#define __mast_performance_counters_h__
+
+// C++ includes
+#include <map>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <iostream>
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+// libMesh includes
+#include "libmesh/parallel.h"
+
+
+namespace MAST {
+    
+    /*!
+     *   Records the number of calls, the inclusive and exclusive wall time,
+     *   the number of elements processed and the bytes of data allocated
+     *   for named phases of the assembly and solution routines. Phases are
+     *   entered and left through MAST::PerformanceScope objects. The
+     *   exclusive time of a phase excludes the time spent in phases nested
+     *   within it.
+     *
+     *   Recording is disabled by default and can be enabled at runtime with
+     *   enable(), or with the command line option
+     *   \p --mast_performance_counters. When disabled, a scope costs one
+     *   flag check. Each thread records its phases separately, so that
+     *   phases entered by the worker threads of the element loops are
+     *   recorded without synchronization. The data of all threads is
+     *   merged by write_json(), and the times of a phase entered by
+     *   several threads are summed over the threads.
+     */
+    class PerformanceCounters {
+        
+    public:
+        
+        /*!
+         *   @returns the object used by all MAST routines
+         */
+        static MAST::PerformanceCounters& instance();
+        
+        /*!
+         *   enables or disables the recording of data
+         */
+        void enable(bool f);
+        
+        /*!
+         *   @returns true if the data is being recorded
+         */
+        bool enabled() const { return _enabled; }
+        
+        /*!
+         *   removes the recorded data. This must not be called from within
+         *   a phase, or while other threads are recording data.
+         */
+        void clear();
+        
+        /*!
+         *   data recorded for a phase
+         */
+        struct Data {
+            Data(): calls(0), inclusive(0.), exclusive(0.), elements(0), bytes(0) {}
+            unsigned long calls;
+            Real          inclusive;
+            Real          exclusive;
+            unsigned long elements;
+            unsigned long bytes;
+        };
+        
+        /*!
+         *   enters the phase \p name on the calling thread. \p name is
+         *   expected to be a string literal, since its address is used to
+         *   identify the phase. @returns the data of the phase for the
+         *   calling thread, or nullptr if the data is not being recorded,
+         *   in which case \p stop() should not be called.
+         */
+        MAST::PerformanceCounters::Data* start(const char* name);
+        
+        /*!
+         *   leaves the innermost phase of the calling thread
+         */
+        void stop();
+        
+        /*!
+         *   writes the data aggregated over the threads and the processors
+         *   of \p comm in JSON format to \p out on processor 0. The counts
+         *   are summed over the processors, and the minimum, maximum and
+         *   mean over the processors that recorded a phase are written for
+         *   its times, along with the number of these processors. This must
+         *   be called on all processors of \p comm, and not while other
+         *   threads are recording data.
+         */
+        void write_json(const libMesh::Parallel::Communicator& comm,
+                        std::ostream& out) const;
+        
+        /*!
+         *   writes the aggregated data to file \p nm on processor 0.
+         *   This must be called on all processors of \p comm.
+         */
+        void write_json(const libMesh::Parallel::Communicator& comm,
+                        const std::string& nm) const;
+        
+    protected:
+        
+        PerformanceCounters();
+        
+        /*!
+         *   phase that has been entered and not left
+         */
+        struct Active {
+            MAST::PerformanceCounters::Data*                   data;
+            std::chrono::steady_clock::time_point              start;
+            Real                                               child_time;
+        };
+        
+        /*!
+         *   data recorded by a thread. \p lookup maps the address of the
+         *   phase names passed to start() to the data, which avoids the
+         *   string comparison for repeated calls.
+         */
+        struct ThreadData {
+            std::map<std::string, MAST::PerformanceCounters::Data>  data;
+            std::map<const char*, MAST::PerformanceCounters::Data*> lookup;
+            std::vector<MAST::PerformanceCounters::Active>          stack;
+        };
+        
+        /*!
+         *   @returns the data of the calling thread
+         */
+        MAST::PerformanceCounters::ThreadData& _thread_data();
+        
+        bool                                                   _enabled;
+        
+        /*!
+         *   data of each thread that has entered a phase. The entries are
+         *   not removed, since the threads keep references to them.
+         */
+        std::map<std::thread::id, MAST::PerformanceCounters::ThreadData> _threads;
+        
+        /*!
+         *   protects \p _threads
+         */
+        mutable std::mutex                                     _mutex;
+    };
+    
+    
+    /*!
+     *   enters the phase \p name of MAST::PerformanceCounters::instance()
+     *   on construction and leaves it on destruction
+     */
+    class PerformanceScope {
+        
+    public:
+        
+        PerformanceScope(const char* name):
+        _data(MAST::PerformanceCounters::instance().start(name)) { }
+        
+        ~PerformanceScope() {
+            if (_data) MAST::PerformanceCounters::instance().stop();
+        }
+        
+        /*!
+         *   adds \p n to the element count of this phase
+         */
+        void add_elements(unsigned long n) {
+            if (_data) _data->elements += n;
+        }
+        
+        /*!
+         *   adds \p n to the bytes allocated in this phase
+         */
+        void add_bytes(unsigned long n) {
+            if (_data) _data->bytes += n;
+        }
+        
+    protected:
+        
+        MAST::PerformanceCounters::Data* _data;
+    };
+}
+
+#endif // __mast_performance_counters_h__
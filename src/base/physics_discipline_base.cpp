@@ -22,7 +22,9 @@
 #include "base/system_initialization.h"
 #include "base/parameter.h"
 #include "base/nonlinear_system.h"
+#include "base/boundary_condition_base.h"
 #include "boundary_condition/dirichlet_boundary_condition.h"
+#include "property_cards/element_property_card_base.h"
 
 // libMesh includes
 #include "libmesh/dof_map.h"
@@ -30,6 +32,7 @@
 #include "libmesh/fe_interface.h"
 #include "libmesh/dirichlet_boundaries.h"
 #include "libmesh/elem.h"
+#include "libmesh/boundary_info.h"
 
 
 void
@@ -168,6 +171,95 @@ MAST::PhysicsDisciplineBase::get_property_card(const libMesh::Elem& elem) const
 
 
 
+bool
+MAST::PhysicsDisciplineBase::
+depends_on_parameter(const MAST::FunctionBase& p) const {
+    
+    if (p.is_shape_parameter() || p.is_topology_parameter())
+        return true;
+    
+    MAST::PropertyCardMapType::const_iterator
+    p_it  = _element_property.begin(),
+    p_end = _element_property.end();
+    
+    for ( ; p_it != p_end; p_it++)
+        if (p_it->second->depends_on(p))
+            return true;
+    
+    MAST::VolumeBCMapType::const_iterator
+    v_it  = _vol_bc_map.begin(),
+    v_end = _vol_bc_map.end();
+    
+    for ( ; v_it != v_end; v_it++)
+        if (v_it->second->depends_on(p))
+            return true;
+    
+    MAST::SideBCMapType::const_iterator
+    s_it  = _side_bc_map.begin(),
+    s_end = _side_bc_map.end();
+    
+    for ( ; s_it != s_end; s_it++)
+        if (s_it->second->depends_on(p))
+            return true;
+    
+    return false;
+}
+
+
+
+bool
+MAST::PhysicsDisciplineBase::
+elem_depends_on_parameter(const libMesh::Elem& elem,
+                          const MAST::FunctionBase& p) const {
+    
+    // shape and topology parameters are not identified by the functions
+    // associated with the element
+    if (p.is_shape_parameter() || p.is_topology_parameter())
+        return true;
+    
+    if (this->get_property_card(elem).depends_on(p))
+        return true;
+    
+    // volume loads on the element subdomain
+    std::pair<MAST::VolumeBCMapType::const_iterator,
+    MAST::VolumeBCMapType::const_iterator>
+    v_it = _vol_bc_map.equal_range(elem.subdomain_id());
+    
+    for ( ; v_it.first != v_it.second; v_it.first++)
+        if (v_it.first->second->depends_on(p))
+            return true;
+    
+    // side loads on the boundaries of this element
+    if (_side_bc_map.empty())
+        return false;
+    
+    const libMesh::BoundaryInfo& binfo = *_eq_systems.get_mesh().boundary_info;
+    std::vector<libMesh::boundary_id_type> bc_ids;
+    
+    for (unsigned short int n=0; n<elem.n_sides(); n++) {
+        
+        if (!binfo.n_boundary_ids(&elem, n))
+            continue;
+        
+        binfo.boundary_ids(&elem, n, bc_ids);
+        
+        for (unsigned int i=0; i<bc_ids.size(); i++) {
+            
+            std::pair<MAST::SideBCMapType::const_iterator,
+            MAST::SideBCMapType::const_iterator>
+            s_it = _side_bc_map.equal_range(bc_ids[i]);
+            
+            for ( ; s_it.first != s_it.second; s_it.first++)
+                if (s_it.first->second->depends_on(p))
+                    return true;
+        }
+    }
+    
+    return false;
+}
+
+
+
 void
 MAST::PhysicsDisciplineBase::
 init_system_dirichlet_bc(MAST::NonlinearSystem& sys) const {
@@ -100,6 +100,14 @@ namespace MAST {
         void add_dirichlet_bc(libMesh::boundary_id_type bid,
                               MAST::DirichletBoundaryCondition& load);
         
+        /*!
+         *    @returns a const reference to the property cards assigned
+         *    to the subdomains
+         */
+        const MAST::PropertyCardMapType& property_cards() const {
+            return _element_property;
+        }
+        
         /*!
          *    @returns a const reference to the side boundary conditions
          */
@@ -202,6 +210,22 @@ namespace MAST {
          */
         const MAST::ElementPropertyCardBase& get_property_card(const unsigned int sid) const;
         
+        /*!
+         *    @returns true if the property card of \p elem, or any of the
+         *    volume loads on its subdomain or side loads on its boundaries,
+         *    depends on \p p. Shape and topology parameters are assumed to
+         *    influence all elements.
+         */
+        bool elem_depends_on_parameter(const libMesh::Elem& elem,
+                                       const MAST::FunctionBase& p) const;
+        
+        /*!
+         *    @returns true if any property card, volume load or side load
+         *    of this discipline depends on \p p. Shape and topology
+         *    parameters are assumed to influence all elements.
+         */
+        bool depends_on_parameter(const MAST::FunctionBase& p) const;
+        
         
         
     protected:
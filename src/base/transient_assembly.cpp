@@ -26,6 +26,7 @@
 #include "base/transient_assembly_elem_operations.h"
 #include "solver/transient_solver_base.h"
 #include "numerics/utility.h"
+#include "base/performance_counters.h"
 
 // libMesh includes
 #include "libmesh/nonlinear_solver.h"
@@ -57,6 +58,8 @@ residual_and_jacobian (const libMesh::NumericVector<Real>& X,
                        libMesh::SparseMatrix<Real>*  J,
                        libMesh::NonlinearImplicitSystem& S) {
     
+    MAST::PerformanceScope perf("TransientAssembly::residual_and_jacobian");
+    
     libmesh_assert(_system);
     libmesh_assert(_discipline);
     libmesh_assert(_elem_ops);
@@ -168,6 +171,8 @@ linearized_jacobian_solution_product (const libMesh::NumericVector<Real>& X,
                                       libMesh::NumericVector<Real>& JdX,
                                       libMesh::NonlinearImplicitSystem& S) {
     
+    MAST::PerformanceScope perf("TransientAssembly::linearized_jacobian_solution_product");
+    
     libmesh_assert(_system);
     libmesh_assert(_discipline);
     libmesh_assert(_elem_ops);
@@ -264,11 +269,118 @@ linearized_jacobian_solution_product (const libMesh::NumericVector<Real>& X,
 
 
 
+void
+MAST::TransientAssembly::
+adjoint_time_derivative_products(const libMesh::NumericVector<Real>& X,
+                                 const libMesh::NumericVector<Real>& lambda,
+                                 std::vector<libMesh::NumericVector<Real>*>& products,
+                                 libMesh::NonlinearImplicitSystem& S) {
+    
+    MAST::PerformanceScope perf("TransientAssembly::adjoint_time_derivative_products");
+    
+    libmesh_assert(_system);
+    libmesh_assert(_discipline);
+    libmesh_assert(_elem_ops);
+    
+    MAST::TransientSolverBase
+    &solver = dynamic_cast<MAST::TransientSolverBase&>(*_elem_ops);
+    MAST::NonlinearSystem
+    &transient_sys = _system->system();
+    
+    // make sure that the system for which this object was created,
+    // and the system passed through the function call are the same
+    libmesh_assert_equal_to(&S, &transient_sys);
+    libmesh_assert_equal_to(products.size(), solver.ode_order());
+    
+    for (unsigned int i=0; i<products.size(); i++)
+        products[i]->zero();
+    
+    // iterate over each element, initialize it and get the relevant
+    // analysis quantities
+    RealVectorX lambda_e;
+    std::vector<RealVectorX> vecs;
+    
+    std::vector<libMesh::dof_id_type> dof_indices;
+    const libMesh::DofMap& dof_map = transient_sys.get_dof_map();
+    
+    
+    // stores the localized solution, velocity, acceleration, etc. vectors.
+    // These pointers will have to be deleted
+    std::vector<libMesh::NumericVector<Real>*>
+    local_qtys;
+    
+    std::unique_ptr<libMesh::NumericVector<Real> >
+    localized_lambda(build_localized_vector(transient_sys, lambda).release());
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function)
+        _sol_function->init( X);
+    
+    // ask the solver to localize the relevant solutions
+    solver.build_local_quantities(X, local_qtys);
+    
+    libMesh::MeshBase::const_element_iterator       el     =
+    transient_sys.get_mesh().active_local_elements_begin();
+    const libMesh::MeshBase::const_element_iterator end_el =
+    transient_sys.get_mesh().active_local_elements_end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        dof_map.dof_indices (elem, dof_indices);
+        
+        solver.init(*elem);
+        
+        // get the adjoint vector for this element
+        unsigned int ndofs = (unsigned int)dof_indices.size();
+        lambda_e.setZero(ndofs);
+        
+        for (unsigned int i=0; i<ndofs; i++)
+            lambda_e(i) = (*localized_lambda)(dof_indices[i]);
+        
+        solver.set_element_data(dof_indices, local_qtys);
+        
+        // perform the element level calculations
+        solver.elem_adjoint_time_derivative_products(lambda_e, vecs);
+        solver.clear_elem();
+        
+        for (unsigned int i=0; i<products.size(); i++) {
+            
+            // copy to the libMesh vector for further processing
+            DenseRealVector v;
+            MAST::copy(v, vecs[i]);
+            
+            // constrain the quantities to account for hanging dofs,
+            // Dirichlet constraints, etc.
+            dof_map.constrain_element_vector(v, dof_indices);
+            
+            // add to the global vector
+            products[i]->add_vector(v, dof_indices);
+        }
+    }
+    
+    // delete pointers to the local solutions
+    for (unsigned int i=0; i<local_qtys.size(); i++)
+        delete local_qtys[i];
+    
+    // if a solution function is attached, clear it
+    if (_sol_function)
+        _sol_function->clear();
+    
+    for (unsigned int i=0; i<products.size(); i++)
+        products[i]->close();
+}
+
+
+
 bool
 MAST::TransientAssembly::
 sensitivity_assemble (const MAST::FunctionBase& f,
                       libMesh::NumericVector<Real>& sensitivity_rhs) {
     
+    MAST::PerformanceScope perf("TransientAssembly::sensitivity_assemble");
+    
     libmesh_assert(_system);
     libmesh_assert(_discipline);
     libmesh_assert(_elem_ops);
@@ -76,6 +76,21 @@ namespace MAST {
                                              libMesh::NumericVector<Real>& JdX,
                                              libMesh::NonlinearImplicitSystem& S);
         
+        /*!
+         *    calculates the products of the adjoint vector \p lambda with
+         *    the transpose of the Jacobian of the residual with respect to
+         *    each time derivative of the solution, for the solution \p X
+         *    at the current time step. \p products[k-1] is the product
+         *    for the \p k th time derivative and must be provided for all
+         *    derivatives handled by the transient solver. This is used
+         *    for the transient adjoint solution.
+         */
+        virtual void
+        adjoint_time_derivative_products(const libMesh::NumericVector<Real>& X,
+                                         const libMesh::NumericVector<Real>& lambda,
+                                         std::vector<libMesh::NumericVector<Real>*>& products,
+                                         libMesh::NonlinearImplicitSystem& S);
+        
         /**
          * Assembly function.  This function will be called
          * to assemble the sensitivity of system residual prior to a solve and must
@@ -145,14 +145,14 @@ assemble_generalized_aerodynamic_force_matrix
     std::unique_ptr<libMesh::NumericVector<Real> >
     localized_solution,
     localized_zero;
-    std::vector<libMesh::NumericVector<Real>*> localized_basis(n_basis);
+    std::vector<libMesh::NumericVector<Real>*> localized_basis;
 
     if (_base_sol)
         localized_solution.reset(build_localized_vector(_system->system(),
                                                          *_base_sol).release());
     
-    for (unsigned int i=0; i<n_basis; i++)
-        localized_basis[i] = build_localized_vector(_system->system(), *basis[i]).release();
+    const bool
+    if_delete_basis = _localize_basis(basis, localized_basis);
     
     //create a zero-clone copy for the imaginary component of the solution
     localized_zero.reset(localized_basis[0]->zero_clone().release());
@@ -165,17 +165,20 @@ assemble_generalized_aerodynamic_force_matrix
     MAST::FluidStructureAssemblyElemOperations&
     ops = dynamic_cast<MAST::FluidStructureAssemblyElemOperations&>(*_elem_ops);
     
-    // iterate over each structural mode to calculate the
-    // fluid small-disturbance solution
-    for (unsigned int i=0; i<n_basis; i++) {
+    const libMesh::DofMap& dof_map = _system->system().get_dof_map();
+    
+    // set up the fluid flexible-surface boundary condition for the i^th mode
+    std::function<void(unsigned int)>
+    init_rhs = [&] (unsigned int i) {
         
-        // set up the fluid flexible-surface boundary condition for this mode
         _complex_displ->clear();
         _complex_displ->init(*localized_basis[i], *localized_zero);
-        
-        
-        // solve the complex smamll-disturbance fluid-equations
-        _fluid_complex_solver->solve_block_matrix(p);
+    };
+    
+    // project the force from the fluid solution for the i^th mode on the
+    // structural modes
+    std::function<void(unsigned int)>
+    use_sol = [&] (unsigned int i) {
         
         // use this solution to initialize the structural boundary conditions
         _pressure_function->init(_fluid_complex_assembly->base_sol());
@@ -187,8 +190,6 @@ assemble_generalized_aerodynamic_force_matrix
          _fluid_complex_solver->imag_solution(p != nullptr));
 
         
-        const libMesh::DofMap& dof_map = _system->system().get_dof_map();
-        
         // assemble the complex small-disturbance force vector force vector
         libMesh::MeshBase::const_element_iterator       el     =
         _system->system().get_mesh().active_local_elements_begin();
@@ -254,7 +255,15 @@ assemble_generalized_aerodynamic_force_matrix
             
 //            physics_elem->detach_active_solution_function();
         }
-    }
+    };
+    
+    
+    // solve the complex small-disturbance fluid-equations for all the
+    // structural modes with the same fluid operator
+    _fluid_complex_solver->solve_block_matrix_multiple_rhs(n_basis,
+                                                           init_rhs,
+                                                           use_sol,
+                                                           p);
     
     
     
@@ -264,8 +273,9 @@ assemble_generalized_aerodynamic_force_matrix
     
     
     // delete the localized basis vectors
-    for (unsigned int i=0; i<basis.size(); i++)
-        delete localized_basis[i];
+    if (if_delete_basis)
+        for (unsigned int i=0; i<basis.size(); i++)
+            delete localized_basis[i];
     
     // sum the matrix and provide it to each processor
     // this assumes that the structural comm is a subset of fluid comm
@@ -0,0 +1,602 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2018  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <cmath>
+
+// MAST includes
+#include "elasticity/gaf_database_assembly.h"
+#include "base/parameter.h"
+#include "base/nonlinear_system.h"
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+
+
+
+/*!
+ *   lag roots of the rational function approximation distributed over the
+ *   sampled range of reduced frequencies.
+ */
+void
+__mast_gaf_lag_roots(unsigned int n_lag,
+                     Real kr_max,
+                     std::vector<Real>& lag) {
+    
+    lag.resize(n_lag);
+    
+    for (unsigned int i=0; i<n_lag; i++)
+        lag[i] = 1.7 * kr_max * pow((i+1.)/(n_lag+1.), 2);
+}
+
+
+
+/*!
+ *   terms of the rational function approximation, or their derivatives with
+ *   respect to kr if \p if_deriv is true.
+ */
+void
+__mast_gaf_rfa_terms(Real kr,
+                     const std::vector<Real>& lag,
+                     bool if_deriv,
+                     std::vector<Complex>& phi) {
+    
+    const Complex
+    ik (0., kr),
+    iu (0., 1.);
+    
+    phi.resize(3+lag.size());
+    
+    if (!if_deriv) {
+        
+        phi[0] = 1.;
+        phi[1] = ik;
+        phi[2] = ik*ik;
+        for (unsigned int i=0; i<lag.size(); i++)
+            phi[3+i] = ik/(ik + lag[i]);
+    }
+    else {
+        
+        phi[0] = 0.;
+        phi[1] = iu;
+        phi[2] = -2.*kr;
+        for (unsigned int i=0; i<lag.size(); i++)
+            phi[3+i] = iu*lag[i]/pow(ik + lag[i], 2);
+    }
+}
+
+
+
+/*!
+ *   fits the real coefficient matrices of the approximation to the samples
+ *   in a least-squares sense. @returns false if there are not enough samples.
+ */
+bool
+__mast_gaf_rfa_fit(const std::map<Real, ComplexMatrixX>& samples,
+                   const std::vector<Real>& lag,
+                   std::vector<RealMatrixX>& coeffs) {
+    
+    const unsigned int
+    n_terms   = (unsigned int)lag.size() + 3,
+    n_samples = (unsigned int)samples.size();
+    
+    if (n_samples < n_terms)
+        return false;
+    
+    const unsigned int
+    n      = (unsigned int)samples.begin()->second.rows();
+    
+    // the real and imaginary parts of the approximation at each sample
+    // provide two rows of the least-squares system. The right-hand side
+    // has a column for each entry of the GAF matrix.
+    RealMatrixX
+    A   = RealMatrixX::Zero(2*n_samples, n_terms),
+    rhs = RealMatrixX::Zero(2*n_samples, n*n),
+    x;
+    
+    std::vector<Complex> phi;
+    
+    std::map<Real, ComplexMatrixX>::const_iterator
+    it  = samples.begin(),
+    end = samples.end();
+    
+    for (unsigned int i=0; it != end; it++, i++) {
+        
+        __mast_gaf_rfa_terms(it->first, lag, false, phi);
+        
+        for (unsigned int j=0; j<n_terms; j++) {
+            
+            A(2*i,   j) = phi[j].real();
+            A(2*i+1, j) = phi[j].imag();
+        }
+        
+        for (unsigned int j=0; j<n; j++)
+            for (unsigned int k=0; k<n; k++) {
+                
+                rhs(2*i,   j*n+k) = it->second(j,k).real();
+                rhs(2*i+1, j*n+k) = it->second(j,k).imag();
+            }
+    }
+    
+    x = A.colPivHouseholderQr().solve(rhs);
+    
+    coeffs.resize(n_terms);
+    
+    for (unsigned int i=0; i<n_terms; i++) {
+        
+        coeffs[i].setZero(n, n);
+        
+        for (unsigned int j=0; j<n; j++)
+            for (unsigned int k=0; k<n; k++)
+                coeffs[i](j,k) = x(i, j*n+k);
+    }
+    
+    return true;
+}
+
+
+
+/*!
+ *   evaluates the approximation, or its derivative with respect to kr if
+ *   \p if_deriv is true.
+ */
+void
+__mast_gaf_rfa_eval(Real kr,
+                    const std::vector<Real>& lag,
+                    const std::vector<RealMatrixX>& coeffs,
+                    bool if_deriv,
+                    ComplexMatrixX& mat) {
+    
+    std::vector<Complex> phi;
+    __mast_gaf_rfa_terms(kr, lag, if_deriv, phi);
+    
+    mat.setZero(coeffs[0].rows(), coeffs[0].cols());
+    
+    for (unsigned int i=0; i<coeffs.size(); i++)
+        mat += phi[i] * coeffs[i].cast<Complex>();
+}
+
+
+
+
+MAST::GAFDatabaseAssembly::GAFDatabaseAssembly():
+MAST::FSIGeneralizedAeroForceAssembly(),
+_kr_param      (nullptr),
+_n_lag         (4),
+_refine_tol    (0.),
+_if_fit        (false) {
+    
+}
+
+
+
+MAST::GAFDatabaseAssembly::~GAFDatabaseAssembly() {
+    
+}
+
+
+
+void
+MAST::GAFDatabaseAssembly::set_reduced_frequency_parameter(MAST::Parameter& kr) {
+    
+    _kr_param = &kr;
+}
+
+
+
+void
+MAST::GAFDatabaseAssembly::set_n_lag_terms(unsigned int n) {
+    
+    _n_lag  = n;
+    _if_fit = false;
+}
+
+
+
+void
+MAST::GAFDatabaseAssembly::set_refinement_tolerance(Real tol) {
+    
+    libmesh_assert_greater_equal(tol, 0.);
+    
+    _refine_tol = tol;
+}
+
+
+
+void
+MAST::GAFDatabaseAssembly::
+add_samples(std::vector<libMesh::NumericVector<Real>*>& basis,
+            const std::vector<Real>& kr) {
+    
+    libmesh_assert(_kr_param);
+    
+    this->_check_basis(basis);
+    
+    const Real
+    kr0 = (*_kr_param)();
+    
+    for (unsigned int i=0; i<kr.size(); i++)
+        if (!_samples.count(kr[i]))
+            this->_add_sample(basis, kr[i]);
+    
+    (*_kr_param) = kr0;
+}
+
+
+
+Real
+MAST::GAFDatabaseAssembly::interpolation_error_estimate(Real kr) const {
+    
+    if (_samples.size() < _n_lag + 4)
+        return -1.;
+    
+    std::vector<Real>
+    lag;
+    std::vector<RealMatrixX>
+    coeffs,
+    coeffs_reduced;
+    
+    __mast_gaf_lag_roots(_n_lag, _samples.rbegin()->first, lag);
+    __mast_gaf_rfa_fit(_samples, lag, coeffs);
+    
+    // approximation without the sample nearest to kr
+    std::map<Real, ComplexMatrixX>
+    reduced = _samples;
+    
+    std::map<Real, ComplexMatrixX>::iterator
+    it = reduced.lower_bound(kr);
+    
+    if (it == reduced.end())
+        it--;
+    else if (it != reduced.begin()) {
+        
+        std::map<Real, ComplexMatrixX>::iterator
+        it_prev = it;
+        it_prev--;
+        
+        if (kr - it_prev->first < it->first - kr)
+            it = it_prev;
+    }
+    
+    reduced.erase(it);
+    
+    __mast_gaf_rfa_fit(reduced, lag, coeffs_reduced);
+    
+    ComplexMatrixX
+    m1,
+    m2;
+    
+    __mast_gaf_rfa_eval(kr, lag, coeffs,         false, m1);
+    __mast_gaf_rfa_eval(kr, lag, coeffs_reduced, false, m2);
+    
+    return (m1-m2).norm()/std::max(m1.norm(), std::numeric_limits<Real>::min());
+}
+
+
+
+void
+MAST::GAFDatabaseAssembly::clear_database() {
+    
+    _samples.clear();
+    _basis_signature.clear();
+    _lag_roots.clear();
+    _coeffs.clear();
+    _if_fit = false;
+}
+
+
+
+void
+MAST::GAFDatabaseAssembly::write_database(const std::string& nm) const {
+    
+    libmesh_assert(_system);
+    
+    if (this->system().comm().rank() != 0)
+        return;
+    
+    std::ofstream out;
+    out.open(nm.c_str(), std::ofstream::out);
+    
+    if (!out.good())
+        libmesh_error_msg("Unable to open file: " << nm);
+    
+    out << std::setprecision(std::numeric_limits<Real>::max_digits10);
+    
+    const unsigned int
+    n = _samples.size()?(unsigned int)_samples.begin()->second.rows():0;
+    
+    out
+    << n << std::endl
+    << _basis_signature.size() << std::endl;
+    
+    for (unsigned int i=0; i<_basis_signature.size(); i++)
+        out << _basis_signature[i] << std::endl;
+    
+    out << _samples.size() << std::endl;
+    
+    std::map<Real, ComplexMatrixX>::const_iterator
+    it  = _samples.begin(),
+    end = _samples.end();
+    
+    for ( ; it != end; it++) {
+        
+        out << it->first << std::endl;
+        
+        for (unsigned int i=0; i<n; i++) {
+            for (unsigned int j=0; j<n; j++)
+                out
+                << " " << it->second(i,j).real()
+                << " " << it->second(i,j).imag();
+            out << std::endl;
+        }
+    }
+}
+
+
+
+bool
+MAST::GAFDatabaseAssembly::
+read_database(const std::string& nm,
+              std::vector<libMesh::NumericVector<Real>*>& basis) {
+    
+    libmesh_assert(_system);
+    
+    const libMesh::Parallel::Communicator&
+    comm = this->system().comm();
+    
+    // the file is read on processor 0 into a buffer that is broadcast
+    // to all processors:
+    // n, n_signature, signature, n_samples, (kr, GAF matrix) ...
+    std::vector<Real>
+    buf;
+    
+    if (comm.rank() == 0) {
+        
+        std::ifstream input;
+        input.open(nm.c_str(), std::ifstream::in);
+        
+        Real
+        v = 0.;
+        
+        while (input.good() && input >> v)
+            buf.push_back(v);
+    }
+    
+    unsigned int
+    n_buf = (unsigned int)buf.size();
+    comm.broadcast(n_buf);
+    buf.resize(n_buf);
+    comm.broadcast(buf);
+    
+    if (n_buf < 3)
+        return false;
+    
+    unsigned int
+    idx   = 0;
+    
+    const unsigned int
+    n     = (unsigned int)buf[idx++],
+    n_sig = (unsigned int)buf[idx++];
+    
+    if (n != basis.size() || idx + n_sig + 1 > n_buf)
+        return false;
+    
+    std::vector<Real>
+    sig(buf.begin()+idx, buf.begin()+idx+n_sig);
+    idx += n_sig;
+    
+    // compare with the signature of the current basis
+    std::vector<Real>
+    sig_old = _basis_signature;
+    std::map<Real, ComplexMatrixX>
+    samples_old = _samples;
+    
+    _basis_signature = sig;
+    this->_check_basis(basis);
+    
+    if (_basis_signature != sig) {
+        
+        // restore the database
+        _basis_signature = sig_old;
+        _samples         = samples_old;
+        return false;
+    }
+    
+    const unsigned int
+    n_samples = (unsigned int)buf[idx++];
+    
+    if (idx + n_samples*(1+2*n*n) > n_buf)
+        libmesh_error_msg("Incomplete GAF database in file: " << nm);
+    
+    _samples.clear();
+    
+    for (unsigned int i=0; i<n_samples; i++) {
+        
+        const Real
+        kr = buf[idx++];
+        
+        ComplexMatrixX
+        &mat = _samples[kr];
+        
+        mat.setZero(n, n);
+        
+        for (unsigned int j=0; j<n; j++)
+            for (unsigned int k=0; k<n; k++) {
+                
+                mat(j,k) = Complex(buf[idx], buf[idx+1]);
+                idx += 2;
+            }
+    }
+    
+    _if_fit = false;
+    
+    return true;
+}
+
+
+
+void
+MAST::GAFDatabaseAssembly::assemble_generalized_aerodynamic_force_matrix
+(std::vector<libMesh::NumericVector<Real>*>& basis,
+ ComplexMatrixX& mat,
+ MAST::Parameter* p) {
+    
+    libmesh_assert(_kr_param);
+    
+    this->_check_basis(basis);
+    
+    const Real
+    kr = (*_kr_param)();
+    
+    // the sensitivity with respect to parameters other than the reduced
+    // frequency requires the fluid solution at kr. The fluid solver may
+    // hold the solution of a different sample, so this is recomputed.
+    if (p && p != _kr_param) {
+        
+        this->_add_sample(basis, kr);
+        
+        MAST::FSIGeneralizedAeroForceAssembly::
+        assemble_generalized_aerodynamic_force_matrix(basis, mat, p);
+        return;
+    }
+    
+    // the fluid solution is computed if there are not enough samples for
+    // the approximation, if kr is outside the sampled range, or if the
+    // estimated error is larger than the refinement tolerance.
+    const bool
+    if_fit = _samples.size() >= _n_lag + 3;
+    
+    bool
+    if_fluid = !if_fit ||
+    kr < _samples.begin()->first ||
+    kr > _samples.rbegin()->first;
+    
+    if (!if_fluid && !p && _samples.count(kr)) {
+        
+        mat = _samples[kr];
+        return;
+    }
+    
+    if (!if_fluid && _refine_tol > 0.) {
+        
+        const Real
+        err = this->interpolation_error_estimate(kr);
+        
+        if_fluid = err < 0. || err > _refine_tol;
+    }
+    
+    bool
+    if_solved = false;
+    
+    if (if_fluid && !_samples.count(kr)) {
+        
+        this->_add_sample(basis, kr);
+        if_solved = true;
+    }
+    
+    if (!p) {
+        
+        if (_samples.count(kr))
+            mat = _samples[kr];
+        else {
+            
+            this->_update_fit();
+            __mast_gaf_rfa_eval(kr, _lag_roots, _coeffs, false, mat);
+        }
+    }
+    else if (_samples.size() >= _n_lag + 3) {
+        
+        this->_update_fit();
+        __mast_gaf_rfa_eval(kr, _lag_roots, _coeffs, true, mat);
+    }
+    else {
+        
+        // the sensitivity solution uses the fluid solution at kr, which
+        // is recomputed if the GAF matrix was available from the samples
+        if (!if_solved)
+            this->_add_sample(basis, kr);
+        
+        MAST::FSIGeneralizedAeroForceAssembly::
+        assemble_generalized_aerodynamic_force_matrix(basis, mat, p);
+    }
+}
+
+
+
+void
+MAST::GAFDatabaseAssembly::
+_add_sample(std::vector<libMesh::NumericVector<Real>*>& basis,
+            Real kr) {
+    
+    (*_kr_param) = kr;
+    
+    ComplexMatrixX
+    &mat = _samples[kr];
+    
+    MAST::FSIGeneralizedAeroForceAssembly::
+    assemble_generalized_aerodynamic_force_matrix(basis, mat, nullptr);
+    
+    _if_fit = false;
+}
+
+
+
+void
+MAST::GAFDatabaseAssembly::
+_check_basis(std::vector<libMesh::NumericVector<Real>*>& basis) {
+    
+    std::vector<Real>
+    sig(2*basis.size(), 0.);
+    
+    for (unsigned int i=0; i<basis.size(); i++) {
+        
+        sig[2*i]   = basis[i]->l2_norm();
+        sig[2*i+1] = basis[i]->sum();
+    }
+    
+    bool
+    if_same = sig.size() == _basis_signature.size();
+    
+    for (unsigned int i=0; if_same && i<sig.size(); i++)
+        if_same = std::fabs(sig[i] - _basis_signature[i]) <=
+        1.e-10 * std::max(1., std::fabs(sig[i]));
+    
+    if (!if_same) {
+        
+        this->clear_database();
+        _basis_signature = sig;
+    }
+}
+
+
+
+void
+MAST::GAFDatabaseAssembly::_update_fit() {
+    
+    if (_if_fit)
+        return;
+    
+    __mast_gaf_lag_roots(_n_lag, _samples.rbegin()->first, _lag_roots);
+    _if_fit = __mast_gaf_rfa_fit(_samples, _lag_roots, _coeffs);
+    
+    libmesh_assert(_if_fit);
+}
@@ -0,0 +1,234 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2018  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__gaf_database_assembly_h__
+#define __mast__gaf_database_assembly_h__
+
+// C++ includes
+#include <map>
+#include <vector>
+#include <string>
+
+// MAST includes
+#include "elasticity/fsi_generalized_aero_force_assembly.h"
+
+
+namespace MAST {
+    
+    // forward declerations
+    class Parameter;
+    
+    /*!
+     *   Stores the generalized aerodynamic force (GAF) matrices computed by
+     *   MAST::FSIGeneralizedAeroForceAssembly at a set of reduced frequency
+     *   samples, and provides the GAF matrix at intermediate reduced
+     *   frequencies from a Roger rational function approximation
+     *
+     *   A(kr) = A_0 + A_1 (i kr) + A_2 (i kr)^2 +
+     *           sum_l A_{l+2} (i kr)/(i kr + b_l),
+     *
+     *   where A_j are real matrices fitted to the samples in a least-squares
+     *   sense, and b_l are the lag roots distributed over the sampled range.
+     *   The fluid solution is computed only for new samples.
+     *
+     *   The error of the approximation at a reduced frequency is estimated
+     *   as the difference with the approximation obtained without the
+     *   nearest sample. If a refinement tolerance is set and this estimate
+     *   exceeds it, then the fluid solution is computed at the requested
+     *   reduced frequency, which is added to the samples.
+     *
+     *   The samples are associated with the basis for which they were
+     *   computed, and are removed if the assembly is called for a different
+     *   basis. Changes to the fluid base solution or flight conditions
+     *   require a call to clear_database(). The samples can be written to,
+     *   and read from, a file so that repeated analyses of the same
+     *   configuration skip the fluid solutions.
+     */
+    class GAFDatabaseAssembly:
+    public MAST::FSIGeneralizedAeroForceAssembly {
+        
+    public:
+        
+        /*!
+         *   default constructor
+         */
+        GAFDatabaseAssembly();
+        
+        
+        /*!
+         *   destructor
+         */
+        virtual ~GAFDatabaseAssembly();
+        
+        
+        /*!
+         *   sets the parameter that defines the reduced frequency for the
+         *   fluid solution. This is the parameter set by the flutter solver,
+         *   and must be provided before the GAF matrices are requested.
+         */
+        void set_reduced_frequency_parameter(MAST::Parameter& kr);
+        
+        
+        /*!
+         *   sets the number of lag terms in the rational function
+         *   approximation. The default is 4.
+         */
+        void set_n_lag_terms(unsigned int n);
+        
+        
+        /*!
+         *   sets the tolerance on the estimated relative error of the
+         *   approximation above which the fluid solution is computed at the
+         *   requested reduced frequency. A zero value, which is the default,
+         *   disables refinement.
+         */
+        void set_refinement_tolerance(Real tol);
+        
+        
+        /*!
+         *   computes the GAF matrices for \p basis at the reduced
+         *   frequencies in \p kr that are not already available.
+         */
+        void add_samples(std::vector<libMesh::NumericVector<Real>*>& basis,
+                         const std::vector<Real>& kr);
+        
+        
+        /*!
+         *   @returns the number of reduced frequency samples
+         */
+        unsigned int n_samples() const {
+            return (unsigned int)_samples.size();
+        }
+        
+        
+        /*!
+         *   @returns the estimated relative error of the approximation at
+         *   \p kr. A negative value is returned if there are not enough
+         *   samples to estimate the error.
+         */
+        Real interpolation_error_estimate(Real kr) const;
+        
+        
+        /*!
+         *   removes the samples
+         */
+        void clear_database();
+        
+        
+        /*!
+         *   writes the samples to the file \p nm on processor 0. The norms
+         *   of the basis vectors are written along with the samples to
+         *   identify the basis.
+         */
+        void write_database(const std::string& nm) const;
+        
+        
+        /*!
+         *   reads the samples from the file \p nm, written by
+         *   write_database(). @returns false, without modifying the
+         *   samples, if the file does not exist or was written for a
+         *   different \p basis. This must be called on all processors.
+         */
+        bool read_database(const std::string& nm,
+                           std::vector<libMesh::NumericVector<Real>*>& basis);
+        
+        
+        /*!
+         *   @returns in \p mat the GAF matrix at the reduced frequency defined
+         *   by the parameter provided in set_reduced_frequency_parameter().
+         *   If \p p is the reduced frequency parameter, then the derivative
+         *   of the approximation is returned. Sensitivity with respect to
+         *   other parameters is computed from the fluid solution.
+         */
+        virtual void
+        assemble_generalized_aerodynamic_force_matrix
+        (std::vector<libMesh::NumericVector<Real>*>& basis,
+         ComplexMatrixX& mat,
+         MAST::Parameter* p = nullptr);
+        
+    protected:
+        
+        /*!
+         *   computes the GAF matrix for \p basis at \p kr from the fluid
+         *   solution and adds it to the samples
+         */
+        void _add_sample(std::vector<libMesh::NumericVector<Real>*>& basis,
+                         Real kr);
+        
+        
+        /*!
+         *   clears the samples if these were computed for a basis other
+         *   than \p basis
+         */
+        void _check_basis(std::vector<libMesh::NumericVector<Real>*>& basis);
+        
+        
+        /*!
+         *   updates the lag roots and the coefficients of the approximation
+         *   from the samples
+         */
+        void _update_fit();
+        
+        
+        /*!
+         *   parameter that defines the reduced frequency
+         */
+        MAST::Parameter*                          _kr_param;
+        
+        
+        /*!
+         *   number of lag terms in the approximation
+         */
+        unsigned int                              _n_lag;
+        
+        
+        /*!
+         *   tolerance on the estimated error for refinement
+         */
+        Real                                      _refine_tol;
+        
+        
+        /*!
+         *   GAF matrices at the reduced frequency samples
+         */
+        std::map<Real, ComplexMatrixX>            _samples;
+        
+        
+        /*!
+         *   norm and sum of each basis vector used for the samples
+         */
+        std::vector<Real>                         _basis_signature;
+        
+        
+        /*!
+         *   true if the approximation is consistent with the samples
+         */
+        bool                                      _if_fit;
+        
+        
+        /*!
+         *   lag roots and coefficient matrices of the approximation
+         */
+        std::vector<Real>                         _lag_roots;
+        std::vector<RealMatrixX>                  _coeffs;
+    };
+}
+
+
+#endif // __mast__gaf_database_assembly_h__
@@ -241,5 +241,8 @@ MAST::LevelSetStressAssembly::build_fe() {
     std::unique_ptr<MAST::FEBase>
     fe(new MAST::SubCellFE(*_system, *_intersection));
 
+    if (_if_reuse_fe)
+        fe->set_object_pool(*_fe_pool);
+    
     return fe;
 }
@@ -27,6 +27,7 @@
 #include "numerics/fem_operator_matrix.h"
 #include "mesh/local_3d_elem.h"
 #include "mesh/fe_base.h"
+#include "base/performance_counters.h"
 #include "property_cards/element_property_card_base.h"
 
 
@@ -139,6 +140,10 @@ MAST::StructuralElement3D::internal_residual(bool request_jacobian,
                                              RealVectorX& f,
                                              RealMatrixX& jac) {
     
+    // the exclusive time of this phase is the quadrature point physics,
+    // and the evaluation of the material properties is recorded separately
+    MAST::PerformanceScope perf("StructuralElement3D::internal_residual");
+    
     const std::vector<Real>& JxW            = _fe->get_JxW();
     const std::vector<libMesh::Point>& xyz  = _fe->get_xyz();
     const unsigned int
@@ -176,8 +181,13 @@ MAST::StructuralElement3D::internal_residual(bool request_jacobian,
     // copy the values from the global to the local element
     local_disp.topRows(n2) = _local_sol.topRows(n2);
     
-    std::unique_ptr<MAST::FieldFunction<RealMatrixX> > mat_stiff =
-    _property.stiffness_A_matrix(*this);
+    std::unique_ptr<MAST::FieldFunction<RealMatrixX> > mat_stiff;
+    
+    {
+        MAST::PerformanceScope
+        perf_prop("StructuralElement3D::internal_residual::property_cards");
+        mat_stiff = _property.stiffness_A_matrix(*this);
+    }
     
     MAST::FEMOperatorMatrix
     Bmat_lin,
@@ -267,7 +277,11 @@ MAST::StructuralElement3D::internal_residual(bool request_jacobian,
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
         // get the material matrix
-        (*mat_stiff)(xyz[qp], _time, material_mat);
+        {
+            MAST::PerformanceScope
+            perf_prop("StructuralElement3D::internal_residual::property_cards");
+            (*mat_stiff)(xyz[qp], _time, material_mat);
+        }
         
         this->initialize_green_lagrange_strain_operator(qp,
                                                         *_fe,
@@ -1252,7 +1266,7 @@ initialize_incompatible_strain_operator(const unsigned int qp,
     RealVectorX phi_vec = RealVectorX::Zero(1);
     
     // get the location of element coordinates
-    const std::vector<libMesh::Point>& q_point = fe.get_qrule().get_points();
+    const std::vector<libMesh::Point>& q_point = fe.get_qpoints();
     const Real
     xi  = q_point[qp](0),
     eta = q_point[qp](1),
@@ -301,6 +301,14 @@ namespace MAST {
          */
         virtual void evaluate_sensitivity(const MAST::FunctionBase& f);
 
+        /*!
+         *    stress and strain sensitivity is stored for each parameter
+         *    in the element data.
+         */
+        virtual bool if_stores_sensitivity_per_parameter() const {
+            return true;
+        }
+
         /*!
          *    this evaluates all relevant shape sensitivity components on
          *    the element.
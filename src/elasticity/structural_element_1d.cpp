@@ -32,6 +32,7 @@
 #include "base/assembly_base.h"
 #include "mesh/fe_base.h"
 #include "mesh/local_1d_elem.h"
+#include "base/performance_counters.h"
 
 
 MAST::StructuralElement1D::StructuralElement1D(MAST::SystemInitialization& sys,
@@ -557,6 +558,10 @@ MAST::StructuralElement1D::internal_residual (bool request_jacobian,
                                               RealVectorX& f,
                                               RealMatrixX& jac)
 {
+    // the exclusive time of this phase is the quadrature point physics,
+    // and the evaluation of the section properties is recorded separately
+    MAST::PerformanceScope perf("StructuralElement1D::internal_residual");
+    
     const std::vector<Real>& JxW           = _fe->get_JxW();
     const std::vector<libMesh::Point>& xyz = _fe->get_xyz();
     const unsigned int
@@ -607,18 +612,30 @@ MAST::StructuralElement1D::internal_residual (bool request_jacobian,
     if_bending = (_property.bending_model(_elem, _fe->get_fe_type()) != MAST::NO_BENDING);
     
     std::unique_ptr<MAST::FieldFunction<RealMatrixX > >
-    mat_stiff_A  = _property.stiffness_A_matrix(*this),
-    mat_stiff_B  = _property.stiffness_B_matrix(*this),
-    mat_stiff_D  = _property.stiffness_D_matrix(*this);
+    mat_stiff_A,
+    mat_stiff_B,
+    mat_stiff_D;
+    
+    {
+        MAST::PerformanceScope
+        perf_prop("StructuralElement1D::internal_residual::property_cards");
+        mat_stiff_A  = _property.stiffness_A_matrix(*this);
+        mat_stiff_B  = _property.stiffness_B_matrix(*this);
+        mat_stiff_D  = _property.stiffness_D_matrix(*this);
+    }
     
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
         // get the material matrix
-        (*mat_stiff_A)(xyz[qp], _time, material_A_mat);
-        
-        if (if_bending) {
-            (*mat_stiff_B)(xyz[qp], _time, material_B_mat);
-            (*mat_stiff_D)(xyz[qp], _time, material_D_mat);
+        {
+            MAST::PerformanceScope
+            perf_prop("StructuralElement1D::internal_residual::property_cards");
+            (*mat_stiff_A)(xyz[qp], _time, material_A_mat);
+            
+            if (if_bending) {
+                (*mat_stiff_B)(xyz[qp], _time, material_B_mat);
+                (*mat_stiff_D)(xyz[qp], _time, material_D_mat);
+            }
         }
         
         // now calculte the quantity for these matrices
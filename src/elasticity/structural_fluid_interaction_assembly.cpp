@@ -25,8 +25,11 @@
 #include "base/system_initialization.h"
 #include "base/mesh_field_function.h"
 #include "base/nonlinear_system.h"
+#include "base/physics_discipline_base.h"
 #include "base/assembly_elem_operation.h"
+#include "base/element_matrix_cache.h"
 #include "numerics/utility.h"
+#include "base/performance_counters.h"
 
 // libMesh includes
 #include "libmesh/numeric_vector.h"
@@ -62,6 +65,7 @@ clear_discipline_and_system( ) {
     
     _base_sol             = nullptr;
     _base_sol_sensitivity = nullptr;
+    this->clear_localized_basis();
     
     MAST::AssemblyBase::clear_discipline_and_system();
 }
@@ -101,12 +105,59 @@ MAST::StructuralFluidInteractionAssembly::clear_base_solution(bool if_sens) {
 
 
 
+void
+MAST::StructuralFluidInteractionAssembly::
+attach_localized_basis(const std::vector<libMesh::NumericVector<Real>*>& basis,
+                       const std::vector<libMesh::NumericVector<Real>*>& localized) {
+    
+    libmesh_assert_equal_to(basis.size(), localized.size());
+    
+    _attached_basis           = basis;
+    _attached_localized_basis = localized;
+}
+
+
+
+
+void
+MAST::StructuralFluidInteractionAssembly::clear_localized_basis() {
+    
+    _attached_basis.clear();
+    _attached_localized_basis.clear();
+}
+
+
+
+
+bool
+MAST::StructuralFluidInteractionAssembly::
+_localize_basis(const std::vector<libMesh::NumericVector<Real>*>& basis,
+                std::vector<libMesh::NumericVector<Real>*>& localized) const {
+    
+    if (_attached_basis.size() && _attached_basis == basis) {
+        
+        localized = _attached_localized_basis;
+        return false;
+    }
+    
+    localized.resize(basis.size());
+    for (unsigned int i=0; i<basis.size(); i++)
+        localized[i] = build_localized_vector(_system->system(), *basis[i]).release();
+    
+    return true;
+}
+
+
+
+
 void
 MAST::StructuralFluidInteractionAssembly::
 assemble_reduced_order_quantity
 (std::vector<libMesh::NumericVector<Real>*>& basis,
  std::map<MAST::StructuralQuantityType, RealMatrixX*>& mat_qty_map) {
     
+    MAST::PerformanceScope perf("StructuralFluidInteractionAssembly::assemble_reduced_order_quantity");
+    
     libmesh_assert(_elem_ops);
     
     MAST::NonlinearSystem& nonlin_sys = _system->system();
@@ -137,9 +188,9 @@ assemble_reduced_order_quantity
                                                         *_base_sol).release());
     
     // also create localized solution vectos for the bassis vectors
-    std::vector<libMesh::NumericVector<Real>*> localized_basis(n_basis);
-    for (unsigned int i=0; i<n_basis; i++)
-        localized_basis[i] = build_localized_vector(nonlin_sys, *basis[i]).release();
+    std::vector<libMesh::NumericVector<Real>*> localized_basis;
+    const bool
+    if_delete_basis = _localize_basis(basis, localized_basis);
     
     
     // if a solution function is attached, initialize it
@@ -155,6 +206,14 @@ assemble_reduced_order_quantity
     MAST::FluidStructureAssemblyElemOperations
     &ops = dynamic_cast<MAST::FluidStructureAssemblyElemOperations&>(*_elem_ops);
     
+    // the element matrices are cached only for quantities about a
+    // zero base solution
+    MAST::ElementMatrixCache
+    *cache = _base_sol?nullptr:_elem_mat_cache.get();
+    
+    if (cache)
+        cache->validate(&ops, *_discipline);
+    
     for ( ; el != end_el; ++el) {
         
         const libMesh::Elem* elem = *el;
@@ -178,14 +237,27 @@ assemble_reduced_order_quantity
                 basis_mat(i,j) = (*localized_basis[j])(dof_indices[i]);
         }
         
+        // the element is initialized only if one of the quantities
+        // is not available in the cache
+        bool
+        if_init = !cache;
+        
+        it   = mat_qty_map.begin();
+        end  = mat_qty_map.end();
+        
+        for ( ; !if_init && it != end; it++)
+            if_init = !cache->contains(*elem, it->first);
         
         //        if (_sol_function)
         //            physics_elem->attach_active_solution_function(*_sol_function);
         
-        _elem_ops->init(*elem);
-        _elem_ops->set_elem_solution(sol);
-        _elem_ops->set_elem_velocity(vec);     // set to zero value
-        _elem_ops->set_elem_acceleration(vec); // set to zero value
+        if (if_init) {
+            
+            _elem_ops->init(*elem);
+            _elem_ops->set_elem_solution(sol);
+            _elem_ops->set_elem_velocity(vec);     // set to zero value
+            _elem_ops->set_elem_acceleration(vec); // set to zero value
+        }
         
         
         // now iterative over all qty types in the map and assemble them
@@ -194,8 +266,16 @@ assemble_reduced_order_quantity
         
         for ( ; it != end; it++) {
             
-            ops.set_qty_to_evaluate(it->first);
-            ops.elem_calculations(true, vec, mat);
+            if (if_init) {
+                
+                ops.set_qty_to_evaluate(it->first);
+                ops.elem_calculations(true, vec, mat);
+                
+                if (cache)
+                    cache->store(*elem, it->first, mat);
+            }
+            else
+                cache->get(*elem, it->first, mat);
             
             DenseRealMatrix m;
             MAST::copy(m, mat);
@@ -206,7 +286,8 @@ assemble_reduced_order_quantity
             (*it->second) += basis_mat.transpose() * mat * basis_mat;
         }
         
-        _elem_ops->clear_elem();
+        if (if_init)
+            _elem_ops->clear_elem();
         //        physics_elem->detach_active_solution_function();
         
     }
@@ -218,8 +299,9 @@ assemble_reduced_order_quantity
     
     
     // delete the localized basis vectors
-    for (unsigned int i=0; i<basis.size(); i++)
-        delete localized_basis[i];
+    if (if_delete_basis)
+        for (unsigned int i=0; i<basis.size(); i++)
+            delete localized_basis[i];
     
     // sum the matrix and provide it to each processor
     it  = mat_qty_map.begin();
@@ -241,49 +323,121 @@ assemble_reduced_order_quantity_sensitivity
  std::vector<libMesh::NumericVector<Real>*>& basis,
  std::map<MAST::StructuralQuantityType, RealMatrixX*>& mat_qty_map) {
     
+    std::vector<const MAST::FunctionBase*>
+    f_vec(1, &f);
+    
+    std::vector<const libMesh::NumericVector<Real>*>
+    sens_vec;
+    
+    std::vector<std::vector<RealMatrixX> >
+    mats(mat_qty_map.size(), std::vector<RealMatrixX>(1));
+    
+    std::map<MAST::StructuralQuantityType, std::vector<RealMatrixX>*>
+    vec_qty_map;
+    
+    std::map<MAST::StructuralQuantityType, RealMatrixX*>::iterator
+    it  = mat_qty_map.begin(),
+    end = mat_qty_map.end();
+    
+    for (unsigned int i=0; it != end; it++, i++)
+        vec_qty_map[it->first] = &mats[i];
+    
+    this->assemble_reduced_order_quantity_sensitivity(f_vec,
+                                                      sens_vec,
+                                                      basis,
+                                                      vec_qty_map);
+    
+    it = mat_qty_map.begin();
+    for (unsigned int i=0; it != end; it++, i++)
+        it->second->swap(mats[i][0]);
+}
+
+
+
+void
+MAST::StructuralFluidInteractionAssembly::
+assemble_reduced_order_quantity_sensitivity
+(const std::vector<const MAST::FunctionBase*>& f,
+ const std::vector<const libMesh::NumericVector<Real>*>& base_sol_sens,
+ std::vector<libMesh::NumericVector<Real>*>& basis,
+ std::map<MAST::StructuralQuantityType, std::vector<RealMatrixX>*>& mat_qty_map) {
+    
+    MAST::PerformanceScope perf("StructuralFluidInteractionAssembly::assemble_reduced_order_quantity_sensitivity");
+    
+    libmesh_assert(base_sol_sens.empty() || base_sol_sens.size() == f.size());
     
     MAST::NonlinearSystem& nonlin_sys = _system->system();
     
-    unsigned int
-    n_basis = (unsigned int)basis.size();
+    const unsigned int
+    n_basis  = (unsigned int)basis.size(),
+    n_params = (unsigned int)f.size();
     
     
     // initialize the quantities to zero matrices
-    std::map<MAST::StructuralQuantityType, RealMatrixX*>::iterator
+    std::map<MAST::StructuralQuantityType, std::vector<RealMatrixX>*>::iterator
     it  = mat_qty_map.begin(),
     end = mat_qty_map.end();
     
     for ( ; it != end; it++)
-        *it->second = RealMatrixX::Zero(n_basis, n_basis);
+        it->second->assign(n_params, RealMatrixX::Zero(n_basis, n_basis));
     
     // iterate over each element, initialize it and get the relevant
     // analysis quantities
     RealVectorX vec, sol, dsol;
     RealMatrixX mat, basis_mat;
+    DenseRealMatrix m;
     
     std::vector<libMesh::dof_id_type> dof_indices;
     const libMesh::DofMap& dof_map = _system->system().get_dof_map();
     
     
     std::unique_ptr<libMesh::NumericVector<Real> >
-    localized_solution,
-    localized_solution_sens;
+    localized_solution;
+    
+    // the localized base solution sensitivity for each parameter. The
+    // sensitivity attached to this assembly is localized once and shared
+    // by the parameters that do not provide their own.
+    std::vector<libMesh::NumericVector<Real>*>
+    localized_solution_sens(n_params, nullptr);
+    std::vector<bool>
+    if_delete_sens(n_params, false);
     
     if (_base_sol) {
         
-        // make sure that the solution sensitivity is provided
-        libmesh_assert(_base_sol_sensitivity);
-        
         localized_solution.reset(build_localized_vector(nonlin_sys,
                                                         *_base_sol).release());
-        localized_solution_sens.reset(build_localized_vector(nonlin_sys,
-                                                             *_base_sol_sensitivity).release());
+        
+        libMesh::NumericVector<Real>* attached_sens = nullptr;
+        
+        for (unsigned int i=0; i<n_params; i++) {
+            
+            if (base_sol_sens.size() && base_sol_sens[i]) {
+                
+                localized_solution_sens[i] =
+                build_localized_vector(nonlin_sys, *base_sol_sens[i]).release();
+                if_delete_sens[i] = true;
+            }
+            else {
+                
+                // make sure that the solution sensitivity is provided
+                libmesh_assert(_base_sol_sensitivity);
+                
+                if (!attached_sens) {
+                    
+                    attached_sens = build_localized_vector(nonlin_sys,
+                                                           *_base_sol_sensitivity).release();
+                    if_delete_sens[i] = true;
+                }
+                
+                localized_solution_sens[i] = attached_sens;
+            }
+        }
     }
     
     // also create localized solution vectos for the bassis vectors
-    std::vector<libMesh::NumericVector<Real>*> localized_basis(n_basis);
-    for (unsigned int i=0; i<n_basis; i++)
-        localized_basis[i] = build_localized_vector(nonlin_sys, *basis[i]).release();
+    std::vector<libMesh::NumericVector<Real>*> localized_basis;
+    const bool
+    if_delete_basis = _localize_basis(basis, localized_basis);
     
     
     // if a solution function is attached, initialize it
@@ -322,7 +476,6 @@ assemble_reduced_order_quantity_sensitivity
                 
                 ops.use_base_sol_for_sensitivity(true);
                 sol(i)  = (*localized_solution)(dof_indices[i]);
-                dsol(i) = (*localized_solution_sens)(dof_indices[i]);
             }
             
             for (unsigned int j=0; j<n_basis; j++)
@@ -330,29 +483,36 @@ assemble_reduced_order_quantity_sensitivity
         }
         
         _elem_ops->set_elem_solution(sol);
-        _elem_ops->set_elem_solution_sensitivity(dsol);
         _elem_ops->set_elem_velocity(vec);     // set to zero value
         _elem_ops->set_elem_acceleration(vec); // set to zero value
         
         //        if (_sol_function)
         //            physics_elem->attach_active_solution_function(*_sol_function);
         
-        // now iterative over all qty types in the map and assemble them
-        it   = mat_qty_map.begin();
-        end  = mat_qty_map.end();
-        
-        for ( ; it != end; it++) {
+        for (unsigned int p=0; p<n_params; p++) {
             
-            ops.set_qty_to_evaluate(it->first);
-            ops.elem_sensitivity_calculations(f, true, vec, mat);
+            if (_base_sol)
+                for (unsigned int i=0; i<dof_indices.size(); i++)
+                    dsol(i) = (*localized_solution_sens[p])(dof_indices[i]);
             
-            DenseRealMatrix m;
-            MAST::copy(m, mat);
-            dof_map.constrain_element_matrix(m, dof_indices);
-            MAST::copy(mat, m);
+            _elem_ops->set_elem_solution_sensitivity(dsol);
             
-            // now add to the reduced order matrix
-            (*it->second) += basis_mat.transpose() * mat * basis_mat;
+            // now iterative over all qty types in the map and assemble them
+            it   = mat_qty_map.begin();
+            end  = mat_qty_map.end();
+            
+            for ( ; it != end; it++) {
+                
+                ops.set_qty_to_evaluate(it->first);
+                ops.elem_sensitivity_calculations(*f[p], true, vec, mat);
+                
+                MAST::copy(m, mat);
+                dof_map.constrain_element_matrix(m, dof_indices);
+                MAST::copy(mat, m);
+                
+                // now add to the reduced order matrix
+                (*it->second)[p] += basis_mat.transpose() * mat * basis_mat;
+            }
         }
         
         _elem_ops->clear_elem();
@@ -366,9 +526,14 @@ assemble_reduced_order_quantity_sensitivity
         _sol_function->clear();
     
     
-    // delete the localized basis vectors
-    for (unsigned int i=0; i<basis.size(); i++)
-        delete localized_basis[i];
+    // delete the localized basis and sensitivity vectors
+    if (if_delete_basis)
+        for (unsigned int i=0; i<basis.size(); i++)
+            delete localized_basis[i];
+    
+    for (unsigned int i=0; i<n_params; i++)
+        if (if_delete_sens[i])
+            delete localized_solution_sens[i];
     
     // sum the matrix and provide it to each processor
     it  = mat_qty_map.begin();
@@ -376,6 +541,7 @@ assemble_reduced_order_quantity_sensitivity
     
     
     for ( ; it != end; it++)
-        MAST::parallel_sum(_system->system().comm(), *(it->second));
+        for (unsigned int p=0; p<n_params; p++)
+            MAST::parallel_sum(_system->system().comm(), (*it->second)[p]);
 }
 
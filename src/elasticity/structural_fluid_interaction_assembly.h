@@ -97,6 +97,24 @@ namespace MAST {
         base_sol(bool if_sens = false) const;
         
         
+        /*!
+         *   provides localized copies of the vectors in \p basis, which are
+         *   used instead of localizing the basis vectors in each call to the
+         *   reduced order assembly methods with the same basis vectors. The
+         *   vectors are not copied and must be kept consistent with
+         *   \p basis until clear_localized_basis() is called.
+         */
+        void
+        attach_localized_basis(const std::vector<libMesh::NumericVector<Real>*>& basis,
+                               const std::vector<libMesh::NumericVector<Real>*>& localized);
+        
+        
+        /*!
+         *   clears the localized basis vectors
+         */
+        void clear_localized_basis();
+        
+        
         /*!
          *   calculates the reduced order matrix given the basis provided in
          *   \par basis. \par X is the steady state solution about which
@@ -120,6 +138,24 @@ namespace MAST {
         (const MAST::FunctionBase& f,
          std::vector<libMesh::NumericVector<Real>*>& basis,
          std::map<MAST::StructuralQuantityType, RealMatrixX*>& mat_qty_map);
+        
+        
+        /*!
+         *   calculates the sensitivity of the reduced order matrices with
+         *   respect to each parameter in \p f in a single pass over the
+         *   elements. The i-th matrix in each vector of \p mat_qty_map is
+         *   the sensitivity with respect to \p f[i]. If a base solution is
+         *   attached, \p base_sol_sens provides the sensitivity of the base
+         *   solution for each parameter. Its entries, or all of them if it
+         *   is empty, may be nullptr, in which case the base solution
+         *   sensitivity attached to this assembly is used.
+         */
+        virtual void
+        assemble_reduced_order_quantity_sensitivity
+        (const std::vector<const MAST::FunctionBase*>& f,
+         const std::vector<const libMesh::NumericVector<Real>*>& base_sol_sens,
+         std::vector<libMesh::NumericVector<Real>*>& basis,
+         std::map<MAST::StructuralQuantityType, std::vector<RealMatrixX>*>& mat_qty_map);
 
         
 
@@ -139,6 +175,24 @@ namespace MAST {
          *   perform element calculations.
          */
         const libMesh::NumericVector<Real> * _base_sol_sensitivity;
+        
+        
+        /*!
+         *   initializes \p localized with the localized vectors of
+         *   \p basis, which are the attached vectors if available.
+         *   @returns \p true if the vectors were created by this method and
+         *   should be deleted by the caller.
+         */
+        bool
+        _localize_basis(const std::vector<libMesh::NumericVector<Real>*>& basis,
+                        std::vector<libMesh::NumericVector<Real>*>& localized) const;
+        
+        
+        /*!
+         *   basis vectors and their localized copies provided by the user
+         */
+        std::vector<libMesh::NumericVector<Real>*> _attached_basis;
+        std::vector<libMesh::NumericVector<Real>*> _attached_localized_basis;
     };
 }
 
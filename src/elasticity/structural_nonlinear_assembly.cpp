@@ -43,6 +43,28 @@ MAST::StructuralNonlinearAssemblyElemOperations::
 
 
 
+std::unique_ptr<MAST::NonlinearImplicitAssemblyElemOperations>
+MAST::StructuralNonlinearAssemblyElemOperations::clone() const {
+    
+    // the incompatible mode solution is stored in a map on the
+    // structural assembly that is modified during element initialization,
+    // so this cannot be shared across threads.
+    if (_incompatible_sol_assembly)
+        return std::unique_ptr<MAST::NonlinearImplicitAssemblyElemOperations>();
+    
+    std::unique_ptr<MAST::StructuralNonlinearAssemblyElemOperations>
+    ops(new MAST::StructuralNonlinearAssemblyElemOperations);
+    
+    if (_discipline && _system)
+        ops->set_discipline_and_system(*_discipline, *_system);
+    if (_assembly)
+        ops->set_assembly(*_assembly);
+    
+    return std::unique_ptr<MAST::NonlinearImplicitAssemblyElemOperations>(ops.release());
+}
+
+
+
 void
 MAST::StructuralNonlinearAssemblyElemOperations::set_elem_solution(const RealVectorX& sol) {
     
@@ -180,6 +202,18 @@ elem_sensitivity_calculations(const MAST::FunctionBase& f,
 
 
 
+bool
+MAST::StructuralNonlinearAssemblyElemOperations::
+if_elem_depends_on_parameter(const libMesh::Elem& elem,
+                             const MAST::FunctionBase& p) const {
+    
+    libmesh_assert(_discipline);
+    
+    return _discipline->elem_depends_on_parameter(elem, p);
+}
+
+
+
 void
 MAST::StructuralNonlinearAssemblyElemOperations::
 elem_topology_sensitivity_calculations(const MAST::FunctionBase& f,
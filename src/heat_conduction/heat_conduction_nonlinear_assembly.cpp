@@ -42,6 +42,22 @@ MAST::HeatConductionNonlinearAssemblyElemOperations::
 
 
 
+std::unique_ptr<MAST::NonlinearImplicitAssemblyElemOperations>
+MAST::HeatConductionNonlinearAssemblyElemOperations::clone() const {
+    
+    std::unique_ptr<MAST::HeatConductionNonlinearAssemblyElemOperations>
+    ops(new MAST::HeatConductionNonlinearAssemblyElemOperations);
+    
+    if (_discipline && _system)
+        ops->set_discipline_and_system(*_discipline, *_system);
+    if (_assembly)
+        ops->set_assembly(*_assembly);
+    
+    return std::unique_ptr<MAST::NonlinearImplicitAssemblyElemOperations>(ops.release());
+}
+
+
+
 void
 MAST::HeatConductionNonlinearAssemblyElemOperations::
 init(const libMesh::Elem& elem) {
@@ -101,6 +117,18 @@ elem_sensitivity_calculations(const MAST::FunctionBase& f,
 }
 
 
+
+bool
+MAST::HeatConductionNonlinearAssemblyElemOperations::
+if_elem_depends_on_parameter(const libMesh::Elem& elem,
+                             const MAST::FunctionBase& p) const {
+    
+    libmesh_assert(_discipline);
+    
+    return _discipline->elem_depends_on_parameter(elem, p);
+}
+
+
 void
 MAST::HeatConductionNonlinearAssemblyElemOperations::
 elem_topology_sensitivity_calculations(const MAST::FunctionBase& f,
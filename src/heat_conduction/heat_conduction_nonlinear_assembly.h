@@ -45,6 +45,13 @@ namespace MAST {
          */
         virtual ~HeatConductionNonlinearAssemblyElemOperations();
         
+        /*!
+         *   @returns a new object attached to the same discipline, system
+         *   and assembly for use in threaded element loops.
+         */
+        virtual std::unique_ptr<MAST::NonlinearImplicitAssemblyElemOperations>
+        clone() const;
+        
         /*!
          *   performs the element calculations over \par elem, and returns
          *   the element vector and matrix quantities in \par mat and
@@ -63,6 +70,14 @@ namespace MAST {
         virtual void
         elem_sensitivity_calculations(const MAST::FunctionBase& f,
                                       RealVectorX& vec);
+
+        /*!
+         *   @returns true if the property card or the loads on \par elem
+         *   depend on \par p.
+         */
+        virtual bool
+        if_elem_depends_on_parameter(const libMesh::Elem& elem,
+                                     const MAST::FunctionBase& p) const;
         
         /*!
          *   performs the element shape sensitivity calculations over \par elem,
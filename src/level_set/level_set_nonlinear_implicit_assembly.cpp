@@ -558,10 +558,13 @@ sensitivity_assemble (const MAST::FunctionBase& f,
     if (_sol_function)
         _sol_function->init( *nonlin_sys.solution);
     
-    libMesh::MeshBase::const_element_iterator       el     =
-    nonlin_sys.get_mesh().active_local_elements_begin();
-    const libMesh::MeshBase::const_element_iterator end_el =
-    nonlin_sys.get_mesh().active_local_elements_end();
+    // only the elements in the support of the parameter are visited
+    std::vector<const libMesh::Elem*> support_elems;
+    _sensitivity_elems(std::vector<const MAST::FunctionBase*>(1, &f), support_elems);
+    
+    std::vector<const libMesh::Elem*>::const_iterator
+    el     = support_elems.begin(),
+    end_el = support_elems.end();
     
     MAST::NonlinearImplicitAssemblyElemOperations&
     ops = dynamic_cast<MAST::NonlinearImplicitAssemblyElemOperations&>(*_elem_ops);
@@ -958,6 +961,57 @@ calculate_output_derivative(const libMesh::NumericVector<Real>& X,
 
 
 
+bool
+MAST::LevelSetNonlinearImplicitAssembly::
+sensitivity_assemble_for_parameters
+(const std::vector<const MAST::FunctionBase*>& f,
+ std::vector<libMesh::NumericVector<Real>*>& sensitivity_rhs) {
+    
+    return MAST::AssemblyBase::sensitivity_assemble_for_parameters(f, sensitivity_rhs);
+}
+
+
+
+void
+MAST::LevelSetNonlinearImplicitAssembly::
+calculate_output_direct_sensitivity_for_parameters
+(const libMesh::NumericVector<Real>& X,
+ const std::vector<const libMesh::NumericVector<Real>*>& dXdp,
+ const std::vector<const MAST::FunctionBase*>& p,
+ MAST::OutputAssemblyElemOperations& output,
+ std::vector<Real>& dq_dp) {
+    
+    MAST::AssemblyBase::calculate_output_direct_sensitivity_for_parameters(X,
+                                                                           dXdp,
+                                                                           p,
+                                                                           output,
+                                                                           dq_dp);
+}
+
+
+
+void
+MAST::LevelSetNonlinearImplicitAssembly::
+calculate_output_adjoint_sensitivity_for_parameters
+(const libMesh::NumericVector<Real>& X,
+ const libMesh::NumericVector<Real>& dq_dX,
+ const std::vector<const MAST::FunctionBase*>& p,
+ MAST::AssemblyElemOperations&       elem_ops,
+ MAST::OutputAssemblyElemOperations& output,
+ std::vector<Real>& dq_dp,
+ const bool include_partial_sens) {
+    
+    MAST::AssemblyBase::calculate_output_adjoint_sensitivity_for_parameters(X,
+                                                                            dq_dX,
+                                                                            p,
+                                                                            elem_ops,
+                                                                            output,
+                                                                            dq_dp,
+                                                                            include_partial_sens);
+}
+
+
+
 void
 MAST::LevelSetNonlinearImplicitAssembly::
 calculate_output_direct_sensitivity(const libMesh::NumericVector<Real>& X,
@@ -1314,6 +1368,9 @@ MAST::LevelSetNonlinearImplicitAssembly::build_fe() {
     std::unique_ptr<MAST::FEBase>
     fe(new MAST::SubCellFE(*_system, *_intersection));
     
+    if (_if_reuse_fe)
+        fe->set_object_pool(*_fe_pool);
+    
     return fe;
 }
 
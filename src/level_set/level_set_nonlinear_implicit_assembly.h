@@ -111,6 +111,40 @@ namespace MAST {
         sensitivity_assemble (const MAST::FunctionBase& f,
                               libMesh::NumericVector<Real>& sensitivity_rhs);
         
+        /*!
+         *   the element loop for each parameter depends on the level set
+         *   intersection and velocity for the parameter. Hence, this calls
+         *   sensitivity_assemble() for each parameter.
+         */
+        virtual bool
+        sensitivity_assemble_for_parameters
+        (const std::vector<const MAST::FunctionBase*>& f,
+         std::vector<libMesh::NumericVector<Real>*>& sensitivity_rhs);
+        
+        /*!
+         *   calls calculate_output_direct_sensitivity() for each parameter.
+         */
+        virtual void
+        calculate_output_direct_sensitivity_for_parameters
+        (const libMesh::NumericVector<Real>& X,
+         const std::vector<const libMesh::NumericVector<Real>*>& dXdp,
+         const std::vector<const MAST::FunctionBase*>& p,
+         MAST::OutputAssemblyElemOperations& output,
+         std::vector<Real>& dq_dp);
+        
+        /*!
+         *   calls calculate_output_adjoint_sensitivity() for each parameter.
+         */
+        virtual void
+        calculate_output_adjoint_sensitivity_for_parameters
+        (const libMesh::NumericVector<Real>& X,
+         const libMesh::NumericVector<Real>& dq_dX,
+         const std::vector<const MAST::FunctionBase*>& p,
+         MAST::AssemblyElemOperations&       elem_ops,
+         MAST::OutputAssemblyElemOperations& output,
+         std::vector<Real>& dq_dp,
+         const bool include_partial_sens = true);
+        
         
         virtual void
         calculate_output_derivative(const libMesh::NumericVector<Real>& X,
@@ -22,6 +22,7 @@
 #include "mesh/local_elem_base.h"
 #include "base/system_initialization.h"
 #include "base/nonlinear_system.h"
+#include "base/performance_counters.h"
 
 
 MAST::FEBase::FEBase(const MAST::SystemInitialization& sys):
@@ -32,13 +33,24 @@ _initialized                   (false),
 _elem                          (nullptr),
 _local_elem                    (nullptr),
 _fe                            (nullptr),
-_qrule                         (nullptr) {
+_qrule                         (nullptr),
+_pool                          (nullptr),
+_if_pooled                     (false),
+_geom_cache                    (nullptr) {
     
 }
 
 
 MAST::FEBase::~FEBase() {
     
+    // objects created for the pool are returned to it for reuse
+    if (_if_pooled) {
+        
+        if (_fe)
+            _pool->release(_pool_key, _fe, _qrule);
+        return;
+    }
+    
     if (_fe)
         delete _fe;
     
@@ -47,6 +59,88 @@ MAST::FEBase::~FEBase() {
 }
 
 
+void
+MAST::FEBase::set_object_pool(MAST::FEObjectPool& pool) {
+    
+    libmesh_assert(!_initialized);
+    
+    _pool = &pool;
+}
+
+
+void
+MAST::FEBase::set_geometry_cache(MAST::FEGeometryCache& cache) {
+    
+    libmesh_assert(!_initialized);
+    
+    _geom_cache = &cache;
+}
+
+
+MAST::FEGeometryCache::Key
+MAST::FEBase::_geometry_cache_key(const libMesh::Elem& elem) const {
+    
+    return MAST::FEGeometryCache::Key
+    (elem.id(),
+     _sys.fetype(0),
+     _sys.system().extra_quadrature_order+_extra_quadrature_order,
+     _init_second_order_derivatives);
+}
+
+
+void
+MAST::FEBase::_store_in_geometry_cache(const libMesh::Elem& elem) {
+    
+    libmesh_assert(_geom_cache);
+    libmesh_assert(_fe);
+    libmesh_assert(_qrule);
+    
+    std::shared_ptr<MAST::FEGeometryCache::Data>
+    d(new MAST::FEGeometryCache::Data);
+    
+    d->fe_type   = _fe->get_fe_type();
+    d->qpoints   = _qrule->get_points();
+    d->JxW       = _fe->get_JxW();
+    d->xyz       = _local_elem?_global_xyz:_fe->get_xyz();
+    d->phi       = _fe->get_phi();
+    d->dphi      = _fe->get_dphi();
+    if (_init_second_order_derivatives)
+        d->d2phi = _fe->get_d2phi();
+    d->dphidxi   = _fe->get_dphidxi();
+    d->dphideta  = _fe->get_dphideta();
+    d->dphidzeta = _fe->get_dphidzeta();
+    d->dxidx     = _fe->get_dxidx();
+    d->dxidy     = _fe->get_dxidy();
+    d->dxidz     = _fe->get_dxidz();
+    d->detadx    = _fe->get_detadx();
+    d->detady    = _fe->get_detady();
+    d->detadz    = _fe->get_detadz();
+    d->dzetadx   = _fe->get_dzetadx();
+    d->dzetady   = _fe->get_dzetady();
+    d->dzetadz   = _fe->get_dzetadz();
+    d->dxyzdxi   = _fe->get_dxyzdxi();
+    d->dxyzdeta  = _fe->get_dxyzdeta();
+    d->dxyzdzeta = _fe->get_dxyzdzeta();
+    
+    _geom_cache->insert(_geometry_cache_key(elem), elem, d);
+}
+
+
+bool
+MAST::FEBase::_acquire_fe_objects(const MAST::FEObjectPool::Key& key) {
+    
+    if (!_pool)
+        return false;
+    
+    // the objects will be returned to the pool on destruction, irrespective
+    // of whether they were found in the pool or created by the caller.
+    _if_pooled = true;
+    _pool_key  = key;
+    
+    return _pool->acquire(key, _fe, _qrule);
+}
+
+
 void
 MAST::FEBase::set_extra_quadrature_order(int n) {
     
@@ -65,8 +159,25 @@ void
 MAST::FEBase::init(const libMesh::Elem& elem,
                    const std::vector<libMesh::Point>* pts) {
     
+    MAST::PerformanceScope perf("FEBase::init");
+    
     libmesh_assert(!_initialized);
     
+    // the cache is keyed by the geometric element, and is handled by the
+    // local element method when this is called with a local element.
+    const bool
+    if_cache = (_geom_cache && !_local_elem && pts == nullptr);
+    
+    if (if_cache) {
+        
+        _cached = _geom_cache->find(_geometry_cache_key(elem), elem);
+        if (_cached) {
+            
+            _initialized = true;
+            return;
+        }
+    }
+    
     const unsigned int
     nv      = _sys.n_vars();
     libMesh::FEType
@@ -76,22 +187,39 @@ MAST::FEBase::init(const libMesh::Elem& elem,
     for (unsigned int i=1; i != nv; ++i)
         libmesh_assert(fe_type == _sys.fetype(i));
     
-    // Create an adequate quadrature rule
-    _fe = libMesh::FEBase::build(elem.dim(), fe_type).release();
-    _fe->get_phi();
-    _fe->get_xyz();
-    _fe->get_JxW();
-    _fe->get_dphi();
-    _fe->get_dphidxi();
-    _fe->get_dphideta();
-    _fe->get_dphidzeta();
-    if (_init_second_order_derivatives) _fe->get_d2phi();
+    const int
+    q_order = _sys.system().extra_quadrature_order+_extra_quadrature_order;
+    
+    // reuse the objects from the pool, if available. libMesh reinitializes
+    // the quadrature and shape functions if the element type has changed.
+    const bool
+    if_reuse = _acquire_fe_objects(MAST::FEObjectPool::Key(elem.dim(),
+                                                           fe_type,
+                                                           pts?-1:q_order,
+                                                           false,
+                                                           true,
+                                                           _init_second_order_derivatives));
+    
+    if (!if_reuse) {
+        
+        // Create an adequate quadrature rule
+        _fe = libMesh::FEBase::build(elem.dim(), fe_type).release();
+        _fe->get_phi();
+        _fe->get_xyz();
+        _fe->get_JxW();
+        _fe->get_dphi();
+        _fe->get_dphidxi();
+        _fe->get_dphideta();
+        _fe->get_dphidzeta();
+        if (_init_second_order_derivatives) _fe->get_d2phi();
+    }
     
     if (pts == nullptr) {
-        _qrule = fe_type.default_quadrature_rule
-        (elem.dim(),
-         _sys.system().extra_quadrature_order+_extra_quadrature_order).release();  // system extra quadrature
-        _fe->attach_quadrature_rule(_qrule);
+        if (!if_reuse) {
+            _qrule = fe_type.default_quadrature_rule
+            (elem.dim(), q_order).release();  // system extra quadrature
+            _fe->attach_quadrature_rule(_qrule);
+        }
         _fe->reinit(&elem);
     }
     else {
@@ -99,6 +227,9 @@ MAST::FEBase::init(const libMesh::Elem& elem,
         _qpoints = *pts;
     }
 
+    if (if_cache)
+        _store_in_geometry_cache(elem);
+    
     _initialized = true;
 }
 
@@ -107,8 +238,27 @@ void
 MAST::FEBase::init(const MAST::LocalElemBase& elem,
                    const std::vector<libMesh::Point>* pts) {
     
+    MAST::PerformanceScope perf("FEBase::init");
+    
     libmesh_assert(!_initialized);
     
+    // the cache uses the geometric element, since the local element is
+    // recreated for each initialization
+    const bool
+    if_cache = (_geom_cache && pts == nullptr);
+    
+    if (if_cache) {
+        
+        _cached = _geom_cache->find(_geometry_cache_key(elem.global_elem()),
+                                    elem.global_elem());
+        if (_cached) {
+            
+            _local_elem  = &elem;
+            _initialized = true;
+            return;
+        }
+    }
+    
     _local_elem = &elem;
     
     // now that this element has been initialized, use it to initialize
@@ -125,6 +275,9 @@ MAST::FEBase::init(const MAST::LocalElemBase& elem,
     
     for (unsigned int i=0; i<n; i++)
         _local_elem->global_coordinates_location(local_xyz[i], _global_xyz[i]);
+    
+    if (if_cache)
+        _store_in_geometry_cache(elem.global_elem());
 }
 
 
@@ -134,6 +287,8 @@ MAST::FEBase::init_for_side(const libMesh::Elem& elem,
                             unsigned int s,
                             bool if_calculate_dphi) {
 
+    MAST::PerformanceScope perf("FEBase::init_for_side");
+    
     libmesh_assert(!_initialized);
 
     unsigned int nv = _sys.n_vars();
@@ -144,20 +299,35 @@ MAST::FEBase::init_for_side(const libMesh::Elem& elem,
     for (unsigned int i=1; i != nv; ++i)
         libmesh_assert(fe_type == _sys.fetype(i));
     
-    // Create an adequate quadrature rule
-    _fe     = libMesh::FEBase::build(elem.dim(), fe_type).release();
-    _qrule  = fe_type.default_quadrature_rule
-    (elem.dim()-1,
-     _sys.system().extra_quadrature_order+_extra_quadrature_order).release();  // system extra quadrature
-    _fe->attach_quadrature_rule(_qrule);
-    _fe->get_phi();
-    _fe->get_xyz();
-    _fe->get_JxW();
-    _fe->get_normals();
-    if (if_calculate_dphi) {
-
-        _fe->get_dphi();
-        if (_init_second_order_derivatives) _fe->get_d2phi();
+    const int
+    q_order = _sys.system().extra_quadrature_order+_extra_quadrature_order;
+    
+    // reuse the objects from the pool, if available
+    const bool
+    if_reuse = _acquire_fe_objects(MAST::FEObjectPool::Key(elem.dim(),
+                                                           fe_type,
+                                                           q_order,
+                                                           true,
+                                                           if_calculate_dphi,
+                                                           if_calculate_dphi &&
+                                                           _init_second_order_derivatives));
+    
+    if (!if_reuse) {
+        
+        // Create an adequate quadrature rule
+        _fe     = libMesh::FEBase::build(elem.dim(), fe_type).release();
+        _qrule  = fe_type.default_quadrature_rule
+        (elem.dim()-1, q_order).release();  // system extra quadrature
+        _fe->attach_quadrature_rule(_qrule);
+        _fe->get_phi();
+        _fe->get_xyz();
+        _fe->get_JxW();
+        _fe->get_normals();
+        if (if_calculate_dphi) {
+            
+            _fe->get_dphi();
+            if (_init_second_order_derivatives) _fe->get_d2phi();
+        }
     }
     
     _fe->reinit(&elem, s);
@@ -171,6 +341,8 @@ MAST::FEBase::init_for_side(const MAST::LocalElemBase& elem,
                             unsigned int s,
                             bool if_calculate_dphi) {
     
+    MAST::PerformanceScope perf("FEBase::init_for_side");
+    
     libmesh_assert(!_initialized);
     
     _local_elem = &elem;
@@ -202,6 +374,8 @@ libMesh::FEType
 MAST::FEBase::get_fe_type() const {
 
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->fe_type;
     return _fe->get_fe_type();
 }
 
@@ -210,6 +384,8 @@ const std::vector<Real>&
 MAST::FEBase::get_JxW() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->JxW;
     return _fe->get_JxW();
 }
 
@@ -218,6 +394,8 @@ const std::vector<libMesh::Point>&
 MAST::FEBase::get_xyz() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->xyz;
     if (_local_elem)
         return _global_xyz;
     else
@@ -229,6 +407,8 @@ unsigned int
 MAST::FEBase::n_shape_functions() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return (unsigned int)_cached->phi.size();
     return _fe->n_shape_functions();
 }
 
@@ -237,6 +417,8 @@ const std::vector<std::vector<Real> >&
 MAST::FEBase::get_phi() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->phi;
     return _fe->get_phi();
 }
 
@@ -245,6 +427,8 @@ const std::vector<std::vector<libMesh::RealVectorValue> >&
 MAST::FEBase::get_dphi() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->dphi;
     return _fe->get_dphi();
 }
 
@@ -253,6 +437,8 @@ const std::vector<std::vector<libMesh::RealTensorValue>>&
 MAST::FEBase::get_d2phi() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->d2phi;
     return _fe->get_d2phi();
 }
 
@@ -261,6 +447,8 @@ const std::vector<Real>&
 MAST::FEBase::get_dxidx() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->dxidx;
     return _fe->get_dxidx();
 }
 
@@ -269,6 +457,8 @@ const std::vector<Real>&
 MAST::FEBase::get_dxidy() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->dxidy;
     return _fe->get_dxidy();
 }
 
@@ -277,6 +467,8 @@ const std::vector<Real>&
 MAST::FEBase::get_dxidz() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->dxidz;
     return _fe->get_dxidz();
 }
 
@@ -285,6 +477,8 @@ const std::vector<Real>&
 MAST::FEBase::get_detadx() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->detadx;
     return _fe->get_detadx();
 }
 
@@ -293,6 +487,8 @@ const std::vector<Real>&
 MAST::FEBase::get_detady() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->detady;
     return _fe->get_detady();
 }
 
@@ -301,6 +497,8 @@ const std::vector<Real>&
 MAST::FEBase::get_detadz() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->detadz;
     return _fe->get_detadz();
 }
 
@@ -309,6 +507,8 @@ const std::vector<Real>&
 MAST::FEBase::get_dzetadx() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->dzetadx;
     return _fe->get_dzetadx();
 }
 
@@ -317,6 +517,8 @@ const std::vector<Real>&
 MAST::FEBase::get_dzetady() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->dzetady;
     return _fe->get_dzetady();
 }
 
@@ -325,6 +527,8 @@ const std::vector<Real>&
 MAST::FEBase::get_dzetadz() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->dzetadz;
     return _fe->get_dzetadz();
 }
 
@@ -333,6 +537,8 @@ const std::vector<libMesh::RealVectorValue>&
 MAST::FEBase::get_dxyzdxi() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->dxyzdxi;
     return _fe->get_dxyzdxi();
 }
 
@@ -341,6 +547,8 @@ const std::vector<libMesh::RealVectorValue>&
 MAST::FEBase::get_dxyzdeta() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->dxyzdeta;
     return _fe->get_dxyzdeta();
 }
 
@@ -349,6 +557,8 @@ const std::vector<libMesh::RealVectorValue>&
 MAST::FEBase::get_dxyzdzeta() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->dxyzdzeta;
     return _fe->get_dxyzdzeta();
 }
 
@@ -357,6 +567,8 @@ const std::vector<std::vector<Real> >&
 MAST::FEBase::get_dphidxi() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->dphidxi;
     return _fe->get_dphidxi();
 }
 
@@ -365,6 +577,8 @@ const std::vector<std::vector<Real> >&
 MAST::FEBase::get_dphideta() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->dphideta;
     return _fe->get_dphideta();
 }
 
@@ -373,6 +587,8 @@ const std::vector<std::vector<Real> >&
 MAST::FEBase::get_dphidzeta() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->dphidzeta;
     return _fe->get_dphidzeta();
 }
 
@@ -392,6 +608,8 @@ const std::vector<libMesh::Point>&
 MAST::FEBase::get_qpoints() const {
     
     libmesh_assert(_initialized);
+    if (_cached)
+        return _cached->qpoints;
     if (_qrule)  // qrule was used
         return _qrule->get_points();
     else         // points were specified
@@ -403,6 +621,8 @@ const libMesh::QBase&
 MAST::FEBase::get_qrule() const {
     
     libmesh_assert(_initialized);
+    libmesh_assert_msg(_qrule,
+                       "Error: quadrature rule not available for cached or point-based initialization.");
     return *_qrule;
 }
 
@@ -23,6 +23,8 @@
 
 // MAST includes
 #include "base/mast_data_types.h"
+#include "mesh/fe_object_pool.h"
+#include "mesh/fe_geometry_cache.h"
 
 // libMesh includes
 #include "libmesh/elem.h"
@@ -55,6 +57,24 @@ namespace MAST {
          */
         void set_evaluate_second_order_derivatives(bool f);
         
+        /*!
+         *   sets the pool from which the libMesh finite element and quadrature
+         *   objects are obtained in init() and init_for_side(), and to which
+         *   they are returned on destruction. This must be called before
+         *   initialization, and the pool must outlive this object.
+         */
+        void set_object_pool(MAST::FEObjectPool& pool);
+        
+        /*!
+         *   sets the cache of quadrature point data used by init() for
+         *   volume integration with the default quadrature rule. If data for
+         *   the element is available in the cache, the finite element is not
+         *   reinitialized and all quantities are returned from the cache.
+         *   This must be called before initialization, and the cache must
+         *   outlive the initialization of this object.
+         */
+        void set_geometry_cache(MAST::FEGeometryCache& cache);
+        
         /*!
          *   Initializes the quadrature and finite element for element volume
          *   integration.
@@ -177,6 +197,27 @@ namespace MAST {
         
     protected:
         
+        /*!
+         *   obtains \p _fe and \p _qrule from the pool for \p key if a
+         *   pool was provided and it has objects available. @returns true if
+         *   the objects were obtained from the pool, in which case they are
+         *   ready for reinit. Otherwise, the caller should create them.
+         */
+        bool _acquire_fe_objects(const MAST::FEObjectPool::Key& key);
+        
+        /*!
+         *   @returns the key for \p elem in the geometry cache
+         */
+        MAST::FEGeometryCache::Key
+        _geometry_cache_key(const libMesh::Elem& elem) const;
+        
+        /*!
+         *   stores the quantities computed by the finite element for
+         *   \p elem in the geometry cache.
+         */
+        void _store_in_geometry_cache(const libMesh::Elem& elem);
+        
+        
         const MAST::SystemInitialization& _sys;
         unsigned int                      _extra_quadrature_order;
         bool                              _init_second_order_derivatives;
@@ -188,6 +229,11 @@ namespace MAST {
         std::vector<libMesh::Point>       _qpoints;
         std::vector<libMesh::Point>       _global_xyz;
         std::vector<libMesh::Point>       _global_normals;
+        MAST::FEObjectPool*               _pool;
+        bool                              _if_pooled;
+        MAST::FEObjectPool::Key           _pool_key;
+        MAST::FEGeometryCache*            _geom_cache;
+        std::shared_ptr<const MAST::FEGeometryCache::Data> _cached;
     };
 }
 
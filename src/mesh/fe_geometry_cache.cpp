@@ -0,0 +1,102 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2018  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// MAST includes
+#include "mesh/fe_geometry_cache.h"
+
+// libMesh includes
+#include "libmesh/node.h"
+
+
+MAST::FEGeometryCache::FEGeometryCache() {
+    
+}
+
+
+MAST::FEGeometryCache::~FEGeometryCache() {
+    
+}
+
+
+std::shared_ptr<const MAST::FEGeometryCache::Data>
+MAST::FEGeometryCache::find(const MAST::FEGeometryCache::Key& key,
+                            const libMesh::Elem& elem) {
+    
+    libMesh::Threads::spin_mutex::scoped_lock lock(_mutex);
+    
+    std::map<MAST::FEGeometryCache::Key,
+    std::shared_ptr<const MAST::FEGeometryCache::Data> >::iterator
+    it = _data.find(key);
+    
+    if (it == _data.end())
+        return std::shared_ptr<const MAST::FEGeometryCache::Data>();
+    
+    // make sure that the geometry has not changed since the data was stored
+    const MAST::FEGeometryCache::Data& d = *it->second;
+    bool
+    valid = (d.elem_type == elem.type() &&
+             d.nodes.size() == elem.n_nodes());
+    
+    for (unsigned int i=0; valid && i<elem.n_nodes(); i++)
+        valid = (d.nodes[i] == elem.point(i));
+    
+    if (!valid) {
+        
+        _data.erase(it);
+        return std::shared_ptr<const MAST::FEGeometryCache::Data>();
+    }
+    
+    return it->second;
+}
+
+
+void
+MAST::FEGeometryCache::insert(const MAST::FEGeometryCache::Key& key,
+                              const libMesh::Elem& elem,
+                              std::shared_ptr<MAST::FEGeometryCache::Data> data) {
+    
+    libmesh_assert(data.get());
+    
+    data->elem_type = elem.type();
+    data->nodes.resize(elem.n_nodes());
+    for (unsigned int i=0; i<elem.n_nodes(); i++)
+        data->nodes[i] = elem.point(i);
+    
+    libMesh::Threads::spin_mutex::scoped_lock lock(_mutex);
+    
+    _data[key] = data;
+}
+
+
+void
+MAST::FEGeometryCache::clear() {
+    
+    libMesh::Threads::spin_mutex::scoped_lock lock(_mutex);
+    
+    _data.clear();
+}
+
+
+unsigned int
+MAST::FEGeometryCache::size() const {
+    
+    libMesh::Threads::spin_mutex::scoped_lock lock(_mutex);
+    
+    return (unsigned int)_data.size();
+}
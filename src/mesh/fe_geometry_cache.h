@@ -0,0 +1,140 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2018  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast_fe_geometry_cache_h__
+#define __mast_fe_geometry_cache_h__
+
+// C++ includes
+#include <map>
+#include <tuple>
+#include <vector>
+#include <memory>
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+// libMesh includes
+#include "libmesh/elem.h"
+#include "libmesh/fe_type.h"
+#include "libmesh/threads.h"
+
+
+namespace MAST {
+    
+    /*!
+     *   Stores the finite element quantities computed at the quadrature
+     *   points of elements so that MAST::FEBase can skip the reinitialization
+     *   of shape functions and the element map when the element geometry
+     *   has not changed, for example between Newton iterations, load steps
+     *   or sizing iterations of an optimization. Only the volume quadrature
+     *   with the default quadrature rule is cached.
+     *
+     *   The node locations and type of the element are stored with each
+     *   entry, and an entry is discarded if these do not match the element
+     *   at lookup. Hence, motion of nodes through shape parameters is
+     *   detected automatically. clear() should be called after mesh
+     *   refinement or redistribution to release the stored data.
+     */
+    class FEGeometryCache {
+        
+    public:
+        
+        /*!
+         *   quadrature point data for an element
+         */
+        struct Data {
+            
+            libMesh::ElemType                                      elem_type;
+            std::vector<libMesh::Point>                            nodes;
+            libMesh::FEType                                        fe_type;
+            std::vector<libMesh::Point>                            qpoints;
+            std::vector<Real>                                      JxW;
+            std::vector<libMesh::Point>                            xyz;
+            std::vector<std::vector<Real> >                        phi;
+            std::vector<std::vector<libMesh::RealVectorValue> >    dphi;
+            std::vector<std::vector<libMesh::RealTensorValue> >    d2phi;
+            std::vector<std::vector<Real> >                        dphidxi;
+            std::vector<std::vector<Real> >                        dphideta;
+            std::vector<std::vector<Real> >                        dphidzeta;
+            std::vector<Real>                                      dxidx;
+            std::vector<Real>                                      dxidy;
+            std::vector<Real>                                      dxidz;
+            std::vector<Real>                                      detadx;
+            std::vector<Real>                                      detady;
+            std::vector<Real>                                      detadz;
+            std::vector<Real>                                      dzetadx;
+            std::vector<Real>                                      dzetady;
+            std::vector<Real>                                      dzetadz;
+            std::vector<libMesh::RealVectorValue>                  dxyzdxi;
+            std::vector<libMesh::RealVectorValue>                  dxyzdeta;
+            std::vector<libMesh::RealVectorValue>                  dxyzdzeta;
+        };
+        
+        /*!
+         *   key identifying an entry: element id, finite element type,
+         *   quadrature order and flag for second order derivatives.
+         */
+        typedef std::tuple<libMesh::dof_id_type, libMesh::FEType, int, bool>
+        Key;
+        
+        FEGeometryCache();
+        
+        virtual ~FEGeometryCache();
+        
+        /*!
+         *   @returns the data stored for \p key if the geometry of \p elem
+         *   is identical to that used to compute the data. Otherwise, a null
+         *   pointer is returned and the stale entry, if any, is removed.
+         */
+        std::shared_ptr<const MAST::FEGeometryCache::Data>
+        find(const MAST::FEGeometryCache::Key& key,
+             const libMesh::Elem& elem);
+        
+        /*!
+         *   stores \p data for \p key. The geometry of \p elem is recorded
+         *   in \p data for validation during lookup.
+         */
+        void insert(const MAST::FEGeometryCache::Key& key,
+                    const libMesh::Elem& elem,
+                    std::shared_ptr<MAST::FEGeometryCache::Data> data);
+        
+        /*!
+         *   removes all stored data. Objects that are currently using
+         *   the data retain it until they are destroyed.
+         */
+        void clear();
+        
+        /*!
+         *   @returns the number of elements for which data is stored.
+         */
+        unsigned int size() const;
+        
+    protected:
+        
+        std::map<MAST::FEGeometryCache::Key,
+        std::shared_ptr<const MAST::FEGeometryCache::Data> > _data;
+        
+        /*!
+         *   mutex for threaded access to the cache
+         */
+        mutable libMesh::Threads::spin_mutex _mutex;
+    };
+}
+
+#endif // __mast_fe_geometry_cache_h__
@@ -0,0 +1,108 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2018  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// MAST includes
+#include "mesh/fe_object_pool.h"
+
+
+MAST::FEObjectPool::FEObjectPool() {
+    
+}
+
+
+MAST::FEObjectPool::~FEObjectPool() {
+    
+    this->clear();
+}
+
+
+bool
+MAST::FEObjectPool::acquire(const MAST::FEObjectPool::Key& key,
+                            libMesh::FEBase*& fe,
+                            libMesh::QBase*&  qrule) {
+    
+    libMesh::Threads::spin_mutex::scoped_lock lock(_mutex);
+    
+    fe    = nullptr;
+    qrule = nullptr;
+
+    std::map<MAST::FEObjectPool::Key,
+    std::vector<std::pair<libMesh::FEBase*, libMesh::QBase*> > >::iterator
+    it = _objects.find(key);
+    
+    if (it == _objects.end() || it->second.empty())
+        return false;
+    
+    fe    = it->second.back().first;
+    qrule = it->second.back().second;
+    it->second.pop_back();
+    
+    return true;
+}
+
+
+void
+MAST::FEObjectPool::release(const MAST::FEObjectPool::Key& key,
+                            libMesh::FEBase* fe,
+                            libMesh::QBase*  qrule) {
+    
+    libMesh::Threads::spin_mutex::scoped_lock lock(_mutex);
+    
+    _objects[key].push_back(std::pair<libMesh::FEBase*, libMesh::QBase*>(fe, qrule));
+}
+
+
+void
+MAST::FEObjectPool::clear() {
+    
+    libMesh::Threads::spin_mutex::scoped_lock lock(_mutex);
+    
+    std::map<MAST::FEObjectPool::Key,
+    std::vector<std::pair<libMesh::FEBase*, libMesh::QBase*> > >::iterator
+    it  = _objects.begin(),
+    end = _objects.end();
+    
+    for ( ; it != end; it++)
+        for (unsigned int i=0; i<it->second.size(); i++) {
+            
+            if (it->second[i].first)  delete it->second[i].first;
+            if (it->second[i].second) delete it->second[i].second;
+        }
+    
+    _objects.clear();
+}
+
+
+unsigned int
+MAST::FEObjectPool::n_objects() const {
+    
+    libMesh::Threads::spin_mutex::scoped_lock lock(_mutex);
+    
+    unsigned int n = 0;
+    
+    std::map<MAST::FEObjectPool::Key,
+    std::vector<std::pair<libMesh::FEBase*, libMesh::QBase*> > >::const_iterator
+    it  = _objects.begin(),
+    end = _objects.end();
+    
+    for ( ; it != end; it++)
+        n += (unsigned int)it->second.size();
+    
+    return n;
+}
@@ -0,0 +1,110 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2018  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast_fe_object_pool_h__
+#define __mast_fe_object_pool_h__
+
+// C++ includes
+#include <map>
+#include <tuple>
+#include <vector>
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+// libMesh includes
+#include "libmesh/fe_base.h"
+#include "libmesh/quadrature.h"
+#include "libmesh/threads.h"
+
+
+namespace MAST {
+    
+    /*!
+     *   This class stores libMesh finite element and quadrature objects
+     *   that are no longer in use by a MAST::FEBase object so that they can
+     *   be reused for subsequent elements. The objects are keyed by the
+     *   element dimension, finite element type, quadrature order and the
+     *   shape function quantities requested from the finite element. Since
+     *   libMesh reinitializes the finite element and quadrature when the
+     *   element type changes, one object can be shared between all
+     *   elements of a given dimension. Access to the pool is protected by a
+     *   mutex so that it can be used from threaded element loops.
+     */
+    class FEObjectPool {
+        
+    public:
+
+        /*!
+         *   key identifying compatible objects: element dimension, finite
+         *   element type, quadrature order (or -1 if the object was initialized
+         *   on user-specified points), and flags for side integration,
+         *   shape function derivatives and second derivatives.
+         */
+        typedef std::tuple<unsigned int, libMesh::FEType, int, bool, bool, bool>
+        Key;
+        
+        FEObjectPool();
+        
+        virtual ~FEObjectPool();
+        
+        /*!
+         *   @returns true if an object for \p key was available in the pool,
+         *   in which case \p fe and \p qrule are set to the objects.
+         *   Otherwise, the user should create the objects and return them to
+         *   the pool using release().
+         */
+        bool acquire(const MAST::FEObjectPool::Key& key,
+                     libMesh::FEBase*& fe,
+                     libMesh::QBase*&  qrule);
+        
+        /*!
+         *   returns the objects to the pool for reuse. The pool takes
+         *   ownership of \p fe and \p qrule, either of which can be nullptr.
+         */
+        void release(const MAST::FEObjectPool::Key& key,
+                     libMesh::FEBase* fe,
+                     libMesh::QBase*  qrule);
+        
+        /*!
+         *   deletes all objects currently stored in the pool.
+         */
+        void clear();
+        
+        /*!
+         *   @returns the number of objects currently stored in the pool.
+         */
+        unsigned int n_objects() const;
+        
+    protected:
+        
+        /*!
+         *   map of available objects for each key.
+         */
+        std::map<MAST::FEObjectPool::Key,
+        std::vector<std::pair<libMesh::FEBase*, libMesh::QBase*> > > _objects;
+        
+        /*!
+         *   mutex for threaded access to the pool
+         */
+        mutable libMesh::Threads::spin_mutex _mutex;
+    };
+}
+
+#endif // __mast_fe_object_pool_h__
@@ -0,0 +1,445 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2018  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__fixed_size_fem_operator_matrix__
+#define __mast__fixed_size_fem_operator_matrix__
+
+// C++ includes
+#include <bitset>
+#include <iomanip>
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+
+
+namespace MAST {
+
+    /*!
+     *   Compile-time sized counterpart of \p MAST::FEMOperatorMatrix. The
+     *   number of interpolated variables (rows), discrete variables and
+     *   dofs per discrete variable are template parameters, so that the
+     *   shape function blocks live in a single fixed-size Eigen matrix
+     *   and no heap allocation happens on \p reinit or
+     *   \p set_shape_function. The block kernels operate on fixed-size
+     *   Eigen segments and are vectorized by Eigen.
+     *
+     *   The interface mirrors that of \p MAST::FEMOperatorMatrix, which
+     *   remains the fallback for element types whose sizes are only known
+     *   at runtime. A typical use is \p NDofsPerVar equal to the number
+     *   of nodes of a first order element (2 for EDGE2, 3 for TRI3, 4 for
+     *   QUAD4) with \p NDiscreteVars equal to the six structural dofs
+     *   per node.
+     */
+    template <unsigned int NInterpolatedVars,
+              unsigned int NDiscreteVars,
+              unsigned int NDofsPerVar>
+    class FixedSizeFEMOperatorMatrix
+    {
+    public:
+
+        /*!
+         *   storage for the shape functions of all blocks. Block
+         *   (i, j) is stored in column j*NInterpolatedVars+i.
+         */
+        typedef Eigen::Matrix<Real, NDofsPerVar, NInterpolatedVars*NDiscreteVars>
+        ShapeFunctionMatrix;
+
+        FixedSizeFEMOperatorMatrix() { }
+
+
+        virtual ~FixedSizeFEMOperatorMatrix() { }
+
+
+        /*!
+         *   marks all blocks as zero. No memory is released or allocated.
+         */
+        void clear() { _nonzero.reset(); }
+
+
+        static constexpr unsigned int m() {return NInterpolatedVars;}
+
+        static constexpr unsigned int n() {return NDiscreteVars*NDofsPerVar;}
+
+        void print(std::ostream& o);
+
+        /*!
+         *   zeros all blocks. The dimensions are provided only for
+         *   interface compatibility with \p MAST::FEMOperatorMatrix, and
+         *   must be the same as the template parameters.
+         */
+        void reinit(unsigned int n_interpolated_vars,
+                    unsigned int n_discrete_vars,
+                    unsigned int n_discrete_dofs_per_var);
+
+        /*!
+         *   sets the shape function values for the block corresponding to
+         *   \par interpolated_var and \par discrete_var. The size of
+         *   \par shape_func must be \p NDofsPerVar.
+         */
+        template <typename ValType>
+        void set_shape_function(unsigned int interpolated_var,
+                                unsigned int discrete_var,
+                                const Eigen::MatrixBase<ValType>& shape_func);
+
+        /*!
+         *   this initializes all variables to use the same interpolation
+         *   function. This requires that the number of interpolated and
+         *   discrete vars are the same.
+         */
+        template <typename ValType>
+        void reinit(unsigned int n_interpolated_vars,
+                    const Eigen::MatrixBase<ValType>& shape_func);
+
+        /*!
+         *   res = [this] * v
+         */
+        template <typename T>
+        void vector_mult(T& res, const T& v) const;
+
+
+        /*!
+         *   res = v^T * [this]
+         */
+        template <typename T>
+        void vector_mult_transpose(T& res, const T& v) const;
+
+
+        /*!
+         *   [R] = [this] * [M]
+         */
+        template <typename T>
+        void right_multiply(T& r, const T& m) const;
+
+
+        /*!
+         *   [R] = [this]^T * [M]
+         */
+        template <typename T>
+        void right_multiply_transpose(T& r, const T& m) const;
+
+
+        /*!
+         *   [R] = [this]^T * [M]
+         */
+        template <typename T, unsigned int NDiscreteVars2, unsigned int NDofsPerVar2>
+        void right_multiply_transpose
+        (T& r,
+         const MAST::FixedSizeFEMOperatorMatrix<NInterpolatedVars, NDiscreteVars2, NDofsPerVar2>& m) const;
+
+
+        /*!
+         *   [R] = [M] * [this]
+         */
+        template <typename T>
+        void left_multiply(T& r, const T& m) const;
+
+
+        /*!
+         *   [R] = [M] * [this]^T
+         */
+        template <typename T>
+        void left_multiply_transpose(T& r, const T& m) const;
+
+
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    protected:
+
+        template <unsigned int, unsigned int, unsigned int>
+        friend class FixedSizeFEMOperatorMatrix;
+
+        /*!
+         *    shape function values of each block, stored in the same
+         *    column major block order as \p MAST::FEMOperatorMatrix.
+         *    Only the columns flagged in \p _nonzero are meaningful.
+         */
+        ShapeFunctionMatrix                           _shape_functions;
+
+        /*!
+         *    \p true for blocks that have been set since the last
+         *    \p clear() or \p reinit(). All other blocks are zero.
+         */
+        std::bitset<NInterpolatedVars*NDiscreteVars>  _nonzero;
+    };
+}
+
+
+
+template <unsigned int NI, unsigned int ND, unsigned int NP>
+inline
+void
+MAST::FixedSizeFEMOperatorMatrix<NI, ND, NP>::print(std::ostream& o) {
+
+    unsigned int index = 0;
+
+    for (unsigned int i=0; i<NI; i++) {// row
+        for (unsigned int j=0; j<ND; j++) { // column
+            index = j*NI+i;
+            for (unsigned int k=0; k<NP; k++)
+                o << std::setw(15) << (_nonzero[index]?_shape_functions(k, index):0.);
+        }
+        o << std::endl;
+    }
+}
+
+
+
+template <unsigned int NI, unsigned int ND, unsigned int NP>
+inline
+void
+MAST::FixedSizeFEMOperatorMatrix<NI, ND, NP>::
+reinit(unsigned int n_interpolated_vars,
+       unsigned int n_discrete_vars,
+       unsigned int n_discrete_dofs_per_var) {
+
+    libmesh_assert_equal_to(n_interpolated_vars, NI);
+    libmesh_assert_equal_to(n_discrete_vars, ND);
+    libmesh_assert_equal_to(n_discrete_dofs_per_var, NP);
+
+    this->clear();
+}
+
+
+
+template <unsigned int NI, unsigned int ND, unsigned int NP>
+template <typename ValType>
+inline
+void
+MAST::FixedSizeFEMOperatorMatrix<NI, ND, NP>::
+set_shape_function(unsigned int interpolated_var,
+                   unsigned int discrete_var,
+                   const Eigen::MatrixBase<ValType>& shape_func) {
+
+    // make sure that the specified indices are within bounds
+    libmesh_assert(interpolated_var < NI);
+    libmesh_assert(discrete_var < ND);
+    libmesh_assert_equal_to(shape_func.size(), NP);
+
+    const unsigned int
+    index = discrete_var*NI+interpolated_var;
+
+    _shape_functions.col(index) = shape_func;
+    _nonzero.set(index);
+}
+
+
+
+template <unsigned int NI, unsigned int ND, unsigned int NP>
+template <typename ValType>
+inline
+void
+MAST::FixedSizeFEMOperatorMatrix<NI, ND, NP>::
+reinit(unsigned int n_vars,
+       const Eigen::MatrixBase<ValType>& shape_func) {
+
+    static_assert(NI == ND,
+                  "reinit with a single shape function requires equal number of interpolated and discrete vars");
+    libmesh_assert_equal_to(n_vars, NI);
+    libmesh_assert_equal_to(shape_func.size(), NP);
+
+    this->clear();
+
+    for (unsigned int i=0; i<n_vars; i++) {
+        _shape_functions.col(i*n_vars+i) = shape_func;
+        _nonzero.set(i*n_vars+i);
+    }
+}
+
+
+
+template <unsigned int NI, unsigned int ND, unsigned int NP>
+template <typename T>
+inline
+void
+MAST::FixedSizeFEMOperatorMatrix<NI, ND, NP>::
+vector_mult(T& res, const T& v) const {
+
+    libmesh_assert_equal_to(res.size(), NI);
+    libmesh_assert_equal_to(v.size(), n());
+
+    res.setZero();
+    unsigned int index = 0;
+
+    for (unsigned int i=0; i<NI; i++) // row
+        for (unsigned int j=0; j<ND; j++) { // column
+            index = j*NI+i;
+            if (_nonzero[index])
+                res(i) += _shape_functions.col(index).dot
+                (v.template segment<NP>(j*NP));
+        }
+}
+
+
+
+template <unsigned int NI, unsigned int ND, unsigned int NP>
+template <typename T>
+inline
+void
+MAST::FixedSizeFEMOperatorMatrix<NI, ND, NP>::
+vector_mult_transpose(T& res, const T& v) const {
+
+    libmesh_assert_equal_to(res.size(), n());
+    libmesh_assert_equal_to(v.size(), NI);
+
+    res.setZero();
+    unsigned int index = 0;
+
+    for (unsigned int i=0; i<NI; i++) // row
+        for (unsigned int j=0; j<ND; j++) { // column
+            index = j*NI+i;
+            if (_nonzero[index])
+                res.template segment<NP>(j*NP) +=
+                _shape_functions.col(index) * v(i);
+        }
+}
+
+
+
+template <unsigned int NI, unsigned int ND, unsigned int NP>
+template <typename T>
+inline
+void
+MAST::FixedSizeFEMOperatorMatrix<NI, ND, NP>::
+right_multiply(T& r, const T& m) const {
+
+    libmesh_assert_equal_to(r.rows(), NI);
+    libmesh_assert_equal_to(r.cols(), m.cols());
+    libmesh_assert_equal_to(m.rows(), n());
+
+    r.setZero();
+    unsigned int index = 0;
+
+    for (unsigned int i=0; i<NI; i++) // row
+        for (unsigned int j=0; j<ND; j++) { // column of operator
+            index = j*NI+i;
+            if (_nonzero[index])
+                r.row(i).noalias() +=
+                _shape_functions.col(index).transpose() *
+                m.template middleRows<NP>(j*NP);
+        }
+}
+
+
+
+template <unsigned int NI, unsigned int ND, unsigned int NP>
+template <typename T>
+inline
+void
+MAST::FixedSizeFEMOperatorMatrix<NI, ND, NP>::
+right_multiply_transpose(T& r, const T& m) const {
+
+    libmesh_assert_equal_to(r.rows(), n());
+    libmesh_assert_equal_to(r.cols(), m.cols());
+    libmesh_assert_equal_to(m.rows(), NI);
+
+    r.setZero();
+    unsigned int index = 0;
+
+    for (unsigned int i=0; i<NI; i++) // row
+        for (unsigned int j=0; j<ND; j++) { // column of operator
+            index = j*NI+i;
+            if (_nonzero[index])
+                r.template middleRows<NP>(j*NP).noalias() +=
+                _shape_functions.col(index) * m.row(i);
+        }
+}
+
+
+
+template <unsigned int NI, unsigned int ND, unsigned int NP>
+template <typename T, unsigned int ND2, unsigned int NP2>
+inline
+void
+MAST::FixedSizeFEMOperatorMatrix<NI, ND, NP>::
+right_multiply_transpose
+(T& r,
+ const MAST::FixedSizeFEMOperatorMatrix<NI, ND2, NP2>& m) const {
+
+    libmesh_assert_equal_to(r.rows(), n());
+    libmesh_assert_equal_to(r.cols(), m.n());
+
+    r.setZero();
+    unsigned int index_i, index_j = 0;
+
+    for (unsigned int i=0; i<ND; i++) // row of result
+        for (unsigned int j=0; j<ND2; j++) // column of result
+            for (unsigned int k=0; k<NI; k++) {
+                index_i = i*NI+k;
+                index_j = j*NI+k;
+                if (_nonzero[index_i] && m._nonzero[index_j])
+                    r.template block<NP, NP2>(i*NP, j*NP2).noalias() +=
+                    _shape_functions.col(index_i) *
+                    m._shape_functions.col(index_j).transpose();
+            }
+}
+
+
+
+template <unsigned int NI, unsigned int ND, unsigned int NP>
+template <typename T>
+inline
+void
+MAST::FixedSizeFEMOperatorMatrix<NI, ND, NP>::
+left_multiply(T& r, const T& m) const {
+
+    libmesh_assert_equal_to(r.rows(), m.rows());
+    libmesh_assert_equal_to(r.cols(), n());
+    libmesh_assert_equal_to(m.cols(), NI);
+
+    r.setZero();
+    unsigned int index = 0;
+
+    for (unsigned int i=0; i<NI; i++) // row
+        for (unsigned int j=0; j<ND; j++) { // column of operator
+            index = j*NI+i;
+            if (_nonzero[index])
+                r.template middleCols<NP>(j*NP).noalias() +=
+                m.col(i) * _shape_functions.col(index).transpose();
+        }
+}
+
+
+
+template <unsigned int NI, unsigned int ND, unsigned int NP>
+template <typename T>
+inline
+void
+MAST::FixedSizeFEMOperatorMatrix<NI, ND, NP>::
+left_multiply_transpose(T& r, const T& m) const {
+
+    libmesh_assert_equal_to(r.rows(), m.rows());
+    libmesh_assert_equal_to(r.cols(), NI);
+    libmesh_assert_equal_to(m.cols(), n());
+
+    r.setZero();
+    unsigned int index = 0;
+
+    for (unsigned int i=0; i<NI; i++) // row
+        for (unsigned int j=0; j<ND; j++) { // column of operator
+            index = j*NI+i;
+            if (_nonzero[index])
+                r.col(i).noalias() +=
+                m.template middleCols<NP>(j*NP) * _shape_functions.col(index);
+        }
+}
+
+
+#endif // __mast__fixed_size_fem_operator_matrix__
@@ -28,10 +28,9 @@ MAST::LAPACK_DGEEV::compute(const RealMatrixX &A,
     
     libmesh_assert(A.cols() == A.rows());
     
-    _A = A;
-    
-    RealMatrixX
-    Amat = A;
+    // the storage of the copies is reused if the size has not changed
+    _A      = A;
+    _A_work = A;
     
     int n = (int)A.cols();
     
@@ -39,46 +38,66 @@ MAST::LAPACK_DGEEV::compute(const RealMatrixX &A,
     
     if (computeEigenvectors) {
         
-        L = 'V'; R = 'V';
-        VL.setZero(n, n);
+        R = 'V';
         VR.setZero(n, n);
+        _vecr.setZero(n, n);
+        
+        if (_if_left_eigenvectors) {
+            L = 'V';
+            VL.setZero(n, n);
+            _vecl.setZero(n, n);
+        }
+        else
+            VL.resize(0, 0);
     }
     
     int
-    lwork=16*n;
+    ldvl     = L=='V'?n:1,
+    ldvr     = R=='V'?n:1,
+    lwork    = 0;
     
     info_val=-1;
     
-    RealVectorX
-    work,
-    w_r,
-    w_i;
-    
-    RealMatrixX
-    vecl,
-    vecr;
-    
     W.setZero(n);
-    work.setZero(lwork);
-    w_r.setZero(n);
-    w_i.setZero(n);
-    vecl.setZero(n,n);
-    vecr.setZero(n,n);
+    _w_r.setZero(n);
+    _w_i.setZero(n);
     
     Real
-    *a_vals    = Amat.data(),
-    *w_r_v     = w_r.data(),
-    *w_i_v     = w_i.data(),
-    *vecl_v    = vecl.data(),
-    *vecr_v    = vecr.data(),
-    *work_v    = work.data();
+    dummy      = 0.,
+    *vecl_v    = L=='V'?_vecl.data():&dummy,
+    *vecr_v    = R=='V'?_vecr.data():&dummy;
+    
+    // query the optimal workspace size if the size or the options have
+    // changed since the last eigensolution
+    if (n != _lwork_n || L != _lwork_jobvl || R != _lwork_jobvr) {
+        
+        Real
+        work_opt = 0.;
+        lwork    = -1;
+        
+        dgeev_(&L, &R, &n,
+               _A_work.data(), &n,
+               _w_r.data(), _w_i.data(),
+               vecl_v, &ldvl, vecr_v, &ldvr,
+               &work_opt, &lwork,
+               &info_val);
+        
+        lwork = info_val == 0 ? (int)work_opt : 16*n;
+        _work.setZero(std::max(lwork, std::max(1, 4*n)));
+        
+        _lwork_n     = n;
+        _lwork_jobvl = L;
+        _lwork_jobvr = R;
+    }
     
+    lwork    = (int)_work.size();
+    info_val = -1;
     
     dgeev_(&L, &R, &n,
-           &(a_vals[0]), &n,
-           &(w_r_v[0]), &(w_i_v[0]),
-           &(vecl_v[0]), &n, &(vecr_v[0]), &n,
-           &(work_v[0]), &lwork,
+           _A_work.data(), &n,
+           _w_r.data(), _w_i.data(),
+           vecl_v, &ldvl, vecr_v, &ldvr,
+           _work.data(), &lwork,
            &info_val);
     
     // now sort the eigenvalues for complex conjugates
@@ -87,24 +106,26 @@ MAST::LAPACK_DGEEV::compute(const RealMatrixX &A,
         
         // if the imaginary part of the eigenvalue is non-zero, it is a
         // complex conjugate
-        if (w_i(n_located) != 0.) { // complex conjugate
+        if (_w_i(n_located) != 0.) { // complex conjugate
             
-            W(  n_located) = std::complex<double>(w_r(n_located),  w_i(n_located));
-            W(1+n_located) = std::complex<double>(w_r(n_located), -w_i(n_located));
+            W(  n_located) = std::complex<double>(_w_r(n_located),  _w_i(n_located));
+            W(1+n_located) = std::complex<double>(_w_r(n_located), -_w_i(n_located));
             
             // copy the eigenvectors if they were requested
             if (computeEigenvectors) {
                 
                 std::complex<double> iota = std::complex<double>(0, 1.);
                 
-                VL.col(  n_located) = (vecl.col(  n_located).cast<Complex>() +
-                                       vecl.col(1+n_located).cast<Complex>() * iota);
-                VL.col(1+n_located) = (vecl.col(  n_located).cast<Complex>() -
-                                       vecl.col(1+n_located).cast<Complex>() * iota);
-                VR.col(  n_located) = (vecr.col(  n_located).cast<Complex>() +
-                                       vecr.col(1+n_located).cast<Complex>() * iota);
-                VR.col(1+n_located) = (vecr.col(  n_located).cast<Complex>() -
-                                       vecr.col(1+n_located).cast<Complex>() * iota);
+                if (L == 'V') {
+                    VL.col(  n_located) = (_vecl.col(  n_located).cast<Complex>() +
+                                           _vecl.col(1+n_located).cast<Complex>() * iota);
+                    VL.col(1+n_located) = (_vecl.col(  n_located).cast<Complex>() -
+                                           _vecl.col(1+n_located).cast<Complex>() * iota);
+                }
+                VR.col(  n_located) = (_vecr.col(  n_located).cast<Complex>() +
+                                       _vecr.col(1+n_located).cast<Complex>() * iota);
+                VR.col(1+n_located) = (_vecr.col(  n_located).cast<Complex>() -
+                                       _vecr.col(1+n_located).cast<Complex>() * iota);
             }
             
             // two complex conjugate roots were found
@@ -112,13 +133,14 @@ MAST::LAPACK_DGEEV::compute(const RealMatrixX &A,
         }
         else {
             
-            W(  n_located) = std::complex<double>(w_r(n_located),  0.);
+            W(  n_located) = std::complex<double>(_w_r(n_located),  0.);
             
             // copy the eigenvectors if they were requested
             if (computeEigenvectors) {
                 
-                VL.col(n_located) = vecl.col(n_located).cast<Complex>();
-                VR.col(n_located) = vecr.col(n_located).cast<Complex>();
+                if (L == 'V')
+                    VL.col(n_located) = _vecl.col(n_located).cast<Complex>();
+                VR.col(n_located) = _vecr.col(n_located).cast<Complex>();
             }
             
             // only one real root was found
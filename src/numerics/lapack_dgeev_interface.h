@@ -152,9 +152,24 @@ namespace MAST {
     public:
         
         LAPACK_DGEEV():
-        info_val(-1)
+        info_val(-1),
+        _if_left_eigenvectors(true),
+        _lwork_n(-1),
+        _lwork_jobvl('N'),
+        _lwork_jobvr('N')
         { }
         
+        /*!
+         *    if \p f is false, the eigensolutions compute only the right
+         *    eigenvectors. The left eigenvectors are then empty, and the
+         *    right eigenvectors are not scaled by
+         *    scale_eigenvectors_to_identity_innerproduct(). The left
+         *    eigenvectors are computed by default.
+         */
+        void set_compute_left_eigenvectors(bool f) {
+            _if_left_eigenvectors = f;
+        }
+        
         /*!
          *    computes the eigensolution for A x = \lambda I x. A & B will be
          *    overwritten
@@ -193,6 +208,10 @@ namespace MAST {
         void scale_eigenvectors_to_identity_innerproduct() {
             libmesh_assert(info_val == 0);
             
+            // the scaling requires the left eigenvectors
+            if (!this->VL.size())
+                return;
+            
             // this product should be an identity matrix
             ComplexMatrixX r = this->VL.conjugate().transpose() * this->VR;
             
@@ -230,6 +249,38 @@ namespace MAST {
         ComplexVectorX W;
         
         int info_val;
+        
+        /*!
+         *    flag to compute the left eigenvectors
+         */
+        bool           _if_left_eigenvectors;
+        
+        /*!
+         *    copy of the matrix that is overwritten by LAPACK, along with the
+         *    workspace and the real-valued outputs of LAPACK. These are
+         *    reused by eigensolutions of the same size.
+         */
+        RealMatrixX    _A_work;
+        
+        RealVectorX    _work;
+        
+        RealVectorX    _w_r;
+        
+        RealVectorX    _w_i;
+        
+        RealMatrixX    _vecl;
+        
+        RealMatrixX    _vecr;
+        
+        /*!
+         *    matrix size and eigenvector options for which the optimal
+         *    size of \p _work was queried from LAPACK
+         */
+        int            _lwork_n;
+        
+        char           _lwork_jobvl;
+        
+        char           _lwork_jobvr;
     };
     
 }
@@ -31,12 +31,11 @@ MAST::LAPACK_DGGEV::compute(const RealMatrixX &A,
                    B.cols() == A.rows() &&
                    B.cols() == B.rows());
     
-    _A = A;
-    _B = B;
-    
-    RealMatrixX
-    Amat = A,
-    Bmat = B;
+    // the storage of the copies is reused if the size has not changed
+    _A      = A;
+    _B      = B;
+    _A_work = A;
+    _B_work = B;
     
     int n = (int)A.cols();
     
@@ -44,53 +43,71 @@ MAST::LAPACK_DGGEV::compute(const RealMatrixX &A,
     
     if (computeEigenvectors) {
         
-        L = 'V'; R = 'V';
-        VL.setZero(n, n);
+        R = 'V';
         VR.setZero(n, n);
+        _vecr.setZero(n, n);
+        
+        if (_if_left_eigenvectors) {
+            L = 'V';
+            VL.setZero(n, n);
+            _vecl.setZero(n, n);
+        }
+        else
+            VL.resize(0, 0);
     }
     
     int
-    lwork=16*n;
+    ldvl     = L=='V'?n:1,
+    ldvr     = R=='V'?n:1,
+    lwork    = 0;
     
     info_val=-1;
     
     alpha.setZero(n);
     beta.setZero(n);
     
-    RealVectorX
-    work,
-    aval_r,
-    aval_i,
-    bval;
-    
-    RealMatrixX
-    vecl,
-    vecr;
-    
-    work.setZero(lwork);
-    aval_r.setZero(n);
-    aval_i.setZero(n);
-    bval.setZero(n);
-    vecl.setZero(n,n);
-    vecr.setZero(n,n);
+    _aval_r.setZero(n);
+    _aval_i.setZero(n);
+    _bval.setZero(n);
     
     Real
-    *a_vals    = Amat.data(),
-    *b_vals    = Bmat.data(),
-    *alpha_r_v = aval_r.data(),
-    *alpha_i_v = aval_i.data(),
-    *beta_v    = bval.data(),
-    *vecl_v    = vecl.data(),
-    *vecr_v    = vecr.data(),
-    *work_v    = work.data();
+    dummy      = 0.,
+    *vecl_v    = L=='V'?_vecl.data():&dummy,
+    *vecr_v    = R=='V'?_vecr.data():&dummy;
     
+    // query the optimal workspace size if the size or the options have
+    // changed since the last eigensolution
+    if (n != _lwork_n || L != _lwork_jobvl || R != _lwork_jobvr) {
+        
+        Real
+        work_opt = 0.;
+        lwork    = -1;
         
+        dggev_(&L, &R, &n,
+               _A_work.data(), &n,
+               _B_work.data(), &n,
+               _aval_r.data(), _aval_i.data(), _bval.data(),
+               vecl_v, &ldvl, vecr_v, &ldvr,
+               &work_opt, &lwork,
+               &info_val);
+        
+        lwork = info_val == 0 ? (int)work_opt : 16*n;
+        _work.setZero(std::max(lwork, std::max(1, 8*n)));
+        
+        _lwork_n     = n;
+        _lwork_jobvl = L;
+        _lwork_jobvr = R;
+    }
+    
+    lwork    = (int)_work.size();
+    info_val = -1;
+    
     dggev_(&L, &R, &n,
-           &(a_vals[0]), &n,
-           &(b_vals[0]), &n,
-           &(alpha_r_v[0]), &(alpha_i_v[0]), &(beta_v[0]),
-           &(vecl_v[0]), &n, &(vecr_v[0]), &n,
-           &(work_v[0]), &lwork,
+           _A_work.data(), &n,
+           _B_work.data(), &n,
+           _aval_r.data(), _aval_i.data(), _bval.data(),
+           vecl_v, &ldvl, vecr_v, &ldvr,
+           _work.data(), &lwork,
            &info_val);
     
     // now sort the eigenvalues for complex conjugates
@@ -99,26 +116,28 @@ MAST::LAPACK_DGGEV::compute(const RealMatrixX &A,
         
         // if the imaginary part of the eigenvalue is non-zero, it is a
         // complex conjugate
-        if (aval_i(n_located) != 0.) { // complex conjugate
+        if (_aval_i(n_located) != 0.) { // complex conjugate
             
-            alpha(  n_located) = std::complex<double>(aval_r(n_located),  aval_i(n_located));
-            alpha(1+n_located) = std::complex<double>(aval_r(n_located), -aval_i(n_located));
-            beta (  n_located) = bval(n_located);
-            beta (1+n_located) = bval(n_located);
+            alpha(  n_located) = std::complex<double>(_aval_r(n_located),  _aval_i(n_located));
+            alpha(1+n_located) = std::complex<double>(_aval_r(n_located), -_aval_i(n_located));
+            beta (  n_located) = _bval(n_located);
+            beta (1+n_located) = _bval(n_located);
 
             // copy the eigenvectors if they were requested
             if (computeEigenvectors) {
                 
                 std::complex<double> iota = std::complex<double>(0, 1.);
                 
-                VL.col(  n_located) = (vecl.col(  n_located).cast<Complex>() +
-                                       vecl.col(1+n_located).cast<Complex>() * iota);
-                VL.col(1+n_located) = (vecl.col(  n_located).cast<Complex>() -
-                                       vecl.col(1+n_located).cast<Complex>() * iota);
-                VR.col(  n_located) = (vecr.col(  n_located).cast<Complex>() +
-                                       vecr.col(1+n_located).cast<Complex>() * iota);
-                VR.col(1+n_located) = (vecr.col(  n_located).cast<Complex>() -
-                                       vecr.col(1+n_located).cast<Complex>() * iota);
+                if (L == 'V') {
+                    VL.col(  n_located) = (_vecl.col(  n_located).cast<Complex>() +
+                                           _vecl.col(1+n_located).cast<Complex>() * iota);
+                    VL.col(1+n_located) = (_vecl.col(  n_located).cast<Complex>() -
+                                           _vecl.col(1+n_located).cast<Complex>() * iota);
+                }
+                VR.col(  n_located) = (_vecr.col(  n_located).cast<Complex>() +
+                                       _vecr.col(1+n_located).cast<Complex>() * iota);
+                VR.col(1+n_located) = (_vecr.col(  n_located).cast<Complex>() -
+                                       _vecr.col(1+n_located).cast<Complex>() * iota);
             }
             
             // two complex conjugate roots were found
@@ -126,14 +145,15 @@ MAST::LAPACK_DGGEV::compute(const RealMatrixX &A,
         }
         else {
             
-            alpha(  n_located) = std::complex<double>(aval_r(n_located),  0.);
-            beta (  n_located) = bval(n_located);
+            alpha(  n_located) = std::complex<double>(_aval_r(n_located),  0.);
+            beta (  n_located) = _bval(n_located);
             
             // copy the eigenvectors if they were requested
             if (computeEigenvectors) {
                 
-                VL.col(n_located) = vecl.col(n_located).cast<Complex>();
-                VR.col(n_located) = vecr.col(n_located).cast<Complex>();
+                if (L == 'V')
+                    VL.col(n_located) = _vecl.col(n_located).cast<Complex>();
+                VR.col(n_located) = _vecr.col(n_located).cast<Complex>();
             }
             
             // only one real root was found
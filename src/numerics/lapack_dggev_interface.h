@@ -182,9 +182,24 @@ namespace MAST {
     public:
         
         LAPACK_DGGEV():
-        info_val(-1)
+        info_val(-1),
+        _if_left_eigenvectors(true),
+        _lwork_n(-1),
+        _lwork_jobvl('N'),
+        _lwork_jobvr('N')
         { }
         
+        /*!
+         *    if \p f is false, the eigensolutions compute only the right
+         *    eigenvectors. The left eigenvectors are then empty, and the
+         *    right eigenvectors are not scaled by
+         *    scale_eigenvectors_to_identity_innerproduct(). The left
+         *    eigenvectors are computed by default.
+         */
+        void set_compute_left_eigenvectors(bool f) {
+            _if_left_eigenvectors = f;
+        }
+        
         /*!
          *    computes the eigensolution for A x = \lambda B x. A & B will be
          *    overwritten
@@ -235,6 +250,10 @@ namespace MAST {
         void scale_eigenvectors_to_identity_innerproduct() {
             libmesh_assert(info_val == 0);
             
+            // the scaling requires the left eigenvectors
+            if (!this->VL.size())
+                return;
+            
             // this product should be an identity matrix
             ComplexMatrixX r = this->VL.conjugate().transpose() * _B * this->VR;
             
@@ -276,6 +295,42 @@ namespace MAST {
         RealVectorX    beta;
         
         int info_val;
+        
+        /*!
+         *    flag to compute the left eigenvectors
+         */
+        bool           _if_left_eigenvectors;
+        
+        /*!
+         *    copies of the matrices that are overwritten by LAPACK, along
+         *    with the workspace and the real-valued outputs of LAPACK. These
+         *    are reused by eigensolutions of the same size.
+         */
+        RealMatrixX    _A_work;
+        
+        RealMatrixX    _B_work;
+        
+        RealVectorX    _work;
+        
+        RealVectorX    _aval_r;
+        
+        RealVectorX    _aval_i;
+        
+        RealVectorX    _bval;
+        
+        RealMatrixX    _vecl;
+        
+        RealMatrixX    _vecr;
+        
+        /*!
+         *    matrix size and eigenvector options for which the optimal
+         *    size of \p _work was queried from LAPACK
+         */
+        int            _lwork_n;
+        
+        char           _lwork_jobvl;
+        
+        char           _lwork_jobvr;
     };
     
 }
@@ -34,9 +34,15 @@ namespace MAST {
     public:
         
         LAPACK_ZGGEV_Base():
-        info_val(-1)
+        info_val(-1),
+        _if_left_eigenvectors(true),
+        _lwork_n(-1),
+        _lwork_jobvl('N'),
+        _lwork_jobvr('N')
         { }
         
+        virtual ~LAPACK_ZGGEV_Base() { }
+        
         /*!
          *    computes the eigensolution for A x = \lambda B x. A & B will be
          *    overwritten
@@ -45,6 +51,16 @@ namespace MAST {
                              const ComplexMatrixX& B,
                              bool computeEigenvectors = true) = 0;
         
+        /*!
+         *    if \p f is false, the eigensolutions compute only the right
+         *    eigenvectors. The left eigenvectors are then empty, and are not
+         *    scaled by scale_eigenvectors_to_identity_innerproduct().
+         *    The left eigenvectors are computed by default.
+         */
+        void set_compute_left_eigenvectors(bool f) {
+            _if_left_eigenvectors = f;
+        }
+        
         const ComplexMatrixX& A() const {
             libmesh_assert(info_val == 0);
             return this->_A;
@@ -97,6 +113,10 @@ namespace MAST {
                 this->VR.col(i) /= l2;
             }
             
+            // the left eigenvectors are not scaled if they were not computed
+            if (!this->VL.size())
+                return;
+            
             // this product should be an identity matrix
             ComplexMatrixX r = this->VL.conjugate().transpose() * _B * this->VR;
             
@@ -138,6 +158,34 @@ namespace MAST {
         ComplexVectorX beta;
         
         int info_val;
+        
+        /*!
+         *    flag to compute the left eigenvectors
+         */
+        bool _if_left_eigenvectors;
+        
+        /*!
+         *    copies of the matrices that are overwritten by LAPACK, along
+         *    with the workspace. These are reused by eigensolutions of the
+         *    same size.
+         */
+        ComplexMatrixX _A_work;
+        
+        ComplexMatrixX _B_work;
+        
+        ComplexVectorX _work;
+        
+        RealVectorX    _rwork;
+        
+        /*!
+         *    matrix size and eigenvector options for which the optimal
+         *    size of \p _work was queried from LAPACK
+         */
+        int  _lwork_n;
+        
+        char _lwork_jobvl;
+        
+        char _lwork_jobvr;
     };
 }
 
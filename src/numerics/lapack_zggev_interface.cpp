@@ -31,12 +31,11 @@ MAST::LAPACK_ZGGEV::compute(const ComplexMatrixX &A,
                    B.cols() == A.rows() &&
                    B.cols() == B.rows());
     
-    _A = A;
-    _B = B;
-    
-    ComplexMatrixX
-    Amat = _A,
-    Bmat = _B;
+    // the storage of the copies is reused if the size has not changed
+    _A      = A;
+    _B      = B;
+    _A_work = A;
+    _B_work = B;
     
     int n = (int)A.cols();
     
@@ -44,43 +43,68 @@ MAST::LAPACK_ZGGEV::compute(const ComplexMatrixX &A,
     
     if (computeEigenvectors)
     {
-        L = 'V'; R = 'V';
-        VL.setZero(n, n);
+        R = 'V';
         VR.setZero(n, n);
+        
+        if (_if_left_eigenvectors) {
+            L = 'V';
+            VL.setZero(n, n);
+        }
+        else
+            VL.resize(0, 0);
     }
     
     int
-    lwork=16*n,
-    l_rwork=8*n;
-    info_val=-1;
+    ldvl     = L=='V'?n:1,
+    ldvr     = R=='V'?n:1,
+    lwork    = 0;
+    info_val = -1;
     
     alpha.setZero(n);
     beta.setZero(n);
-    ComplexVectorX
-    work  = ComplexVectorX::Zero(lwork);
-    RealVectorX
-    rwork = RealVectorX::Zero(l_rwork);
+    if (_rwork.size() != 8*n)
+        _rwork.setZero(8*n);
     
     Complex
-    *a_vals     = Amat.data(),
-    *b_vals     = Bmat.data(),
-    *alpha_v    = alpha.data(),
-    *beta_v     = beta.data(),
-    *VL_v       = VL.data(),
-    *VR_v       = VR.data(),
-    *work_v     = work.data();
+    dummy       = 0.,
+    *VL_v       = L=='V'?VL.data():&dummy,
+    *VR_v       = R=='V'?VR.data():&dummy;
     
-    Real
-    *rwork_v    = rwork.data();
+    // query the optimal workspace size if the size or the options have
+    // changed since the last eigensolution
+    if (n != _lwork_n || L != _lwork_jobvl || R != _lwork_jobvr) {
+        
+        Complex
+        work_opt = 0.;
+        lwork    = -1;
+        
+        zggev_(&L, &R, &n,
+               _A_work.data(), &n,
+               _B_work.data(), &n,
+               alpha.data(), beta.data(),
+               VL_v, &ldvl, VR_v, &ldvr,
+               &work_opt, &lwork,
+               _rwork.data(),
+               &info_val);
+        
+        lwork = info_val == 0 ? (int)std::real(work_opt) : 16*n;
+        _work.setZero(std::max(lwork, std::max(1, 2*n)));
+        
+        _lwork_n     = n;
+        _lwork_jobvl = L;
+        _lwork_jobvr = R;
+    }
     
+    lwork    = (int)_work.size();
+    info_val = -1;
     
     zggev_(&L, &R, &n,
-           &(a_vals[0]), &n,
-           &(b_vals[0]), &n,
-           &(alpha_v[0]), &(beta_v[0]),
-           &(VL_v[0]), &n, &(VR_v[0]), &n,
-           &(work_v[0]), &lwork,
-           &(rwork_v[0]),
+           _A_work.data(), &n,
+           _B_work.data(), &n,
+           alpha.data(), beta.data(),
+           VL_v, &ldvl, VR_v, &ldvr,
+           _work.data(), &lwork,
+           _rwork.data(),
            &info_val);
     
     if (info_val  != 0)
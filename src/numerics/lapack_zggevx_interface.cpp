@@ -31,80 +31,114 @@ MAST::LAPACK_ZGGEVX::compute(const ComplexMatrixX &A,
                    B.cols() == A.rows() &&
                    B.cols() == B.rows());
     
-    _A = A;
-    _B = B;
-    
-    ComplexMatrixX
-    Amat = _A,
-    Bmat = _B;
+    // the storage of the copies is reused if the size has not changed
+    _A      = A;
+    _B      = B;
+    _A_work = A;
+    _B_work = B;
     
     int n = (int)A.cols();
     
-    char BAL='B', L='N',R='N', S='E';
+    char BAL=_if_balance?'B':'N', L='N',R='N', S='N';
     
     if (computeEigenvectors) {
         
-        L = 'V'; R = 'V'; S='B';
-        VL.setZero(n, n);
+        R = 'V';
         VR.setZero(n, n);
+        
+        // the condition numbers require both left and right eigenvectors
+        if (_if_left_eigenvectors) {
+            L = 'V'; S = 'B';
+            VL.setZero(n, n);
+        }
+        else
+            VL.resize(0, 0);
     }
     
     int
-    lwork    =4*(n*n+n),
-    l_rwork  =8*n,
+    ldvl     = L=='V'?n:1,
+    ldvr     = R=='V'?n:1,
+    lwork    = 0,
     ilo      = 0,
     ihi      = 0;
-    info_val =-1,
+    info_val =-1;
     
     alpha.setZero(n);
     beta.setZero(n);
-    ComplexVectorX
-    work   = ComplexVectorX::Zero(lwork);
-    RealVectorX
-    rwork  = RealVectorX::Zero(l_rwork),
-    lscale = RealVectorX::Zero(n),
-    rscale = RealVectorX::Zero(n),
-    rconde = RealVectorX::Zero(n),
-    rcondv = RealVectorX::Zero(n);
+    
+    if (_rwork.size() != 8*n) {
+        
+        _rwork.setZero(8*n);
+        _lscale.setZero(n);
+        _rscale.setZero(n);
+        _rconde.setZero(n);
+        _rcondv.setZero(n);
+        _iwork.resize(n+2, 0);
+        _bwork.resize(std::max(n, 1), 0);
+    }
     
     Complex
-    *a_vals  = Amat.data(),
-    *b_vals  = Bmat.data(),
-    *alpha_v = alpha.data(),
-    *beta_v  = beta.data(),
-    *VL_v    = VL.data(),
-    *VR_v    = VR.data(),
-    *work_v  = work.data();
+    dummy     = 0.,
+    *VL_v     = L=='V'?VL.data():&dummy,
+    *VR_v     = R=='V'?VR.data():&dummy;
     
     Real
-    *rwork_v  = rwork.data(),
-    *lscale_v = lscale.data(),
-    *rscale_v = rscale.data(),
-    *rconde_v = rconde.data(),
-    *rcondv_v = rcondv.data(),
     abnrm     = 0.,
     bbnrm     = 0.;
     
-    std::vector<int>
-    iwork(n+2, 0);
-    
+    // LAPACK logical arrays use the size of an integer
     bool
-    bwork[n];
+    *bwork_v  = reinterpret_cast<bool*>(&(_bwork[0]));
+    
+    // query the optimal workspace size if the size or the options have
+    // changed since the last eigensolution
+    if (n != _lwork_n || L != _lwork_jobvl || R != _lwork_jobvr) {
+        
+        Complex
+        work_opt = 0.;
+        lwork    = -1;
+        
+        zggevx_(&BAL, &L, &R, &S, &n,
+                _A_work.data(), &n,
+                _B_work.data(), &n,
+                alpha.data(), beta.data(),
+                VL_v, &ldvl,
+                VR_v, &ldvr,
+                &ilo, &ihi,
+                _lscale.data(), _rscale.data(),
+                &abnrm, &bbnrm,
+                _rconde.data(), _rcondv.data(),
+                &work_opt, &lwork,
+                _rwork.data(),
+                &(_iwork[0]),
+                bwork_v,
+                &info_val);
+        
+        lwork = info_val == 0 ? (int)std::real(work_opt) : 4*(n*n+n);
+        _work.setZero(std::max(lwork, std::max(1, 2*n*(n+1))));
+        
+        _lwork_n     = n;
+        _lwork_jobvl = L;
+        _lwork_jobvr = R;
+    }
+    
+    lwork    = (int)_work.size();
+    info_val = -1;
     
     zggevx_(&BAL, &L, &R, &S, &n,
-            &(a_vals[0]), &n,
-            &(b_vals[0]), &n,
-            &(alpha_v[0]), &(beta_v[0]),
-            &(VL_v[0]), &n,
-            &(VR_v[0]), &n,
+            _A_work.data(), &n,
+            _B_work.data(), &n,
+            alpha.data(), beta.data(),
+            VL_v, &ldvl,
+            VR_v, &ldvr,
             &ilo, &ihi,
-            &(lscale_v[0]), &(rscale_v[0]),
+            _lscale.data(), _rscale.data(),
             &abnrm, &bbnrm,
-            &(rconde_v[0]), &(rcondv_v[0]),
-            &(work_v[0]), &lwork,
-            &(rwork_v[0]),
-            &(iwork[0]),
-            &(bwork[0]),
+            _rconde.data(), _rcondv.data(),
+            _work.data(), &lwork,
+            _rwork.data(),
+            &(_iwork[0]),
+            bwork_v,
             &info_val);
     
     if (info_val  != 0)
@@ -294,7 +294,8 @@ namespace MAST {
     public:
         
         LAPACK_ZGGEVX():
-        MAST::LAPACK_ZGGEV_Base()
+        MAST::LAPACK_ZGGEV_Base(),
+        _if_balance(true)
         { }
         
         /*!
@@ -305,6 +306,36 @@ namespace MAST {
                              const ComplexMatrixX& B,
                              bool computeEigenvectors = true);
         
+        /*!
+         *    if \p f is false, the matrices are not permuted or scaled before
+         *    the eigensolution. Balancing is used by default.
+         */
+        void set_balancing(bool f) {
+            _if_balance = f;
+        }
+        
+    protected:
+        
+        /*!
+         *    flag to balance the matrices
+         */
+        bool                _if_balance;
+        
+        /*!
+         *    workspace specific to ZGGEVX, reused by eigensolutions of the
+         *    same size
+         */
+        RealVectorX         _lscale;
+        
+        RealVectorX         _rscale;
+        
+        RealVectorX         _rconde;
+        
+        RealVectorX         _rcondv;
+        
+        std::vector<int>    _iwork;
+        
+        std::vector<int>    _bwork;
     };
 }
 
@@ -0,0 +1,461 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2018  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <cmath>
+
+// MAST includes
+#include "solver/checkpointed_transient_adjoint.h"
+#include "solver/transient_solver_base.h"
+#include "base/transient_assembly.h"
+#include "base/output_assembly_elem_operations.h"
+#include "base/nonlinear_system.h"
+#include "base/performance_counters.h"
+
+// libMesh includes
+#include "libmesh/linear_solver.h"
+#include "libmesh/sparse_matrix.h"
+#include "libmesh/dof_map.h"
+
+
+MAST::CheckpointedTransientAdjoint::
+CheckpointedTransientAdjoint(MAST::TransientSolverBase&           solver,
+                             MAST::TransientAssembly&             assembly,
+                             MAST::OutputAssemblyElemOperations&  output,
+                             unsigned int                         n_checkpoints):
+_solver                (solver),
+_assembly              (assembly),
+_output                (output),
+_n_checkpoints         (n_checkpoints),
+_n_steps               (0),
+_n_recomputed_steps    (0),
+_output_value          (0.) {
+    
+}
+
+
+
+MAST::CheckpointedTransientAdjoint::~CheckpointedTransientAdjoint() {
+    
+    this->_clear_checkpoints();
+    
+    for (unsigned int i=0; i<_adjoint_carry.size(); i++)
+        delete _adjoint_carry[i];
+}
+
+
+
+Real
+MAST::CheckpointedTransientAdjoint::forward_solve(unsigned int n_steps) {
+    
+    MAST::PerformanceScope perf("CheckpointedTransientAdjoint::forward_solve");
+    
+    libmesh_assert_greater(n_steps, 0);
+    
+    MAST::NonlinearSystem
+    &sys = _assembly.system();
+    
+    this->_clear_checkpoints();
+    
+    _n_steps      = n_steps;
+    _output_value = 0.;
+    _dt.assign(n_steps+1, 0.);
+    _time.assign(n_steps+1, sys.time);
+    
+    this->_store_checkpoint(0);
+    
+    // the checkpoints for the first reversal from the last time step are
+    // placed during the forward solution, so that these need not be
+    // recomputed. These are the same as the ones selected in _reverse().
+    unsigned int
+    n_free  = _n_checkpoints,
+    n_next  = 0;
+    
+    if (n_free && n_steps > 1)
+        n_next = _checkpoint_distance(n_steps, n_free);
+    
+    for (unsigned int n=1; n<=n_steps; n++) {
+        
+        if (_solver.if_adaptive_time_stepping())
+            _solver.solve_and_advance_adaptive_time_step(_assembly);
+        else {
+            
+            _solver.solve(_assembly);
+            _solver.advance_time_step();
+        }
+        
+        _time[n] = sys.time;
+        _dt[n]   = _time[n] - _time[n-1];
+        
+        _assembly.calculate_output(*sys.solution, _output);
+        _output_value += _dt[n] * _output.output_total();
+        
+        if (n == n_next) {
+            
+            this->_store_checkpoint(n);
+            n_free--;
+            
+            if (n_free && n_steps - n > 1)
+                n_next = n + _checkpoint_distance(n_steps - n, n_free);
+        }
+    }
+    
+    return _output_value;
+}
+
+
+
+void
+MAST::CheckpointedTransientAdjoint::
+adjoint_sensitivity(const std::vector<const MAST::FunctionBase*>& p,
+                    std::vector<Real>& dq_dp) {
+    
+    MAST::PerformanceScope perf("CheckpointedTransientAdjoint::adjoint_sensitivity");
+    
+    libmesh_assert_msg(_n_steps, "forward_solve() must be called before adjoint.");
+    
+    MAST::NonlinearSystem
+    &sys = _assembly.system();
+    
+    const unsigned int
+    n_derivs = _solver.ode_order();
+    
+    dq_dp.assign(p.size(), 0.);
+    _n_recomputed_steps = 0;
+    
+    // the adjoint of the time derivatives is zero after the last time step
+    for (unsigned int i=0; i<_adjoint_carry.size(); i++)
+        delete _adjoint_carry[i];
+    _adjoint_carry.resize(n_derivs+1);
+    for (unsigned int i=0; i<=n_derivs; i++)
+        _adjoint_carry[i] = sys.solution->zero_clone().release();
+    
+    this->_reverse(0, _n_steps, _n_checkpoints, p, dq_dp);
+    
+    // the highest derivative at the initial time step is obtained from
+    // the residual and depends on the parameters. Its adjoint provides the
+    // last contribution to the sensitivity.
+    this->_restore_checkpoint(0);
+    _solver.dt = _dt[1];
+    
+    _solver.highest_derivative_adjoint_solve(_assembly,
+                                             *_adjoint_carry[n_derivs],
+                                             sys.add_adjoint_solution(),
+                                             p,
+                                             dq_dp);
+}
+
+
+
+unsigned int
+MAST::CheckpointedTransientAdjoint::
+_checkpoint_distance(unsigned int n_steps,
+                     unsigned int n_free) const {
+    
+    libmesh_assert_greater(n_free, 0);
+    libmesh_assert_greater(n_steps, 1);
+    
+    // number of time steps that can be reversed with s checkpoints when
+    // each step is computed at most r times: (s+r)!/(s! r!)
+    auto beta = [] (unsigned int s, unsigned int r) -> Real {
+        Real v = 1.;
+        for (unsigned int i=1; i<=s; i++)
+            v = v * (r + i) / i;
+        return v;
+    };
+    
+    // smallest number of repetitions that allow the reversal
+    unsigned int r = 1;
+    while (beta(n_free, r) < n_steps)
+        r++;
+    
+    // the steps after the checkpoint are reversed with one checkpoint less,
+    // and the steps before the checkpoint with one repetition less.
+    const Real
+    d = n_steps - beta(n_free-1, r);
+    
+    return d < 1. ? 1 : (unsigned int)std::round(d);
+}
+
+
+
+void
+MAST::CheckpointedTransientAdjoint::_store_checkpoint(unsigned int n) {
+    
+    libmesh_assert(!_checkpoints.count(n));
+    
+    MAST::NonlinearSystem
+    &sys = _assembly.system();
+    
+    std::vector<libMesh::NumericVector<Real>*>
+    &vecs = _checkpoints[n];
+    
+    // after the time step is advanced the time derivatives of this time
+    // step are available as the previous iteration
+    vecs.resize(_solver.ode_order()+1, nullptr);
+    vecs[0] = sys.solution->clone().release();
+    vecs[1] = _solver.velocity(1).clone().release();
+    if (_solver.ode_order() > 1)
+        vecs[2] = _solver.acceleration(1).clone().release();
+}
+
+
+
+void
+MAST::CheckpointedTransientAdjoint::_restore_checkpoint(unsigned int n) {
+    
+    std::map<unsigned int, std::vector<libMesh::NumericVector<Real>*> >::iterator
+    it = _checkpoints.find(n);
+    
+    libmesh_assert(it != _checkpoints.end());
+    
+    MAST::NonlinearSystem
+    &sys = _assembly.system();
+    
+    const std::vector<libMesh::NumericVector<Real>*>
+    &vecs = it->second;
+    
+    *sys.solution = *vecs[0];
+    sys.solution->close();
+    sys.update();
+    
+    _solver.solution(1)  = *vecs[0];
+    _solver.velocity(1)  = *vecs[1];
+    _solver.velocity()   = *vecs[1];
+    
+    if (_solver.ode_order() > 1) {
+        
+        _solver.acceleration(1) = *vecs[2];
+        _solver.acceleration()  = *vecs[2];
+    }
+    
+    sys.time = _time[n];
+}
+
+
+
+void
+MAST::CheckpointedTransientAdjoint::_clear_checkpoint(unsigned int n) {
+    
+    std::map<unsigned int, std::vector<libMesh::NumericVector<Real>*> >::iterator
+    it = _checkpoints.find(n);
+    
+    libmesh_assert(it != _checkpoints.end());
+    
+    for (unsigned int i=0; i<it->second.size(); i++)
+        delete it->second[i];
+    
+    _checkpoints.erase(it);
+}
+
+
+
+void
+MAST::CheckpointedTransientAdjoint::_clear_checkpoints() {
+    
+    std::map<unsigned int, std::vector<libMesh::NumericVector<Real>*> >::iterator
+    it  = _checkpoints.begin(),
+    end = _checkpoints.end();
+    
+    for ( ; it != end; it++)
+        for (unsigned int i=0; i<it->second.size(); i++)
+            delete it->second[i];
+    
+    _checkpoints.clear();
+}
+
+
+
+void
+MAST::CheckpointedTransientAdjoint::_recompute(unsigned int n0,
+                                               unsigned int n1) {
+    
+    MAST::NonlinearSystem
+    &sys = _assembly.system();
+    
+    for (unsigned int n=n0+1; n<=n1; n++) {
+        
+        _solver.dt = _dt[n];
+        _solver.solve(_assembly);
+        _solver.advance_time_step();
+        
+        // use the recorded time to avoid accumulation of round-off
+        sys.time = _time[n];
+        _n_recomputed_steps++;
+    }
+}
+
+
+
+void
+MAST::CheckpointedTransientAdjoint::
+_reverse(unsigned int n0,
+         unsigned int n1,
+         unsigned int n_free,
+         const std::vector<const MAST::FunctionBase*>& p,
+         std::vector<Real>& dq_dp) {
+    
+    while (n1 > n0) {
+        
+        if (n1 - n0 == 1 || !n_free) {
+            
+            // recompute the state before the last step from the checkpoint
+            // and reverse the last step
+            this->_restore_checkpoint(n0);
+            this->_recompute(n0, n1-1);
+            this->_adjoint_step(n1, p, dq_dp);
+            n1--;
+        }
+        else {
+            
+            // place a checkpoint and reverse the steps after it with the
+            // remaining checkpoints. The checkpoint may already be available
+            // from the forward solution.
+            const unsigned int
+            n = n0 + _checkpoint_distance(n1 - n0, n_free);
+            
+            if (!_checkpoints.count(n)) {
+                
+                this->_restore_checkpoint(n0);
+                this->_recompute(n0, n);
+                this->_store_checkpoint(n);
+            }
+            
+            this->_reverse(n, n1, n_free-1, p, dq_dp);
+            this->_clear_checkpoint(n);
+            n1 = n;
+        }
+    }
+}
+
+
+
+void
+MAST::CheckpointedTransientAdjoint::
+_adjoint_step(unsigned int n,
+              const std::vector<const MAST::FunctionBase*>& p,
+              std::vector<Real>& dq_dp) {
+    
+    MAST::PerformanceScope perf("CheckpointedTransientAdjoint::_adjoint_step");
+    
+    MAST::NonlinearSystem
+    &sys = _assembly.system();
+    
+    const unsigned int
+    n_derivs = _solver.ode_order();
+    
+    // solve for the state at this time step from the previous state
+    _solver.dt = _dt[n];
+    _solver.solve(_assembly);
+    _n_recomputed_steps++;
+    
+    // the time derivatives at this time step are obtained as
+    //     x^(k) = c(k-1, 0) x + sum_j c(k-1, j+1) x0^(j)
+    // and the adjoint equation for x is
+    //     J^T lambda = -dt dq/dx + g_0 + sum_k c(k-1, 0) g_k
+    // where g_j is the adjoint carried from the next time step for the
+    // j th derivative at this time step.
+    RealMatrixX
+    c;
+    _solver.time_derivative_update_coefficients(c);
+    
+    libMesh::NumericVector<Real>
+    &lambda = sys.add_adjoint_solution(),
+    &rhs    = sys.add_adjoint_rhs();
+    
+    _assembly.calculate_output_derivative(*sys.solution, _output, rhs);
+    rhs.scale(-_dt[n]);
+    rhs.add(1., *_adjoint_carry[0]);
+    for (unsigned int k=1; k<=n_derivs; k++)
+        rhs.add(c(k-1, 0), *_adjoint_carry[k]);
+    rhs.close();
+    
+    std::vector<libMesh::NumericVector<Real>*>
+    mu(n_derivs, nullptr);
+    for (unsigned int k=0; k<n_derivs; k++)
+        mu[k] = sys.solution->zero_clone().release();
+    
+    _assembly.set_elem_operation_object(_solver);
+    _assembly.residual_and_jacobian(*sys.solution, nullptr, sys.matrix, sys);
+    
+    std::pair<unsigned int, Real>
+    solver_params = sys.get_linear_solve_parameters();
+    
+    sys.linear_solver->adjoint_solve(*sys.matrix,
+                                     lambda,
+                                     rhs,
+                                     solver_params.second,
+                                     solver_params.first);
+    
+    // The linear solver may not have fit our constraints exactly
+#ifdef LIBMESH_ENABLE_CONSTRAINTS
+    sys.get_dof_map().enforce_adjoint_constraints_exactly(lambda, 0);
+#endif
+    
+    _assembly.adjoint_time_derivative_products(*sys.solution, lambda, mu, sys);
+    _assembly.clear_elem_operation_object();
+    
+    // the system matrix has been replaced by the Jacobian of this step
+    sys.reset_lagged_jacobian();
+    
+    // adjoint of the time derivatives at this time step:
+    //     mu_k = g_k - [dR/dx^(k)]^T lambda
+    for (unsigned int k=1; k<=n_derivs; k++) {
+        
+        mu[k-1]->scale(-1.);
+        mu[k-1]->add(1., *_adjoint_carry[k]);
+        mu[k-1]->close();
+    }
+    
+    // contribution of this time step to the sensitivity
+    std::vector<Real>
+    vals;
+    
+    _assembly.calculate_output_adjoint_sensitivity_for_parameters(*sys.solution,
+                                                                  lambda,
+                                                                  p,
+                                                                  _solver,
+                                                                  _output,
+                                                                  vals,
+                                                                  false);
+    for (unsigned int i=0; i<p.size(); i++)
+        dq_dp[i] += vals[i];
+    
+    _assembly.calculate_output_direct_sensitivity_for_parameters
+    (*sys.solution,
+     std::vector<const libMesh::NumericVector<Real>*>(),
+     p,
+     _output,
+     vals);
+    for (unsigned int i=0; i<p.size(); i++)
+        dq_dp[i] += _dt[n] * vals[i];
+    
+    // adjoint carried to the previous time step for its solution and
+    // time derivatives
+    for (unsigned int j=0; j<=n_derivs; j++) {
+        
+        _adjoint_carry[j]->zero();
+        for (unsigned int k=1; k<=n_derivs; k++)
+            _adjoint_carry[j]->add(c(k-1, j+1), *mu[k-1]);
+        _adjoint_carry[j]->close();
+    }
+    
+    for (unsigned int k=0; k<n_derivs; k++)
+        delete mu[k];
+}
@@ -0,0 +1,240 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2018  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__checkpointed_transient_adjoint_h__
+#define __mast__checkpointed_transient_adjoint_h__
+
+// C++ includes
+#include <map>
+#include <vector>
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class TransientSolverBase;
+    class TransientAssembly;
+    class OutputAssemblyElemOperations;
+    class FunctionBase;
+    
+    
+    /*!
+     *   Computes the sensitivity of the time-integrated output
+     *   \f[ J = \sum_{n=1}^{N} \Delta t_n q(X_n, p) \f]
+     *   of a transient solution with respect to many parameters using the
+     *   adjoint of the time integration scheme, so that the cost is
+     *   independent of the number of parameters.
+     *
+     *   The adjoint is solved backwards in time and needs the forward
+     *   solution at each time step. Only a limited number of states are
+     *   stored as checkpoints, and the intermediate states are recomputed
+     *   from the nearest checkpoint. The checkpoints are placed using the
+     *   binomial schedule of Griewank and Walther (Revolve), which
+     *   minimizes the number of recomputed time steps for the given
+     *   number of checkpoints.
+     *
+     *   The initial conditions are assumed to be independent of the
+     *   parameters. The dependence of the initial highest derivative on the
+     *   parameters is accounted for.
+     */
+    class CheckpointedTransientAdjoint {
+        
+    public:
+        
+        /*!
+         *   \p n_checkpoints is the number of states that can be stored in
+         *   addition to the initial conditions.
+         */
+        CheckpointedTransientAdjoint(MAST::TransientSolverBase&           solver,
+                                     MAST::TransientAssembly&             assembly,
+                                     MAST::OutputAssemblyElemOperations&  output,
+                                     unsigned int                         n_checkpoints);
+        
+        
+        virtual ~CheckpointedTransientAdjoint();
+        
+        
+        /*!
+         *   integrates the solution for \p n_steps time steps from the
+         *   current state of the transient solver and stores the
+         *   checkpoints. The highest derivative of the initial conditions
+         *   must have been computed by the solver before this call. If
+         *   adaptive time stepping is enabled in the solver, the time steps
+         *   are selected adaptively, and the same time steps are used for
+         *   the recomputed states.
+         *   @returns the time-integrated output.
+         */
+        Real forward_solve(unsigned int n_steps);
+        
+        
+        /*!
+         *   computes the sensitivity of the output from the last call to
+         *   forward_solve() with respect to each parameter in \p p and
+         *   returns the values in \p dq_dp. Upon return, the solver is
+         *   at the initial time step.
+         */
+        void adjoint_sensitivity(const std::vector<const MAST::FunctionBase*>& p,
+                                 std::vector<Real>& dq_dp);
+        
+        
+        /*!
+         *   @returns the time-integrated output from the last call to
+         *   forward_solve()
+         */
+        Real output() const {
+            return _output_value;
+        }
+        
+        
+        /*!
+         *   @returns the number of time steps recomputed during the last
+         *   call to adjoint_sensitivity()
+         */
+        unsigned int n_recomputed_steps() const {
+            return _n_recomputed_steps;
+        }
+        
+        
+    protected:
+        
+        
+        /*!
+         *   @returns the number of time steps from the beginning of a
+         *   reversal of \p n_steps time steps with \p n_free free
+         *   checkpoints at which the next checkpoint is placed.
+         */
+        unsigned int _checkpoint_distance(unsigned int n_steps,
+                                          unsigned int n_free) const;
+        
+        
+        /*!
+         *   stores the current state of the solver as the checkpoint of
+         *   time step \p n
+         */
+        void _store_checkpoint(unsigned int n);
+        
+        
+        /*!
+         *   sets the state of the solver to the checkpoint of time step \p n
+         */
+        void _restore_checkpoint(unsigned int n);
+        
+        
+        /*!
+         *   deletes the checkpoint of time step \p n
+         */
+        void _clear_checkpoint(unsigned int n);
+        
+        
+        /*!
+         *   deletes all checkpoints
+         */
+        void _clear_checkpoints();
+        
+        
+        /*!
+         *   recomputes the time steps \p n0 + 1 to \p n1 from the state of
+         *   time step \p n0 in the solver.
+         */
+        void _recompute(unsigned int n0,
+                        unsigned int n1);
+        
+        
+        /*!
+         *   reverses the time steps \p n1 to \p n0 + 1, with a checkpoint
+         *   available at time step \p n0 and \p n_free checkpoints
+         *   available for intermediate states.
+         */
+        void _reverse(unsigned int n0,
+                      unsigned int n1,
+                      unsigned int n_free,
+                      const std::vector<const MAST::FunctionBase*>& p,
+                      std::vector<Real>& dq_dp);
+        
+        
+        /*!
+         *   solves the adjoint of time step \p n, with the solver set to the
+         *   state of time step \p n - 1, and adds the contribution of this
+         *   time step to \p dq_dp.
+         */
+        void _adjoint_step(unsigned int n,
+                           const std::vector<const MAST::FunctionBase*>& p,
+                           std::vector<Real>& dq_dp);
+        
+        
+        MAST::TransientSolverBase&             _solver;
+        
+        MAST::TransientAssembly&               _assembly;
+        
+        MAST::OutputAssemblyElemOperations&    _output;
+        
+        /*!
+         *   number of checkpoints in addition to the initial conditions
+         */
+        const unsigned int                     _n_checkpoints;
+        
+        /*!
+         *   number of time steps in the last forward solution
+         */
+        unsigned int                           _n_steps;
+        
+        /*!
+         *   number of time steps recomputed in the adjoint solution
+         */
+        unsigned int                           _n_recomputed_steps;
+        
+        /*!
+         *   time-integrated output
+         */
+        Real                                   _output_value;
+        
+        /*!
+         *   size of each time step. Index \p n is the step from time
+         *   step \p n - 1 to \p n.
+         */
+        std::vector<Real>                      _dt;
+        
+        /*!
+         *   time at each time step, with the initial time at index 0
+         */
+        std::vector<Real>                      _time;
+        
+        /*!
+         *   solution and its time derivatives stored for each checkpoint
+         */
+        std::map<unsigned int, std::vector<libMesh::NumericVector<Real>*> >
+        _checkpoints;
+        
+        /*!
+         *   adjoint of the time derivatives from the next time step, combined
+         *   with the coefficients of the time derivative update. Index 0 is
+         *   for the solution, and index \p k for the \p k th derivative.
+         */
+        std::vector<libMesh::NumericVector<Real>*>   _adjoint_carry;
+    };
+}
+
+
+#endif // __mast__checkpointed_transient_adjoint_h__
@@ -22,6 +22,7 @@
 #include "solver/complex_solver_base.h"
 #include "base/complex_assembly_base.h"
 #include "base/nonlinear_system.h"
+#include "base/performance_counters.h"
 
 
 // libMesh includes
@@ -37,9 +38,17 @@
 
 
 MAST::ComplexSolverBase::ComplexSolverBase():
-tol        (1.0e-3),
-max_iters  (20),
-_assembly  (nullptr) {
+tol                  (1.0e-3),
+max_iters            (20),
+_assembly            (nullptr),
+_block_mat           (nullptr),
+_block_res           (nullptr),
+_block_sol           (nullptr),
+_block_ksp           (nullptr),
+_block_dof_map       (nullptr),
+_block_n_dofs        (0),
+_pc_lag              (1),
+_n_block_assemblies  (0) {
     
 }
 
@@ -47,6 +56,7 @@ _assembly  (nullptr) {
 
 MAST::ComplexSolverBase::~ComplexSolverBase() {
     
+    this->clear_solver_data();
 }
 
 
@@ -64,6 +74,8 @@ MAST::ComplexSolverBase::set_assembly(MAST::ComplexAssemblyBase &assemble) {
 void
 MAST::ComplexSolverBase::clear_assembly() {
     
+    this->clear_solver_data();
+    
     MAST::NonlinearSystem& sys = _assembly->system();
     
     // remove the real part of the vector
@@ -186,6 +198,8 @@ MAST::ComplexSolverBase::imag_solution(bool if_sens) const {
 void
 MAST::ComplexSolverBase::solve_pc_fieldsplit() {
     
+    MAST::PerformanceScope perf("ComplexSolverBase::solve_pc_fieldsplit");
+    
     libmesh_assert(_assembly);
 
     START_LOG("complex_solve()", "PetscFieldSplitSolver");
@@ -332,6 +346,25 @@ MAST::ComplexSolverBase::solve_pc_fieldsplit() {
 void
 MAST::ComplexSolverBase::solve_block_matrix(MAST::Parameter* p)  {
     
+    MAST::PerformanceScope perf("ComplexSolverBase::solve_block_matrix");
+    
+    std::function<void(unsigned int)>
+    no_op = [] (unsigned int i) { };
+    
+    this->solve_block_matrix_multiple_rhs(1, no_op, no_op, p);
+}
+
+
+
+void
+MAST::ComplexSolverBase::
+solve_block_matrix_multiple_rhs(unsigned int n_rhs,
+                                const std::function<void(unsigned int)>& init_rhs,
+                                const std::function<void(unsigned int)>& use_sol,
+                                MAST::Parameter* p) {
+    
+    MAST::PerformanceScope perf("ComplexSolverBase::solve_block_matrix_multiple_rhs");
+    
     libmesh_assert(_assembly);
     
     START_LOG("solve_block_matrix()", "ComplexSolve");
@@ -340,8 +373,156 @@ MAST::ComplexSolverBase::solve_block_matrix(MAST::Parameter* p)  {
     MAST::NonlinearSystem& sys =
     dynamic_cast<MAST::NonlinearSystem&>(_assembly->system());
     
+    // create the matrix, vectors and KSP, or reuse them from a
+    // previous solve
+    this->_init_block_matrix_data();
+    
+    PetscErrorCode   ierr;
+    
+    std::unique_ptr<libMesh::SparseMatrix<Real> >
+    jac_mat(new libMesh::PetscMatrix<Real>(_block_mat, sys.comm()));
+    
+    std::unique_ptr<libMesh::NumericVector<Real> >
+    res(new libMesh::PetscVector<Real>(_block_res, sys.comm())),
+    sol(new libMesh::PetscVector<Real>(_block_sol, sys.comm()));
+    
+    // the matrix is assembled once in this call, and the preconditioner
+    // from a previous assembly is reused if it is lagged
+    const bool
+    if_reuse_pc = (_n_block_assemblies % _pc_lag) != 0;
+    _n_block_assemblies++;
+    
+    ierr = KSPSetReusePreconditioner(_block_ksp,
+                                     if_reuse_pc?PETSC_TRUE:PETSC_FALSE);
+    CHKERRABORT(sys.comm().get(), ierr);
+    
+    
+    // vectors for the real and imaginary parts of the solution
+    libMesh::NumericVector<Real>
+    &sol_R = this->real_solution(p != nullptr),
+    &sol_I = this->imag_solution(p != nullptr);
+    
+    unsigned int
+    first = sol_R.first_local_index(),
+    last  = sol_R.last_local_index();
+    
+    for (unsigned int i_rhs=0; i_rhs<n_rhs; i_rhs++) {
+        
+        init_rhs(i_rhs);
+        
+        // the residual is evaluated about a zero solution. If sensitivity
+        // analysis is requested, then the complex solution is set in the
+        // solution vector
+        sol->zero();
+        
+        if (p) {
+            
+            const libMesh::NumericVector<Real>
+            &X_R = this->real_solution(),
+            &X_I = this->imag_solution();
+            
+            for (unsigned int i=first; i<last; i++) {
+                
+                sol->set(  2*i, X_R(i));
+                sol->set(2*i+1, X_I(i));
+            }
+        }
+        
+        sol->close();
+        
+        // assemble the residual, and the matrix with the first residual
+        _assembly->residual_and_jacobian_blocked(*sol,
+                                                 *res,
+                                                 i_rhs==0?jac_mat.get():nullptr,
+                                                 p);
+        res->scale(-1.);
+        
+        
+        START_LOG("KSPSolve", "ComplexSolve");
+        
+        // now solve
+        ierr = KSPSolve(_block_ksp, _block_res, _block_sol);
+        CHKERRABORT(sys.comm().get(), ierr);
+        
+        STOP_LOG("KSPSolve", "ComplexSolve");
+        
+        
+        // copy the solution to separate real and imaginary vectors
+        for (unsigned int i=first; i<last; i++) {
+            sol_R.set(i, (*sol)(  2*i));
+            sol_I.set(i, (*sol)(2*i+1));
+        }
+        
+        sol_R.close();
+        sol_I.close();
+        sol->close();
+        
+        use_sol(i_rhs);
+    }
+    
+    STOP_LOG("solve_block_matrix()", "ComplexSolve");
+}
+
+
+
+void
+MAST::ComplexSolverBase::set_preconditioner_lag(unsigned int n) {
+    
+    libmesh_assert_greater(n, 0);
+    
+    _pc_lag = n;
+}
+
+
+
+void
+MAST::ComplexSolverBase::clear_solver_data() {
+    
+    PetscErrorCode ierr;
+    
+    if (_block_ksp) {
+        ierr = KSPDestroy(&_block_ksp);   CHKERRABORT(PETSC_COMM_SELF, ierr);
+    }
+    if (_block_mat) {
+        ierr = MatDestroy(&_block_mat);   CHKERRABORT(PETSC_COMM_SELF, ierr);
+    }
+    if (_block_res) {
+        ierr = VecDestroy(&_block_res);   CHKERRABORT(PETSC_COMM_SELF, ierr);
+    }
+    if (_block_sol) {
+        ierr = VecDestroy(&_block_sol);   CHKERRABORT(PETSC_COMM_SELF, ierr);
+    }
+    
+    _block_ksp          = nullptr;
+    _block_mat          = nullptr;
+    _block_res          = nullptr;
+    _block_sol          = nullptr;
+    _block_dof_map      = nullptr;
+    _block_n_dofs       = 0;
+    _n_block_assemblies = 0;
+}
+
+
+
+void
+MAST::ComplexSolverBase::_init_block_matrix_data() {
+    
+    libmesh_assert(_assembly);
+    
+    // get reference to the system
+    MAST::NonlinearSystem& sys =
+    dynamic_cast<MAST::NonlinearSystem&>(_assembly->system());
+    
     libMesh::DofMap& dof_map = sys.get_dof_map();
     
+    // the data is reused if it was created for the same dofs
+    if (_block_mat &&
+        _block_dof_map == &dof_map &&
+        _block_n_dofs  == dof_map.n_dofs())
+        return;
+    
+    this->clear_solver_data();
+    
     const PetscInt
     my_m = dof_map.n_dofs(),
     my_n = my_m,
@@ -412,45 +593,9 @@ MAST::ComplexSolverBase::solve_block_matrix(MAST::Parameter* p)  {
     ierr = MatCreateVecs(mat, &sol_vec, PETSC_NULL);               CHKERRABORT(sys.comm().get(), ierr);
     
     
-    std::unique_ptr<libMesh::SparseMatrix<Real> >
-    jac_mat(new libMesh::PetscMatrix<Real>(mat, sys.comm()));
-    
-    std::unique_ptr<libMesh::NumericVector<Real> >
-    res(new libMesh::PetscVector<Real>(res_vec, sys.comm())),
-    sol(new libMesh::PetscVector<Real>(sol_vec, sys.comm()));
-    
-    
-    // if sensitivity analysis is requested, then set the complex solution in
-    // the solution vector
-    if (p) {
-        
-        // copy the solution to separate real and imaginary vectors
-        libMesh::NumericVector<Real>
-        &sol_R = this->real_solution(),
-        &sol_I = this->imag_solution();
-        
-        unsigned int
-        first = sol_R.first_local_index(),
-        last  = sol_I.last_local_index();
-        
-        for (unsigned int i=first; i<last; i++) {
-            
-            sol->set(  2*i, sol_R(i));
-            sol->set(2*i+1, sol_I(i));
-        }
-        
-        sol->close();
-    }
-    
-    
-    // assemble the matrix
-    _assembly->residual_and_jacobian_blocked(*sol,
-                                             *res,
-                                             *jac_mat,
-                                             p);
-    res->scale(-1.);
-    
-    // now initialize the KSP and ask for solution.
+    // now initialize the KSP. The operators are set before the matrix is
+    // assembled. The PC is set up in the first solve after each assembly,
+    // unless it is lagged, and is reused for all right-hand sides.
     KSP        ksp;
     PC         pc;
     
@@ -470,39 +615,13 @@ MAST::ComplexSolverBase::solve_block_matrix(MAST::Parameter* p)  {
     ierr = KSPGetPC(ksp, &pc);                CHKERRABORT(sys.comm().get(), ierr);
     ierr = PCSetFromOptions(pc);              CHKERRABORT(sys.comm().get(), ierr);
     
-    
-    START_LOG("KSPSolve", "ComplexSolve");
-    
-    // now solve
-    ierr = KSPSolve(ksp, res_vec, sol_vec);
-
-    STOP_LOG("KSPSolve", "ComplexSolve");
-    
-    
-    // copy the solution to separate real and imaginary vectors
-    libMesh::NumericVector<Real>
-    &sol_R = this->real_solution(p != nullptr),
-    &sol_I = this->imag_solution(p != nullptr);
-    
-    unsigned int
-    first = sol_R.first_local_index(),
-    last  = sol_R.last_local_index();
-    
-    for (unsigned int i=first; i<last; i++) {
-        sol_R.set(i, (*sol)(  2*i));
-        sol_I.set(i, (*sol)(2*i+1));
-    }
-    
-    sol_R.close();
-    sol_I.close();
-    sol->close();
-    
-    ierr = KSPDestroy(&ksp);                  CHKERRABORT(sys.comm().get(), ierr);
-    ierr = MatDestroy(&mat);                  CHKERRABORT(sys.comm().get(), ierr);
-    ierr = VecDestroy(&res_vec);              CHKERRABORT(sys.comm().get(), ierr);
-    ierr = VecDestroy(&sol_vec);              CHKERRABORT(sys.comm().get(), ierr);
-    
-    STOP_LOG("solve_block_matrix()", "ComplexSolve");
+    _block_mat          = mat;
+    _block_res          = res_vec;
+    _block_sol          = sol_vec;
+    _block_ksp          = ksp;
+    _block_dof_map      = &dof_map;
+    _block_n_dofs       = dof_map.n_dofs();
+    _n_block_assemblies = 0;
 }
 
 
@@ -20,11 +20,18 @@
 #ifndef __mast__complex_solver_base_h__
 #define __mast__complex_solver_base_h__
 
+// C++ includes
+#include <functional>
+
 // MAST includes
 #include "base/mast_data_types.h"
 
 // libMesh includes
 #include "libmesh/numeric_vector.h"
+#include "libmesh/dof_map.h"
+
+// PETSc includes
+#include <petscksp.h>
 
 
 namespace MAST {
@@ -82,6 +89,26 @@ namespace MAST {
         virtual void solve_block_matrix(MAST::Parameter* p = nullptr);
 
         
+        /*!
+         *  solves the complex system of equations using block matrices for
+         *  \par n_rhs right-hand sides that share the same matrix. The matrix
+         *  is assembled and the KSP and PC are set up once, so that the
+         *  preconditioner, or factorization, is reused for all right-hand
+         *  sides. For the i^th right-hand side, \par init_rhs(i) is called to
+         *  set up the data that defines the residual before it is assembled,
+         *  and \par use_sol(i) is called after the solve, when the solution
+         *  is available from real_solution() and imag_solution(). If \par p
+         *  is specified, then the sensitivity of the system is solved for
+         *  each right-hand side.
+         */
+        virtual void
+        solve_block_matrix_multiple_rhs
+        (unsigned int n_rhs,
+         const std::function<void(unsigned int)>& init_rhs,
+         const std::function<void(unsigned int)>& use_sol,
+         MAST::Parameter* p = nullptr);
+
+        
         /*!
          *  @returns a reference to the real part of the solution. If 
          *  \par if_sens is true, the the sensitivity vector is returned. Note,
@@ -117,6 +144,26 @@ namespace MAST {
          */
         const libMesh::NumericVector<Real>& imag_solution(bool if_sens=false) const;
 
+        
+        /*!
+         *  the preconditioner of the block matrix solves is rebuilt for
+         *  every \par n^th assembly of the matrix, and is reused with the
+         *  updated matrix in between. This is useful when the matrix changes
+         *  by a small frequency shift. Values larger than 1 should only be
+         *  used with Krylov methods, since a direct solve with a lagged
+         *  factorization would solve the wrong system. The default is 1.
+         */
+        void set_preconditioner_lag(unsigned int n);
+        
+        
+        /*!
+         *  destroys the matrix, vectors and KSP that are retained between
+         *  the block matrix solves. This must be called if the mesh or the
+         *  dofs of the system change without a change in the number of dofs,
+         *  which is otherwise detected.
+         */
+        void clear_solver_data();
+        
 
         Real tol;
         
@@ -125,12 +172,46 @@ namespace MAST {
     protected:
         
         
+        /*!
+         *   creates the block matrix, vectors and KSP, if they do not exist
+         *   or if the system dofs have changed since they were created.
+         */
+        void _init_block_matrix_data();
+        
+        
         /*!
          *   Associated ComplexAssembly object that provides the
          *   element level quantities
          */
         MAST::ComplexAssemblyBase* _assembly;
         
+        
+        /*!
+         *   block matrix, residual and solution vectors and KSP of the
+         *   block matrix solves. These are created on the first solve and
+         *   reused by the subsequent solves. The matrix values are updated
+         *   in place, in the nonzero pattern from the first assembly.
+         */
+        Mat                          _block_mat;
+        Vec                          _block_res;
+        Vec                          _block_sol;
+        KSP                          _block_ksp;
+        
+        
+        /*!
+         *   dof map and number of dofs for which the block data was created
+         */
+        const libMesh::DofMap*       _block_dof_map;
+        libMesh::dof_id_type         _block_n_dofs;
+        
+        
+        /*!
+         *   number of matrix assemblies between rebuilds of the
+         *   preconditioner, and the number of assemblies since the
+         *   block data was created
+         */
+        unsigned int                 _pc_lag;
+        unsigned int                 _n_block_assemblies;
     };
 }
 
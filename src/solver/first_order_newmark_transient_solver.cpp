@@ -165,6 +165,23 @@ update_velocity(libMesh::NumericVector<Real>&       vec,
 
 
 
+void
+MAST::FirstOrderNewmarkTransientSolver::
+_local_error_estimate(libMesh::NumericVector<Real>& err) {
+    
+    const libMesh::NumericVector<Real>
+    &vel      = this->velocity(),
+    &prev_vel = this->velocity(1);
+    
+    err.zero();
+    err.add( 1.,      vel);
+    err.add(-1., prev_vel);
+    err.scale(beta*dt);
+    err.close();
+}
+
+
+
 void
 MAST::FirstOrderNewmarkTransientSolver::
 update_delta_velocity(libMesh::NumericVector<Real>&       vec,
@@ -260,6 +277,53 @@ elem_calculations(bool if_jac,
 
 
 
+void
+MAST::FirstOrderNewmarkTransientSolver::
+time_derivative_update_coefficients(RealMatrixX& c) const {
+    
+    // columns: x, x0, x0_dot
+    c.setZero(1, 3);
+    
+    // x_dot = (x-x0)/beta/dt - (1-beta)/beta x0_dot
+    c(0, 0) =  1./beta/dt;
+    c(0, 1) = -1./beta/dt;
+    c(0, 2) = -(1.-beta)/beta;
+}
+
+
+
+void
+MAST::FirstOrderNewmarkTransientSolver::
+elem_adjoint_time_derivative_products(const RealVectorX& lambda,
+                                      std::vector<RealVectorX>& vecs) {
+    
+    // make sure that the assembly object is provided
+    libmesh_assert(_assembly_ops);
+    unsigned int n_dofs = (unsigned int)lambda.size();
+    
+    RealVectorX
+    f_x     = RealVectorX::Zero(n_dofs),
+    f_m     = RealVectorX::Zero(n_dofs);
+    
+    RealMatrixX
+    f_m_jac_xdot  = RealMatrixX::Zero(n_dofs, n_dofs),
+    f_m_jac       = RealMatrixX::Zero(n_dofs, n_dofs),
+    f_x_jac       = RealMatrixX::Zero(n_dofs, n_dofs);
+    
+    // perform the element assembly
+    _assembly_ops->elem_calculations(true,
+                                     f_m,           // mass vector
+                                     f_x,           // forcing vector
+                                     f_m_jac_xdot,  // Jac of mass wrt x_dot
+                                     f_m_jac,       // Jac of mass wrt x
+                                     f_x_jac);      // Jac of forcing vector wrt x
+    
+    vecs.resize(1);
+    vecs[0] = f_m_jac_xdot.transpose() * lambda;
+}
+
+
+
 void
 MAST::FirstOrderNewmarkTransientSolver::
 elem_linearized_jacobian_solution_product(RealVectorX& vec) {
@@ -41,39 +41,21 @@ __mast_multiphysics_petsc_shell_context {
 };
 
 
+//---------------------------------------------------------------
+// computes the product of the (i,j) off-diagonal block of the Jacobian at
+// the solution x with the perturbation dx in the j^th discipline
 PetscErrorCode
-__mast_multiphysics_petsc_mat_mult(Mat mat,Vec dx,Vec y) {
-
-    LOG_SCOPE("mat_mult()", "PetscNonlinearSolver");
+__mast_multiphysics_coupling_product(MAST::MultiphysicsNonlinearSolverBase& solver,
+                                     unsigned int i_block,
+                                     unsigned int j_block,
+                                     Vec x,
+                                     Vec dx,
+                                     Vec y) {
     
     PetscErrorCode ierr=0;
     
-    libmesh_assert(mat);
-    libmesh_assert(dx);
-    libmesh_assert(y);
-    
-    
-    void * ctx = PETSC_NULL;
-    
-    // get the matrix context. This is for the i^th row-block and j^th column
-    // block, which uses the linear perturbation in the j^th block.
-    ierr = MatShellGetContext(mat, &ctx);
-    
-    __mast_multiphysics_petsc_shell_context
-    *mat_ctx = static_cast<__mast_multiphysics_petsc_shell_context*> (ctx);
-
-
-    MAST::MultiphysicsNonlinearSolverBase
-    *solver = mat_ctx->solver;
-    
-    // get the current nonlinear solution
-    Vec x;
-    
-    ierr = SNESGetSolution(mat_ctx->snes, &x);              CHKERRABORT(solver->comm().get(), ierr);
-
-    
     const unsigned int
-    nd = solver->n_disciplines();
+    nd = solver.n_disciplines();
     
     std::vector<Vec>
     sol (nd);
@@ -89,18 +71,18 @@ __mast_multiphysics_petsc_mat_mult(Mat mat,Vec dx,Vec y) {
     for (unsigned int i=0; i< nd; i++) {
         
         // system for this discipline
-        MAST::NonlinearSystem& sys = solver->get_system_assembly(i).system();
+        MAST::NonlinearSystem& sys = solver.get_system_assembly(i).system();
         
         // get the IS for this system
-        IS sys_is = solver->index_sets()[i];
+        IS sys_is = solver.index_sets()[i];
         
         // extract the subvector for this system
-        ierr = VecGetSubVector( x, sys_is,  &sol[i]);      CHKERRABORT(solver->comm().get(), ierr);
+        ierr = VecGetSubVector( x, sys_is,  &sol[i]);      CHKERRABORT(solver.comm().get(), ierr);
 
         // use the nonlinear sol of all disciplines, by the perturbed sol of only
         // one should be nonzero.
         sys_sols[i]   = new libMesh::PetscVector<Real>( sol[i], sys.comm());
-        if (i == mat_ctx->j) {
+        if (i == j_block) {
             sys_dsols[i]  = new libMesh::PetscVector<Real>(dx, sys.comm());
             
             // Enforce constraints (if any) exactly on the
@@ -111,29 +93,30 @@ __mast_multiphysics_petsc_mat_mult(Mat mat,Vec dx,Vec y) {
                                                           true /* homogeneous = true */);
         }
         else
-            sys_dsols[i]  = sys_sols[i]->zero_clone().release();
+            // the zero perturbations are reused between products
+            sys_dsols[i]  = &solver.zero_perturbation(i, *sys_sols[i]);
     }
     
     //////////////////////////////////////////////////////////////////
     // initialize the data structures before calculation of residuals
     //////////////////////////////////////////////////////////////////
-    if (solver->get_pre_residual_update_object())
-        solver->get_pre_residual_update_object()->update_at_perturbed_solution(sys_sols,
-                                                                               sys_dsols);
+    if (solver.get_pre_residual_update_object())
+        solver.get_pre_residual_update_object()->update_at_perturbed_solution(sys_sols,
+                                                                              sys_dsols);
     
     //////////////////////////////////////////////////////////////////
     // calculate the matrix-vector product
     //////////////////////////////////////////////////////////////////
     
     std::unique_ptr<libMesh::NumericVector<Real> >
-    res(new libMesh::PetscVector<Real>(y, solver->comm()));
+    res(new libMesh::PetscVector<Real>(y, solver.comm()));
     
     // system for this discipline
-    MAST::NonlinearSystem& sys = solver->get_system_assembly(mat_ctx->i).system();
+    MAST::NonlinearSystem& sys = solver.get_system_assembly(i_block).system();
 
-    solver->get_system_assembly(mat_ctx->i).linearized_jacobian_solution_product
-    (*sys_sols [mat_ctx->i],
-     *sys_dsols[mat_ctx->i],
+    solver.get_system_assembly(i_block).linearized_jacobian_solution_product
+    (*sys_sols [i_block],
+     *sys_dsols[i_block],
      *res,
      sys);
     
@@ -144,20 +127,68 @@ __mast_multiphysics_petsc_mat_mult(Mat mat,Vec dx,Vec y) {
     //////////////////////////////////////////////////////////////////
     for (unsigned int i=0; i< nd; i++) {
         
-        // system for this discipline
-        MAST::NonlinearSystem& sys = solver->get_system_assembly(i).system();
-        
         // get the IS for this system
-        IS sys_is = solver->index_sets()[i];
+        IS sys_is = solver.index_sets()[i];
         
         // delete the NumericVector wrappers
         delete sys_sols[i];
-        delete sys_dsols[i];
+        if (i == j_block)
+            delete sys_dsols[i];
         
         // now restore the subvectors
-        ierr = VecRestoreSubVector(x, sys_is, &sol[i]);  CHKERRABORT(solver->comm().get(), ierr);
+        ierr = VecRestoreSubVector(x, sys_is, &sol[i]);  CHKERRABORT(solver.comm().get(), ierr);
+    }
+    
+    return ierr;
+}
+
+
+
+PetscErrorCode
+__mast_multiphysics_petsc_mat_mult(Mat mat,Vec dx,Vec y) {
+
+    LOG_SCOPE("mat_mult()", "PetscNonlinearSolver");
+    
+    PetscErrorCode ierr=0;
+    
+    libmesh_assert(mat);
+    libmesh_assert(dx);
+    libmesh_assert(y);
+    
+    
+    void * ctx = PETSC_NULL;
+    
+    // get the matrix context. This is for the i^th row-block and j^th column
+    // block, which uses the linear perturbation in the j^th block.
+    ierr = MatShellGetContext(mat, &ctx);
+    CHKERRABORT(PetscObjectComm((PetscObject)mat), ierr);
+    
+    __mast_multiphysics_petsc_shell_context
+    *mat_ctx = static_cast<__mast_multiphysics_petsc_shell_context*> (ctx);
+
+
+    MAST::MultiphysicsNonlinearSolverBase
+    *solver = mat_ctx->solver;
+    
+    // the cached blocks are computed at the current Newton iterate
+    if (solver->if_cache_coupling_blocks(mat_ctx->j)) {
+        
+        solver->cached_coupling_block_product(mat_ctx->i, mat_ctx->j, dx, y);
+        return ierr;
     }
     
+    // get the current nonlinear solution
+    Vec x;
+    
+    ierr = SNESGetSolution(mat_ctx->snes, &x);              CHKERRABORT(solver->comm().get(), ierr);
+
+    ierr = __mast_multiphysics_coupling_product(*solver,
+                                                mat_ctx->i,
+                                                mat_ctx->j,
+                                                x,
+                                                dx,
+                                                y);
+    
     return ierr;
 }
 
@@ -376,6 +407,11 @@ __mast_multiphysics_petsc_snes_jacobian(SNES snes, Vec x, Mat jac, Mat pc, void
     }
 
     
+    // the coupling blocks are recomputed at each Newton iterate, and are
+    // used for all Krylov iterations of this iterate
+    if (solver->if_cache_coupling_blocks())
+        solver->update_coupling_blocks(x);
+    
     // call assembly of the global matrix
     ierr = MatAssemblyBegin(jac, MAT_FINAL_ASSEMBLY);  CHKERRABORT(solver->comm().get(), ierr);
     ierr = MatAssemblyEnd(jac, MAT_FINAL_ASSEMBLY);    CHKERRABORT(solver->comm().get(), ierr);
@@ -399,7 +435,12 @@ _update                       (nullptr),
 _discipline_assembly          (n, nullptr),
 _is                           (_n_disciplines, PETSC_NULL),
 _sub_mats                     (_n_disciplines*_n_disciplines, PETSC_NULL),
-_n_dofs                       (0) {
+_n_dofs                       (0),
+_pc_type                      (MAST::MultiphysicsNonlinearSolverBase::OPTIONS_PC),
+_if_cache_coupling            (false),
+_coupling_dofs                (_n_disciplines),
+_coupling_columns             (_n_disciplines*_n_disciplines),
+_zero_dsols                   (_n_disciplines, nullptr) {
     
 }
 
@@ -409,6 +450,189 @@ _n_dofs                       (0) {
 
 MAST::MultiphysicsNonlinearSolverBase::~MultiphysicsNonlinearSolverBase() {
     
+    this->_clear_coupling_blocks();
+}
+
+
+
+
+void
+MAST::MultiphysicsNonlinearSolverBase::
+set_coupling_dofs(unsigned int j,
+                  const std::vector<libMesh::dof_id_type>& dofs) {
+    
+    // make sure that the index is within bounds
+    libmesh_assert_less(j, _n_disciplines);
+    
+    // the cached blocks are computed with the same perturbations on all
+    // processors
+    libmesh_assert(this->comm().verify(dofs.size()));
+    libmesh_assert(this->comm().verify(dofs));
+    
+    _coupling_dofs[j] = dofs;
+}
+
+
+
+
+void
+MAST::MultiphysicsNonlinearSolverBase::update_coupling_blocks(Vec x) {
+    
+    LOG_SCOPE("update_coupling_blocks()", "PetscMultiphysicsNonlinearSolver");
+    
+    PetscErrorCode ierr=0;
+    
+    // remove the blocks from the previous iterate
+    for (unsigned int i=0; i<_coupling_columns.size(); i++) {
+        
+        for (unsigned int k=0; k<_coupling_columns[i].size(); k++) {
+            ierr = VecDestroy(&_coupling_columns[i][k]);
+            CHKERRABORT(this->comm().get(), ierr);
+        }
+        _coupling_columns[i].clear();
+    }
+    
+    for (unsigned int j=0; j<_n_disciplines; j++) {
+        
+        // the blocks of disciplines without coupling dofs use the
+        // matrix-free product
+        if (!this->if_cache_coupling_blocks(j))
+            continue;
+        
+        MAST::NonlinearSystem& sys_j = _discipline_assembly[j]->system();
+        
+        const libMesh::dof_id_type
+        first  = sys_j.get_dof_map().first_dof(),
+        end    = sys_j.get_dof_map().end_dof(),
+        n_dofs = _coupling_dofs[j].size();
+        
+        // unit perturbation in the j^th discipline
+        Vec dx;
+        ierr = VecCreateMPI(this->comm().get(),
+                            sys_j.n_local_dofs(),
+                            sys_j.n_dofs(),
+                            &dx);
+        CHKERRABORT(this->comm().get(), ierr);
+        
+        for (unsigned int k=0; k<n_dofs; k++) {
+            
+            const libMesh::dof_id_type
+            dof = _coupling_dofs[j][k];
+            
+            ierr = VecZeroEntries(dx);                CHKERRABORT(this->comm().get(), ierr);
+            if (dof >= first && dof < end) {
+                ierr = VecSetValue(dx, (PetscInt)dof, 1., INSERT_VALUES);
+                CHKERRABORT(this->comm().get(), ierr);
+            }
+            ierr = VecAssemblyBegin(dx);              CHKERRABORT(this->comm().get(), ierr);
+            ierr = VecAssemblyEnd(dx);                CHKERRABORT(this->comm().get(), ierr);
+            
+            for (unsigned int i=0; i<_n_disciplines; i++) {
+                
+                if (i == j)
+                    continue;
+                
+                MAST::NonlinearSystem& sys_i = _discipline_assembly[i]->system();
+                
+                Vec col;
+                ierr = VecCreateMPI(this->comm().get(),
+                                    sys_i.n_local_dofs(),
+                                    sys_i.n_dofs(),
+                                    &col);
+                CHKERRABORT(this->comm().get(), ierr);
+                
+                ierr = __mast_multiphysics_coupling_product(*this, i, j, x, dx, col);
+                CHKERRABORT(this->comm().get(), ierr);
+                
+                _coupling_columns[i*_n_disciplines+j].push_back(col);
+            }
+        }
+        
+        ierr = VecDestroy(&dx);                       CHKERRABORT(this->comm().get(), ierr);
+    }
+}
+
+
+
+
+void
+MAST::MultiphysicsNonlinearSolverBase::
+cached_coupling_block_product(unsigned int i,
+                              unsigned int j,
+                              Vec dx,
+                              Vec y) const {
+    
+    LOG_SCOPE("cached_coupling_block_product()", "PetscMultiphysicsNonlinearSolver");
+    
+    PetscErrorCode ierr=0;
+    
+    const std::vector<Vec>
+    &cols = _coupling_columns[i*_n_disciplines+j];
+    
+    // the blocks are only cached for disciplines with coupling dofs
+    libmesh_assert(this->if_cache_coupling_blocks(j));
+    
+    // the coupling dofs of the perturbation are needed on all processors
+    std::vector<libMesh::numeric_index_type>
+    dofs(_coupling_dofs[j].begin(), _coupling_dofs[j].end());
+    
+    // the block must have been computed for all coupling dofs
+    libmesh_assert_equal_to(cols.size(), dofs.size());
+    
+    std::vector<Real>
+    vals;
+    
+    {
+        libMesh::PetscVector<Real> v(dx, this->comm());
+        v.localize(vals, dofs);
+    }
+    
+    ierr = VecZeroEntries(y);                         CHKERRABORT(this->comm().get(), ierr);
+    if (cols.size()) {
+        ierr = VecMAXPY(y, (PetscInt)cols.size(), &vals[0], &cols[0]);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+}
+
+
+
+
+libMesh::NumericVector<Real>&
+MAST::MultiphysicsNonlinearSolverBase::
+zero_perturbation(unsigned int i,
+                  const libMesh::NumericVector<Real>& sol) {
+    
+    // make sure that the index is within bounds
+    libmesh_assert_less(i, _n_disciplines);
+    
+    if (!_zero_dsols[i])
+        _zero_dsols[i] = sol.zero_clone().release();
+    
+    return *_zero_dsols[i];
+}
+
+
+
+
+void
+MAST::MultiphysicsNonlinearSolverBase::_clear_coupling_blocks() {
+    
+    PetscErrorCode ierr=0;
+    
+    for (unsigned int i=0; i<_coupling_columns.size(); i++) {
+        
+        for (unsigned int k=0; k<_coupling_columns[i].size(); k++) {
+            ierr = VecDestroy(&_coupling_columns[i][k]);
+            CHKERRABORT(this->comm().get(), ierr);
+        }
+        _coupling_columns[i].clear();
+    }
+    
+    for (unsigned int i=0; i<_zero_dsols.size(); i++) {
+        
+        delete _zero_dsols[i];
+        _zero_dsols[i] = nullptr;
+    }
 }
 
 
@@ -455,6 +679,15 @@ MAST::MultiphysicsNonlinearSolverBase::solve() {
         p = ((_discipline_assembly[i] != nullptr) && p);
     libmesh_assert(p);
     
+    // probing all dofs of a discipline for its coupling blocks is too
+    // expensive, so these use the matrix-free product
+    if (_if_cache_coupling)
+        for (unsigned int j=0; j<_n_disciplines; j++)
+            if (!_coupling_dofs[j].size())
+                libMesh::out
+                << "Warning: no coupling dofs set for discipline " << j
+                << ", its coupling blocks are not cached." << std::endl;
+    
     
     //////////////////////////////////////////////////////////////////////
     // create the solver context. This will be partially initialized now
@@ -661,6 +894,40 @@ MAST::MultiphysicsNonlinearSolverBase::solve() {
     // setup the pc
     ierr = KSPGetPC(ksp, &pc);                        CHKERRABORT(this->comm().get(), ierr);
     
+    // the field split type is set before the index sets are provided
+    switch (_pc_type) {
+            
+        case MAST::MultiphysicsNonlinearSolverBase::BLOCK_GAUSS_SEIDEL_PC: {
+            
+            ierr = PCSetType(pc, PCFIELDSPLIT);       CHKERRABORT(this->comm().get(), ierr);
+            ierr = PCFieldSplitSetType(pc, PC_COMPOSITE_MULTIPLICATIVE);
+            CHKERRABORT(this->comm().get(), ierr);
+        }
+            break;
+            
+        case MAST::MultiphysicsNonlinearSolverBase::SCHUR_COMPLEMENT_PC: {
+            
+            // Schur complement field split is defined for two blocks
+            if (_n_disciplines != 2)
+                libmesh_error_msg("Schur complement preconditioner requires two disciplines, found "
+                                  << _n_disciplines);
+            
+            ierr = PCSetType(pc, PCFIELDSPLIT);       CHKERRABORT(this->comm().get(), ierr);
+            ierr = PCFieldSplitSetType(pc, PC_COMPOSITE_SCHUR);
+            CHKERRABORT(this->comm().get(), ierr);
+            ierr = PCFieldSplitSetSchurFactType(pc, PC_FIELDSPLIT_SCHUR_FACT_FULL);
+            CHKERRABORT(this->comm().get(), ierr);
+            // the off-diagonal blocks are shell matrices, so the Schur
+            // complement is preconditioned with the second diagonal block
+            ierr = PCFieldSplitSetSchurPre(pc, PC_FIELDSPLIT_SCHUR_PRE_A11, PETSC_NULL);
+            CHKERRABORT(this->comm().get(), ierr);
+        }
+            break;
+            
+        default:
+            break;
+    }
+    
     for (unsigned int i=0; i<_n_disciplines; i++) {
         
         if (sys_name) {
@@ -672,6 +939,11 @@ MAST::MultiphysicsNonlinearSolverBase::solve() {
             ierr = PCFieldSplitSetIS(pc, nullptr, _is[i]);CHKERRABORT(this->comm().get(), ierr);
     }
     
+    // command line options take precedence over the selected preconditioner
+    if (_pc_type != MAST::MultiphysicsNonlinearSolverBase::OPTIONS_PC) {
+        ierr = PCSetFromOptions(pc);                  CHKERRABORT(this->comm().get(), ierr);
+    }
+    
 
     //ierr = SNESSetSolution(snes, _sol);
     //this->verify_gateaux_derivatives(snes);
@@ -740,6 +1012,7 @@ MAST::MultiphysicsNonlinearSolverBase::solve() {
     ierr = VecDestroy(&_sol);                          CHKERRABORT(this->comm().get(), ierr);
     ierr = VecDestroy(&_res);                          CHKERRABORT(this->comm().get(), ierr);
     
+    this->_clear_coupling_blocks();
 }
 
 
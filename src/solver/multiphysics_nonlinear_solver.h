@@ -120,6 +120,112 @@ namespace MAST {
          */
         void solve();
         
+        
+        /*!
+         *   preconditioner built from the discipline blocks of the nested
+         *   matrix. \p OPTIONS_PC leaves the choice to the command line
+         *   options. \p BLOCK_GAUSS_SEIDEL_PC uses a multiplicative field
+         *   split, and \p SCHUR_COMPLEMENT_PC uses a Schur complement
+         *   field split for two disciplines with the second discipline
+         *   matrix as preconditioner of the Schur complement. The command
+         *   line options are applied after the selected preconditioner,
+         *   and can be used to set the solvers for each block.
+         */
+        enum BlockPreconditionerType {
+            OPTIONS_PC,
+            BLOCK_GAUSS_SEIDEL_PC,
+            SCHUR_COMPLEMENT_PC
+        };
+        
+        
+        /*!
+         *   sets the preconditioner used for the coupled system
+         */
+        void
+        set_block_preconditioner(MAST::MultiphysicsNonlinearSolverBase::BlockPreconditionerType t) {
+            
+            _pc_type = t;
+        }
+        
+        
+        /*!
+         *   If \p flag is true, the off-diagonal coupling blocks are
+         *   computed once at each Newton iterate and reused for all
+         *   Krylov iterations of the iterate, instead of evaluating the
+         *   linearized coupling for each matrix-vector product. Each block
+         *   \f$ (i,j) \f$ is stored as its columns for the coupling dofs
+         *   of discipline \f$ j \f$, which requires one coupling product
+         *   per coupling dof at each Newton iterate. Only the blocks of
+         *   disciplines with coupling dofs set by set_coupling_dofs() are
+         *   cached. The other blocks use the matrix-free product.
+         */
+        void set_cache_coupling_blocks(bool flag) {
+            
+            _if_cache_coupling = flag;
+        }
+        
+        
+        /*!
+         *   @returns true if the coupling blocks are cached
+         */
+        bool if_cache_coupling_blocks() const {
+            
+            return _if_cache_coupling;
+        }
+        
+        
+        /*!
+         *   @returns true if the coupling blocks \f$ (i,j) \f$ of
+         *   discipline \p j are cached
+         */
+        bool if_cache_coupling_blocks(unsigned int j) const {
+            
+            return _if_cache_coupling && _coupling_dofs[j].size();
+        }
+        
+        
+        /*!
+         *   sets the dofs of discipline \p j that influence the residual
+         *   of other disciplines, for example the dofs on the interface of
+         *   a fluid-structure interaction problem. The cached coupling
+         *   blocks are then low-rank operators that act only on these dofs.
+         *   The blocks of a discipline without coupling dofs are not cached.
+         *   \p dofs are global dof ids, and must be the same on all
+         *   processors.
+         */
+        void
+        set_coupling_dofs(unsigned int j,
+                          const std::vector<libMesh::dof_id_type>& dofs);
+        
+        
+        /*!
+         *   computes and stores the off-diagonal coupling blocks at
+         *   solution \p x.
+         */
+        void update_coupling_blocks(Vec x);
+        
+        
+        /*!
+         *   computes \p y as the product of the cached (\p i, \p j)
+         *   coupling block with \p dx.
+         */
+        void cached_coupling_block_product(unsigned int i,
+                                           unsigned int j,
+                                           Vec dx,
+                                           Vec y) const;
+        
+        
+        /*!
+         *   @returns a zero vector for discipline \p i with the same
+         *   layout as \p sol, which is used as the perturbation of
+         *   the disciplines that are not perturbed in a coupling product.
+         *   The vector is created at the first call, and kept until the
+         *   end of solve().
+         */
+        libMesh::NumericVector<Real>&
+        zero_perturbation(unsigned int i,
+                          const libMesh::NumericVector<Real>& sol);
+        
 
         /*!
          *    This class provides the interface that, if provided, will 
@@ -209,6 +315,40 @@ namespace MAST {
         Mat              _mat;
         Vec              _sol, _res;
 
+        
+        /*!
+         *   deletes the cached coupling blocks and zero perturbations
+         */
+        void _clear_coupling_blocks();
+        
+        /*!
+         *   preconditioner for the coupled system
+         */
+        MAST::MultiphysicsNonlinearSolverBase::BlockPreconditionerType _pc_type;
+        
+        /*!
+         *   flag to cache the off-diagonal coupling blocks
+         */
+        bool             _if_cache_coupling;
+        
+        /*!
+         *   coupling dofs for each discipline, which are the same on all
+         *   processors. The blocks of a discipline with an empty vector
+         *   are not cached.
+         */
+        std::vector<std::vector<libMesh::dof_id_type> > _coupling_dofs;
+        
+        /*!
+         *   columns of the cached coupling blocks for the coupling dofs,
+         *   in row-major ordering of the blocks
+         */
+        std::vector<std::vector<Vec> > _coupling_columns;
+        
+        /*!
+         *   zero perturbation vectors for each discipline
+         */
+        std::vector<libMesh::NumericVector<Real>*> _zero_dsols;
+
     };
 }
 
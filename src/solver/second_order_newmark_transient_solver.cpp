@@ -200,6 +200,23 @@ update_acceleration(libMesh::NumericVector<Real>& vec,
 
 
 
+void
+MAST::SecondOrderNewmarkTransientSolver::
+_local_error_estimate(libMesh::NumericVector<Real>& err) {
+    
+    const libMesh::NumericVector<Real>
+    &acc      = this->acceleration(),
+    &prev_acc = this->acceleration(1);
+    
+    err.zero();
+    err.add( 1.,      acc);
+    err.add(-1., prev_acc);
+    err.scale((beta-1./6.)*dt*dt);
+    err.close();
+}
+
+
+
 void
 MAST::SecondOrderNewmarkTransientSolver::
 update_delta_velocity(libMesh::NumericVector<Real>& vec,
@@ -333,6 +350,65 @@ elem_calculations(bool if_jac,
 
 
 
+void
+MAST::SecondOrderNewmarkTransientSolver::
+time_derivative_update_coefficients(RealMatrixX& c) const {
+    
+    // columns: x, x0, x0_dot, x0_ddot
+    c.setZero(2, 4);
+    
+    // x_dot  = gamma/beta/dt (x-x0) + (1 - gamma/beta) x0_dot + (1 - gamma/2/beta) dt x0_ddot
+    c(0, 0) =  gamma/beta/dt;
+    c(0, 1) = -gamma/beta/dt;
+    c(0, 2) =  1.-gamma/beta;
+    c(0, 3) = (1.-gamma/2./beta)*dt;
+    
+    // x_ddot = (x-x0)/beta/dt^2 - 1/beta/dt x0_dot - (1/2-beta)/beta x0_ddot
+    c(1, 0) =  1./beta/dt/dt;
+    c(1, 1) = -1./beta/dt/dt;
+    c(1, 2) = -1./beta/dt;
+    c(1, 3) = -(.5-beta)/beta;
+}
+
+
+
+void
+MAST::SecondOrderNewmarkTransientSolver::
+elem_adjoint_time_derivative_products(const RealVectorX& lambda,
+                                      std::vector<RealVectorX>& vecs) {
+    
+    // make sure that the assembly object is provided
+    libmesh_assert(_assembly_ops);
+    unsigned int n_dofs = (unsigned int)lambda.size();
+    
+    RealVectorX
+    f_x     = RealVectorX::Zero(n_dofs),
+    f_m     = RealVectorX::Zero(n_dofs);
+    
+    RealMatrixX
+    f_m_jac_xddot    = RealMatrixX::Zero(n_dofs, n_dofs),
+    f_m_jac_xdot     = RealMatrixX::Zero(n_dofs, n_dofs),
+    f_m_jac          = RealMatrixX::Zero(n_dofs, n_dofs),
+    f_x_jac_xdot     = RealMatrixX::Zero(n_dofs, n_dofs),
+    f_x_jac          = RealMatrixX::Zero(n_dofs, n_dofs);
+    
+    // perform the element assembly
+    _assembly_ops->elem_calculations(true,
+                                     f_m,           // mass vector
+                                     f_x,           // forcing vector
+                                     f_m_jac_xddot, // Jac of mass wrt x_dotdot
+                                     f_m_jac_xdot,  // Jac of mass wrt x_dot
+                                     f_m_jac,       // Jac of mass wrt x
+                                     f_x_jac_xdot,  // Jac of forcing vector wrt x_dot
+                                     f_x_jac);      // Jac of forcing vector wrt x
+    
+    vecs.resize(2);
+    vecs[0] = (f_m_jac_xdot + f_x_jac_xdot).transpose() * lambda;
+    vecs[1] = f_m_jac_xddot.transpose() * lambda;
+}
+
+
+
 void
 MAST::SecondOrderNewmarkTransientSolver::
 elem_linearized_jacobian_solution_product(RealVectorX& vec) {
@@ -157,9 +157,41 @@ namespace MAST {
         elem_second_derivative_dot_solution_assembly(RealMatrixX& mat) {
             libmesh_assert(false); // to be implemented
         }
+        
+        /*!
+         *   computes the coefficients of the Newmark update of time
+         *   derivatives. See TransientSolverBase for the layout of \p c.
+         */
+        virtual void
+        time_derivative_update_coefficients(RealMatrixX& c) const;
+        
+        /*!
+         *   computes the product of \p lambda with the transpose of the
+         *   element Jacobians with respect to the time derivatives.
+         */
+        virtual void
+        elem_adjoint_time_derivative_products(const RealVectorX& lambda,
+                                              std::vector<RealVectorX>& vecs);
 
     protected:
         
+        /*!
+         *    computes the local error estimate of Zienkiewicz and Xie,
+         *    \f$ e = (\beta - 1/6) dt^2 (\ddot{x}_{n+1} - \ddot{x}_n) \f$,
+         *    which is the difference between the Newmark update and the
+         *    update with a linear variation of acceleration over the step.
+         */
+        virtual void
+        _local_error_estimate(libMesh::NumericVector<Real>& err);
+        
+        /*!
+         *    @returns 3, since the local error estimate is
+         *    \f$ O(dt^3) \f$
+         */
+        virtual unsigned int _local_error_order() const {
+            return 3;
+        }
+        
     };
     
 }
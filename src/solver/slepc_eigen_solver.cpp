@@ -103,3 +103,27 @@ MAST::SlepcEigenSolver::get_eigenpair(unsigned int i,
     return std::make_pair(re, im);
 }
 
+
+
+
+void
+MAST::SlepcEigenSolver::
+set_initial_space (const std::vector<libMesh::NumericVector<Real>*>& vecs) {
+    
+    // make sure that the EPS object is created
+    this->init();
+    
+    PetscErrorCode ierr=0;
+    
+    std::vector<Vec> v(vecs.size());
+    
+    for (unsigned int i=0; i<vecs.size(); i++) {
+        
+        vecs[i]->close();
+        v[i] = libMesh::cast_ptr<libMesh::PetscVector<Real>*>(vecs[i])->vec();
+    }
+    
+    ierr = EPSSetInitialSpace(eps(), (PetscInt)v.size(), v.size()?&v[0]:PETSC_NULL);
+    
+    CHKERRABORT(this->comm().get(), ierr);
+}
@@ -61,6 +61,16 @@ namespace MAST {
         get_eigenpair (unsigned int i,
                        libMesh::NumericVector<Real> &eig_vec,
                        libMesh::NumericVector<Real> *eig_vec_im = libmesh_nullptr);
+        
+        
+        /**
+         * Provides the vectors \p vecs to SLEPc as the initial space for
+         * the next solve. SLEPc uses the space to build the starting
+         * vectors of the iteration, which accelerates convergence if the
+         * vectors are close to the sought eigenvectors.
+         */
+        void
+        set_initial_space (const std::vector<libMesh::NumericVector<Real>*>& vecs);
 
 
     };
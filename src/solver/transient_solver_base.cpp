@@ -17,6 +17,10 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+// C++ includes
+#include <cmath>
+#include <algorithm>
+
 // MAST includes
 #include "solver/transient_solver_base.h"
 #include "base/transient_assembly_elem_operations.h"
@@ -24,6 +28,7 @@
 #include "base/transient_assembly.h"
 #include "base/nonlinear_system.h"
 #include "base/system_initialization.h"
+#include "base/performance_counters.h"
 
 // libMesh includes
 #include "libmesh/numeric_vector.h"
@@ -42,7 +47,25 @@ _first_sensitivity_step         (true),
 _ode_order                      (o),
 _n_iters_to_store               (n),
 _assembly_ops                   (nullptr),
-_if_highest_derivative_solution (false) {
+_if_highest_derivative_solution (false),
+_history_offset                 (0),
+_solution_history_offset        (0),
+_sensitivity_history_offset     (0),
+_jacobian_dt                    (0.),
+_if_adaptive_dt                 (false),
+_adaptive_rtol                  (1.e-4),
+_adaptive_atol                  (1.e-8),
+_dt_min                         (0.),
+_dt_max                         (1.e12),
+_controller_k_I                 (0.7),
+_controller_k_P                 (0.4),
+_controller_safety              (0.9),
+_controller_fac_min             (0.2),
+_controller_fac_max             (5.),
+_max_step_rejections            (20),
+_error_estimate                 (0.),
+_error_prev                     (1.),
+_n_rejected_steps               (0) {
 
 }
 
@@ -135,6 +158,9 @@ set_elem_operation_object(MAST::TransientAssemblyElemOperations &assembly_ops) {
         }
     }
     
+    _history_offset             = 0;
+    _solution_history_offset    = 0;
+    _sensitivity_history_offset = 0;
     _first_step = true;
 }
 
@@ -185,6 +211,11 @@ MAST::TransientSolverBase::clear_elem_operation_object() {
         }
     }
     
+    _history_offset             = 0;
+    _solution_history_offset    = 0;
+    _sensitivity_history_offset = 0;
+    _scratch.reset();
+    
     _assembly_ops   = nullptr;
     _first_step     = true;
 }
@@ -198,17 +229,12 @@ MAST::TransientSolverBase::solution(unsigned int prev_iter) const {
     // make sura that prev_iter is within acceptable bounds
     libmesh_assert_less(prev_iter, _n_iters_to_store);
     
-    // make sure that the vectors have been initialized
-    std::ostringstream oss;
-    oss << prev_iter;
-    
-    if (prev_iter) {
-        // get references to the solution
-        std::string
-        nm = "transient_solution_" + oss.str();
-
-        return _system->system().get_vector(nm);
-    }
+    // the current solution is obtained from system->solution, and the
+    // previous solutions are stored in a ring of _n_iters_to_store-1 vectors
+    if (prev_iter)
+        return _history_vector("transient_solution_",
+                               1 + (prev_iter - 1 + _solution_history_offset) %
+                               (_n_iters_to_store - 1));
     else
         return *_system->system().solution;
 }
@@ -221,14 +247,8 @@ MAST::TransientSolverBase::solution_sensitivity(unsigned int prev_iter) const {
     // make sura that prev_iter is within acceptable bounds
     libmesh_assert_less(prev_iter, _n_iters_to_store);
     
-    // make sure that the vectors have been initialized
-    std::ostringstream oss;
-    oss << prev_iter;
-    
-    std::string
-    nm = "transient_solution_sensitivity_" + oss.str();
-    
-    return _system->system().get_vector(nm);
+    return _history_vector("transient_solution_sensitivity_",
+                           (prev_iter + _sensitivity_history_offset) % _n_iters_to_store);
 }
 
 
@@ -239,15 +259,8 @@ MAST::TransientSolverBase::velocity(unsigned int prev_iter) const {
     // make sura that prev_iter is within acceptable bounds
     libmesh_assert_less(prev_iter, _n_iters_to_store);
     
-    // make sure that the vectors have been initialized
-    std::ostringstream oss;
-    oss << prev_iter;
-    
-    // get references to the solution
-    std::string
-    nm = "transient_velocity_" + oss.str();
-    
-    return _system->system().get_vector(nm);
+    return _history_vector("transient_velocity_",
+                           (prev_iter + _history_offset) % _n_iters_to_store);
 }
 
 
@@ -258,15 +271,8 @@ MAST::TransientSolverBase::velocity_sensitivity(unsigned int prev_iter) const {
     // make sura that prev_iter is within acceptable bounds
     libmesh_assert_less(prev_iter, _n_iters_to_store);
     
-    // make sure that the vectors have been initialized
-    std::ostringstream oss;
-    oss << prev_iter;
-    
-    // get references to the solution
-    std::string
-    nm = "transient_velocity_sensitivity_" + oss.str();
-    
-    return _system->system().get_vector(nm);
+    return _history_vector("transient_velocity_sensitivity_",
+                           (prev_iter + _sensitivity_history_offset) % _n_iters_to_store);
 }
 
 
@@ -278,15 +284,8 @@ MAST::TransientSolverBase::acceleration(unsigned int prev_iter) const {
     // make sura that prev_iter is within acceptable bounds
     libmesh_assert_less(prev_iter, _n_iters_to_store);
     
-    // make sure that the vectors have been initialized
-    std::ostringstream oss;
-    oss << prev_iter;
-    
-    // get references to the solution
-    std::string
-    nm = "transient_acceleration_" + oss.str();
-    
-    return _system->system().get_vector(nm);
+    return _history_vector("transient_acceleration_",
+                           (prev_iter + _history_offset) % _n_iters_to_store);
 }
 
 
@@ -297,15 +296,74 @@ MAST::TransientSolverBase::acceleration_sensitivity(unsigned int prev_iter) cons
     // make sura that prev_iter is within acceptable bounds
     libmesh_assert_less(prev_iter, _n_iters_to_store);
     
-    // make sure that the vectors have been initialized
+    return _history_vector("transient_acceleration_sensitivity_",
+                           (prev_iter + _sensitivity_history_offset) % _n_iters_to_store);
+}
+
+
+
+libMesh::NumericVector<Real>&
+MAST::TransientSolverBase::_history_vector(const std::string& prefix,
+                                           unsigned int i) const {
+    
     std::ostringstream oss;
-    oss << prev_iter;
+    oss << prefix << i;
+    
+    return _system->system().get_vector(oss.str());
+}
+
+
+
+void
+MAST::TransientSolverBase::_advance_history() {
+    
+    libmesh_assert_greater(_n_iters_to_store, 1);
+    
+    // the vectors are rotated by one position so that the vector of the
+    // oldest iteration is reused for the current iteration. The current
+    // solution is copied to the previous iteration, and the velocity and
+    // acceleration of the current iteration are initialized to the values
+    // from the previous iteration.
+    _history_offset          =
+    (_history_offset + _n_iters_to_store - 1) % _n_iters_to_store;
+    _solution_history_offset =
+    (_solution_history_offset + _n_iters_to_store - 2) % (_n_iters_to_store - 1);
+    
+    this->solution(1)  = this->solution();
+    this->velocity()   = this->velocity(1);
+    
+    if (_ode_order > 1)
+        this->acceleration() = this->acceleration(1);
+}
+
+
+
+void
+MAST::TransientSolverBase::_advance_sensitivity_history() {
+    
+    _sensitivity_history_offset =
+    (_sensitivity_history_offset + _n_iters_to_store - 1) % _n_iters_to_store;
+    
+    this->solution_sensitivity()  = this->solution_sensitivity(1);
+    this->velocity_sensitivity()  = this->velocity_sensitivity(1);
+    
+    if (_ode_order > 1)
+        this->acceleration_sensitivity() = this->acceleration_sensitivity(1);
+}
+
+
+
+libMesh::NumericVector<Real>&
+MAST::TransientSolverBase::_scratch_vector() {
+    
+    const libMesh::NumericVector<Real>&
+    sol = this->solution();
     
-    // get references to the solution
-    std::string
-    nm = "transient_acceleration_sensitivity_" + oss.str();
+    if (!_scratch || _scratch->size() != sol.size() ||
+        _scratch->local_size() != sol.local_size())
+        _scratch.reset(sol.zero_clone().release());
     
-    return _system->system().get_vector(nm);
+    return *_scratch;
 }
 
 
@@ -313,11 +371,24 @@ MAST::TransientSolverBase::acceleration_sensitivity(unsigned int prev_iter) cons
 void
 MAST::TransientSolverBase::solve(MAST::AssemblyBase& assembly) {
     
+    MAST::PerformanceScope perf("TransientSolverBase::solve");
+    
     // make sure that the system has been specified
     libmesh_assert_msg(_system, "System pointer is nullptr.");
     
+    MAST::NonlinearSystem
+    &sys = _system->system();
+    
+    // the effective Jacobian depends on the time step, so a lagged
+    // Jacobian is updated if the time step has changed
+    if (sys.if_lagged_jacobian() && dt != _jacobian_dt) {
+        
+        sys.reset_lagged_jacobian();
+        _jacobian_dt = dt;
+    }
+    
     // ask the Newton solver to solve for the system solution
-    _system->system().solve(*this, assembly);
+    sys.solve(*this, assembly);
     
 }
 
@@ -327,6 +398,8 @@ void
 MAST::TransientSolverBase::sensitivity_solve(MAST::AssemblyBase& assembly,
                                              const MAST::FunctionBase& f) {
     
+    MAST::PerformanceScope perf("TransientSolverBase::sensitivity_solve");
+    
     // make sure that the system has been specified
     libmesh_assert_msg(_system, "System pointer is nullptr.");
     
@@ -340,6 +413,8 @@ void
 MAST::TransientSolverBase::
 solve_highest_derivative_and_advance_time_step(MAST::AssemblyBase& assembly) {
     
+    MAST::PerformanceScope perf("TransientSolverBase::solve_highest_derivative_and_advance_time_step");
+    
     libmesh_assert(_first_step);
     libmesh_assert(_system);
     libmesh_assert(_discipline);
@@ -367,8 +442,9 @@ solve_highest_derivative_and_advance_time_step(MAST::AssemblyBase& assembly) {
     libMesh::SparseMatrix<Real> *
     pc = sys.request_matrix("Preconditioner");
     
-    std::unique_ptr<libMesh::NumericVector<Real> >
-    dvec(velocity().zero_clone().release());
+    libMesh::NumericVector<Real>
+    *dvec = &this->_scratch_vector();
+    dvec->zero();
 
     sys.linear_solver->solve (*sys.matrix, pc,
                               *dvec,
@@ -395,6 +471,10 @@ solve_highest_derivative_and_advance_time_step(MAST::AssemblyBase& assembly) {
     
     vec->add(-1., *dvec);
     
+    // the system matrix was used for the highest derivative, and
+    // cannot be reused as the Jacobian of the time step
+    sys.reset_lagged_jacobian();
+    
     // The linear solver may not have fit our constraints exactly
 #ifdef LIBMESH_ENABLE_CONSTRAINTS
     sys.get_dof_map().enforce_constraints_exactly(sys, vec, /* homogeneous = */ true);
@@ -402,22 +482,7 @@ solve_highest_derivative_and_advance_time_step(MAST::AssemblyBase& assembly) {
     
     // next, move all the solutions and velocities into older
     // time step locations
-    for (unsigned int i=_n_iters_to_store-1; i>0; i--) {
-        this->solution(i).zero();
-        this->solution(i).add(1., this->solution(i-1));
-        this->solution(i).close();
-        
-        this->velocity(i).zero();
-        this->velocity(i).add(1., this->velocity(i-1));
-        this->velocity(i).close();
-        
-        if (_ode_order > 1) {
-            
-            this->acceleration(i).zero();
-            this->acceleration(i).add(1., this->acceleration(i-1));
-            this->acceleration(i).close();
-        }
-    }
+    this->_advance_history();
     
     // finally, update the system time
     sys.time          += dt;
@@ -432,6 +497,8 @@ MAST::TransientSolverBase::
 solve_highest_derivative_and_advance_time_step_with_sensitivity(MAST::AssemblyBase& assembly,
                                                                 const MAST::FunctionBase& f) {
     
+    MAST::PerformanceScope perf("TransientSolverBase::solve_highest_derivative_and_advance_time_step_with_sensitivity");
+    
     libmesh_assert(_first_sensitivity_step);
     libmesh_assert(_system);
     libmesh_assert(_discipline);
@@ -461,8 +528,9 @@ solve_highest_derivative_and_advance_time_step_with_sensitivity(MAST::AssemblyBa
     libMesh::SparseMatrix<Real> *
     pc = sys.request_matrix("Preconditioner");
     
-    std::unique_ptr<libMesh::NumericVector<Real> >
-    dvec(velocity().zero_clone().release());
+    libMesh::NumericVector<Real>
+    *dvec = &this->_scratch_vector();
+    dvec->zero();
     
     sys.linear_solver->solve (*sys.matrix, pc,
                               *dvec,
@@ -489,6 +557,10 @@ solve_highest_derivative_and_advance_time_step_with_sensitivity(MAST::AssemblyBa
     
     vec->add(-1., *dvec);
     
+    // the system matrix was used for the highest derivative, and
+    // cannot be reused as the Jacobian of the time step
+    sys.reset_lagged_jacobian();
+    
     // The linear solver may not have fit our constraints exactly
 #ifdef LIBMESH_ENABLE_CONSTRAINTS
     sys.get_dof_map().enforce_constraints_exactly(sys, vec, /* homogeneous = */ true);
@@ -496,23 +568,7 @@ solve_highest_derivative_and_advance_time_step_with_sensitivity(MAST::AssemblyBa
     
     // next, move all the solutions and velocities into older
     // time step locations
-    for (unsigned int i=_n_iters_to_store-1; i>0; i--) {
-        
-        this->solution_sensitivity(i).zero();
-        this->solution_sensitivity(i).add(1., this->solution_sensitivity(i-1));
-        this->solution_sensitivity(i).close();
-        
-        this->velocity_sensitivity(i).zero();
-        this->velocity_sensitivity(i).add(1., this->velocity_sensitivity(i-1));
-        this->velocity_sensitivity(i).close();
-        
-        if (_ode_order > 1) {
-            
-            this->acceleration_sensitivity(i).zero();
-            this->acceleration_sensitivity(i).add(1., this->acceleration_sensitivity(i-1));
-            this->acceleration_sensitivity(i).close();
-        }
-    }
+    this->_advance_sensitivity_history();
     
     // finally, update the system time
     _first_sensitivity_step        = false;
@@ -622,8 +678,8 @@ build_perturbed_local_quantities(const libMesh::NumericVector<Real>& current_dso
     send_list = sys.get_dof_map().get_send_list();
     
     
-    std::unique_ptr<libMesh::NumericVector<Real> >
-    tmp(this->solution().zero_clone().release());
+    libMesh::NumericVector<Real>
+    *tmp = &this->_scratch_vector();
     
     for ( unsigned int i=0; i<=_ode_order; i++) {
         
@@ -685,6 +741,87 @@ build_perturbed_local_quantities(const libMesh::NumericVector<Real>& current_dso
 
 
 
+void
+MAST::TransientSolverBase::
+highest_derivative_adjoint_solve(MAST::AssemblyBase& assembly,
+                                 libMesh::NumericVector<Real>& rhs,
+                                 libMesh::NumericVector<Real>& lambda,
+                                 const std::vector<const MAST::FunctionBase*>& p,
+                                 std::vector<Real>& dq_dp) {
+    
+    MAST::PerformanceScope perf("TransientSolverBase::highest_derivative_adjoint_solve");
+    
+    libmesh_assert(_system);
+    libmesh_assert(_discipline);
+    libmesh_assert(!_assembly);
+    libmesh_assert_equal_to(p.size(), dq_dp.size());
+    
+    MAST::NonlinearSystem
+    &sys = _system->system();
+    
+    // the Jacobian and the residual sensitivity are evaluated for the
+    // highest derivative, so that the solution and its lower derivatives
+    // are used from the current time step
+    _if_highest_derivative_solution = true;
+    
+    assembly.set_elem_operation_object(*this);
+    assembly.residual_and_jacobian(*sys.solution, nullptr, sys.matrix, sys);
+    assembly.clear_elem_operation_object();
+    
+    std::pair<unsigned int, Real>
+    solver_params = sys.get_linear_solve_parameters();
+    
+    sys.linear_solver->adjoint_solve(*sys.matrix,
+                                     lambda,
+                                     rhs,
+                                     solver_params.second,
+                                     solver_params.first);
+    
+    // The linear solver may not have fit our constraints exactly
+#ifdef LIBMESH_ENABLE_CONSTRAINTS
+    sys.get_dof_map().enforce_adjoint_constraints_exactly(lambda, 0);
+#endif
+    
+    libMesh::NumericVector<Real>
+    &dres_dp = this->_scratch_vector();
+    
+    for (unsigned int i=0; i<p.size(); i++) {
+        
+        assembly.set_elem_operation_object(*this);
+        assembly.sensitivity_assemble(*p[i], dres_dp);
+        assembly.clear_elem_operation_object();
+        
+        dq_dp[i] += lambda.dot(dres_dp);
+    }
+    
+    _if_highest_derivative_solution = false;
+    
+    // the system matrix was used for the highest derivative, and
+    // cannot be reused as the Jacobian of the time step
+    sys.reset_lagged_jacobian();
+}
+
+
+
+void
+MAST::TransientSolverBase::
+time_derivative_update_coefficients(RealMatrixX& c) const {
+    
+    libmesh_error_msg("Time derivative update not implemented for this solver.");
+}
+
+
+
+void
+MAST::TransientSolverBase::
+elem_adjoint_time_derivative_products(const RealVectorX& lambda,
+                                      std::vector<RealVectorX>& vecs) {
+    
+    libmesh_error_msg("Adjoint products not implemented for this solver.");
+}
+
+
+
 void
 MAST::TransientSolverBase::advance_time_step() {
 
@@ -702,22 +839,7 @@ MAST::TransientSolverBase::advance_time_step() {
 
     // next, move all the solutions and velocities into older
     // time step locations
-    for (unsigned int i=_n_iters_to_store-1; i>0; i--) {
-        this->solution(i).zero();
-        this->solution(i).add(1., this->solution(i-1));
-        this->solution(i).close();
-        
-        this->velocity(i).zero();
-        this->velocity(i).add(1., this->velocity(i-1));
-        this->velocity(i).close();
-        
-        if (_ode_order > 1) {
-            
-            this->acceleration(i).zero();
-            this->acceleration(i).add(1., this->acceleration(i-1));
-            this->acceleration(i).close();
-        }
-    }
+    this->_advance_history();
 
     // finally, update the system time
     sys.time          += dt;
@@ -737,31 +859,198 @@ MAST::TransientSolverBase::advance_time_step_with_sensitivity() {
     
     // next, move all the solutions and velocities into older
     // time step locations
-    for (unsigned int i=_n_iters_to_store-1; i>0; i--) {
-        this->solution_sensitivity(i).zero();
-        this->solution_sensitivity(i).add(1., this->solution_sensitivity(i-1));
-        this->solution_sensitivity(i).close();
+    this->_advance_sensitivity_history();
+    
+    // finally, update the system time
+    _first_sensitivity_step   = false;
+
+    this->advance_time_step();
+}
+
+
+
+
+void
+MAST::TransientSolverBase::set_adaptive_time_stepping(bool flag,
+                                                      Real rtol,
+                                                      Real atol,
+                                                      Real dt_min,
+                                                      Real dt_max) {
+    
+    libmesh_assert_greater(rtol, 0.);
+    libmesh_assert_greater_equal(atol, 0.);
+    libmesh_assert_greater_equal(dt_min, 0.);
+    libmesh_assert_greater(dt_max, dt_min);
+    
+    _if_adaptive_dt = flag;
+    _adaptive_rtol  = rtol;
+    _adaptive_atol  = atol;
+    _dt_min         = dt_min;
+    _dt_max         = dt_max;
+    _error_prev     = 1.;
+}
+
+
+
+void
+MAST::TransientSolverBase::set_time_step_controller(Real k_I,
+                                                    Real k_P,
+                                                    Real safety,
+                                                    Real fac_min,
+                                                    Real fac_max,
+                                                    unsigned int max_rejections) {
+    
+    libmesh_assert_greater(k_I, 0.);
+    libmesh_assert_greater_equal(k_P, 0.);
+    libmesh_assert_greater(safety, 0.);
+    libmesh_assert_less_equal(safety, 1.);
+    libmesh_assert_greater(fac_min, 0.);
+    libmesh_assert_less(fac_min, 1.);
+    libmesh_assert_greater(fac_max, 1.);
+    
+    _controller_k_I      = k_I;
+    _controller_k_P      = k_P;
+    _controller_safety   = safety;
+    _controller_fac_min  = fac_min;
+    _controller_fac_max  = fac_max;
+    _max_step_rejections = max_rejections;
+}
+
+
+
+unsigned int
+MAST::TransientSolverBase::
+solve_and_advance_adaptive_time_step(MAST::AssemblyBase& assembly) {
+    
+    MAST::PerformanceScope perf("TransientSolverBase::solve_and_advance_adaptive_time_step");
+    
+    libmesh_assert_msg(_if_adaptive_dt, "Adaptive time stepping is not enabled.");
+    libmesh_assert_msg(_system, "System pointer is nullptr.");
+    // the error estimate uses the velocity and acceleration of the
+    // previous time step, which are available only after the first step.
+    libmesh_assert_msg(!_first_step,
+                       "Highest derivative must be initialized before adaptive time stepping.");
+    
+    MAST::NonlinearSystem
+    &sys = _system->system();
+    
+    const Real
+    p   = this->_local_error_order();
+    
+    unsigned int
+    n_rejected = 0;
+    
+    while (true) {
         
-        this->velocity_sensitivity(i).zero();
-        this->velocity_sensitivity(i).add(1., this->velocity_sensitivity(i-1));
-        this->velocity_sensitivity(i).close();
+        this->solve(assembly);
         
-        if (_ode_order > 1) {
+        // velocity and acceleration of the converged solution are needed
+        // for the error estimate
+        update_velocity(this->velocity(), *sys.solution);
+        if (_ode_order > 1)
+            update_acceleration(this->acceleration(), *sys.solution);
+        
+        const Real
+        err = this->_scaled_local_error();
+        
+        if (err <= 1. || dt <= _dt_min) {
+            
+            if (err > 1.)
+                libMesh::out
+                << "Warning: local error estimate " << err
+                << " exceeds tolerance at minimum time step dt = " << dt << std::endl;
+            
+            // the PI controller selects the time step for the next step
+            // using the error of this and the previous accepted step
+            const Real
+            e   = std::max(err, 1.e-10);
+            
+            Real
+            fac = _controller_safety *
+            std::pow(e, -_controller_k_I/p) *
+            std::pow(_error_prev, _controller_k_P/p);
+            fac = std::min(_controller_fac_max, std::max(_controller_fac_min, fac));
             
-            this->acceleration_sensitivity(i).zero();
-            this->acceleration_sensitivity(i).add(1., this->acceleration_sensitivity(i-1));
-            this->acceleration_sensitivity(i).close();
+            // a time step was just rejected, so the step is not increased
+            if (n_rejected)
+                fac = std::min(fac, 1.);
+            
+            _error_estimate = err;
+            _error_prev     = e;
+            
+            // the history stores the time derivatives, and not the scaled
+            // differences, so it remains consistent after a change of dt
+            this->advance_time_step();
+            
+            dt = std::min(_dt_max, std::max(_dt_min, dt * fac));
+            
+            return n_rejected;
         }
+        
+        // reject the step: the current solution, velocity and acceleration
+        // are reset to the values of the previous time step, which are
+        // left unchanged until the step is accepted.
+        n_rejected++;
+        _n_rejected_steps++;
+        
+        if (n_rejected > _max_step_rejections)
+            libmesh_error_msg("Time step rejected " << n_rejected
+                              << " times at t = " << sys.time
+                              << ", dt = " << dt);
+        
+        *sys.solution       = this->solution(1);
+        sys.solution->close();
+        sys.update();
+        this->velocity()    = this->velocity(1);
+        if (_ode_order > 1)
+            this->acceleration() = this->acceleration(1);
+        
+        Real
+        fac = _controller_safety * std::pow(err, -1./p);
+        fac = std::min(1., std::max(_controller_fac_min, fac));
+        
+        dt  = std::max(_dt_min, dt * fac);
     }
+}
+
+
+
+void
+MAST::TransientSolverBase::
+_local_error_estimate(libMesh::NumericVector<Real>& err) {
     
-    // finally, update the system time
-    _first_sensitivity_step   = false;
+    libmesh_error_msg("Local error estimate not implemented for this solver.");
+}
 
-    this->advance_time_step();
+
+
+unsigned int
+MAST::TransientSolverBase::_local_error_order() const {
+    
+    libmesh_error_msg("Local error estimate not implemented for this solver.");
+    return 0;
 }
 
 
 
+Real
+MAST::TransientSolverBase::_scaled_local_error() {
+    
+    libMesh::NumericVector<Real>
+    &err = this->_scratch_vector();
+    
+    this->_local_error_estimate(err);
+    
+    const Real
+    scale = _adaptive_atol * std::sqrt(1.*err.size()) +
+    _adaptive_rtol * this->solution().l2_norm();
+    
+    libmesh_assert_greater(scale, 0.);
+    
+    return err.l2_norm() / scale;
+}
+
+
 
 void
 MAST::TransientSolverBase::init(const libMesh::Elem &elem) {
@@ -21,6 +21,12 @@
 #ifndef __mast__transient_solver_base__
 #define __mast__transient_solver_base__
 
+// C++ includes
+#include <memory>
+#include <string>
+#include <vector>
+
+
 // MAST includes
 #include "base/mast_data_types.h"
 #include "base/nonlinear_implicit_assembly_elem_operations.h"
@@ -191,6 +197,57 @@ namespace MAST {
 
 
         
+        /*!
+         *    solves the adjoint of the highest derivative problem at the
+         *    initial conditions,
+         *    \f$ [\partial R/\partial X^{(n)}]^T \{\lambda\} = \{rhs\} \f$,
+         *    where \f$ X^{(n)} \f$ is the highest time derivative. The
+         *    product of \p lambda with the residual sensitivity for each
+         *    parameter in \p p is added to the corresponding entry in
+         *    \p dq_dp. The solution, velocity and acceleration of the
+         *    current time step must be set to the initial conditions.
+         */
+        void
+        highest_derivative_adjoint_solve(MAST::AssemblyBase& assembly,
+                                         libMesh::NumericVector<Real>& rhs,
+                                         libMesh::NumericVector<Real>& lambda,
+                                         const std::vector<const MAST::FunctionBase*>& p,
+                                         std::vector<Real>& dq_dp);
+        
+        
+        /*!
+         *   @returns the highest order time derivative that the solver
+         *   will handle
+         */
+        unsigned int ode_order() const {
+            return _ode_order;
+        }
+        
+        
+        /*!
+         *   computes the coefficients of the update of time derivatives
+         *   of the solution at the current time step for the current
+         *   \p dt. Row \p k-1 of \p c provides the coefficients of the
+         *   \p k th time derivative. Column 0 multiplies the current
+         *   solution, and column \p j+1 multiplies the \p j th time
+         *   derivative at the previous time step, where the solution is the
+         *   0th derivative. This is used for the transient adjoint solution.
+         */
+        virtual void
+        time_derivative_update_coefficients(RealMatrixX& c) const;
+        
+        
+        /*!
+         *   computes the product of \p lambda with the transpose of the
+         *   Jacobian of the element residual with respect to each time
+         *   derivative of the solution. \p vecs[k-1] is the product for
+         *   the \p k th derivative.
+         */
+        virtual void
+        elem_adjoint_time_derivative_products(const RealVectorX& lambda,
+                                              std::vector<RealVectorX>& vecs);
+        
+        
         /*!
          *   advances the time step and copies the current solution to old
          *   solution, and so on.
@@ -205,6 +262,71 @@ namespace MAST {
         virtual void advance_time_step_with_sensitivity();
 
         
+        /*!
+         *   enables or disables the adaptive selection of time step in
+         *   solve_and_advance_adaptive_time_step(). The local truncation
+         *   error estimate of a step is scaled by
+         *   \f$ atol \sqrt{N} + rtol \| X \| \f$, and the step is accepted
+         *   if the scaled error is less than one. The time step is limited
+         *   to the range [\p dt_min, \p dt_max].
+         */
+        void set_adaptive_time_stepping(bool flag,
+                                        Real rtol   = 1.e-4,
+                                        Real atol   = 1.e-8,
+                                        Real dt_min = 0.,
+                                        Real dt_max = 1.e12);
+        
+        /*!
+         *   @returns true if the adaptive time stepping is enabled
+         */
+        bool if_adaptive_time_stepping() const {
+            return _if_adaptive_dt;
+        }
+        
+        /*!
+         *   sets the parameters of the PI controller used to select the
+         *   time step. After an accepted step the time step is scaled by
+         *   \f$ s e_n^{-k_I/p} e_{n-1}^{k_P/p} \f$, where \f$ e \f$ is the
+         *   scaled error, \f$ s \f$ is the \p safety factor and \f$ p \f$
+         *   is the order of the local error in the time step. The
+         *   scaling is limited to [\p fac_min, \p fac_max]. A time step
+         *   is rejected at most \p max_rejections times in a row.
+         */
+        void set_time_step_controller(Real k_I                     = 0.7,
+                                      Real k_P                     = 0.4,
+                                      Real safety                  = 0.9,
+                                      Real fac_min                 = 0.2,
+                                      Real fac_max                 = 5.,
+                                      unsigned int max_rejections  = 20);
+        
+        /*!
+         *   solves the current time step, estimates the local truncation
+         *   error and advances the time step if the error is acceptable.
+         *   Otherwise, the solution is reset to the previous time step and
+         *   the step is repeated with a smaller \p dt. Upon return,
+         *   \p dt is the time step suggested for the next step.
+         *   @returns the number of rejected attempts for this time step.
+         */
+        unsigned int
+        solve_and_advance_adaptive_time_step(MAST::AssemblyBase& assembly);
+        
+        /*!
+         *   @returns the scaled local error estimate of the last accepted
+         *   time step.
+         */
+        Real last_error_estimate() const {
+            return _error_estimate;
+        }
+        
+        /*!
+         *   @returns the total number of time steps rejected by the
+         *   adaptive time stepping.
+         */
+        unsigned int n_rejected_time_steps() const {
+            return _n_rejected_steps;
+        }
+
+        
         /*!
          *    localizes the relevant solutions for system assembly. The
          *    calling function has to delete the pointers to these vectors
@@ -295,6 +417,117 @@ namespace MAST {
          *    derivative solution, or to evaluate solution at current time step.
          */
         bool   _if_highest_derivative_solution;
+        
+        
+        /*!
+         *    @returns the vector stored in the system with name \p prefix
+         *    followed by \p i
+         */
+        libMesh::NumericVector<Real>&
+        _history_vector(const std::string& prefix,
+                        unsigned int i) const;
+        
+        
+        /*!
+         *    moves the solution, velocity and acceleration to the older time
+         *    step locations by rotating the stored vectors
+         */
+        void _advance_history();
+        
+        
+        /*!
+         *    moves the sensitivity of solution, velocity and acceleration to
+         *    the older time step locations by rotating the stored vectors
+         */
+        void _advance_sensitivity_history();
+        
+        
+        /*!
+         *    @returns a work vector with the same layout as the solution,
+         *    which is kept across the time steps. The values are not
+         *    initialized.
+         */
+        libMesh::NumericVector<Real>& _scratch_vector();
+        
+        
+        /*!
+         *    computes the estimate of the local truncation error of the
+         *    current time step in \p err. This is called after the
+         *    velocity and acceleration of the current time step have been
+         *    updated from the converged solution. The derived solvers
+         *    must override this to support adaptive time stepping.
+         */
+        virtual void
+        _local_error_estimate(libMesh::NumericVector<Real>& err);
+        
+        
+        /*!
+         *    @returns the power of the time step in the leading term of
+         *    the local error estimate.
+         */
+        virtual unsigned int _local_error_order() const;
+        
+        
+        /*!
+         *    @returns the local error estimate of the current time step
+         *    scaled by the tolerances.
+         */
+        Real _scaled_local_error();
+        
+        
+        /*!
+         *    offsets of the current iteration in the rotating storage of
+         *    the velocity and acceleration, of the previous solutions, and
+         *    of the sensitivities.
+         */
+        unsigned int   _history_offset;
+        unsigned int   _solution_history_offset;
+        unsigned int   _sensitivity_history_offset;
+        
+        
+        /*!
+         *    work vector returned by _scratch_vector()
+         */
+        std::unique_ptr<libMesh::NumericVector<Real> > _scratch;
+        
+        
+        /*!
+         *    time step for which the lagged Jacobian of the system was
+         *    assembled
+         */
+        Real           _jacobian_dt;
+
+        
+        /*!
+         *    adaptive time stepping flag, the relative and absolute
+         *    tolerances on the local error, and the limits on the time step
+         */
+        bool           _if_adaptive_dt;
+        Real           _adaptive_rtol;
+        Real           _adaptive_atol;
+        Real           _dt_min;
+        Real           _dt_max;
+        
+        
+        /*!
+         *    integral and proportional gains, safety factor, and limits on
+         *    the scaling of the time step by the PI controller
+         */
+        Real           _controller_k_I;
+        Real           _controller_k_P;
+        Real           _controller_safety;
+        Real           _controller_fac_min;
+        Real           _controller_fac_max;
+        unsigned int   _max_step_rejections;
+        
+        
+        /*!
+         *    scaled local error of the last and the previous accepted
+         *    time steps, and the total number of rejected time steps
+         */
+        Real           _error_estimate;
+        Real           _error_prev;
+        unsigned int   _n_rejected_steps;
 
     };
 
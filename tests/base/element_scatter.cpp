@@ -0,0 +1,150 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2018  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <map>
+#include <vector>
+
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+
+// MAST includes
+#include "base/element_scatter.h"
+#include "base/nonlinear_system.h"
+
+// libMesh includes
+#include "libmesh/libmesh.h"
+#include "libmesh/distributed_mesh.h"
+#include "libmesh/mesh_generation.h"
+#include "libmesh/equation_systems.h"
+#include "libmesh/dof_map.h"
+
+
+extern libMesh::LibMeshInit* __init;
+
+
+BOOST_AUTO_TEST_SUITE  (ElementScatterLayouts)
+
+
+BOOST_AUTO_TEST_CASE   (DofRenumberingWithEqualCounts) {
+
+    const unsigned int
+    n_elems = 10;
+
+    // a DistributedMesh is used since it allows the element ids to be
+    // changed arbitrarily. Renumbering is disabled so that the ids set
+    // below are retained.
+    libMesh::DistributedMesh
+    mesh(__init->comm());
+
+    mesh.allow_renumbering(false);
+    libMesh::MeshTools::Generation::build_line(mesh, n_elems, 0., 1., libMesh::EDGE2);
+
+    libMesh::EquationSystems
+    eq_sys(mesh);
+
+    MAST::NonlinearSystem&
+    sys = eq_sys.add_system<MAST::NonlinearSystem>("scatter");
+
+    sys.add_variable("u", libMesh::FIRST, libMesh::LAGRANGE);
+    eq_sys.init();
+
+    const libMesh::DofMap&
+    dof_map = sys.get_dof_map();
+
+    MAST::ElementScatter
+    scatter;
+
+    // store the layouts of all local elements
+    scatter.init(sys);
+
+    const unsigned int
+    revision0 = scatter.revision(),
+    n_dofs0   = dof_map.n_dofs();
+
+    std::map<libMesh::dof_id_type, std::vector<libMesh::dof_id_type>>
+    dofs0;
+
+    libMesh::MeshBase::const_element_iterator
+    el     = mesh.active_local_elements_begin(),
+    end_el = mesh.active_local_elements_end();
+
+    for ( ; el != end_el; ++el)
+        dofs0[(*el)->id()] = scatter.layout(dof_map, **el).dof_indices;
+
+    // reverse the element ids on all processors. The dofs are numbered
+    // in the order of the elements, so this changes the dof indices of
+    // each element id without a change in the number of dofs.
+    std::vector<libMesh::dof_id_type>
+    ids;
+
+    libMesh::MeshBase::element_iterator
+    e_it  = mesh.elements_begin(),
+    e_end = mesh.elements_end();
+
+    for ( ; e_it != e_end; ++e_it)
+        ids.push_back((*e_it)->id());
+
+    for (unsigned int i=0; i<ids.size(); i++)
+        mesh.renumber_elem(ids[i], ids[i] + n_elems);
+
+    for (unsigned int i=0; i<ids.size(); i++)
+        mesh.renumber_elem(ids[i] + n_elems, n_elems - 1 - ids[i]);
+
+    eq_sys.reinit();
+
+    BOOST_CHECK_EQUAL(dof_map.n_dofs(), n_dofs0);
+
+    // the layouts must be recomputed after the dofs are redistributed
+    scatter.init(sys);
+
+    BOOST_CHECK(scatter.revision() != revision0);
+
+    bool
+    changed = false;
+
+    std::vector<libMesh::dof_id_type>
+    dofs;
+
+    el     = mesh.active_local_elements_begin();
+    end_el = mesh.active_local_elements_end();
+
+    for ( ; el != end_el; ++el) {
+
+        dof_map.dof_indices(*el, dofs);
+
+        const std::vector<libMesh::dof_id_type>&
+        layout_dofs = scatter.layout(dof_map, **el).dof_indices;
+
+        BOOST_CHECK(layout_dofs == dofs);
+
+        if (dofs0.count((*el)->id()) && dofs0[(*el)->id()] != dofs)
+            changed = true;
+    }
+
+    // with a single processor the renumbering must have changed the dofs
+    // of some element id, otherwise the test does not check anything
+    if (__init->comm().size() == 1)
+        BOOST_CHECK(changed);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
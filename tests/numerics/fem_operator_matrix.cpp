@@ -17,111 +17,206 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
-//#include "numerics/fem_operator_matrix.h"
-//
-//int main_fem_operator (int argc, char* const argv[])
-//{
-//    DenseRealVector vec1, vec2, shp;
-//    DenseRealMatrix mat1, mat2, bmat1, bmat2, tmp;
-//    
-//    vec1.resize(12); shp.resize(4);
-//    
-//    for (unsigned int i=0; i<shp.size(); i++)
-//        shp(i) = i+1;
-//    
-//    for (unsigned int i=0; i<vec1.size(); i++)
-//        vec1(i) = i+100;
-//    
-//    shp.print(libMesh::out);
-//    vec1.print(libMesh::out);
-//    mat1.print(libMesh::out);
-//    
-//    MAST::FEMOperatorMatrix b1, b2;
-//    b1.reinit(3, shp); b2.reinit(3, shp);
-//    bmat1.resize(3, shp.size()*3); bmat2.resize(3, shp.size()*3);
-//    for (unsigned int i=0; i<3; i++)
-//        for (unsigned int j=0; j<shp.size(); j++) {
-//            bmat1(i, i*shp.size()+j) = shp(j);
-//            bmat2(i, i*shp.size()+j) = shp(j);
-//        }
-//    
-//    
-//    vec2.resize(3);
-//    b1.vector_mult(vec2, vec1);
-//    libMesh::out << "FEMOperator: " << std::endl; vec2.print(libMesh::out);
-//    bmat1.vector_mult(vec2, vec1);
-//    libMesh::out << "Matrix:      " << std::endl; vec2.print(libMesh::out);
-//    
-//    vec1.resize(3);
-//    for (unsigned int i=0; i<vec1.size(); i++)
-//        vec1(i) = 100+i;
-//    vec2.resize(12);
-//    b1.vector_mult_transpose(vec2, vec1);
-//    libMesh::out << "FEMOperator: " << std::endl; vec2.print(libMesh::out);
-//    bmat1.vector_mult_transpose(vec2, vec1);
-//    libMesh::out << "Matrix:      " << std::endl; vec2.print(libMesh::out);
-//    
-//    
-//    mat1.resize(5,3);
-//    mat2.resize(5, 12);
-//    for (unsigned int i=0; i<5; i++)
-//        for (unsigned int j=0; j<3; j++)
-//            mat1(i,j) = (i+1)*(j+1);
-//    libMesh::out << "multiply matrix" << std::endl;  mat1.print();
-//    b1.left_multiply(mat2, mat1);
-//    libMesh::out << "FEMOperator: " << std::endl;  mat2.print();
-//    tmp = bmat1;
-//    tmp.left_multiply(mat1);
-//    libMesh::out << "Matrix:      " << std::endl;  tmp.print();
-//    
-//    
-//    mat1.resize(5,12);
-//    mat2.resize(5, 3);
-//    for (unsigned int i=0; i<5; i++)
-//        for (unsigned int j=0; j<12; j++)
-//            mat1(i,j) = (i+1)*(j+1);
-//    libMesh::out << "multiply matrix" << std::endl;  mat1.print();
-//    b1.left_multiply_transpose(mat2, mat1);
-//    libMesh::out << "FEMOperator: " << std::endl;  mat2.print();
-//    bmat1.get_transpose(tmp);
-//    tmp.left_multiply(mat1);
-//    libMesh::out << "Matrix:      " << std::endl;  tmp.print();
-//    
-//    
-//    mat1.resize(12,5);
-//    mat2.resize(3, 5);
-//    for (unsigned int i=0; i<12; i++)
-//        for (unsigned int j=0; j<5; j++)
-//            mat1(i,j) = (i+1)*(j+1);
-//    libMesh::out << "multiply matrix" << std::endl;  mat1.print();
-//    b1.right_multiply(mat2, mat1);
-//    libMesh::out << "FEMOperator: " << std::endl;  mat2.print();
-//    tmp = bmat1;
-//    tmp.right_multiply(mat1);
-//    libMesh::out << "Matrix:      " << std::endl;  tmp.print();
-//    
-//    
-//    mat1.resize(3, 5);
-//    mat2.resize(12, 5);
-//    for (unsigned int i=0; i<3; i++)
-//        for (unsigned int j=0; j<5; j++)
-//            mat1(i,j) = (i+1)*(j+1);
-//    libMesh::out << "multiply matrix" << std::endl;  mat1.print();
-//    b1.right_multiply_transpose(mat2, mat1);
-//    libMesh::out << "FEMOperator: " << std::endl;  mat2.print();
-//    bmat1.get_transpose(tmp);
-//    tmp.right_multiply(mat1);
-//    libMesh::out << "Matrix:      " << std::endl;  tmp.print();
-//    
-//    
-//    mat2.resize(12, 12);
-//    b1.right_multiply_transpose(mat2, b1);
-//    libMesh::out << "FEMOperator: " << std::endl;  mat2.print();
-//    bmat1.get_transpose(tmp);
-//    tmp.right_multiply(bmat1);
-//    libMesh::out << "Matrix:      " << std::endl;  tmp.print();
-//    
-//    return 0;
-//}
-//
-//
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+
+// MAST includes
+#include "numerics/fem_operator_matrix.h"
+#include "numerics/fixed_size_fem_operator_matrix.h"
+#include "tests/base/test_comparisons.h"
+
+
+/*!
+ *   sizes representative of a QUAD4 structural element: three membrane
+ *   strain components, six dofs per node and four nodes.
+ */
+static const unsigned int
+__n_interp   = 3,
+__n_discrete = 6,
+__n_dofs     = 4;
+
+
+/*!
+ *   blocks of the operator that are set, chosen to mimic the membrane
+ *   strain operator: eps_xx = du/dx, eps_yy = dv/dy, gam_xy = du/dy + dv/dx
+ */
+static const unsigned int
+__blocks[][2] = {{0, 0}, {1, 1}, {2, 0}, {2, 1}};
+
+
+template <typename OpType>
+void
+__init_operator(OpType& op, RealMatrixX& dense) {
+
+    op.reinit(__n_interp, __n_discrete, __n_dofs);
+    dense = RealMatrixX::Zero(__n_interp, __n_discrete*__n_dofs);
+
+    RealVectorX
+    shp = RealVectorX::Zero(__n_dofs);
+
+    for (unsigned int b=0; b<4; b++) {
+
+        const unsigned int
+        i = __blocks[b][0],
+        j = __blocks[b][1];
+
+        for (unsigned int k=0; k<__n_dofs; k++)
+            shp(k) = 1. + 0.1*b + 0.37*k*(i+1) - 0.05*j;
+
+        op.set_shape_function(i, j, shp);
+        dense.block(i, j*__n_dofs, 1, __n_dofs) = shp.transpose();
+    }
+}
+
+
+
+template <typename OpType>
+void
+__check_operator() {
+
+    const Real
+    tol   = 1.e-12;
+
+    const unsigned int
+    n_cols = 5,
+    n      = __n_discrete*__n_dofs;
+
+    OpType
+    op1,
+    op2;
+
+    RealMatrixX
+    B1,
+    B2;
+
+    __init_operator(op1, B1);
+    __init_operator(op2, B2);
+
+    BOOST_CHECK_EQUAL(op1.m(), __n_interp);
+    BOOST_CHECK_EQUAL(op1.n(), n);
+
+    RealVectorX
+    v_n     = RealVectorX::Zero(n),
+    v_m     = RealVectorX::Zero(__n_interp),
+    res_n   = RealVectorX::Zero(n),
+    res_m   = RealVectorX::Zero(__n_interp);
+
+    RealMatrixX
+    m_nc    = RealMatrixX::Zero(n, n_cols),
+    m_mc    = RealMatrixX::Zero(__n_interp, n_cols),
+    m_cm    = RealMatrixX::Zero(n_cols, __n_interp),
+    m_cn    = RealMatrixX::Zero(n_cols, n),
+    r;
+
+    for (unsigned int i=0; i<n; i++) {
+        v_n(i) = 100. + i;
+        for (unsigned int j=0; j<n_cols; j++) {
+            m_nc(i, j) = (i+1)*(j+1);
+            m_cn(j, i) = (i+1) - 2.*(j+1);
+        }
+    }
+
+    for (unsigned int i=0; i<__n_interp; i++) {
+        v_m(i) = 10. + i;
+        for (unsigned int j=0; j<n_cols; j++) {
+            m_mc(i, j) = (i+1)*(j+2);
+            m_cm(j, i) = (i+3) - (j+1);
+        }
+    }
+
+    // res = [B] v
+    op1.vector_mult(res_m, v_n);
+    BOOST_CHECK(MAST::compare_vector(B1 * v_n, res_m, tol));
+
+    // res = v^T [B]
+    op1.vector_mult_transpose(res_n, v_m);
+    BOOST_CHECK(MAST::compare_vector(B1.transpose() * v_m, res_n, tol));
+
+    // [R] = [B] [M]
+    r.setZero(__n_interp, n_cols);
+    op1.right_multiply(r, m_nc);
+    BOOST_CHECK(MAST::compare_matrix(B1 * m_nc, r, tol));
+
+    // [R] = [B]^T [M]
+    r.setZero(n, n_cols);
+    op1.right_multiply_transpose(r, m_mc);
+    BOOST_CHECK(MAST::compare_matrix(B1.transpose() * m_mc, r, tol));
+
+    // [R] = [B1]^T [B2]
+    r.setZero(n, n);
+    op1.right_multiply_transpose(r, op2);
+    BOOST_CHECK(MAST::compare_matrix(B1.transpose() * B2, r, tol));
+
+    // [R] = [M] [B]
+    r.setZero(n_cols, n);
+    op1.left_multiply(r, m_cm);
+    BOOST_CHECK(MAST::compare_matrix(m_cm * B1, r, tol));
+
+    // [R] = [M] [B]^T
+    r.setZero(n_cols, __n_interp);
+    op1.left_multiply_transpose(r, m_cn);
+    BOOST_CHECK(MAST::compare_matrix(m_cn * B1.transpose(), r, tol));
+
+    // reinitializing the operator must zero all previously set blocks
+    op1.reinit(__n_interp, __n_discrete, __n_dofs);
+    op1.vector_mult(res_m, v_n);
+    BOOST_CHECK(MAST::compare_vector(RealVectorX::Zero(__n_interp), res_m, tol));
+}
+
+
+
+BOOST_AUTO_TEST_SUITE  (FEMOperatorMatrixOperations)
+
+
+BOOST_AUTO_TEST_CASE   (DynamicSizeOperator) {
+
+    __check_operator<MAST::FEMOperatorMatrix>();
+}
+
+
+BOOST_AUTO_TEST_CASE   (FixedSizeOperator) {
+
+    __check_operator<MAST::FixedSizeFEMOperatorMatrix<__n_interp, __n_discrete, __n_dofs> >();
+}
+
+
+BOOST_AUTO_TEST_CASE   (FixedSizeOperatorSingleShapeFunction) {
+
+    const Real
+    tol   = 1.e-12;
+
+    RealVectorX
+    shp   = RealVectorX::Zero(__n_dofs),
+    v     = RealVectorX::Zero(3*__n_dofs),
+    res1  = RealVectorX::Zero(3),
+    res2  = RealVectorX::Zero(3);
+
+    for (unsigned int i=0; i<__n_dofs; i++)
+        shp(i) = i+1;
+    for (unsigned int i=0; i<v.size(); i++)
+        v(i) = i+100;
+
+    MAST::FEMOperatorMatrix
+    b1;
+    MAST::FixedSizeFEMOperatorMatrix<3, 3, __n_dofs>
+    b2;
+
+    b1.reinit(3, shp);
+    b2.reinit(3, shp);
+
+    b1.vector_mult(res1, v);
+    b2.vector_mult(res2, v);
+    BOOST_CHECK(MAST::compare_vector(res1, res2, tol));
+
+    RealMatrixX
+    m1 = RealMatrixX::Zero(3*__n_dofs, 3*__n_dofs),
+    m2 = RealMatrixX::Zero(3*__n_dofs, 3*__n_dofs);
+
+    b1.right_multiply_transpose(m1, b1);
+    b2.right_multiply_transpose(m2, b2);
+    BOOST_CHECK(MAST::compare_matrix(m1, m2, tol));
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()